@@ -36,23 +36,38 @@
 * indemnify Cypress against all liability.
 *****************************************************************************/
 
+#include <string.h>
+
 #include "amux.h"
 
 /*******************************************************************************
 * Constants
 *******************************************************************************/
+/* Each chain of AMux_SetChannelMask() takes one half of the descriptors, so 
+ * the next one is built while the DMA runs the other half */
+#define AMUX_CHAIN_DESCRIPTORS(amux)   ((uint32_t)(amux)->max_desc / 2u)
 
 /*******************************************************************************
 * Local Functions
 *******************************************************************************/
+static en_amux_status_t AMux_GetPinConnection(GPIO_PRT_Type *port, uint8_t pin, 
+                                              en_amux_select_t amux_sel,
+                                              uint32_t *reg, uint32_t *value);
+static uint32_t AMux_GetFieldMask(uint32_t value);
+static void AMux_UpdateDisconnect(amux_t *amux);
+static void AMux_UpdateChain(amux_t *amux);
+#if (AMUX_MAX_NUM_DESCRIPTORS > 0u)
+static uint8_t AMux_GetLastConnection(amux_t *amux, uint32_t mask);
+static uint32_t AMux_CountDescriptors(amux_t *amux, uint32_t mask);
+static void AMux_SetupClear(amux_t *amux, uint32_t d, uint8_t conn);
+static void AMux_SetupChain(amux_t *amux, uint32_t first, uint32_t mask);
+#endif
 
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
 const uint32_t amux_all_zero = 0x00000000;
 
-cy_stc_dma_descriptor_t amux_dma_descriptor[2*AMUX_MAX_NUM_CONNECTIONS];
-
 const cy_stc_dma_descriptor_config_t amux_dma_descriptor_config = 
 {
     .retrigger = CY_DMA_RETRIG_IM,
@@ -77,7 +92,7 @@ const cy_stc_dma_descriptor_config_t amux_dma_descriptor_config =
 
 const cy_stc_dma_channel_config_t amux_dma_channel_config = 
 {
-    .descriptor = &amux_dma_descriptor[0],
+    .descriptor = NULL,
     .preemptable = false,
     .priority = 3,
     .enable = false,
@@ -108,8 +123,19 @@ en_amux_status_t AMux_Init(amux_t *amux, en_amux_select_t amux_sel)
     /* Set some structure variables to their initial values */
     amux->num_conn = 0;
     amux->curr_conn = AMUX_CONN_UNKNOWN;
+    amux->hold_count = 1;
+    memset(amux->settle_count, 0, sizeof(amux->settle_count));
+    amux->schedule_len = 0;
+    amux->num_desc = 0;
+    amux->dma_chain = NULL;
+    amux->channel_mask = AMUX_ALL_CHANNELS;
+    amux->pending_chain = NULL;
     amux->dma_base = NULL;
     amux->dma_en = false;
+#if (AMUX_MAX_NUM_DESCRIPTORS > 0u)
+    amux->dma_desc = NULL;
+    amux->max_desc = 0;
+#endif
 
     /* Check if Amux selection is correct */
     if ((amux_sel != AMUX_A) && (amux_sel != AMUX_B))
@@ -151,6 +177,11 @@ void AMux_Deinit(amux_t *amux)
     /* Set some structure variables to their initial values */
     amux->num_conn = 0;
     amux->curr_conn = AMUX_CONN_UNKNOWN;
+    amux->schedule_len = 0;
+    amux->num_desc = 0;
+    amux->dma_chain = NULL;
+    amux->channel_mask = AMUX_ALL_CHANNELS;
+    amux->pending_chain = NULL;
     amux->dma_base = NULL;
     amux->dma_en = false;
 }
@@ -160,9 +191,9 @@ void AMux_Deinit(amux_t *amux)
 ********************************************************************************
 * Summary:
 *   Add the pins from the given port to the list of connections to the analog 
-*   mux.
-*   If some of the pins in this port is not used, the pin must be configured to
-*   work as a GPIO. No peripheral connection is allowed. 
+*   mux. The other pins of the port keep their HSIOM selection, as read by 
+*   this function, see AMux_AddPins(). The pins shall not share an HSIOM 
+*   register with the pins of another AMux object.
 *
 * Parameters:
 *   amux: AMux object
@@ -175,57 +206,122 @@ void AMux_Deinit(amux_t *amux)
 *******************************************************************************/
 en_amux_status_t AMux_AddPort(amux_t *amux, GPIO_PRT_Type *port, uint8_t mask)
 {
-    uint32_t portNum;
-    HSIOM_PRT_Type* portAddrHSIOM;
+    amux_pin_t pins[CY_GPIO_PINS_MAX];
+    uint8_t num_pins = 0;
 
     if (amux == NULL || port == NULL || amux->dma_en == true)
     {
         return AMUX_ERROR;
     }   
      
-    /* Extract the port number and port HSIOM address */
-    portNum = ((uint32_t)(port) - CY_GPIO_BASE) / GPIO_PRT_SECTION_SIZE;
-    portAddrHSIOM = (HSIOM_PRT_Type*)(CY_HSIOM_BASE + (HSIOM_PRT_SECTION_SIZE * portNum));
-
     /* Check the mask argument for which bits to connect */
     for (uint8_t pinNum = 0; pinNum < CY_GPIO_PINS_MAX; pinNum++)
     {
-        /* Check if reached the number of connections*/
-        if (amux->num_conn < AMUX_MAX_NUM_CONNECTIONS)
-        {  
-            /* Add the connections to the list */
-            if ((mask & (1 << pinNum)) != 0)
+        if ((mask & (1 << pinNum)) != 0)
+        {
+            pins[num_pins].port = port;
+            pins[num_pins].pin = pinNum;
+            num_pins++;
+        }
+    }
+
+    return AMux_AddPins(amux, pins, num_pins, false);
+}
+
+/*******************************************************************************
+* Function Name: AMux_AddPins
+********************************************************************************
+* Summary:
+*   Add a list of pins, from any port, to the list of connections to the 
+*   analog mux. All the pins are checked before any is added, so on error 
+*   the connections are not changed. The other pins of the HSIOM registers
+*   used keep their selection, so a port can also carry digital peripherals.
+*   Their selection is read here and written back with every connection, as
+*   the DMA writes whole registers, so these pins shall be configured before
+*   calling this function and not changed afterwards.
+*   For the same reason, two AMux objects, for example one on AMUX_A and one 
+*   on AMUX_B, shall not have pins in the same HSIOM register (pins 0 to 3 
+*   or pins 4 to 7 of a port): each object would write the pins of the 
+*   other one back to GPIO at every connection. This is not checked, as the
+*   objects do not know each other.
+*
+* Parameters:
+*   amux: AMux object
+*   pins: list of pins. A pin cannot be added twice.
+*   num_pins: number of pins in the list
+*   group: if true, the pins that share an HSIOM register are added next to
+*          each other, in the order of the first pin of each register. It 
+*          reduces the number of HSIOM writes per frame. Otherwise the pins 
+*          are added in the order of the list.
+*
+* Return:
+*   If added correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_amux_status_t AMux_AddPins(amux_t *amux, const amux_pin_t *pins, uint8_t num_pins, bool group)
+{
+    uint32_t reg[AMUX_MAX_NUM_CONNECTIONS];
+    uint32_t value[AMUX_MAX_NUM_CONNECTIONS];
+    bool added[AMUX_MAX_NUM_CONNECTIONS];
+
+    if (amux == NULL || amux->dma_en == true || (pins == NULL && num_pins != 0))
+    {
+        return AMUX_ERROR;
+    }
+
+    if (num_pins > (AMUX_MAX_NUM_CONNECTIONS - amux->num_conn))
+    {
+        /* No more connections allowed */
+        return AMUX_ERROR;
+    }
+
+    /* Check all the pins exist and none is added twice */
+    for (uint32_t i = 0; i < num_pins; i++)
+    {
+        if (AMux_GetPinConnection(pins[i].port, pins[i].pin, amux->amux_sel, 
+                                  &reg[i], &value[i]) != AMUX_SUCCESS)
+        {
+            return AMUX_ERROR;
+        }
+
+        for (uint32_t j = 0; j < amux->num_conn; j++)
+        {
+            if (amux->connect_port[j] == reg[i] && 
+                (amux->connect_pin[j] & ~amux->disconnect_pin[j]) == value[i])
             {
-                /* Check which HSIOM register (SEL0 or SEL1) to use */
-                if(pinNum < CY_GPIO_PRT_HALF)
-                {
-                    /* Set the HSIOM port address */
-                    amux->connect_port[amux->num_conn] = (volatile uint32_t) &portAddrHSIOM->PORT_SEL0;
-                    /* Set the value to write to HSIOM */
-                    amux->connect_pin[amux->num_conn] = (amux->amux_sel << (8*pinNum));
-                }
-                else
-                {
-                    /* Set the HSIOM port address */
-                    amux->connect_port[amux->num_conn] = (volatile uint32_t) &portAddrHSIOM->PORT_SEL1;
-                    /* Set the value to write to HSIOM */
-                    amux->connect_pin[amux->num_conn] = amux->amux_sel << (8*(pinNum-4));                
-                }
-
-                /* Increment the number of connections */
-                amux->num_conn++;
+                return AMUX_ERROR;
             }
         }
-        else 
+
+        for (uint32_t j = 0; j < i; j++)
         {
-            /* No more connections allowed */
-            return AMUX_ERROR;
-        }   
+            if (reg[j] == reg[i] && value[j] == value[i])
+            {
+                return AMUX_ERROR;
+            }
+        }
+
+        added[i] = false;
     }
 
-    /* Clear all connections from the given port to the analog mux */
-    portAddrHSIOM->PORT_SEL0 = 0;
-    portAddrHSIOM->PORT_SEL1 = 0;
+    /* Add the connections to the list */
+    for (uint32_t i = 0; i < num_pins; i++)
+    {
+        for (uint32_t j = i; j < num_pins; j++)
+        {
+            if (added[j] == false && (j == i || (group && reg[j] == reg[i])))
+            {
+                amux->connect_port[amux->num_conn] = reg[j];
+                amux->connect_pin[amux->num_conn] = value[j];
+                amux->disconnect_pin[amux->num_conn] = 0;
+                amux->num_conn++;
+                added[j] = true;
+            }
+        }
+    }
+
+    /* Update the values to write to HSIOM and disconnect the pins */
+    AMux_UpdateDisconnect(amux);
 
     return AMUX_SUCCESS;
 }
@@ -255,7 +351,8 @@ en_amux_status_t AMux_Connect(amux_t *amux, uint8_t index)
     if (amux->curr_conn != AMUX_CONN_UNKNOWN)
     {
         /* Disconnect current pin */
-        CY_SET_REG32(amux->connect_port[amux->curr_conn], 0);
+        CY_SET_REG32(amux->connect_port[amux->curr_conn], 
+                     amux->disconnect_pin[amux->curr_conn]);
     }
     else
     {
@@ -300,7 +397,8 @@ en_amux_status_t AMux_ConnectNext(amux_t *amux)
     else
     {
         /* Disconnect current pin */
-        CY_SET_REG32(amux->connect_port[amux->curr_conn], 0);
+        CY_SET_REG32(amux->connect_port[amux->curr_conn], 
+                     amux->disconnect_pin[amux->curr_conn]);
     }
 
     /* Update to the next pin and connect it */
@@ -340,7 +438,7 @@ en_amux_status_t AMux_DisconnectAll(amux_t *amux)
         /* Skip if previous port is the same */
         if (previous_port != amux->connect_port[i])
         {
-            CY_SET_REG32(amux->connect_port[i], 0);
+            CY_SET_REG32(amux->connect_port[i], amux->disconnect_pin[i]);
             previous_port = amux->connect_port[i];
         }
     }
@@ -351,6 +449,220 @@ en_amux_status_t AMux_DisconnectAll(amux_t *amux)
     return AMUX_SUCCESS;
 }
 
+/*******************************************************************************
+* Function Name: AMux_SetSchedule
+********************************************************************************
+* Summary:
+*   Set the order the DMA visits the connections. Each entry of the schedule is
+*   a connection index, based on the order the pins were added with 
+*   AMux_AddPort(). An index can be repeated, so a pin can be sampled more 
+*   often than the others within a frame. The samples of the Sampler follow
+*   the same order, so its number of channels shall be the schedule length.
+*   Without a schedule, all the connections are visited once in order.
+*   This function shall be called before AMux_SetupDMA().
+*
+* Parameters:
+*   amux: AMux object
+*   schedule: list of connection indexes. The list is copied.
+*   length: number of entries, up to AMUX_MAX_SCHEDULE_LENGTH. Set to 0 to 
+*           go back to the default order.
+*
+* Return:
+*   If set correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_amux_status_t AMux_SetSchedule(amux_t *amux, const uint8_t *schedule, uint16_t length)
+{
+    if (amux == NULL || amux->dma_en == true)
+    {
+        return AMUX_ERROR;
+    }
+
+    if (length > AMUX_MAX_SCHEDULE_LENGTH || (length != 0 && schedule == NULL))
+    {
+        return AMUX_ERROR;
+    }
+
+    /* Check every entry refers to an added connection */
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if (schedule[i] >= amux->num_conn)
+        {
+            return AMUX_ERROR;
+        }
+    }
+
+    if (length != 0)
+    {
+        memcpy(amux->schedule, schedule, length);
+    }
+    amux->schedule_len = length;
+
+    return AMUX_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: AMux_GetScheduleLength
+********************************************************************************
+* Summary:
+*   Get the number of slots visited by the DMA in one frame. It is the length
+*   of the schedule or, if none was set, the number of connections.
+*
+* Parameters:
+*   amux: AMux object
+*
+* Return:
+*   Number of slots per frame.
+*
+*******************************************************************************/
+uint16_t AMux_GetScheduleLength(amux_t *amux)
+{
+    if (amux == NULL)
+    {
+        return 0;
+    }
+
+    return (amux->schedule_len != 0) ? amux->schedule_len : amux->num_conn;
+}
+
+/*******************************************************************************
+* Function Name: AMux_GetSlotConnection
+********************************************************************************
+* Summary:
+*   Get the connection index of the given schedule slot.
+*
+* Parameters:
+*   amux: AMux object
+*   slot: schedule slot
+*
+* Return:
+*   Connection index, or AMUX_CONN_UNKNOWN if the slot does not exist.
+*
+*******************************************************************************/
+uint8_t AMux_GetSlotConnection(amux_t *amux, uint16_t slot)
+{
+    if (amux == NULL || slot >= AMux_GetScheduleLength(amux))
+    {
+        return AMUX_CONN_UNKNOWN;
+    }
+
+    return (amux->schedule_len != 0) ? amux->schedule[slot] : (uint8_t) slot;
+}
+
+/*******************************************************************************
+* Function Name: AMux_SetHoldCount
+********************************************************************************
+* Summary:
+*   Set the number of DMA triggers each connection is held before switching to
+*   the next one. It is used with the oversampling of the Sampler, which shall
+*   be set to the same value, so every conversion averaged for a channel is 
+*   taken from the same pin. This function shall be called before 
+*   AMux_SetupDMA().
+*
+* Parameters:
+*   amux: AMux object
+*   hold_count: number of triggers per connection, from 1 to 
+*               AMUX_MAX_HOLD_COUNT.
+*
+* Return:
+*   If set correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_amux_status_t AMux_SetHoldCount(amux_t *amux, uint16_t hold_count)
+{
+    if (amux == NULL || amux->dma_en == true)
+    {
+        return AMUX_ERROR;
+    }
+
+    if (hold_count == 0 || hold_count > AMUX_MAX_HOLD_COUNT)
+    {
+        return AMUX_ERROR;
+    }
+
+    amux->hold_count = hold_count;
+
+    return AMUX_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: AMux_SetSettleCount
+********************************************************************************
+* Summary:
+*   Set the number of extra samples the given connection is held before the
+*   sample that is kept. It is used for pins that need more settling time than
+*   the acquisition time, like high impedance sources. The Sampler shall 
+*   discard the same number of samples for this channel with 
+*   Sampler_SetDiscardCount(). This function shall be called before 
+*   AMux_SetupDMA().
+*
+* Parameters:
+*   amux: AMux object
+*   index: connection index
+*   settle_count: number of extra samples. The hold count times one plus the
+*                 settle count shall not exceed CY_DMA_LOOP_COUNT_MAX.
+*
+* Return:
+*   If set correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_amux_status_t AMux_SetSettleCount(amux_t *amux, uint8_t index, uint8_t settle_count)
+{
+    if (amux == NULL || amux->dma_en == true)
+    {
+        return AMUX_ERROR;
+    }
+
+    if (index >= amux->num_conn)
+    {
+        return AMUX_ERROR;
+    }
+
+    amux->settle_count[index] = settle_count;
+
+    return AMUX_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: AMux_ConfigureDescriptors
+********************************************************************************
+* Summary:
+*   Give the DMA descriptors AMux_SetupDMA() builds the chain in, allocated by
+*   the application. AMUX_NUM_DESCRIPTORS() of the schedule length is enough 
+*   for any settle count and channel mask. Without channel masks, half of 
+*   them is enough. The descriptors shall stay allocated while the DMA runs,
+*   and shall not be shared with another object. This function shall be 
+*   called before AMux_SetupDMA(). They are not needed by 
+*   AMux_SetupDMATable().
+*
+* Parameters:
+*   amux: AMux object
+*   descriptors: array of num_descriptors descriptors
+*   num_descriptors: number of descriptors
+*
+* Return:
+*   If configured correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_amux_status_t AMux_ConfigureDescriptors(amux_t *amux, cy_stc_dma_descriptor_t *descriptors, 
+                                           uint16_t num_descriptors)
+{
+    if (amux == NULL || descriptors == NULL || num_descriptors == 0 || amux->dma_en == true)
+    {
+        return AMUX_ERROR;
+    }
+
+#if (AMUX_MAX_NUM_DESCRIPTORS == 0u)
+    /* No descriptors in RAM, only AMux_SetupDMATable() can be used */
+    return AMUX_ERROR;
+#else
+    amux->dma_desc = descriptors;
+    amux->max_desc = num_descriptors;
+
+    return AMUX_SUCCESS;
+#endif
+}
+
 /*******************************************************************************
 * Function Name: AMux_SetupDMA
 ********************************************************************************
@@ -358,6 +670,7 @@ en_amux_status_t AMux_DisconnectAll(amux_t *amux)
 *   Setup a DMA to change the AMux connections without the CPU. 
 *   This function shall only be called after AMux_AddPort() was executed for 
 *   all connections.
+*   The descriptors are given by AMux_ConfigureDescriptors().
 *
 * Parameters:
 *   amux: AMux object
@@ -370,53 +683,153 @@ en_amux_status_t AMux_DisconnectAll(amux_t *amux)
 *******************************************************************************/
 en_amux_status_t AMux_SetupDMA(amux_t *amux, DW_Type *dma_base, uint32_t dma_chan)
 {
+    cy_stc_dma_channel_config_t channel_config = amux_dma_channel_config;
+    uint32_t num_slots;
+    uint32_t num_desc;
+    uint8_t conn;
+
     if (amux == NULL || dma_base == NULL || amux->dma_en == true)
     {
         return AMUX_ERROR;
     } 
 
+#if (AMUX_MAX_NUM_DESCRIPTORS == 0u)
+    /* No descriptors in RAM, only AMux_SetupDMATable() can be used */
+    (void) channel_config;
+    (void) num_slots;
+    (void) num_desc;
+    (void) conn;
+    (void) dma_chan;
+    return AMUX_ERROR;
+#else
+    num_slots = AMux_GetScheduleLength(amux);
+    if (num_slots == 0)
+    {
+        return AMUX_ERROR;
+    }
+
+    /* The whole hold of a slot is done by a single descriptor */
+    for (uint32_t i = 0; i < num_slots; i++)
+    {
+        conn = AMux_GetSlotConnection(amux, i);
+        if ((amux->hold_count * (1u + amux->settle_count[conn])) > CY_DMA_LOOP_COUNT_MAX)
+        {
+            return AMUX_ERROR;
+        }
+    }
+
+    num_desc = AMux_CountDescriptors(amux, AMUX_ALL_CHANNELS);
+    if (amux->dma_desc == NULL || num_desc > amux->max_desc)
+    {
+        return AMUX_ERROR;
+    }
+
     amux->dma_base = dma_base;
     amux->dma_chan = dma_chan;
+    amux->num_desc = num_desc;
+    amux->channel_mask = AMUX_ALL_CHANNELS;
+    amux->pending_chain = NULL;
 
-    /* Initialize the DMA descriptor settings for each pin connection. 
-     * Each pin requires two descriptors, one to clear and one to set */
-    for (uint32_t i = 0; i < amux->num_conn; i++)
+    AMux_SetupChain(amux, 0, AMUX_ALL_CHANNELS);
+
+    /* Disconnect all pins from the mux */
+    AMux_DisconnectAll(amux);
+
+    amux->curr_conn = AMUX_CONN_UNKNOWN;
+
+    /* Initialize the DMA channel with the descriptors of this object */
+    amux->dma_chain = &amux->dma_desc[0];
+    channel_config.descriptor = &amux->dma_desc[0];
+    Cy_DMA_Channel_Init(dma_base, dma_chan, &channel_config);
+
+    return AMUX_SUCCESS;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: AMux_SetupDMATable
+********************************************************************************
+* Summary:
+*   Setup a DMA to change the AMux connections without the CPU, using a table 
+*   built at compile time with AMUX_TABLE_DEFINE(). The DMA runs the 
+*   descriptors from flash, so AMux_AddPort(), AMux_SetSchedule(), 
+*   AMux_SetHoldCount() and AMux_SetSettleCount() are not used. The DMA 
+*   writes whole HSIOM registers, so the other pins of the registers used by 
+*   the table shall be GPIO.
+*
+* Parameters:
+*   amux: AMux object, initialized with the same global amux as the table
+*   table: flash table
+*   dma_base: DW base
+*   dma_chan: DW channel
+*
+* Return:
+*   If setup correctly, returns SUCCESS. If another pin of a register used by 
+*   the table is not GPIO, or otherwise, returns ERROR.
+*
+*******************************************************************************/
+en_amux_status_t AMux_SetupDMATable(amux_t *amux, const amux_table_t *table, 
+                                    DW_Type *dma_base, uint32_t dma_chan)
+{
+    cy_stc_dma_channel_config_t channel_config = amux_dma_channel_config;
+    uint32_t pin_mask;
+
+    if (amux == NULL || table == NULL || dma_base == NULL || amux->dma_en == true)
     {
-        /* Setup the DMA descriptor to clear the connection */
-        Cy_DMA_Descriptor_Init(&amux_dma_descriptor[2*i], &amux_dma_descriptor_config);
-        if (i == 0)
+        return AMUX_ERROR;
+    }
+
+    if (table->amux_sel != amux->amux_sel || table->num_conn == 0 ||
+        table->num_conn > AMUX_MAX_NUM_CONNECTIONS)
+    {
+        return AMUX_ERROR;
+    }
+
+    /* The table writes whole HSIOM registers, so the other pins of these 
+     * registers shall be GPIO */
+    for (uint32_t i = 0; i < table->num_conn; i++)
+    {
+        pin_mask = 0;
+        for (uint32_t j = 0; j < table->num_conn; j++)
         {
-            Cy_DMA_Descriptor_SetDstAddress(&amux_dma_descriptor[2*i], (void *) amux->connect_port[amux->num_conn-1]);
+            if (table->connect_port[j] == table->connect_port[i])
+            {
+                pin_mask |= AMux_GetFieldMask(table->connect_pin[j]);
+            }
         }
-        else
+        if ((CY_GET_REG32(table->connect_port[i]) & ~pin_mask) != 0)
         {
-            Cy_DMA_Descriptor_SetDstAddress(&amux_dma_descriptor[2*i], (void *) amux->connect_port[i-1]);
+            return AMUX_ERROR;
         }
-        Cy_DMA_Descriptor_SetSrcAddress(&amux_dma_descriptor[2*i], &amux_all_zero);
-        Cy_DMA_Descriptor_SetNextDescriptor(&amux_dma_descriptor[2*i], &amux_dma_descriptor[2*i+1]);
+    }
 
-        /* Setup the DMA descriptor to set the connection */
-        Cy_DMA_Descriptor_Init(&amux_dma_descriptor[2*i+1], &amux_dma_descriptor_config);
-        Cy_DMA_Descriptor_SetDstAddress(&amux_dma_descriptor[2*i+1], (void *) amux->connect_port[i]);
-        Cy_DMA_Descriptor_SetSrcAddress(&amux_dma_descriptor[2*i+1], &amux->connect_pin[i]);
-        Cy_DMA_Descriptor_SetTriggerInType(&amux_dma_descriptor[2*i+1], CY_DMA_1ELEMENT);
-        if (i == (amux->num_conn - 1))
-        {
-            Cy_DMA_Descriptor_SetNextDescriptor(&amux_dma_descriptor[2*i+1], &amux_dma_descriptor[0]);
-        }
-        else
-        {
-            Cy_DMA_Descriptor_SetNextDescriptor(&amux_dma_descriptor[2*i+1], &amux_dma_descriptor[2*(i+1)]);
-        }           
+    /* Keep a copy of the connections for the CPU functions */
+    for (uint32_t i = 0; i < table->num_conn; i++)
+    {
+        amux->connect_port[i] = table->connect_port[i];
+        amux->connect_pin[i] = table->connect_pin[i];
+        amux->disconnect_pin[i] = 0;
     }
+    amux->num_conn = table->num_conn;
+    amux->hold_count = table->hold_count;
+    memset(amux->settle_count, 0, sizeof(amux->settle_count));
+    amux->schedule_len = 0;
+
+    amux->dma_base = dma_base;
+    amux->dma_chan = dma_chan;
+    amux->num_desc = 0;
+    amux->dma_chain = table->dma_chain;
+    amux->channel_mask = AMUX_ALL_CHANNELS;
+    amux->pending_chain = NULL;
 
     /* Disconnect all pins from the mux */
     AMux_DisconnectAll(amux);
 
     amux->curr_conn = AMUX_CONN_UNKNOWN;
 
-    /* Initialize the DMA channel */
-    Cy_DMA_Channel_Init(dma_base, dma_chan, &amux_dma_channel_config);
+    /* Initialize the DMA channel with the descriptors in flash */
+    channel_config.descriptor = (cy_stc_dma_descriptor_t *) table->dma_chain;
+    Cy_DMA_Channel_Init(dma_base, dma_chan, &channel_config);
 
     return AMUX_SUCCESS;
 }
@@ -442,10 +855,13 @@ en_amux_status_t AMux_StartDMA(amux_t *amux)
         return AMUX_ERROR;
     } 
 
+    /* Restart from the last chain linked by AMux_SetChannelMask() */
+    AMux_UpdateChain(amux);
+
     amux->dma_en = true;
 
     Cy_DMA_Channel_SetDescriptor(amux->dma_base, amux->dma_chan, 
-                                &amux_dma_descriptor[0]);
+                                 amux->dma_chain);
     Cy_DMA_Channel_Enable(amux->dma_base, amux->dma_chan);
     Cy_DMA_Enable(amux->dma_base);
 
@@ -479,5 +895,472 @@ en_amux_status_t AMux_StopDMA(amux_t *amux)
     return AMUX_SUCCESS;
 }
 
+/*******************************************************************************
+* Function Name: AMux_SetChannelMask
+********************************************************************************
+* Summary:
+*   Select the slots of the schedule the DMA visits, without stopping it. The
+*   chain of the enabled slots is built in the half of the descriptors the
+*   DMA is not running, as AMux_SetupDMA() does. Disabled slots take no
+*   trigger, so the enabled ones are scanned more often. The DMA moves to the 
+*   new chain once the last descriptor of the running chain, returned in link,
+*   points to its first descriptor, returned in link_next. It is then at the 
+*   end of the schedule, so the new chain starts with the first enabled slot.
+*
+*   When link is NULL, the link is written at once and the DMA switches at the
+*   end of the current schedule. Otherwise the caller writes it with 
+*   Cy_DMA_Descriptor_SetNextDescriptor(), typically Sampler_SetChannelMask()
+*   at a frame boundary, so both DMAs switch in the same period. Until then, 
+*   calling this function again rebuilds the new chain. When the DMA is not 
+*   running, the new chain is used by the next AMux_StartDMA() and the link 
+*   is returned as NULL.
+*
+*   Only the chains built by AMux_SetupDMA() can be masked, and each chain 
+*   shall fit in half of the descriptors of AMux_ConfigureDescriptors().
+*
+* Parameters:
+*   amux: AMux object
+*   mask: bit n enables the slot n of the schedule, up to AMUX_MAX_MASK_SLOTS
+*   link: returns the descriptor to link, or NULL to link it in this call
+*   link_next: returns the descriptor to link to, NULL when link is NULL
+*
+* Return:
+*   If set correctly, returns SUCCESS, BUSY if the DMA has not reached the 
+*   chain of the previous change yet, otherwise ERROR.
+*
+*******************************************************************************/
+en_amux_status_t AMux_SetChannelMask(amux_t *amux, uint32_t mask, 
+                                     cy_stc_dma_descriptor_t **link,
+                                     cy_stc_dma_descriptor_t **link_next)
+{
+#if (AMUX_MAX_NUM_DESCRIPTORS == 0u)
+    (void) amux;
+    (void) mask;
+    (void) link;
+    (void) link_next;
+    return AMUX_ERROR;
+#else
+    const cy_stc_dma_descriptor_t *descr;
+    cy_stc_dma_descriptor_t *last;
+    uint32_t num_slots;
+    uint32_t num_desc;
+    uint32_t first;
+
+    if (amux == NULL || amux->dma_base == NULL || amux->num_desc == 0 || 
+        ((link == NULL) != (link_next == NULL)))
+    {
+        return AMUX_ERROR;
+    }
+
+    num_slots = AMux_GetScheduleLength(amux);
+    if (num_slots > AMUX_MAX_MASK_SLOTS)
+    {
+        return AMUX_ERROR;
+    }
+    if (num_slots < AMUX_MAX_MASK_SLOTS)
+    {
+        mask &= (1UL << num_slots) - 1u;
+    }
+    if (mask == 0)
+    {
+        return AMUX_ERROR;
+    }
+
+    AMux_UpdateChain(amux);
+
+    /* The DW channel still runs the chain the new one would overwrite */
+    if (amux->dma_en)
+    {
+        descr = Cy_DMA_Channel_GetCurrentDescriptor(amux->dma_base, amux->dma_chan);
+        if (descr < amux->dma_chain || descr >= &amux->dma_chain[amux->num_desc])
+        {
+            return AMUX_BUSY;
+        }
+    }
+
+    num_desc = AMux_CountDescriptors(amux, mask) + 1u;
+    if (amux->num_desc > AMUX_CHAIN_DESCRIPTORS(amux) || num_desc > AMUX_CHAIN_DESCRIPTORS(amux))
+    {
+        return AMUX_ERROR;
+    }
+
+    first = (amux->dma_chain == &amux->dma_desc[0]) ? AMUX_CHAIN_DESCRIPTORS(amux) : 0u;
+    last = &amux->dma_desc[(uint32_t)(amux->dma_chain - amux->dma_desc) + amux->num_desc - 1u];
+
+    /* The new chain is entered once, from the end of the running one, whose
+     * last pin may not share the register cleared by the new first slot */
+    AMux_SetupClear(amux, first, AMux_GetLastConnection(amux, amux->channel_mask));
+    AMux_SetupChain(amux, first + 1u, mask);
+
+    amux->pending_chain = &amux->dma_desc[first];
+    amux->pending_link = last;
+    amux->pending_num_desc = (uint16_t) num_desc;
+    amux->pending_mask = mask;
+
+    if (!amux->dma_en)
+    {
+        /* Nothing to link, AMux_StartDMA() starts from the new chain */
+        amux->dma_chain = amux->pending_chain;
+        amux->num_desc = amux->pending_num_desc;
+        amux->channel_mask = mask;
+        amux->pending_chain = NULL;
+        last = NULL;
+    }
+    else if (link == NULL)
+    {
+        Cy_DMA_Descriptor_SetNextDescriptor(last, &amux->dma_desc[first]);
+        AMux_UpdateChain(amux);
+    }
+
+    if (link != NULL)
+    {
+        *link = last;
+        *link_next = (last != NULL) ? &amux->dma_desc[first] : NULL;
+    }
+
+    return AMUX_SUCCESS;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: AMux_GetStats
+********************************************************************************
+* Summary:
+*   Get a snapshot of the state of the AMux DMA. The DW channel stops on a bus
+*   error, a misaligned address or a NULL descriptor, after which the pins are
+*   no longer switched, so the Sampler keeps converting the same pin.
+*
+* Parameters:
+*   amux: AMux object
+*   stats: returns the statistics
+*
+* Return:
+*   If read correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_amux_status_t AMux_GetStats(amux_t *amux, amux_stats_t *stats)
+{
+    const cy_stc_dma_descriptor_t *descr;
+
+    if (amux == NULL || stats == NULL || amux->dma_base == NULL || amux->dma_chain == NULL)
+    {
+        return AMUX_ERROR;
+    }
+
+    AMux_UpdateChain(amux);
+
+    stats->dma_status = Cy_DMA_Channel_GetStatus(amux->dma_base, amux->dma_chan);
+    stats->dma_error = (stats->dma_status != CY_DMA_INTR_CAUSE_NO_INTR) && 
+                       (stats->dma_status != CY_DMA_INTR_CAUSE_COMPLETION);
+
+    descr = Cy_DMA_Channel_GetCurrentDescriptor(amux->dma_base, amux->dma_chan);
+    stats->descriptor = (descr != NULL) ? (uint16_t)(descr - amux->dma_chain) : AMUX_DESCR_UNKNOWN;
+
+    /* Still at the end of the chain before the last AMux_SetChannelMask() */
+    if (amux->num_desc != 0 && stats->descriptor >= amux->num_desc)
+    {
+        stats->descriptor = AMUX_DESCR_UNKNOWN;
+    }
+
+    return AMUX_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: AMux_GetPinConnection
+********************************************************************************
+* Summary:
+*   Get the HSIOM register and the value to write to connect the given pin to
+*   the analog mux.
+*
+* Parameters:
+*   port: Port base
+*   pin: pin number in the port
+*   amux_sel: global amux
+*   reg: returns the HSIOM register address
+*   value: returns the selection of the pin, without the other pins
+*
+* Return:
+*   If the pin exists, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+static en_amux_status_t AMux_GetPinConnection(GPIO_PRT_Type *port, uint8_t pin, 
+                                              en_amux_select_t amux_sel,
+                                              uint32_t *reg, uint32_t *value)
+{
+    uint32_t portOffset;
+    uint32_t portNum;
+    HSIOM_PRT_Type* portAddrHSIOM;
+
+    if (port == NULL || pin >= CY_GPIO_PINS_MAX)
+    {
+        return AMUX_ERROR;
+    }
+
+    /* Extract the port number and port HSIOM address */
+    portOffset = (uint32_t)(uintptr_t)(port) - CY_GPIO_BASE;
+    portNum = portOffset / GPIO_PRT_SECTION_SIZE;
+    if ((portOffset % GPIO_PRT_SECTION_SIZE) != 0 || portNum >= IOSS_GPIO_GPIO_PORT_NR)
+    {
+        return AMUX_ERROR;
+    }
+    portAddrHSIOM = (HSIOM_PRT_Type*)(CY_HSIOM_BASE + (HSIOM_PRT_SECTION_SIZE * portNum));
+
+    /* Check which HSIOM register (SEL0 or SEL1) to use */
+    if (pin < CY_GPIO_PRT_HALF)
+    {
+        *reg = (uint32_t)(uintptr_t) &portAddrHSIOM->PORT_SEL0;
+    }
+    else
+    {
+        *reg = (uint32_t)(uintptr_t) &portAddrHSIOM->PORT_SEL1;
+    }
+    *value = (uint32_t) amux_sel << (8*(pin % CY_GPIO_PRT_HALF));
+
+    return AMUX_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: AMux_GetFieldMask
+********************************************************************************
+* Summary:
+*   Get the mask of the HSIOM register fields that are not zero in a value.
+*
+* Parameters:
+*   value: HSIOM register value
+*
+* Return:
+*   Mask of the fields.
+*
+*******************************************************************************/
+static uint32_t AMux_GetFieldMask(uint32_t value)
+{
+    uint32_t mask = 0;
+
+    for (uint32_t field = 0; field < CY_GPIO_PRT_HALF; field++)
+    {
+        if ((value & (0xFFUL << (8*field))) != 0)
+        {
+            mask |= 0xFFUL << (8*field);
+        }
+    }
+
+    return mask;
+}
+
+/*******************************************************************************
+* Function Name: AMux_UpdateDisconnect
+********************************************************************************
+* Summary:
+*   Update the HSIOM values of all connections from the current value of their
+*   registers, so writing them only changes the pins of the AMux, and 
+*   disconnect all the pins.
+*
+* Parameters:
+*   amux: AMux object
+*
+*******************************************************************************/
+static void AMux_UpdateDisconnect(amux_t *amux)
+{
+    uint32_t pin_value;
+    uint32_t pin_mask;
+    uint32_t other_pins;
+
+    for (uint32_t i = 0; i < amux->num_conn; i++)
+    {
+        /* Find the fields of all the AMux pins in this register */
+        pin_mask = 0;
+        for (uint32_t j = 0; j < amux->num_conn; j++)
+        {
+            if (amux->connect_port[j] == amux->connect_port[i])
+            {
+                pin_mask |= AMux_GetFieldMask(amux->connect_pin[j] & ~amux->disconnect_pin[j]);
+            }
+        }
+
+        /* Keep the selection of the other pins */
+        pin_value = amux->connect_pin[i] & ~amux->disconnect_pin[i];
+        other_pins = CY_GET_REG32(amux->connect_port[i]) & ~pin_mask;
+        amux->disconnect_pin[i] = other_pins;
+        amux->connect_pin[i] = other_pins | pin_value;
+
+        CY_SET_REG32(amux->connect_port[i], other_pins);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: AMux_UpdateChain
+********************************************************************************
+* Summary:
+*   Make the chain of AMux_SetChannelMask() the running one once its link is 
+*   written, so AMux_StartDMA() restarts from it.
+*
+* Parameters:
+*   amux: AMux object
+*
+*******************************************************************************/
+static void AMux_UpdateChain(amux_t *amux)
+{
+    if (amux->pending_chain != NULL &&
+        Cy_DMA_Descriptor_GetNextDescriptor(amux->pending_link) == amux->pending_chain)
+    {
+        amux->dma_chain = amux->pending_chain;
+        amux->num_desc = amux->pending_num_desc;
+        amux->channel_mask = amux->pending_mask;
+        amux->pending_chain = NULL;
+    }
+}
+
+#if (AMUX_MAX_NUM_DESCRIPTORS > 0u)
+/*******************************************************************************
+* Function Name: AMux_GetLastConnection
+********************************************************************************
+* Summary:
+*   Get the connection of the last enabled slot, which precedes the first one.
+*
+* Parameters:
+*   amux: AMux object
+*   mask: enabled slots of the schedule
+*
+* Return:
+*   Connection index.
+*
+*******************************************************************************/
+static uint8_t AMux_GetLastConnection(amux_t *amux, uint32_t mask)
+{
+    uint32_t num_slots = AMux_GetScheduleLength(amux);
+    uint8_t conn = 0;
+
+    for (uint32_t i = 0; i < num_slots; i++)
+    {
+        if (AMUX_SLOT_ENABLED(mask, i))
+        {
+            conn = AMux_GetSlotConnection(amux, i);
+        }
+    }
+
+    return conn;
+}
+
+/*******************************************************************************
+* Function Name: AMux_CountDescriptors
+********************************************************************************
+* Summary:
+*   Count the descriptors of the chain of the enabled slots, as a slot whose 
+*   pin shares the HSIOM register of the previous enabled slot only needs one.
+*
+* Parameters:
+*   amux: AMux object
+*   mask: enabled slots of the schedule
+*
+* Return:
+*   Number of descriptors.
+*
+*******************************************************************************/
+static uint32_t AMux_CountDescriptors(amux_t *amux, uint32_t mask)
+{
+    uint32_t num_slots = AMux_GetScheduleLength(amux);
+    uint32_t num_desc = 0;
+    uint8_t conn;
+    uint8_t prev_conn = AMux_GetLastConnection(amux, mask);
+
+    for (uint32_t i = 0; i < num_slots; i++)
+    {
+        if (AMUX_SLOT_ENABLED(mask, i))
+        {
+            conn = AMux_GetSlotConnection(amux, i);
+            num_desc += (amux->connect_port[prev_conn] == amux->connect_port[conn]) ? 1u : 2u;
+            prev_conn = conn;
+        }
+    }
+
+    return num_desc;
+}
+
+/*******************************************************************************
+* Function Name: AMux_SetupClear
+********************************************************************************
+* Summary:
+*   Initialize a descriptor to clear the pin of a connection, chained to the 
+*   next descriptor.
+*
+* Parameters:
+*   amux: AMux object
+*   d: index of the descriptor
+*   conn: connection index
+*
+*******************************************************************************/
+static void AMux_SetupClear(amux_t *amux, uint32_t d, uint8_t conn)
+{
+    Cy_DMA_Descriptor_Init(&amux->dma_desc[d], &amux_dma_descriptor_config);
+    Cy_DMA_Descriptor_SetDstAddress(&amux->dma_desc[d], (void *)(uintptr_t) amux->connect_port[conn]);
+    Cy_DMA_Descriptor_SetSrcAddress(&amux->dma_desc[d], &amux->disconnect_pin[conn]);
+    Cy_DMA_Descriptor_SetNextDescriptor(&amux->dma_desc[d], &amux->dma_desc[d+1]);
+}
+
+/*******************************************************************************
+* Function Name: AMux_SetupChain
+********************************************************************************
+* Summary:
+*   Initialize the descriptors of the enabled slots, starting at the given
+*   descriptor index. A slot requires one descriptor to clear the pin of the 
+*   previous enabled slot and one to set its own pin. If both pins are in the
+*   same HSIOM register, writing the new pin value also clears the previous 
+*   one, so the clear descriptor is skipped. The last descriptor loops back to
+*   the first one.
+*
+* Parameters:
+*   amux: AMux object
+*   first: index of the first descriptor
+*   mask: enabled slots of the schedule
+*
+*******************************************************************************/
+static void AMux_SetupChain(amux_t *amux, uint32_t first, uint32_t mask)
+{
+    uint32_t num_slots = AMux_GetScheduleLength(amux);
+    uint32_t d = first;
+    uint32_t hold;
+    uint8_t conn;
+    uint8_t prev_conn = AMux_GetLastConnection(amux, mask);
+
+    for (uint32_t i = 0; i < num_slots; i++)
+    {
+        if (!AMUX_SLOT_ENABLED(mask, i))
+        {
+            continue;
+        }
+        conn = AMux_GetSlotConnection(amux, i);
+
+        if (amux->connect_port[prev_conn] != amux->connect_port[conn])
+        {
+            AMux_SetupClear(amux, d, prev_conn);
+            d++;
+        }
+
+        /* Setup the DMA descriptor to set the connection */
+        Cy_DMA_Descriptor_Init(&amux->dma_desc[d], &amux_dma_descriptor_config);
+        Cy_DMA_Descriptor_SetDstAddress(&amux->dma_desc[d], (void *)(uintptr_t) amux->connect_port[conn]);
+        Cy_DMA_Descriptor_SetSrcAddress(&amux->dma_desc[d], &amux->connect_pin[conn]);
+        Cy_DMA_Descriptor_SetTriggerInType(&amux->dma_desc[d], CY_DMA_1ELEMENT);
+        hold = amux->hold_count * (1u + amux->settle_count[conn]);
+        if (hold > 1)
+        {
+            /* Write the same connection again on every trigger, so the pin 
+             * stays connected for hold_count triggers per sample, including
+             * the samples taken while it settles */
+            Cy_DMA_Descriptor_SetDescriptorType(&amux->dma_desc[d], CY_DMA_1D_TRANSFER);
+            Cy_DMA_Descriptor_SetXloopDataCount(&amux->dma_desc[d], hold);
+            Cy_DMA_Descriptor_SetXloopSrcIncrement(&amux->dma_desc[d], 0);
+            Cy_DMA_Descriptor_SetXloopDstIncrement(&amux->dma_desc[d], 0);
+        }
+        Cy_DMA_Descriptor_SetNextDescriptor(&amux->dma_desc[d], &amux->dma_desc[d+1]);
+        d++;
+
+        prev_conn = conn;
+    }
+
+    Cy_DMA_Descriptor_SetNextDescriptor(&amux->dma_desc[d-1], &amux->dma_desc[first]);
+}
+#endif
 
 /* [] END OF FILE */
\ No newline at end of file
@@ -66,6 +66,9 @@ typedef enum
     /** Return error */
     AMUX_ERROR = 1u,
 
+    /** The DMA has not reached the chain of the previous channel mask yet */
+    AMUX_BUSY = 2u,
+
 } en_amux_status_t;
 
 
@@ -76,7 +79,34 @@ typedef enum
     #define AMUX_MAX_NUM_CONNECTIONS       (32u)
 #endif
 
+/* A schedule can visit some connections more than once per frame. Each slot
+ * is a sample of the frame, so it shall not exceed SAMPLER_MAX_NUM_CHANNELS */
+#ifndef AMUX_MAX_SCHEDULE_LENGTH
+    #define AMUX_MAX_SCHEDULE_LENGTH       (AMUX_MAX_NUM_CONNECTIONS)
+#endif
+
+/* Each schedule slot takes at most two descriptors, one to clear and one 
+ * to set, in each of the two chains of AMux_SetChannelMask(). The 
+ * application allocates them, see AMux_ConfigureDescriptors() */
+#define AMUX_NUM_DESCRIPTORS(length)   (4u*(length))
+
+/* Set to 0 when only flash tables are used, see AMUX_TABLE_DEFINE(), to 
+ * remove the code building the descriptors in RAM */
+#ifndef AMUX_MAX_NUM_DESCRIPTORS
+    #define AMUX_MAX_NUM_DESCRIPTORS       (AMUX_NUM_DESCRIPTORS(AMUX_MAX_SCHEDULE_LENGTH))
+#endif
+
+/* Slots of the schedule covered by a channel mask, see AMux_SetChannelMask() */
+#define AMUX_MAX_MASK_SLOTS            (32u)
+/* Slots past the mask are always in the chain */
+#define AMUX_SLOT_ENABLED(mask, slot)  (((slot) >= AMUX_MAX_MASK_SLOTS) || \
+                                        ((((mask) >> (slot)) & 1u) != 0u))
+#define AMUX_ALL_CHANNELS              (0xFFFFFFFFu)
+
 #define AMUX_CONN_UNKNOWN              (0xFF)
+#define AMUX_DESCR_UNKNOWN             (0xFFFFu)
+
+#define AMUX_MAX_HOLD_COUNT            (CY_DMA_LOOP_COUNT_MAX)
 
 /*******************************************************************************
 *                              Type Definitions
@@ -87,24 +117,212 @@ typedef struct
     en_amux_select_t amux_sel;
     volatile uint32_t connect_port[AMUX_MAX_NUM_CONNECTIONS];
     uint32_t connect_pin[AMUX_MAX_NUM_CONNECTIONS];
+    /* HSIOM value with the AMux pins of the register disconnected, keeping
+     * the selection of the other pins */
+    uint32_t disconnect_pin[AMUX_MAX_NUM_CONNECTIONS];
     uint8_t curr_conn;
     uint8_t num_conn;
+    uint16_t hold_count;
+    uint8_t settle_count[AMUX_MAX_NUM_CONNECTIONS];
+    uint8_t schedule[AMUX_MAX_SCHEDULE_LENGTH];
+    uint16_t schedule_len;
     bool dma_en;
     DW_Type* dma_base;
     uint32_t dma_chan;
+    /* First descriptor run by the DMA, either in dma_desc or in a flash 
+     * table */
+    const cy_stc_dma_descriptor_t *dma_chain;
+#if (AMUX_MAX_NUM_DESCRIPTORS > 0u)
+    /* Descriptors given by AMux_ConfigureDescriptors(), used by this object 
+     * only, so several objects can run at the same time on different DW 
+     * channels */
+    cy_stc_dma_descriptor_t *dma_desc;
+    uint16_t max_desc;
+#endif
+    uint16_t num_desc;
+    /* Slots of the schedule in the chain, see AMux_SetChannelMask() */
+    uint32_t channel_mask;
+    /* Chain built in the other half of dma_desc, run once the DW channel 
+     * follows the link descriptor to it */
+    const cy_stc_dma_descriptor_t *pending_chain;
+    cy_stc_dma_descriptor_t *pending_link;
+    uint16_t pending_num_desc;
+    uint32_t pending_mask;
 } amux_t;
 
+/** Pin to add to the AMux */
+typedef struct
+{
+    GPIO_PRT_Type *port;
+    uint8_t pin;
+} amux_pin_t;
+
+/** Statistics Structure */
+typedef struct
+{
+    /* Cause of the last interrupt of the DW channel */
+    cy_en_dma_intr_cause_t dma_status;
+    /* The DW channel stopped on a bus error, misalignment or NULL pointer */
+    bool dma_error;
+    /* Index in the chain of the descriptor the DW channel is at, or 
+     * AMUX_DESCR_UNKNOWN */
+    uint16_t descriptor;
+} amux_stats_t;
+
+/** Flash Table Structure, defined with AMUX_TABLE_DEFINE() */
+typedef struct
+{
+    en_amux_select_t amux_sel;
+    const uint32_t *connect_port;
+    const uint32_t *connect_pin;
+    uint8_t num_conn;
+    uint16_t hold_count;
+    const cy_stc_dma_descriptor_t *dma_chain;
+} amux_table_t;
+
+/*******************************************************************************
+*                              Flash Table Macros
+*******************************************************************************/
+/* For a fixed board, the connections and the whole DMA chain can be built by
+ * the compiler and placed in flash, instead of AMux_AddPort() and 
+ * AMux_SetupDMA() building them in RAM at startup. The pins are given by a 
+ * list macro, which calls X(t, port, pin) for each pin in the order they 
+ * are visited. Port and pin shall be plain decimal numbers:
+ *
+ *   #define BOARD_AMUX_PINS(X, t)   AMUX_TABLE_PORT(X, t, 9) X(t, 10, 3)
+ *   AMUX_TABLE_DEFINE(board_amux, BOARD_AMUX_PINS, AMUX_B, 1);
+ *
+ * It defines the amux_table_t board_amux, which is given to 
+ * AMux_SetupDMATable(). The chain is the same as AMux_SetupDMA() builds 
+ * without a schedule nor settle counts. As in AMux_SetupDMA(), a pin that
+ * shares the HSIOM register of the previous pin does not need a clear 
+ * descriptor. Every pin takes two descriptors in flash, but the DMA only 
+ * runs the second one when the previous pin must be cleared. The DMA 
+ * writes whole HSIOM registers, so the other pins of the registers used by
+ * the table shall be GPIO, which AMux_SetupDMATable() checks. The tables 
+ * hold 32-bit addresses, so they are only valid on the target. The register 
+ * addresses are built from HSIOM_BASE of the device header, as CY_HSIOM_BASE 
+ * of the PDL is read from the device description at run time. */
+
+/** Call X for all the pins of a port */
+#define AMUX_TABLE_PORT(X, t, port) \
+    X(t, port, 0) X(t, port, 1) X(t, port, 2) X(t, port, 3) \
+    X(t, port, 4) X(t, port, 5) X(t, port, 6) X(t, port, 7)
+
+/** HSIOM register address and value to connect a pin */
+#define AMUX_TABLE_REG(port, pin) \
+    (HSIOM_BASE + (HSIOM_PRT_SECTION_SIZE * (port)) + (((pin) < CY_GPIO_PRT_HALF) ? \
+     offsetof(HSIOM_PRT_Type, PORT_SEL0) : offsetof(HSIOM_PRT_Type, PORT_SEL1)))
+#define AMUX_TABLE_VALUE(sel, pin) \
+    ((uint32_t)(sel) << (8u * ((pin) % CY_GPIO_PRT_HALF)))
+
+/* Index of each pin in the table */
+#define AMUX_TABLE_ENUM_CONN(t, port, pin)      t##_CONN_##port##_##pin,
+
+/* Register of each pin. The implicit value of the PREV enumerator is the 
+ * register of the previous pin plus one */
+#define AMUX_TABLE_ENUM_REG(t, port, pin) \
+    t##_PREV_##port##_##pin, t##_REG_##port##_##pin = (int) AMUX_TABLE_REG(port, pin),
+
+#define AMUX_TABLE_PREV_REG(t, port, pin) \
+    ((t##_CONN_##port##_##pin == 0) ? (uint32_t)(t##_REG_END - 1) : \
+                                       (uint32_t)(t##_PREV_##port##_##pin - 1))
+#define AMUX_TABLE_SAME_REG(t, port, pin) \
+    (AMUX_TABLE_PREV_REG(t, port, pin) == (uint32_t) t##_REG_##port##_##pin)
+
+#define AMUX_TABLE_PORT_ENTRY(t, port, pin)     (uint32_t) AMUX_TABLE_REG(port, pin),
+#define AMUX_TABLE_PIN_ENTRY(t, port, pin)      AMUX_TABLE_VALUE(t##_AMUX_SEL, pin),
+
+/* Control word of a descriptor that writes one word per element */
+#define AMUX_TABLE_CTL(tr_in) \
+    (_VAL2FLD(CY_DMA_CTL_RETRIG, CY_DMA_RETRIG_IM) | \
+     _VAL2FLD(CY_DMA_CTL_INTR_TYPE, CY_DMA_1ELEMENT) | \
+     _VAL2FLD(CY_DMA_CTL_TR_OUT_TYPE, CY_DMA_DESCR) | \
+     _VAL2FLD(CY_DMA_CTL_TR_IN_TYPE, (tr_in)) | \
+     _VAL2FLD(CY_DMA_CTL_DATA_SIZE, CY_DMA_WORD) | \
+     _VAL2FLD(CY_DMA_CTL_SRC_SIZE, CY_DMA_TRANSFER_SIZE_WORD) | \
+     _VAL2FLD(CY_DMA_CTL_DST_SIZE, CY_DMA_TRANSFER_SIZE_WORD) | \
+     _VAL2FLD(CY_DMA_CTL_TYPE, CY_DMA_1D_TRANSFER))
+
+#define AMUX_TABLE_NEXT(t, port, pin) \
+    ((uint32_t) &t##_chain[2u * ((t##_CONN_##port##_##pin + 1u) % t##_NUM_CONN)])
+
+/* Two descriptors per pin. The first one clears the previous pin, or sets 
+ * this pin when both share a register. The second one sets this pin for 
+ * hold count triggers */
+#define AMUX_TABLE_DESCR(t, port, pin) \
+    { \
+        .ctl = AMUX_TABLE_SAME_REG(t, port, pin) ? \
+               AMUX_TABLE_CTL(CY_DMA_1ELEMENT) : AMUX_TABLE_CTL(CY_DMA_DESCR_CHAIN), \
+        .src = AMUX_TABLE_SAME_REG(t, port, pin) ? \
+               (uint32_t) &t##_connect_pin[t##_CONN_##port##_##pin] : (uint32_t) &amux_all_zero, \
+        .dst = AMUX_TABLE_PREV_REG(t, port, pin), \
+        .xCtl = _VAL2FLD(CY_DMA_CTL_COUNT, AMUX_TABLE_SAME_REG(t, port, pin) ? (t##_HOLD - 1u) : 0u), \
+        .yCtl = AMUX_TABLE_SAME_REG(t, port, pin) ? AMUX_TABLE_NEXT(t, port, pin) : \
+                (uint32_t) &t##_chain[(2u * t##_CONN_##port##_##pin) + 1u], \
+        .nextPtr = 0u, \
+    }, \
+    { \
+        .ctl = AMUX_TABLE_CTL(CY_DMA_1ELEMENT), \
+        .src = (uint32_t) &t##_connect_pin[t##_CONN_##port##_##pin], \
+        .dst = (uint32_t) AMUX_TABLE_REG(port, pin), \
+        .xCtl = _VAL2FLD(CY_DMA_CTL_COUNT, t##_HOLD - 1u), \
+        .yCtl = AMUX_TABLE_NEXT(t, port, pin), \
+        .nextPtr = 0u, \
+    },
+
+/* Constants of a table */
+#define AMUX_TABLE_ENUMS(t, pins, sel, hold) \
+    enum { pins(AMUX_TABLE_ENUM_CONN, t) t##_NUM_CONN }; \
+    enum { t##_REG_START = 0, pins(AMUX_TABLE_ENUM_REG, t) t##_REG_END }; \
+    enum { t##_AMUX_SEL = (sel), t##_HOLD = (hold) }
+
+/** Define the flash table t of the pins given by the list macro pins. The
+ *  hold count is the same as AMux_SetHoldCount() */
+#define AMUX_TABLE_DEFINE(t, pins, sel, hold) \
+    AMUX_TABLE_ENUMS(t, pins, sel, hold); \
+    static const uint32_t t##_connect_port[] = { pins(AMUX_TABLE_PORT_ENTRY, t) }; \
+    static const uint32_t t##_connect_pin[] = { pins(AMUX_TABLE_PIN_ENTRY, t) }; \
+    static const cy_stc_dma_descriptor_t t##_chain[2u * t##_NUM_CONN] = { pins(AMUX_TABLE_DESCR, t) }; \
+    const amux_table_t t = \
+    { \
+        .amux_sel = (sel), \
+        .connect_port = t##_connect_port, \
+        .connect_pin = t##_connect_pin, \
+        .num_conn = t##_NUM_CONN, \
+        .hold_count = (hold), \
+        .dma_chain = &t##_chain[0], \
+    }
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+extern const uint32_t amux_all_zero;
+
 /*******************************************************************************
 *                            Function Prototypes
 *******************************************************************************/
 en_amux_status_t AMux_Init(amux_t *amux, en_amux_select_t amux_sel);
 en_amux_status_t AMux_AddPort(amux_t *amux, GPIO_PRT_Type *port, uint8_t mask);
+en_amux_status_t AMux_AddPins(amux_t *amux, const amux_pin_t *pins, uint8_t num_pins, bool group);
 en_amux_status_t AMux_Connect(amux_t *amux, uint8_t index);
 en_amux_status_t AMux_ConnectNext(amux_t *amux);
 en_amux_status_t AMux_DisconnectAll(amux_t *amux);
+en_amux_status_t AMux_SetSchedule(amux_t *amux, const uint8_t *schedule, uint16_t length);
+uint16_t AMux_GetScheduleLength(amux_t *amux);
+uint8_t AMux_GetSlotConnection(amux_t *amux, uint16_t slot);
+en_amux_status_t AMux_SetHoldCount(amux_t *amux, uint16_t hold_count);
+en_amux_status_t AMux_SetSettleCount(amux_t *amux, uint8_t index, uint8_t settle_count);
+en_amux_status_t AMux_ConfigureDescriptors(amux_t *amux, cy_stc_dma_descriptor_t *descriptors, 
+                                           uint16_t num_descriptors);
 en_amux_status_t AMux_SetupDMA(amux_t *amux, DW_Type *dma_base, uint32_t dma_chan);
+en_amux_status_t AMux_SetupDMATable(amux_t *amux, const amux_table_t *table, DW_Type *dma_base, uint32_t dma_chan);
 en_amux_status_t AMux_StartDMA(amux_t *amux);
 en_amux_status_t AMux_StopDMA(amux_t *amux);
+en_amux_status_t AMux_SetChannelMask(amux_t *amux, uint32_t mask, 
+                                     cy_stc_dma_descriptor_t **link,
+                                     cy_stc_dma_descriptor_t **link_next);
+en_amux_status_t AMux_GetStats(amux_t *amux, amux_stats_t *stats);
 void AMux_Deinit(amux_t *amux);
 
 
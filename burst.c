@@ -0,0 +1,576 @@
+/*******************************************************************************
+* File Name: burst.c
+*
+*  Description: This file contains the duty-cycled burst scanning of the AMux
+*   channels, with the SAR ADC powered down between the bursts.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include "burst.h"
+#include "cyhal.h"
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+/* The MCWDT applies a new configuration after two LFCLK cycles */
+#define BURST_TIMER_WAIT_US             (93u)
+
+/*******************************************************************************
+* Local Functions
+*******************************************************************************/
+static void Burst_SamplerCallback(const sampler_event_t *event, void *arg);
+static void Burst_PowerDown(burst_t *burst);
+static cy_en_syspm_status_t Burst_DeepSleepCallback(cy_stc_syspm_callback_params_t *params,
+                                                    cy_en_syspm_callback_mode_t mode);
+
+/*******************************************************************************
+* Function Name: Burst_Init
+********************************************************************************
+* Summary:
+*   Initialize a Burst object. Each burst scans all the channels of the AMux
+*   frames_per_burst times, then the Sampler and AMux DMAs are stopped, the
+*   SAR ADC is disabled and all the AMux switches are opened, until the next
+*   Burst_Start(). The AMux and the Sampler shall be configured, including
+*   their DMAs, before calling this function, in the single or ping-pong
+*   mode, as the frames are counted in the Sampler callback. The Sampler
+*   callback is taken by this object, the application registers its own with
+*   Burst_RegisterCallback(). A Deep Sleep callback is registered, so the
+*   device does not enter Deep Sleep while a burst is running.
+*
+* Parameters:
+*   burst: burst object
+*   amux: AMux object connecting the channels
+*   sampler: Sampler object converting the channels
+*   frames_per_burst: number of frames per burst
+*
+* Return:
+*   If initialized correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_burst_status_t Burst_Init(burst_t *burst, amux_t *amux, sampler_t *sampler,
+                             uint32_t frames_per_burst)
+{
+    if (burst == NULL || amux == NULL || sampler == NULL || frames_per_burst == 0)
+    {
+        return BURST_ERROR;
+    }
+
+    if (amux->dma_base == NULL || sampler->dma_base == NULL ||
+        sampler->mode == SAMPLER_MODE_RING)
+    {
+        return BURST_ERROR;
+    }
+
+    burst->amux = amux;
+    burst->sampler = sampler;
+    burst->frames_per_burst = frames_per_burst;
+    burst->frames = 0;
+    burst->active = false;
+    burst->callback = NULL;
+    burst->callback_arg = NULL;
+    burst->bursts = 0;
+    burst->total_frames = 0;
+    burst->start_timestamp = 0;
+    burst->active_us = 0;
+    burst->sleeps_denied = 0;
+    burst->bursts_skipped = 0;
+    burst->timer_base = NULL;
+    burst->period_us = 0;
+    burst->active_ua = 0;
+    burst->sleep_ua = 0;
+    burst->supply_mv = 0;
+
+    burst->pm_params.base = NULL;
+    burst->pm_params.context = burst;
+    burst->pm_callback.callback = Burst_DeepSleepCallback;
+    burst->pm_callback.type = CY_SYSPM_DEEPSLEEP;
+    burst->pm_callback.skipMode = 0;
+    burst->pm_callback.callbackParams = &burst->pm_params;
+    burst->pm_callback.prevItm = NULL;
+    burst->pm_callback.nextItm = NULL;
+    burst->pm_callback.order = 0;
+
+    if (!Cy_SysPm_RegisterCallback(&burst->pm_callback))
+    {
+        return BURST_ERROR;
+    }
+
+    Sampler_RegisterCallback(sampler, Burst_SamplerCallback, burst);
+
+    /* Start from the low power state */
+    Burst_PowerDown(burst);
+
+    return BURST_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Burst_Deinit
+********************************************************************************
+* Summary:
+*   De-initialize a Burst object. A running burst is stopped, the wake-up 
+*   timer is disabled, and the Deep Sleep and Sampler callbacks are removed.
+*
+* Parameters:
+*   burst: burst object
+*
+*******************************************************************************/
+void Burst_Deinit(burst_t *burst)
+{
+    if (burst == NULL || burst->sampler == NULL)
+    {
+        return;
+    }
+
+    if (burst->timer_base != NULL)
+    {
+        Cy_MCWDT_SetInterruptMask(burst->timer_base, 0u);
+        Cy_MCWDT_Disable(burst->timer_base, CY_MCWDT_CTR0, BURST_TIMER_WAIT_US);
+        Cy_MCWDT_ClearInterrupt(burst->timer_base, CY_MCWDT_CTR0);
+        burst->timer_base = NULL;
+    }
+
+    Burst_PowerDown(burst);
+
+    Cy_SysPm_UnregisterCallback(&burst->pm_callback);
+    Sampler_RegisterCallback(burst->sampler, NULL, NULL);
+
+    burst->amux = NULL;
+    burst->sampler = NULL;
+}
+
+/*******************************************************************************
+* Function Name: Burst_RegisterCallback
+********************************************************************************
+* Summary:
+*   Register the callback receiving the frames of the bursts. It is called from
+*   the Sampler interrupt with the Sampler events. The sequence of the frames
+*   restarts from 0 at every burst. The last frame of a burst is reported after
+*   the power down, so Burst_IsActive() returns false in its callback.
+*
+* Parameters:
+*   burst: burst object
+*   callback: function called for every frame, NULL to remove it
+*   arg: argument passed to the callback
+*
+* Return:
+*   If registered correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_burst_status_t Burst_RegisterCallback(burst_t *burst, sampler_callback_t callback, void *arg)
+{
+    if (burst == NULL)
+    {
+        return BURST_ERROR;
+    }
+
+    burst->callback_arg = arg;
+    burst->callback = callback;
+
+    return BURST_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Burst_Start
+********************************************************************************
+* Summary:
+*   Start a burst. The AMux DMA is restarted from the first connection before
+*   the Sampler, so the samples stay in the channel order. Typically called
+*   from the interrupt of a low-power timer waking the device up from Deep 
+*   Sleep, see Burst_SetupTimer().
+*
+* Parameters:
+*   burst: burst object
+*
+* Return:
+*   If started correctly, returns SUCCESS, BUSY if a burst is running,
+*   otherwise ERROR.
+*
+*******************************************************************************/
+en_burst_status_t Burst_Start(burst_t *burst)
+{
+    if (burst == NULL || burst->sampler == NULL)
+    {
+        return BURST_ERROR;
+    }
+
+    if (burst->active)
+    {
+        return BURST_BUSY;
+    }
+
+    /* Refuse the Deep Sleep from now on */
+    burst->active = true;
+    burst->frames = 0;
+    burst->start_timestamp = Sampler_GetTimestamp(burst->sampler);
+
+    if (AMUX_SUCCESS != AMux_StartDMA(burst->amux) ||
+        SAMPLER_SUCCESS != Sampler_Start(burst->sampler))
+    {
+        Burst_PowerDown(burst);
+        return BURST_ERROR;
+    }
+
+    return BURST_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Burst_Stop
+********************************************************************************
+* Summary:
+*   Stop the running burst before its last frame and power down. The frames
+*   already completed are counted in the statistics.
+*
+* Parameters:
+*   burst: burst object
+*
+* Return:
+*   If stopped correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_burst_status_t Burst_Stop(burst_t *burst)
+{
+    if (burst == NULL || burst->sampler == NULL)
+    {
+        return BURST_ERROR;
+    }
+
+    if (burst->active)
+    {
+        Burst_PowerDown(burst);
+        burst->total_frames += burst->frames;
+        burst->bursts++;
+    }
+
+    return BURST_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Burst_IsActive
+********************************************************************************
+* Summary:
+*   Check if a burst is running.
+*
+* Parameters:
+*   burst: burst object
+*
+* Return:
+*   True between Burst_Start() and the power down after the last frame.
+*
+*******************************************************************************/
+bool Burst_IsActive(burst_t *burst)
+{
+    if (burst == NULL)
+    {
+        return false;
+    }
+
+    return burst->active;
+}
+
+/*******************************************************************************
+* Function Name: Burst_SetupTimer
+********************************************************************************
+* Summary:
+*   Start a burst every period_us with counter 0 of an MCWDT, which keeps 
+*   counting the LFCLK in Deep Sleep. The counter is cleared on match and 
+*   interrupts at every match, the first one period_us from now. The interrupt
+*   of the MCWDT shall be enabled in the NVIC, with a handler calling
+*   Burst_TimerIRQHandler(). The period is rounded to LFCLK cycles, and the 
+*   rounded period is used by the power model, see Burst_SetPowerModel().
+*
+* Parameters:
+*   burst: burst object
+*   base: MCWDT, whose counter 0 is used by this object only
+*   period_us: time between the starts of two bursts
+*
+* Return:
+*   If started correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_burst_status_t Burst_SetupTimer(burst_t *burst, MCWDT_STRUCT_Type *base, uint32_t period_us)
+{
+    uint32_t clk_lf_hz;
+    uint64_t ticks;
+
+    if (burst == NULL || burst->sampler == NULL || base == NULL)
+    {
+        return BURST_ERROR;
+    }
+
+    clk_lf_hz = cyhal_clock_get_frequency(&CYHAL_CLOCK_LF);
+    ticks = (((uint64_t) period_us * clk_lf_hz) + 500000u) / 1000000u;
+    if (ticks < BURST_TIMER_MIN_TICKS || ticks > BURST_TIMER_MAX_TICKS)
+    {
+        return BURST_ERROR;
+    }
+
+    Cy_MCWDT_Disable(base, CY_MCWDT_CTR0, BURST_TIMER_WAIT_US);
+    Cy_MCWDT_SetMode(base, CY_MCWDT_COUNTER0, CY_MCWDT_MODE_INT);
+    Cy_MCWDT_SetClearOnMatch(base, CY_MCWDT_COUNTER0, 1u);
+    /* Counts from 0 to the match included */
+    Cy_MCWDT_SetMatch(base, CY_MCWDT_COUNTER0, (uint32_t) ticks - 1u, BURST_TIMER_WAIT_US);
+    Cy_MCWDT_ResetCounters(base, CY_MCWDT_CTR0, BURST_TIMER_WAIT_US);
+    Cy_MCWDT_ClearInterrupt(base, CY_MCWDT_CTR0);
+    Cy_MCWDT_SetInterruptMask(base, CY_MCWDT_CTR0);
+
+    burst->timer_base = base;
+    burst->period_us = (uint32_t)(((ticks * 1000000u) + (clk_lf_hz / 2u)) / clk_lf_hz);
+
+    Cy_MCWDT_Enable(base, CY_MCWDT_CTR0, BURST_TIMER_WAIT_US);
+
+    return BURST_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Burst_TimerIRQHandler
+********************************************************************************
+* Summary:
+*   Handle the interrupt of the wake-up timer: start the next burst. When the 
+*   previous burst is still running, the period is too short for the burst,
+*   and the wake-up is skipped and counted.
+*
+* Parameters:
+*   burst: burst object
+*
+*******************************************************************************/
+void Burst_TimerIRQHandler(burst_t *burst)
+{
+    if (burst == NULL || burst->timer_base == NULL)
+    {
+        return;
+    }
+
+    if ((Cy_MCWDT_GetInterruptStatusMasked(burst->timer_base) & CY_MCWDT_CTR0) == 0u)
+    {
+        return;
+    }
+
+    Cy_MCWDT_ClearInterrupt(burst->timer_base, CY_MCWDT_CTR0);
+
+    if (Burst_Start(burst) == BURST_BUSY)
+    {
+        burst->bursts_skipped++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: Burst_SetPowerModel
+********************************************************************************
+* Summary:
+*   Set the figures used to report the energy per frame. The currents are the
+*   average consumption of the device while a burst runs and while it sleeps
+*   between the bursts, measured once with a power analyzer or taken from
+*   the datasheet. The active time is measured at every burst, so the report
+*   follows the scan rate and the number of frames per burst.
+*
+* Parameters:
+*   burst: burst object
+*   period_us: time between the starts of two bursts, as set in the
+*              low-power timer, or 0 to keep the period of Burst_SetupTimer()
+*   active_ua: current while a burst runs, in microamps
+*   sleep_ua: current in Deep Sleep, in microamps
+*   supply_mv: supply voltage, in millivolts
+*
+* Return:
+*   If set correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_burst_status_t Burst_SetPowerModel(burst_t *burst, uint32_t period_us, uint32_t active_ua,
+                                      uint32_t sleep_ua, uint32_t supply_mv)
+{
+    if (burst == NULL)
+    {
+        return BURST_ERROR;
+    }
+
+    if (period_us != 0)
+    {
+        burst->period_us = period_us;
+    }
+    burst->active_ua = active_ua;
+    burst->sleep_ua = sleep_ua;
+    burst->supply_mv = supply_mv;
+
+    return BURST_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Burst_GetStats
+********************************************************************************
+* Summary:
+*   Get the counters of the bursts, and the energy per frame of the last
+*   burst computed with the power model. With a period shorter than the
+*   burst, the device never sleeps and the period is the burst duration.
+*
+* Parameters:
+*   burst: burst object
+*   stats: returns the statistics
+*
+* Return:
+*   If read correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_burst_status_t Burst_GetStats(burst_t *burst, burst_stats_t *stats)
+{
+    uint64_t charge;
+    uint32_t period_us;
+    uint32_t frames;
+
+    if (burst == NULL || stats == NULL)
+    {
+        return BURST_ERROR;
+    }
+
+    stats->bursts = burst->bursts;
+    stats->frames = burst->total_frames;
+    stats->active_us = burst->active_us;
+    stats->sleeps_denied = burst->sleeps_denied;
+    stats->bursts_skipped = burst->bursts_skipped;
+    stats->average_ua = 0;
+    stats->energy_nj_per_frame = 0;
+
+    frames = (burst->frames != 0) ? burst->frames : burst->frames_per_burst;
+    if (burst->period_us == 0 || burst->bursts == 0)
+    {
+        return BURST_SUCCESS;
+    }
+
+    period_us = (burst->period_us > burst->active_us) ? burst->period_us : burst->active_us;
+
+    /* Charge in picocoulombs, times millivolts gives femtojoules */
+    charge = (uint64_t) burst->active_ua * burst->active_us +
+             (uint64_t) burst->sleep_ua * (period_us - burst->active_us);
+
+    stats->average_ua = (uint32_t)(charge / period_us);
+    stats->energy_nj_per_frame = (uint32_t)((charge * burst->supply_mv) /
+                                            (1000000ull * frames));
+
+    return BURST_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Burst_SamplerCallback
+********************************************************************************
+* Summary:
+*   Count the frames of the burst and power down after the last one, before
+*   passing the event to the application.
+*
+*******************************************************************************/
+static void Burst_SamplerCallback(const sampler_event_t *event, void *arg)
+{
+    burst_t *burst = (burst_t *) arg;
+
+    /* A frame completed while Burst_Stop() was stopping the DMA */
+    if (!burst->active)
+    {
+        return;
+    }
+
+    if (event->event == SAMPLER_EVENT_FRAME_COMPLETE)
+    {
+        burst->frames++;
+        if (burst->frames >= burst->frames_per_burst)
+        {
+            Burst_PowerDown(burst);
+            burst->total_frames += burst->frames;
+            burst->bursts++;
+        }
+    }
+
+    if (burst->callback != NULL)
+    {
+        burst->callback(event, burst->callback_arg);
+    }
+}
+
+/*******************************************************************************
+* Function Name: Burst_PowerDown
+********************************************************************************
+* Summary:
+*   Stop the Sampler and AMux DMAs, disable the SAR ADC and the scan timer,
+*   and open all the AMux switches, then record the duration of the burst.
+*
+*******************************************************************************/
+static void Burst_PowerDown(burst_t *burst)
+{
+    sampler_t *sampler = burst->sampler;
+    uint32_t clk_mhz;
+    uint64_t triggers;
+
+    Sampler_Stop(sampler);
+    AMux_StopDMA(burst->amux);
+    AMux_DisconnectAll(burst->amux);
+
+    if (burst->active)
+    {
+        clk_mhz = (cyhal_clock_get_frequency(&CYHAL_CLOCK_PERI) + 500000u) / 1000000u;
+        if (sampler->timestamp_base != NULL && clk_mhz != 0)
+        {
+            burst->active_us = (Sampler_GetTimestamp(sampler) - burst->start_timestamp) / clk_mhz;
+        }
+        else if (sampler->scan_rate_hz != 0)
+        {
+            triggers = (uint64_t) burst->frames * sampler->num_channels * sampler->oversampling;
+            burst->active_us = (uint32_t)((triggers * 1000000u) / sampler->scan_rate_hz);
+        }
+    }
+
+    burst->active = false;
+}
+
+/*******************************************************************************
+* Function Name: Burst_DeepSleepCallback
+********************************************************************************
+* Summary:
+*   Refuse the Deep Sleep while a burst is running. A DW transfer cut in the
+*   middle of a frame would leave the AMux and the Sampler descriptors out of
+*   step. Between the bursts, the DMAs and the scan timer are stopped and
+*   keep their configuration in Deep Sleep, so nothing is saved or restored.
+*
+*******************************************************************************/
+static cy_en_syspm_status_t Burst_DeepSleepCallback(cy_stc_syspm_callback_params_t *params,
+                                                    cy_en_syspm_callback_mode_t mode)
+{
+    burst_t *burst = (burst_t *) params->context;
+
+    if (mode == CY_SYSPM_CHECK_READY && burst->active)
+    {
+        burst->sleeps_denied++;
+        return CY_SYSPM_FAIL;
+    }
+
+    return CY_SYSPM_SUCCESS;
+}
+
+
+/* [] END OF FILE */
\ No newline at end of file
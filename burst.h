@@ -0,0 +1,146 @@
+/*****************************************************************************
+* File Name  : burst.h
+*
+* Description: This file contains definitions of constants and structures for
+*              the duty-cycled burst scanning of the AMux channels.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef BURST_H_
+#define BURST_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "cy_pdl.h"
+#include "amux.h"
+#include "sampler.h"
+
+/*******************************************************************************
+*                              Enumerated Types
+*******************************************************************************/
+typedef enum
+{
+    /** Return success */
+    BURST_SUCCESS = 0u,
+
+    /** Return error */
+    BURST_ERROR = 1u,
+
+    /** A burst is running */
+    BURST_BUSY = 2u,
+
+} en_burst_status_t;
+
+/*******************************************************************************
+*                                 API Constants
+*******************************************************************************/
+/* The wake-up timer is the 16-bit counter 0 of an MCWDT, clocked by the LFCLK,
+ * so the period is up to 2 s with the 32.768 kHz WCO */
+#define BURST_TIMER_MIN_TICKS          (2u)
+#define BURST_TIMER_MAX_TICKS          (0x10000u)
+
+/*******************************************************************************
+*                              Type Definitions
+*******************************************************************************/
+
+/** Statistics Structure */
+typedef struct
+{
+    /* Bursts completed since Burst_Init() */
+    uint32_t bursts;
+    /* Frames completed in all the bursts */
+    uint32_t frames;
+    /* Duration of the last burst, from Burst_Start() to the power down.
+     * Measured with the Sampler timestamps, or computed from the scan rate
+     * when they are not enabled */
+    uint32_t active_us;
+    /* Average current over a burst period, 0 without a power model */
+    uint32_t average_ua;
+    /* Energy per frame in nanojoules, 0 without a power model */
+    uint32_t energy_nj_per_frame;
+    /* Times the Deep Sleep was refused because a burst was running */
+    uint32_t sleeps_denied;
+    /* Wake-ups of the timer skipped because a burst was still running */
+    uint32_t bursts_skipped;
+
+} burst_stats_t;
+
+/** Object Structure */
+typedef struct
+{
+    amux_t *amux;
+    sampler_t *sampler;
+    uint32_t frames_per_burst;
+    volatile uint32_t frames;
+    volatile bool active;
+    /* Application callback, the Sampler callback is used by this object */
+    sampler_callback_t callback;
+    void *callback_arg;
+    uint32_t bursts;
+    uint32_t total_frames;
+    uint32_t start_timestamp;
+    uint32_t active_us;
+    uint32_t sleeps_denied;
+    uint32_t bursts_skipped;
+    /* Wake-up timer, see Burst_SetupTimer() */
+    MCWDT_STRUCT_Type *timer_base;
+    /* Power model, see Burst_SetPowerModel() */
+    uint32_t period_us;
+    uint32_t active_ua;
+    uint32_t sleep_ua;
+    uint32_t supply_mv;
+    cy_stc_syspm_callback_params_t pm_params;
+    cy_stc_syspm_callback_t pm_callback;
+
+} burst_t;
+
+/*******************************************************************************
+*                            Function Prototypes
+*******************************************************************************/
+en_burst_status_t Burst_Init(burst_t *burst, amux_t *amux, sampler_t *sampler,
+                             uint32_t frames_per_burst);
+void Burst_Deinit(burst_t *burst);
+en_burst_status_t Burst_RegisterCallback(burst_t *burst, sampler_callback_t callback, void *arg);
+en_burst_status_t Burst_Start(burst_t *burst);
+en_burst_status_t Burst_Stop(burst_t *burst);
+bool Burst_IsActive(burst_t *burst);
+en_burst_status_t Burst_SetupTimer(burst_t *burst, MCWDT_STRUCT_Type *base, uint32_t period_us);
+void Burst_TimerIRQHandler(burst_t *burst);
+en_burst_status_t Burst_SetPowerModel(burst_t *burst, uint32_t period_us, uint32_t active_ua,
+                                      uint32_t sleep_ua, uint32_t supply_mv);
+en_burst_status_t Burst_GetStats(burst_t *burst, burst_stats_t *stats);
+
+
+#endif /* BURST_H_ */
\ No newline at end of file
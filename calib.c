@@ -0,0 +1,277 @@
+/*******************************************************************************
+* File Name: calib.c
+*
+*  Description: This file contains the per-channel offset and gain calibration
+*   that converts the Sampler frames from counts to millivolts.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <string.h>
+
+#include "calib.h"
+
+#if CALIB_USE_SIMD
+    #include "cy_pdl.h"
+#endif
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+/* Saturate to 16 bits, like the SSAT instruction */
+#define CALIB_SAT16(value)              (((value) > INT16_MAX) ? INT16_MAX : \
+                                         (((value) < INT16_MIN) ? INT16_MIN : (value)))
+
+/* Half of the last gain bit, to round the output */
+#define CALIB_ROUNDING                  (1 << (CALIB_GAIN_SHIFT - 1u))
+
+/*******************************************************************************
+* Local Functions
+*******************************************************************************/
+static int32_t Calib_DivideRounded(int32_t numerator, int32_t denominator);
+
+/*******************************************************************************
+* Function Name: Calib_Init
+********************************************************************************
+* Summary:
+*   Initialize the calibration of frames of num_channels samples. The channels
+*   start with no offset and a gain of one, so the output is in counts until 
+*   they are calibrated.
+*
+* Parameters:
+*   calib: calibration object
+*   num_channels: number of channels per frame
+*
+* Return:
+*   If initialized correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_calib_status_t Calib_Init(calib_t *calib, uint8_t num_channels)
+{
+    if (calib == NULL || num_channels == 0 || num_channels > CALIB_MAX_NUM_CHANNELS)
+    {
+        return CALIB_ERROR;
+    }
+
+    calib->num_channels = num_channels;
+
+    for (uint32_t i = 0; i < CALIB_MAX_NUM_CHANNELS; i++)
+    {
+        calib->offset[i] = 0;
+        calib->gain[i] = CALIB_GAIN_ONE;
+    }
+
+    return CALIB_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Calib_SetChannel
+********************************************************************************
+* Summary:
+*   Set the offset and gain of a channel, for example from values stored in 
+*   flash by a previous calibration.
+*
+* Parameters:
+*   calib: calibration object
+*   channel: channel index in the frame
+*   offset: counts read at 0 mV
+*   gain: millivolts per count, Q3.12
+*
+* Return:
+*   If set correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_calib_status_t Calib_SetChannel(calib_t *calib, uint8_t channel, int16_t offset, int16_t gain)
+{
+    if (calib == NULL || channel >= calib->num_channels)
+    {
+        return CALIB_ERROR;
+    }
+
+    calib->offset[channel] = offset;
+    calib->gain[channel] = gain;
+
+    return CALIB_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Calib_TwoPoint
+********************************************************************************
+* Summary:
+*   Calibrate a channel from two known inputs, for example two reference 
+*   voltages applied to the sensor. The counts are best averaged over several
+*   frames. The gain shall fit in Q3.12, so less than 8 mV per count.
+*
+* Parameters:
+*   calib: calibration object
+*   channel: channel index in the frame
+*   counts_low: counts read for the first input
+*   mv_low: first input, in millivolts
+*   counts_high: counts read for the second input
+*   mv_high: second input, in millivolts
+*
+* Return:
+*   If calibrated correctly, returns SUCCESS, otherwise ERROR and the channel
+*   is not changed.
+*
+*******************************************************************************/
+en_calib_status_t Calib_TwoPoint(calib_t *calib, uint8_t channel, int16_t counts_low, int16_t mv_low,
+                                 int16_t counts_high, int16_t mv_high)
+{
+    int32_t gain;
+    int32_t offset;
+
+    if (calib == NULL || channel >= calib->num_channels || counts_low == counts_high)
+    {
+        return CALIB_ERROR;
+    }
+
+    gain = Calib_DivideRounded(((int32_t) mv_high - mv_low) * CALIB_GAIN_ONE, 
+                               (int32_t) counts_high - counts_low);
+    if (gain == 0 || gain > INT16_MAX || gain < INT16_MIN)
+    {
+        return CALIB_ERROR;
+    }
+
+    /* Counts that give 0 mV */
+    offset = counts_low - Calib_DivideRounded((int32_t) mv_low * CALIB_GAIN_ONE, gain);
+    if (offset > INT16_MAX || offset < INT16_MIN)
+    {
+        return CALIB_ERROR;
+    }
+
+    calib->offset[channel] = (int16_t) offset;
+    calib->gain[channel] = (int16_t) gain;
+
+    return CALIB_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Calib_Convert
+********************************************************************************
+* Summary:
+*   Convert a frame from counts to millivolts. On the CM4, the channels are 
+*   processed in pairs, loaded as 32-bit words: one saturating dual subtraction
+*   removes both offsets, then each halfword is multiplied by its gain.
+*
+* Parameters:
+*   calib: calibration object
+*   frame: samples in counts, num_channels of them
+*   output: returns the samples in millivolts, num_channels of them. It can be
+*           the same array as frame.
+*
+* Return:
+*   If converted correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_calib_status_t Calib_Convert(calib_t *calib, const int16_t *frame, int16_t *output)
+{
+#if CALIB_USE_SIMD
+    uint32_t samples;
+    uint32_t offsets;
+    uint32_t gains;
+    uint32_t counts;
+    int32_t high;
+#endif
+    int32_t low;
+    uint32_t i;
+
+    if (calib == NULL || frame == NULL || output == NULL)
+    {
+        return CALIB_ERROR;
+    }
+
+    i = 0;
+
+#if CALIB_USE_SIMD
+    /* The frames are only halfword aligned, the word copies compile to single
+     * unaligned loads and stores on the CM4 */
+    for (; (i + 1u) < calib->num_channels; i += 2u)
+    {
+        memcpy(&samples, &frame[i], sizeof(samples));
+        memcpy(&offsets, &calib->offset[i], sizeof(offsets));
+        memcpy(&gains, &calib->gain[i], sizeof(gains));
+
+        counts = __QSUB16(samples, offsets);
+        low = (int32_t)(int16_t) counts * (int16_t) gains;
+        high = (int32_t)(int16_t)(counts >> 16) * (int16_t)(gains >> 16);
+        low = __SSAT((low + CALIB_ROUNDING) >> CALIB_GAIN_SHIFT, 16);
+        high = __SSAT((high + CALIB_ROUNDING) >> CALIB_GAIN_SHIFT, 16);
+
+        samples = __PKHBT((uint32_t) low, (uint32_t) high, 16);
+        memcpy(&output[i], &samples, sizeof(samples));
+    }
+#endif
+
+    /* Same operations, one channel at a time */
+    for (; i < calib->num_channels; i++)
+    {
+        low = (int32_t) frame[i] - calib->offset[i];
+        low = CALIB_SAT16(low) * calib->gain[i];
+        output[i] = (int16_t) CALIB_SAT16((low + CALIB_ROUNDING) >> CALIB_GAIN_SHIFT);
+    }
+
+    return CALIB_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Calib_DivideRounded
+********************************************************************************
+* Summary:
+*   Divide, rounding to the nearest integer.
+*
+* Parameters:
+*   numerator: numerator
+*   denominator: denominator, not 0
+*
+* Return:
+*   Rounded quotient.
+*
+*******************************************************************************/
+static int32_t Calib_DivideRounded(int32_t numerator, int32_t denominator)
+{
+    if (denominator < 0)
+    {
+        numerator = -numerator;
+        denominator = -denominator;
+    }
+
+    if (numerator < 0)
+    {
+        return -((-numerator + (denominator / 2)) / denominator);
+    }
+
+    return (numerator + (denominator / 2)) / denominator;
+}
+
+
+/* [] END OF FILE */
\ No newline at end of file
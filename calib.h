@@ -0,0 +1,106 @@
+/*****************************************************************************
+* File Name  : calib.h
+*
+* Description: This file contains definitions of constants and structures for
+*              the per-channel calibration of the Sampler frames to millivolts.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef CALIB_H_
+#define CALIB_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*                              Enumerated Types
+*******************************************************************************/
+typedef enum
+{
+    /** Return success */
+    CALIB_SUCCESS = 0u,
+
+    /** Return error */
+    CALIB_ERROR = 1u,
+
+} en_calib_status_t;
+
+
+/*******************************************************************************
+*                                 API Constants
+*******************************************************************************/
+#ifndef CALIB_MAX_NUM_CHANNELS
+    #define CALIB_MAX_NUM_CHANNELS         (32u)
+#endif
+
+/* Gains are signed Q3.12, in millivolts per count: 
+ * mV = ((counts - offset) * gain) >> CALIB_GAIN_SHIFT, rounded and saturated
+ * to 16 bits */
+#define CALIB_GAIN_SHIFT               (12u)
+#define CALIB_GAIN_ONE                 (1 << CALIB_GAIN_SHIFT)
+
+/* Subtract the offsets of two channels at once, and multiply their halfwords,
+ * on the Cortex-M4. Otherwise a portable C version gives the same results */
+#ifndef CALIB_USE_SIMD
+    #if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+        #define CALIB_USE_SIMD                 (1)
+    #else
+        #define CALIB_USE_SIMD                 (0)
+    #endif
+#endif
+
+/*******************************************************************************
+*                              Type Definitions
+*******************************************************************************/
+/** Object Structure */
+typedef struct
+{
+    uint8_t num_channels;
+    /* In counts */
+    int16_t offset[CALIB_MAX_NUM_CHANNELS];
+    /* In millivolts per count, Q3.12 */
+    int16_t gain[CALIB_MAX_NUM_CHANNELS];
+} calib_t;
+
+/*******************************************************************************
+*                            Function Prototypes
+*******************************************************************************/
+en_calib_status_t Calib_Init(calib_t *calib, uint8_t num_channels);
+en_calib_status_t Calib_SetChannel(calib_t *calib, uint8_t channel, int16_t offset, int16_t gain);
+en_calib_status_t Calib_TwoPoint(calib_t *calib, uint8_t channel, int16_t counts_low, int16_t mv_low,
+                                 int16_t counts_high, int16_t mv_high);
+en_calib_status_t Calib_Convert(calib_t *calib, const int16_t *frame, int16_t *output);
+
+
+#endif /* CALIB_H_ */
\ No newline at end of file
@@ -0,0 +1,355 @@
+/*******************************************************************************
+* File Name: capture.c
+*
+*  Description: This file contains the columnar capture of the frames
+*   of the Sampler to a file.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <string.h>
+
+#include "capture.h"
+
+/*******************************************************************************
+* Local Functions
+*******************************************************************************/
+static en_capture_status_t Capture_Write(capture_t *capture, const void *data, uint32_t size);
+
+/*******************************************************************************
+* Function Name: Capture_Init
+********************************************************************************
+* Summary:
+*   Initialize a Capture object for the frames of the given Sampler. The file
+*   header records the scan rate and acquisition time of the Sampler, and the 
+*   port and pin connected by the AMux for every channel of the frames, so 
+*   the AMux and the Sampler shall be configured before calling this function.
+*   The frames are transposed into blocks of frames_per_block frames, stored 
+*   channel after channel, so a host can read a single channel of a large 
+*   capture without reading the others.
+*
+* Parameters:
+*   capture: capture object
+*   amux: AMux object connecting the channels
+*   sampler: Sampler object producing the frames
+*   block: buffer of frames_per_block * number of channels samples
+*   frames_per_block: number of frames per block
+*   write: callback storing the bytes of the file
+*   arg: argument passed to the callback
+*
+* Return:
+*   If initialized correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_capture_status_t Capture_Init(capture_t *capture, amux_t *amux, sampler_t *sampler, 
+                                 int16_t *block, uint32_t frames_per_block,
+                                 capture_write_t write, void *arg)
+{
+    uint32_t num_channels;
+    uint32_t reg;
+    uint32_t field;
+    uint8_t conn;
+
+    if (capture == NULL || amux == NULL || sampler == NULL || block == NULL || 
+        write == NULL || frames_per_block == 0)
+    {
+        return CAPTURE_ERROR;
+    }
+
+    num_channels = sampler->num_channels;
+    if (num_channels == 0 || num_channels > CAPTURE_MAX_NUM_CHANNELS)
+    {
+        return CAPTURE_ERROR;
+    }
+
+    memset(capture, 0, sizeof(capture_t));
+
+    /* Channel map, the frames of the Sampler follow the AMux schedule */
+    for (uint32_t i = 0; i < num_channels; i++)
+    {
+        conn = AMux_GetSlotConnection(amux, (uint16_t) i);
+        if (conn == AMUX_CONN_UNKNOWN)
+        {
+            return CAPTURE_ERROR;
+        }
+
+        /* The pin is the HSIOM field changed by the connection */
+        reg = amux->connect_port[conn] - CY_HSIOM_BASE;
+        field = amux->connect_pin[conn] ^ amux->disconnect_pin[conn];
+        capture->channel[i].port = (uint8_t)(reg / HSIOM_PRT_SECTION_SIZE);
+        capture->channel[i].pin = ((reg % HSIOM_PRT_SECTION_SIZE) == 
+                                   offsetof(HSIOM_PRT_Type, PORT_SEL0)) ? 0u : CY_GPIO_PRT_HALF;
+        while ((field & 0xFFu) == 0u && field != 0u)
+        {
+            field >>= 8u;
+            capture->channel[i].pin++;
+        }
+        capture->channel[i].amux_sel = (uint8_t) amux->amux_sel;
+    }
+
+    capture->header.magic = CAPTURE_MAGIC;
+    capture->header.version = CAPTURE_VERSION;
+    capture->header.header_size = (uint16_t)(sizeof(capture_file_header_t) + 
+                                             num_channels * sizeof(capture_channel_t));
+    capture->header.scan_rate_hz = sampler->scan_rate_hz;
+    capture->header.acq_time_ns = sampler->acq_time_ns;
+    capture->header.oversampling = sampler->oversampling;
+    capture->header.num_channels = (uint16_t) num_channels;
+    capture->header.frames_per_block = frames_per_block;
+    capture->header.block_size = sizeof(capture_block_header_t) + 
+                                 num_channels * frames_per_block * sizeof(int16_t);
+
+    capture->block_header.magic = CAPTURE_BLOCK_MAGIC;
+    capture->block = block;
+    capture->write = write;
+    capture->write_arg = arg;
+
+    return CAPTURE_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Capture_Deinit
+********************************************************************************
+* Summary:
+*   De-initialize a Capture object. The frames of the block being filled are 
+*   lost, Capture_Flush() shall be called before to store them.
+*
+* Parameters:
+*   capture: capture object
+*
+*******************************************************************************/
+void Capture_Deinit(capture_t *capture)
+{
+    if (capture == NULL)
+    {
+        return;
+    }
+
+    capture->block = NULL;
+    capture->write = NULL;
+}
+
+/*******************************************************************************
+* Function Name: Capture_Start
+********************************************************************************
+* Summary:
+*   Write the file header and the channel map. It shall be called once, before
+*   the first frame, at the start of an empty file.
+*
+* Parameters:
+*   capture: capture object
+*
+* Return:
+*   If written correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_capture_status_t Capture_Start(capture_t *capture)
+{
+    if (capture == NULL || capture->write == NULL)
+    {
+        return CAPTURE_ERROR;
+    }
+
+    capture->blocks = 0;
+    capture->block_header.num_frames = 0;
+    capture->write_failed = false;
+
+    if (Capture_Write(capture, &capture->header, sizeof(capture_file_header_t)) != CAPTURE_SUCCESS)
+    {
+        return CAPTURE_ERROR;
+    }
+
+    return Capture_Write(capture, capture->channel, 
+                         capture->header.num_channels * sizeof(capture_channel_t));
+}
+
+/*******************************************************************************
+* Function Name: Capture_AddFrame
+********************************************************************************
+* Summary:
+*   Add a frame to the block being filled, and write the block when it is 
+*   full. The frames of a block have consecutive sequence numbers, so when 
+*   frames were lost the block is written short and a new block starts. After
+*   a write error, the frames are no longer added, see Capture_Flush().
+*
+* Parameters:
+*   capture: capture object
+*   frame: samples of all the channels, as given by the Sampler
+*   sequence: frame sequence number, as given by the Sampler
+*
+* Return:
+*   If added correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_capture_status_t Capture_AddFrame(capture_t *capture, const int16_t *frame, uint32_t sequence)
+{
+    uint32_t frames_per_block;
+    uint32_t slot;
+
+    if (capture == NULL || frame == NULL || capture->block == NULL || capture->write_failed)
+    {
+        return CAPTURE_ERROR;
+    }
+
+    if (capture->block_header.num_frames != 0 && sequence != capture->next_sequence)
+    {
+        capture->gaps++;
+        if (Capture_Flush(capture) != CAPTURE_SUCCESS)
+        {
+            return CAPTURE_ERROR;
+        }
+    }
+
+    if (capture->block_header.num_frames == 0)
+    {
+        capture->block_header.first_sequence = sequence;
+    }
+
+    /* Transpose the frame into the columns of the block */
+    frames_per_block = capture->header.frames_per_block;
+    slot = capture->block_header.num_frames;
+    for (uint32_t i = 0; i < capture->header.num_channels; i++)
+    {
+        capture->block[slot] = frame[i];
+        slot += frames_per_block;
+    }
+
+    capture->block_header.num_frames++;
+    capture->next_sequence = sequence + 1u;
+
+    if (capture->block_header.num_frames == frames_per_block)
+    {
+        return Capture_Flush(capture);
+    }
+
+    return CAPTURE_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Capture_Flush
+********************************************************************************
+* Summary:
+*   Write the block being filled, even if it is not full. All the blocks have
+*   the same size, so the unused samples of the columns are written as zero.
+*   The block is written with two calls of the write callback, the header 
+*   then the samples, and a failed call may have stored part of its bytes. So
+*   after a write error nothing more is written: the file ends with the 
+*   complete blocks and at most one partial block, which the readers ignore.
+*
+* Parameters:
+*   capture: capture object
+*
+* Return:
+*   If written correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_capture_status_t Capture_Flush(capture_t *capture)
+{
+    uint32_t frames_per_block;
+    uint32_t num_frames;
+    en_capture_status_t status;
+
+    if (capture == NULL || capture->block == NULL || capture->write_failed)
+    {
+        return CAPTURE_ERROR;
+    }
+
+    num_frames = capture->block_header.num_frames;
+    if (num_frames == 0)
+    {
+        return CAPTURE_SUCCESS;
+    }
+
+    frames_per_block = capture->header.frames_per_block;
+    if (num_frames < frames_per_block)
+    {
+        for (uint32_t i = 0; i < capture->header.num_channels; i++)
+        {
+            memset(&capture->block[i * frames_per_block + num_frames], 0, 
+                   (frames_per_block - num_frames) * sizeof(int16_t));
+        }
+    }
+
+    capture->block_header.index = capture->blocks;
+    status = Capture_Write(capture, &capture->block_header, sizeof(capture_block_header_t));
+    if (status == CAPTURE_SUCCESS)
+    {
+        status = Capture_Write(capture, capture->block, 
+                               capture->header.block_size - sizeof(capture_block_header_t));
+    }
+
+    /* The block is dropped on error, and Capture_Write() refuses the next 
+     * ones, so a partial block can only be at the end of the file */
+    capture->block_header.num_frames = 0;
+    if (status == CAPTURE_SUCCESS)
+    {
+        capture->blocks++;
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: Capture_Write
+********************************************************************************
+* Summary:
+*   Store bytes with the write callback of the application. Once a call has
+*   failed, the next ones are refused until Capture_Start().
+*
+* Parameters:
+*   capture: capture object
+*   data: bytes to store
+*   size: number of bytes
+*
+* Return:
+*   If stored correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+static en_capture_status_t Capture_Write(capture_t *capture, const void *data, uint32_t size)
+{
+    if (capture->write_failed)
+    {
+        return CAPTURE_ERROR;
+    }
+
+    if (!capture->write(data, size, capture->write_arg))
+    {
+        capture->write_errors++;
+        capture->write_failed = true;
+        return CAPTURE_ERROR;
+    }
+
+    return CAPTURE_SUCCESS;
+}
+
+
+/* [] END OF FILE */
\ No newline at end of file
@@ -0,0 +1,108 @@
+/*****************************************************************************
+* File Name  : capture.h
+*
+* Description: This file contains definitions of constants and structures for
+*              the columnar capture of the frames of the Sampler to a file.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef CAPTURE_H_
+#define CAPTURE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "cy_pdl.h"
+#include "amux.h"
+#include "sampler.h"
+#include "capture_format.h"
+
+/*******************************************************************************
+*                              Enumerated Types
+*******************************************************************************/
+typedef enum
+{
+    /** Return success */
+    CAPTURE_SUCCESS = 0u,
+
+    /** Return error */
+    CAPTURE_ERROR = 1u,
+
+} en_capture_status_t;
+
+
+/*******************************************************************************
+*                                 API Constants
+*******************************************************************************/
+#define CAPTURE_MAX_NUM_CHANNELS       (SAMPLER_MAX_NUM_CHANNELS)
+
+/*******************************************************************************
+*                              Type Definitions
+*******************************************************************************/
+/** Write Callback, stores the bytes at the end of the file. Returns false if
+ *  they could not be stored */
+typedef bool (*capture_write_t)(const void *data, uint32_t size, void *arg);
+
+/** Object Structure */
+typedef struct
+{
+    capture_file_header_t header;
+    capture_channel_t channel[CAPTURE_MAX_NUM_CHANNELS];
+    capture_block_header_t block_header;
+    /* Block being filled, num_channels columns of frames_per_block samples */
+    int16_t *block;
+    capture_write_t write;
+    void *write_arg;
+    uint32_t next_sequence;
+    uint32_t blocks;
+    uint32_t gaps;
+    uint32_t write_errors;
+    /* A write failed, the file may end with a partial block, so nothing is 
+     * appended to it until the next Capture_Start() */
+    bool write_failed;
+} capture_t;
+
+/*******************************************************************************
+*                            Function Prototypes
+*******************************************************************************/
+en_capture_status_t Capture_Init(capture_t *capture, amux_t *amux, sampler_t *sampler, 
+                                 int16_t *block, uint32_t frames_per_block,
+                                 capture_write_t write, void *arg);
+en_capture_status_t Capture_Start(capture_t *capture);
+en_capture_status_t Capture_AddFrame(capture_t *capture, const int16_t *frame, uint32_t sequence);
+en_capture_status_t Capture_Flush(capture_t *capture);
+void Capture_Deinit(capture_t *capture);
+
+
+#endif /* CAPTURE_H_ */
\ No newline at end of file
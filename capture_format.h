@@ -0,0 +1,97 @@
+/*****************************************************************************
+* File Name  : capture_format.h
+*
+* Description: This file contains definitions of constants and structures for
+*              the capture file format of the AMux and Sampler, shared by the
+*              device and the host reader.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef CAPTURE_FORMAT_H_
+#define CAPTURE_FORMAT_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+*                                 API Constants
+*******************************************************************************/
+/* A capture file is a file header, one channel entry per channel, then blocks
+ * of the same size. A block holds consecutive frames stored by channel: all
+ * the samples of channel 0, then all the samples of channel 1, and so on, so
+ * a channel is read without touching the others. All fields are little
+ * endian and naturally aligned */
+#define CAPTURE_MAGIC                  (0x43584D41u)    /* "AMXC" */
+#define CAPTURE_BLOCK_MAGIC            (0x4B4C4243u)    /* "CBLK" */
+#define CAPTURE_VERSION                (1u)
+
+/*******************************************************************************
+*                              Type Definitions
+*******************************************************************************/
+/** File Header */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    /* Size of this header and the channel entries */
+    uint16_t header_size;
+    uint32_t scan_rate_hz;
+    uint32_t acq_time_ns;
+    uint16_t oversampling;
+    uint16_t num_channels;
+    uint32_t frames_per_block;
+    /* Size of a block, with its header */
+    uint32_t block_size;
+    uint32_t reserved;
+} capture_file_header_t;
+
+/** Channel Entry, the pin sampled by the channel */
+typedef struct
+{
+    uint8_t port;
+    uint8_t pin;
+    uint8_t amux_sel;
+    uint8_t reserved;
+} capture_channel_t;
+
+/** Block Header, followed by num_channels columns of frames_per_block
+ *  samples. Only the first num_frames samples of each column are valid */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t index;
+    uint32_t first_sequence;
+    uint32_t num_frames;
+} capture_block_header_t;
+
+
+#endif /* CAPTURE_FORMAT_H_ */
\ No newline at end of file
@@ -0,0 +1,378 @@
+/*******************************************************************************
+* File Name: filter_bank.c
+*
+*  Description: This file contains the bank of per-channel IIR biquad
+*   and CIC decimation filters applied to the Sampler frames.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <string.h>
+
+#include "filter_bank.h"
+
+#if FILTER_BANK_USE_SIMD
+    #include "cy_pdl.h"
+#endif
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+/* Dual 16-bit MAC and halfword packing. The C versions give the same results
+ * as the Cortex-M4 instructions */
+#if FILTER_BANK_USE_SIMD
+    #define FILTER_BANK_SMLAD(x, y, acc)    ((int32_t) __SMLAD((x), (y), (uint32_t)(acc)))
+    #define FILTER_BANK_PKHBT(a, b)         __PKHBT((a), (b), 16)
+    #define FILTER_BANK_PKHTB(a, b)         __PKHTB((a), (b), 16)
+    #define FILTER_BANK_SAT16(value)        __SSAT((value), 16)
+#else
+    #define FILTER_BANK_SMLAD(x, y, acc)    ((acc) + ((int32_t)(int16_t)(x) * (int16_t)(y)) + \
+                                             ((int32_t)(int16_t)((x) >> 16) * (int16_t)((y) >> 16)))
+    #define FILTER_BANK_PKHBT(a, b)         (((uint32_t)(a) & 0x0000FFFFu) | ((uint32_t)(b) << 16))
+    #define FILTER_BANK_PKHTB(a, b)         (((uint32_t)(a) & 0xFFFF0000u) | ((uint32_t)(b) >> 16))
+    #define FILTER_BANK_SAT16(value)        (((value) > INT16_MAX) ? INT16_MAX : \
+                                             (((value) < INT16_MIN) ? INT16_MIN : (value)))
+#endif
+
+/* Half of the last coefficient bit, to round the biquad output */
+#define FILTER_BANK_ROUNDING            (1 << (FILTER_BANK_COEFF_SHIFT - 1u))
+
+/*******************************************************************************
+* Local Functions
+*******************************************************************************/
+static inline int32_t FilterBank_Biquad(filter_biquad_t *biquad, int32_t x);
+
+/*******************************************************************************
+* Function Name: FilterBank_Init
+********************************************************************************
+* Summary:
+*   Initialize a bank of filters, one per channel of the Sampler frames. Every
+*   channel goes through its biquad sections, then its CIC filter, and the 
+*   bank outputs one frame every decimation input frames. The channels are 
+*   initialized without biquads nor CIC, which only decimates them.
+*
+* Parameters:
+*   bank: filter bank object
+*   num_channels: number of channels per frame
+*   decimation: number of input frames per output frame, a power of two up to
+*               FILTER_BANK_MAX_DECIMATION. Set to 1 to filter without 
+*               decimating.
+*
+* Return:
+*   If initialized correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_filter_bank_status_t FilterBank_Init(filter_bank_t *bank, uint8_t num_channels, uint16_t decimation)
+{
+    if (bank == NULL || num_channels == 0 || num_channels > FILTER_BANK_MAX_NUM_CHANNELS)
+    {
+        return FILTER_BANK_ERROR;
+    }
+
+    if (decimation == 0 || decimation > FILTER_BANK_MAX_DECIMATION || 
+        (decimation & (decimation - 1)) != 0)
+    {
+        return FILTER_BANK_ERROR;
+    }
+
+    memset(bank, 0, sizeof(filter_bank_t));
+
+    bank->num_channels = num_channels;
+    bank->decimation = decimation;
+    while ((1u << bank->decimation_log2) < decimation)
+    {
+        bank->decimation_log2++;
+    }
+
+    return FILTER_BANK_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: FilterBank_SetBiquads
+********************************************************************************
+* Summary:
+*   Set the cascade of biquad sections of a channel, for low-pass filtering 
+*   before the decimation for example. The sections run at the input frame 
+*   rate, in direct form I, with 16-bit states and a 32-bit accumulator. The 
+*   coefficients shall keep the accumulator within 32 bits, which is the case
+*   of stable filters fed with 12-bit samples. The states are cleared.
+*
+* Parameters:
+*   bank: filter bank object
+*   channel: channel index in the frame
+*   coeffs: FILTER_BANK_COEFFS_PER_BIQUAD Q2.14 coefficients per section, 
+*           b0, b1, b2, a1, a2
+*   num_biquads: number of sections, up to FILTER_BANK_MAX_BIQUADS. Set to 0
+*                to remove the biquads.
+*
+* Return:
+*   If set correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_filter_bank_status_t FilterBank_SetBiquads(filter_bank_t *bank, uint8_t channel, 
+                                              const int16_t *coeffs, uint8_t num_biquads)
+{
+    filter_channel_t *ch;
+    const int16_t *c;
+
+    if (bank == NULL || channel >= bank->num_channels || num_biquads > FILTER_BANK_MAX_BIQUADS)
+    {
+        return FILTER_BANK_ERROR;
+    }
+
+    if (coeffs == NULL && num_biquads != 0)
+    {
+        return FILTER_BANK_ERROR;
+    }
+
+    /* The feedback coefficients are stored negated */
+    for (uint32_t i = 0; i < num_biquads; i++)
+    {
+        c = &coeffs[i * FILTER_BANK_COEFFS_PER_BIQUAD];
+        if (c[3] == INT16_MIN || c[4] == INT16_MIN)
+        {
+            return FILTER_BANK_ERROR;
+        }
+    }
+
+    ch = &bank->channel[channel];
+    memset(ch->biquad, 0, sizeof(ch->biquad));
+    for (uint32_t i = 0; i < num_biquads; i++)
+    {
+        c = &coeffs[i * FILTER_BANK_COEFFS_PER_BIQUAD];
+        ch->biquad[i].b0_b1 = FILTER_BANK_PKHBT((uint16_t) c[0], (uint16_t) c[1]);
+        ch->biquad[i].b2_a1 = FILTER_BANK_PKHBT((uint16_t) c[2], (uint16_t)(-c[3]));
+        ch->biquad[i].a2 = -c[4];
+    }
+    ch->num_biquads = num_biquads;
+
+    return FILTER_BANK_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: FilterBank_SetCic
+********************************************************************************
+* Summary:
+*   Set the order of the CIC decimation filter of a channel. Its integrators
+*   run at the input frame rate and its combs at the output frame rate, with a
+*   differential delay of one. The output is divided by the CIC gain, 
+*   decimation^order, so it keeps the scale of the input. The states are 
+*   cleared.
+*
+* Parameters:
+*   bank: filter bank object
+*   channel: channel index in the frame
+*   order: number of stages, up to FILTER_BANK_MAX_CIC_ORDER, and such that 
+*          the gain is at most 2^FILTER_BANK_MAX_CIC_GROWTH. Set to 0 to only
+*          keep one sample out of decimation.
+*
+* Return:
+*   If set correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_filter_bank_status_t FilterBank_SetCic(filter_bank_t *bank, uint8_t channel, uint8_t order)
+{
+    filter_channel_t *ch;
+
+    if (bank == NULL || channel >= bank->num_channels || order > FILTER_BANK_MAX_CIC_ORDER)
+    {
+        return FILTER_BANK_ERROR;
+    }
+
+    if ((order * bank->decimation_log2) > FILTER_BANK_MAX_CIC_GROWTH)
+    {
+        return FILTER_BANK_ERROR;
+    }
+
+    ch = &bank->channel[channel];
+    memset(ch->integrator, 0, sizeof(ch->integrator));
+    memset(ch->comb, 0, sizeof(ch->comb));
+    ch->cic_order = order;
+
+    return FILTER_BANK_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: FilterBank_Reset
+********************************************************************************
+* Summary:
+*   Clear the states of all the filters, keeping their configuration, for 
+*   example after the Sampler was stopped.
+*
+* Parameters:
+*   bank: filter bank object
+*
+*******************************************************************************/
+void FilterBank_Reset(filter_bank_t *bank)
+{
+    filter_channel_t *ch;
+
+    if (bank == NULL)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < bank->num_channels; i++)
+    {
+        ch = &bank->channel[i];
+        for (uint32_t j = 0; j < FILTER_BANK_MAX_BIQUADS; j++)
+        {
+            ch->biquad[j].x = 0;
+            ch->biquad[j].y = 0;
+        }
+        memset(ch->integrator, 0, sizeof(ch->integrator));
+        memset(ch->comb, 0, sizeof(ch->comb));
+    }
+
+    bank->phase = 0;
+}
+
+/*******************************************************************************
+* Function Name: FilterBank_Process
+********************************************************************************
+* Summary:
+*   Filter one frame of the Sampler. The output frame is only written on the
+*   last input frame of each decimation period.
+*
+* Parameters:
+*   bank: filter bank object
+*   frame: input samples, num_channels of them
+*   output: returns the filtered samples, num_channels of them. It can be the
+*           same array as frame.
+*
+* Return:
+*   SUCCESS if the output frame was written, PENDING if more input frames are
+*   needed, otherwise ERROR.
+*
+*******************************************************************************/
+en_filter_bank_status_t FilterBank_Process(filter_bank_t *bank, const int16_t *frame, int16_t *output)
+{
+    filter_channel_t *ch;
+    bool decimate;
+    uint32_t shift;
+    uint32_t value;
+    uint32_t delayed;
+    int32_t sample;
+
+    if (bank == NULL || frame == NULL || output == NULL)
+    {
+        return FILTER_BANK_ERROR;
+    }
+
+    decimate = (bank->phase == (bank->decimation - 1u));
+
+    for (uint32_t i = 0; i < bank->num_channels; i++)
+    {
+        ch = &bank->channel[i];
+        sample = frame[i];
+
+        for (uint32_t j = 0; j < ch->num_biquads; j++)
+        {
+            sample = FilterBank_Biquad(&ch->biquad[j], sample);
+        }
+
+        /* Integrators, at the input rate */
+        value = (uint32_t) sample;
+        for (uint32_t j = 0; j < ch->cic_order; j++)
+        {
+            ch->integrator[j] += value;
+            value = ch->integrator[j];
+        }
+
+        if (decimate)
+        {
+            /* Combs, at the output rate */
+            for (uint32_t j = 0; j < ch->cic_order; j++)
+            {
+                delayed = ch->comb[j];
+                ch->comb[j] = value;
+                value -= delayed;
+            }
+
+            shift = ch->cic_order * bank->decimation_log2;
+            sample = ((int32_t) value) >> shift;
+            output[i] = (int16_t) FILTER_BANK_SAT16(sample);
+        }
+    }
+
+    if (!decimate)
+    {
+        bank->phase++;
+        return FILTER_BANK_PENDING;
+    }
+
+    bank->phase = 0;
+    return FILTER_BANK_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: FilterBank_Biquad
+********************************************************************************
+* Summary:
+*   Run one sample through a biquad section. The five products take two dual
+*   MACs and one multiply-accumulate.
+*
+* Parameters:
+*   biquad: biquad section
+*   x: input sample
+*
+* Return:
+*   Output sample, saturated to 16 bits.
+*
+*******************************************************************************/
+static inline int32_t FilterBank_Biquad(filter_biquad_t *biquad, int32_t x)
+{
+    uint32_t x_x1;
+    uint32_t x2_y1;
+    int32_t acc;
+    int32_t y;
+
+    /* (x[n], x[n-1]) and (x[n-2], y[n-1]) */
+    x_x1 = FILTER_BANK_PKHBT((uint32_t) x, biquad->x);
+    x2_y1 = FILTER_BANK_PKHTB(biquad->y << 16, biquad->x);
+
+    acc = FILTER_BANK_ROUNDING;
+    acc = FILTER_BANK_SMLAD(x_x1, biquad->b0_b1, acc);
+    acc = FILTER_BANK_SMLAD(x2_y1, biquad->b2_a1, acc);
+    acc += (int32_t)(int16_t)(biquad->y >> 16) * biquad->a2;
+
+    y = acc >> FILTER_BANK_COEFF_SHIFT;
+    y = FILTER_BANK_SAT16(y);
+
+    biquad->x = x_x1;
+    biquad->y = FILTER_BANK_PKHBT((uint32_t) y, biquad->y);
+
+    return y;
+}
+
+
+/* [] END OF FILE */
\ No newline at end of file
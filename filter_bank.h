@@ -0,0 +1,148 @@
+/*****************************************************************************
+* File Name  : filter_bank.h
+*
+* Description: This file contains definitions of constants and structures for
+*              the bank of per-channel filters applied to the Sampler frames.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef FILTER_BANK_H_
+#define FILTER_BANK_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*                              Enumerated Types
+*******************************************************************************/
+typedef enum
+{
+    /** Return success, a filtered frame is available */
+    FILTER_BANK_SUCCESS = 0u,
+
+    /** Return error */
+    FILTER_BANK_ERROR = 1u,
+
+    /** The frame was filtered, but the decimated frame is not complete yet */
+    FILTER_BANK_PENDING = 2u,
+
+} en_filter_bank_status_t;
+
+
+/*******************************************************************************
+*                                 API Constants
+*******************************************************************************/
+#ifndef FILTER_BANK_MAX_NUM_CHANNELS
+    #define FILTER_BANK_MAX_NUM_CHANNELS   (32u)
+#endif
+
+/* Cascaded biquad sections per channel */
+#ifndef FILTER_BANK_MAX_BIQUADS
+    #define FILTER_BANK_MAX_BIQUADS        (2u)
+#endif
+
+#define FILTER_BANK_MAX_CIC_ORDER      (4u)
+#define FILTER_BANK_MAX_DECIMATION     (256u)
+
+/* The CIC gain, decimation^order, shall fit the 16 bits of headroom left by 
+ * 16-bit samples in 32-bit registers */
+#define FILTER_BANK_MAX_CIC_GROWTH     (16u)
+
+/* Biquad coefficients are signed Q2.14: b0, b1, b2, a1, a2 per section, for
+ * y = b0*x[n] + b1*x[n-1] + b2*x[n-2] - a1*y[n-1] - a2*y[n-2] */
+#define FILTER_BANK_COEFF_SHIFT        (14u)
+#define FILTER_BANK_COEFFS_PER_BIQUAD  (5u)
+
+/* Use the dual 16-bit MAC of the Cortex-M4, otherwise a portable C version
+ * giving the same results */
+#ifndef FILTER_BANK_USE_SIMD
+    #if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+        #define FILTER_BANK_USE_SIMD           (1)
+    #else
+        #define FILTER_BANK_USE_SIMD           (0)
+    #endif
+#endif
+
+/*******************************************************************************
+*                              Type Definitions
+*******************************************************************************/
+/** Biquad Section. Pairs of 16-bit values are packed in 32-bit words, low 
+ *  half first, as consumed by the dual MAC */
+typedef struct
+{
+    /* b0, b1 */
+    uint32_t b0_b1;
+    /* b2, -a1 */
+    uint32_t b2_a1;
+    /* -a2 */
+    int32_t a2;
+    /* x[n-1], x[n-2] */
+    uint32_t x;
+    /* y[n-1], y[n-2] */
+    uint32_t y;
+} filter_biquad_t;
+
+/** Channel Structure */
+typedef struct
+{
+    uint8_t num_biquads;
+    uint8_t cic_order;
+    filter_biquad_t biquad[FILTER_BANK_MAX_BIQUADS];
+    /* The CIC registers wrap around, which the combs cancel out */
+    uint32_t integrator[FILTER_BANK_MAX_CIC_ORDER];
+    uint32_t comb[FILTER_BANK_MAX_CIC_ORDER];
+} filter_channel_t;
+
+/** Object Structure */
+typedef struct
+{
+    uint8_t num_channels;
+    uint16_t decimation;
+    uint8_t decimation_log2;
+    uint16_t phase;
+    filter_channel_t channel[FILTER_BANK_MAX_NUM_CHANNELS];
+} filter_bank_t;
+
+/*******************************************************************************
+*                            Function Prototypes
+*******************************************************************************/
+en_filter_bank_status_t FilterBank_Init(filter_bank_t *bank, uint8_t num_channels, uint16_t decimation);
+en_filter_bank_status_t FilterBank_SetBiquads(filter_bank_t *bank, uint8_t channel, 
+                                              const int16_t *coeffs, uint8_t num_biquads);
+en_filter_bank_status_t FilterBank_SetCic(filter_bank_t *bank, uint8_t channel, uint8_t order);
+en_filter_bank_status_t FilterBank_Process(filter_bank_t *bank, const int16_t *frame, int16_t *output);
+void FilterBank_Reset(filter_bank_t *bank);
+
+
+#endif /* FILTER_BANK_H_ */
\ No newline at end of file
@@ -0,0 +1,365 @@
+/*******************************************************************************
+* File Name: frame_codec.c
+*
+*  Description: This file contains the delta encoder and decoder that compress
+*   consecutive Sampler frames for the telemetry links.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <string.h>
+
+#include "frame_codec.h"
+
+/*******************************************************************************
+* Local Functions
+*******************************************************************************/
+static inline uint32_t FrameCodec_PutVarint(uint8_t *data, uint16_t value);
+static inline bool FrameCodec_GetVarint(const uint8_t *data, uint32_t size, uint32_t *pos, uint16_t *value);
+
+/*******************************************************************************
+* Function Name: FrameCodec_Init
+********************************************************************************
+* Summary:
+*   Initialize a frame codec, as an encoder or as a decoder. Most channels 
+*   change slowly, so the encoder only sends the channels that changed since 
+*   the previous frame, as small differences. Key frames send all the 
+*   channels, so a decoder that lost a frame can start again. The first frame
+*   is always a key frame.
+*
+* Parameters:
+*   codec: frame codec object
+*   num_channels: number of channels per frame
+*   key_interval: number of frames between two key frames, or 0 for key 
+*                 frames only when requested. Not used by the decoder.
+*
+* Return:
+*   If initialized correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_frame_codec_status_t FrameCodec_Init(frame_codec_t *codec, uint8_t num_channels, uint16_t key_interval)
+{
+    if (codec == NULL || num_channels == 0 || num_channels > FRAME_CODEC_MAX_NUM_CHANNELS)
+    {
+        return FRAME_CODEC_ERROR;
+    }
+
+    memset(codec, 0, sizeof(frame_codec_t));
+
+    codec->num_channels = num_channels;
+    codec->key_interval = key_interval;
+
+    return FRAME_CODEC_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: FrameCodec_Encode
+********************************************************************************
+* Summary:
+*   Encode a frame against the previous one. The encoded frame can only be 
+*   decoded after the previous one, so if it is not sent, call 
+*   FrameCodec_RequestKeyFrame() for the next frame to be a key frame.
+*
+* Parameters:
+*   codec: frame codec object
+*   frame: samples, num_channels of them
+*   data: returns the encoded frame
+*   size: size of data, at least FRAME_CODEC_MAX_SIZE(num_channels)
+*   length: returns the length of the encoded frame
+*
+* Return:
+*   If encoded correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_frame_codec_status_t FrameCodec_Encode(frame_codec_t *codec, const int16_t *frame, 
+                                          uint8_t *data, uint32_t size, uint32_t *length)
+{
+    uint8_t *bitmap;
+    uint32_t pos;
+    int16_t delta;
+    bool key;
+
+    if (codec == NULL || frame == NULL || data == NULL || length == NULL)
+    {
+        return FRAME_CODEC_ERROR;
+    }
+
+    if (size < FRAME_CODEC_MAX_SIZE(codec->num_channels))
+    {
+        return FRAME_CODEC_ERROR;
+    }
+
+    key = !codec->reference_valid || (codec->key_interval != 0 && codec->key_countdown == 0);
+
+    if (key)
+    {
+        data[0] = FRAME_CODEC_FLAG_KEY;
+        pos = FRAME_CODEC_FLAGS_SIZE;
+
+        for (uint32_t ch = 0; ch < codec->num_channels; ch++)
+        {
+            pos += FrameCodec_PutVarint(&data[pos], (uint16_t) frame[ch]);
+            codec->reference[ch] = frame[ch];
+        }
+
+        codec->reference_valid = true;
+        codec->key_countdown = codec->key_interval;
+        codec->key_frames++;
+    }
+    else
+    {
+        data[0] = 0;
+        bitmap = &data[FRAME_CODEC_FLAGS_SIZE];
+        memset(bitmap, 0, FRAME_CODEC_BITMAP_SIZE(codec->num_channels));
+        pos = FRAME_CODEC_FLAGS_SIZE + FRAME_CODEC_BITMAP_SIZE(codec->num_channels);
+
+        for (uint32_t ch = 0; ch < codec->num_channels; ch++)
+        {
+            /* Differences wrap around, so any 16-bit sample can be sent */
+            delta = (int16_t)(uint16_t)((uint16_t) frame[ch] - (uint16_t) codec->reference[ch]);
+            if (delta != 0)
+            {
+                bitmap[ch / 8u] |= (uint8_t)(1u << (ch % 8u));
+                pos += FrameCodec_PutVarint(&data[pos], (uint16_t) delta);
+                codec->reference[ch] = frame[ch];
+            }
+        }
+    }
+
+    if (codec->key_countdown != 0)
+    {
+        codec->key_countdown--;
+    }
+
+    codec->frames++;
+    codec->bytes += pos;
+    *length = pos;
+
+    return FRAME_CODEC_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: FrameCodec_Decode
+********************************************************************************
+* Summary:
+*   Decode a frame encoded by FrameCodec_Encode(). The encoded frames have no 
+*   length field, the decoder returns the length it read. The frames shall be
+*   decoded in order. If one is lost, call FrameCodec_RequestKeyFrame(), so 
+*   the following delta frames are skipped until the next key frame. The 
+*   decoder does not depend on the hardware, so it can be built on a PC.
+*
+* Parameters:
+*   codec: frame codec object
+*   data: encoded frame
+*   size: number of bytes available in data
+*   frame: returns the samples, num_channels of them
+*   length: returns the length of the encoded frame
+*
+* Return:
+*   SUCCESS if the frame was decoded, NEED_KEY_FRAME if it is a delta frame 
+*   and there is no reference frame, in which case length is still returned,
+*   otherwise ERROR.
+*
+*******************************************************************************/
+en_frame_codec_status_t FrameCodec_Decode(frame_codec_t *codec, const uint8_t *data, uint32_t size, 
+                                          int16_t *frame, uint32_t *length)
+{
+    const uint8_t *bitmap;
+    uint32_t pos;
+    uint16_t value;
+    bool key;
+
+    if (codec == NULL || data == NULL || frame == NULL || length == NULL || size == 0)
+    {
+        return FRAME_CODEC_ERROR;
+    }
+
+    if ((data[0] & ~FRAME_CODEC_FLAG_KEY) != 0)
+    {
+        return FRAME_CODEC_ERROR;
+    }
+
+    key = (data[0] & FRAME_CODEC_FLAG_KEY) != 0;
+    pos = FRAME_CODEC_FLAGS_SIZE;
+
+    if (key)
+    {
+        for (uint32_t ch = 0; ch < codec->num_channels; ch++)
+        {
+            if (!FrameCodec_GetVarint(data, size, &pos, &value))
+            {
+                return FRAME_CODEC_ERROR;
+            }
+            frame[ch] = (int16_t) value;
+        }
+    }
+    else
+    {
+        bitmap = &data[FRAME_CODEC_FLAGS_SIZE];
+        pos += FRAME_CODEC_BITMAP_SIZE(codec->num_channels);
+        if (pos > size)
+        {
+            return FRAME_CODEC_ERROR;
+        }
+
+        for (uint32_t ch = 0; ch < codec->num_channels; ch++)
+        {
+            value = 0;
+            if ((bitmap[ch / 8u] & (1u << (ch % 8u))) != 0)
+            {
+                if (!FrameCodec_GetVarint(data, size, &pos, &value))
+                {
+                    return FRAME_CODEC_ERROR;
+                }
+            }
+            frame[ch] = (int16_t)(uint16_t)((uint16_t) codec->reference[ch] + value);
+        }
+    }
+
+    *length = pos;
+
+    if (!key && !codec->reference_valid)
+    {
+        return FRAME_CODEC_NEED_KEY_FRAME;
+    }
+
+    /* Only a complete frame becomes the reference */
+    memcpy(codec->reference, frame, codec->num_channels * sizeof(int16_t));
+    codec->reference_valid = true;
+    codec->frames++;
+    codec->key_frames += key ? 1u : 0u;
+    codec->bytes += pos;
+
+    return FRAME_CODEC_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: FrameCodec_RequestKeyFrame
+********************************************************************************
+* Summary:
+*   Drop the reference frame. The encoder then sends a key frame, and the 
+*   decoder waits for one.
+*
+* Parameters:
+*   codec: frame codec object
+*
+*******************************************************************************/
+void FrameCodec_RequestKeyFrame(frame_codec_t *codec)
+{
+    if (codec == NULL)
+    {
+        return;
+    }
+
+    codec->reference_valid = false;
+}
+
+/*******************************************************************************
+* Function Name: FrameCodec_PutVarint
+********************************************************************************
+* Summary:
+*   Write a signed difference as a zigzag varint: 0, -1, 1, -2... are mapped 
+*   to 0, 1, 2, 3..., so small differences of both signs take one byte.
+*
+* Parameters:
+*   data: returns the varint
+*   value: 16-bit difference
+*
+* Return:
+*   Number of bytes written.
+*
+*******************************************************************************/
+static inline uint32_t FrameCodec_PutVarint(uint8_t *data, uint16_t value)
+{
+    uint32_t zigzag;
+    uint32_t n = 0;
+
+    zigzag = ((uint32_t) value << 1) ^ ((value & 0x8000u) ? 0xFFFFu : 0u);
+    zigzag &= 0xFFFFu;
+
+    while (zigzag >= 0x80u)
+    {
+        data[n++] = (uint8_t)(zigzag | 0x80u);
+        zigzag >>= 7;
+    }
+    data[n++] = (uint8_t) zigzag;
+
+    return n;
+}
+
+/*******************************************************************************
+* Function Name: FrameCodec_GetVarint
+********************************************************************************
+* Summary:
+*   Read a zigzag varint written by FrameCodec_PutVarint().
+*
+* Parameters:
+*   data: encoded frame
+*   size: number of bytes available in data
+*   pos: position of the varint, returns the position after it
+*   value: returns the 16-bit difference
+*
+* Return:
+*   False if the varint is truncated or too long.
+*
+*******************************************************************************/
+static inline bool FrameCodec_GetVarint(const uint8_t *data, uint32_t size, uint32_t *pos, uint16_t *value)
+{
+    uint32_t zigzag = 0;
+    uint32_t byte;
+
+    for (uint32_t n = 0; n < FRAME_CODEC_MAX_VARINT_SIZE; n++)
+    {
+        if (*pos >= size)
+        {
+            return false;
+        }
+
+        byte = data[(*pos)++];
+        zigzag |= (byte & 0x7Fu) << (7u * n);
+
+        if ((byte & 0x80u) == 0)
+        {
+            if (zigzag > 0xFFFFu)
+            {
+                return false;
+            }
+            *value = (uint16_t)((zigzag >> 1) ^ (0u - (zigzag & 1u)));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/* [] END OF FILE */
\ No newline at end of file
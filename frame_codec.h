@@ -0,0 +1,116 @@
+/*****************************************************************************
+* File Name  : frame_codec.h
+*
+* Description: This file contains definitions of constants and structures for
+*              the delta encoder and decoder of consecutive Sampler frames.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef FRAME_CODEC_H_
+#define FRAME_CODEC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*                              Enumerated Types
+*******************************************************************************/
+typedef enum
+{
+    /** Return success */
+    FRAME_CODEC_SUCCESS = 0u,
+
+    /** Return error */
+    FRAME_CODEC_ERROR = 1u,
+
+    /** The encoded frame is a delta but the decoder has no reference frame, 
+     *  it shall wait for the next key frame */
+    FRAME_CODEC_NEED_KEY_FRAME = 2u,
+
+} en_frame_codec_status_t;
+
+
+/*******************************************************************************
+*                                 API Constants
+*******************************************************************************/
+#ifndef FRAME_CODEC_MAX_NUM_CHANNELS
+    #define FRAME_CODEC_MAX_NUM_CHANNELS   (32u)
+#endif
+
+/* Encoded frame: flags (1), then for a delta frame a bitmap of the changed 
+ * channels (1 bit per channel), then one varint per sent channel. A varint
+ * holds the zigzag-mapped difference with the reference frame, 7 bits per 
+ * byte, low bits first, the top bit set on all bytes but the last. A key 
+ * frame has no bitmap and sends all the channels against zero */
+#define FRAME_CODEC_FLAG_KEY           (0x01u)
+
+#define FRAME_CODEC_FLAGS_SIZE         (1u)
+#define FRAME_CODEC_BITMAP_SIZE(num_channels)   (((num_channels) + 7u) / 8u)
+
+/* A 16-bit difference takes up to 3 bytes */
+#define FRAME_CODEC_MAX_VARINT_SIZE    (3u)
+
+/* Buffer size that fits any encoded frame */
+#define FRAME_CODEC_MAX_SIZE(num_channels)  (FRAME_CODEC_FLAGS_SIZE + FRAME_CODEC_BITMAP_SIZE(num_channels) + \
+                                             (FRAME_CODEC_MAX_VARINT_SIZE * (num_channels)))
+
+/*******************************************************************************
+*                              Type Definitions
+*******************************************************************************/
+/** Object Structure, for the encoder or the decoder */
+typedef struct
+{
+    uint8_t num_channels;
+    /* Frames between two key frames, 0 for only the first one */
+    uint16_t key_interval;
+    uint16_t key_countdown;
+    bool reference_valid;
+    int16_t reference[FRAME_CODEC_MAX_NUM_CHANNELS];
+    uint32_t frames;
+    uint32_t key_frames;
+    uint32_t bytes;
+} frame_codec_t;
+
+/*******************************************************************************
+*                            Function Prototypes
+*******************************************************************************/
+en_frame_codec_status_t FrameCodec_Init(frame_codec_t *codec, uint8_t num_channels, uint16_t key_interval);
+en_frame_codec_status_t FrameCodec_Encode(frame_codec_t *codec, const int16_t *frame, 
+                                          uint8_t *data, uint32_t size, uint32_t *length);
+en_frame_codec_status_t FrameCodec_Decode(frame_codec_t *codec, const uint8_t *data, uint32_t size, 
+                                          int16_t *frame, uint32_t *length);
+void FrameCodec_RequestKeyFrame(frame_codec_t *codec);
+
+
+#endif /* FRAME_CODEC_H_ */
\ No newline at end of file
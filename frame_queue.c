@@ -0,0 +1,218 @@
+/*******************************************************************************
+* File Name: frame_queue.c
+*
+*  Description: This file contains the single-producer single-consumer
+*   queue of frames, without locks nor critical sections.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include "frame_queue.h"
+
+/*******************************************************************************
+* Function Name: FrameQueue_Init
+********************************************************************************
+* Summary:
+*   Initialize a queue of frames, filled by a single producer, typically the 
+*   Sampler callback in the DMA interrupt, and drained by a single consumer, 
+*   typically the main loop or a task. Neither side blocks the other, so no 
+*   lock nor critical section is needed. The entries only point to the frames,
+*   which are overwritten by the DMA later on, so the consumer shall copy a 
+*   frame before the DMA comes back to its buffer, or check it with 
+*   Sampler_ReadFrame().
+*
+* Parameters:
+*   queue: queue object
+*   entries: array of size entries, allocated by the application
+*   size: number of entries, a power of two up to FRAME_QUEUE_MAX_SIZE
+*
+* Return:
+*   If initialized correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_frame_queue_status_t FrameQueue_Init(frame_queue_t *queue, frame_queue_entry_t *entries, uint32_t size)
+{
+    if (queue == NULL || entries == NULL)
+    {
+        return FRAME_QUEUE_ERROR;
+    }
+
+    if (size == 0 || size > FRAME_QUEUE_MAX_SIZE || (size & (size - 1)) != 0)
+    {
+        return FRAME_QUEUE_ERROR;
+    }
+
+    queue->entries = entries;
+    queue->size = size;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->overflows = 0;
+
+    return FRAME_QUEUE_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: FrameQueue_Push
+********************************************************************************
+* Summary:
+*   Add an entry at the head of the queue. Shall only be called by the 
+*   producer. When the queue is full, the new entry is dropped and counted as
+*   an overflow, so the consumer finds the oldest frames it did not get yet.
+*
+* Parameters:
+*   queue: queue object
+*   entry: entry to copy into the queue
+*
+* Return:
+*   SUCCESS if added, FULL if dropped, otherwise ERROR.
+*
+*******************************************************************************/
+en_frame_queue_status_t FrameQueue_Push(frame_queue_t *queue, const frame_queue_entry_t *entry)
+{
+    uint32_t head;
+
+    if (queue == NULL || entry == NULL || queue->entries == NULL)
+    {
+        return FRAME_QUEUE_ERROR;
+    }
+
+    head = queue->head;
+    if ((head - queue->tail) >= queue->size)
+    {
+        queue->overflows++;
+        return FRAME_QUEUE_FULL;
+    }
+
+    /* The consumer is done with the entry before it moved the tail, and the
+     * entry is written before the head covers it */
+    __DMB();
+    queue->entries[head & (queue->size - 1u)] = *entry;
+    __DMB();
+    queue->head = head + 1u;
+
+    return FRAME_QUEUE_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: FrameQueue_Pop
+********************************************************************************
+* Summary:
+*   Remove the entry at the tail of the queue. Shall only be called by the 
+*   consumer.
+*
+* Parameters:
+*   queue: queue object
+*   entry: returns the oldest entry
+*
+* Return:
+*   SUCCESS if an entry was removed, EMPTY if there was none, otherwise ERROR.
+*
+*******************************************************************************/
+en_frame_queue_status_t FrameQueue_Pop(frame_queue_t *queue, frame_queue_entry_t *entry)
+{
+    uint32_t tail;
+
+    if (queue == NULL || entry == NULL || queue->entries == NULL)
+    {
+        return FRAME_QUEUE_ERROR;
+    }
+
+    tail = queue->tail;
+    if (queue->head == tail)
+    {
+        return FRAME_QUEUE_EMPTY;
+    }
+
+    /* The entry is read after the head that covers it, and before the tail 
+     * gives it back to the producer */
+    __DMB();
+    *entry = queue->entries[tail & (queue->size - 1u)];
+    __DMB();
+    queue->tail = tail + 1u;
+
+    return FRAME_QUEUE_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: FrameQueue_GetCount
+********************************************************************************
+* Summary:
+*   Get the number of entries in the queue. Called by the producer, the queue 
+*   holds at least this number; called by the consumer, at least this number 
+*   can be popped.
+*
+* Parameters:
+*   queue: queue object
+*
+* Return:
+*   Number of entries.
+*
+*******************************************************************************/
+uint32_t FrameQueue_GetCount(frame_queue_t *queue)
+{
+    uint32_t tail;
+
+    if (queue == NULL)
+    {
+        return 0;
+    }
+
+    tail = queue->tail;
+
+    return queue->head - tail;
+}
+
+/*******************************************************************************
+* Function Name: FrameQueue_GetOverflows
+********************************************************************************
+* Summary:
+*   Get the number of entries dropped because the queue was full.
+*
+* Parameters:
+*   queue: queue object
+*
+* Return:
+*   Number of dropped entries.
+*
+*******************************************************************************/
+uint32_t FrameQueue_GetOverflows(frame_queue_t *queue)
+{
+    if (queue == NULL)
+    {
+        return 0;
+    }
+
+    return queue->overflows;
+}
+
+
+/* [] END OF FILE */
\ No newline at end of file
@@ -0,0 +1,107 @@
+/*****************************************************************************
+* File Name  : frame_queue.h
+*
+* Description: This file contains definitions of constants and structures for
+*              the single-producer single-consumer queue of frames.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef FRAME_QUEUE_H_
+#define FRAME_QUEUE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "cy_pdl.h"
+
+/*******************************************************************************
+*                              Enumerated Types
+*******************************************************************************/
+typedef enum
+{
+    /** Return success */
+    FRAME_QUEUE_SUCCESS = 0u,
+
+    /** Return error */
+    FRAME_QUEUE_ERROR = 1u,
+
+    /** No entry to pop */
+    FRAME_QUEUE_EMPTY = 2u,
+
+    /** No room to push, the entry is dropped */
+    FRAME_QUEUE_FULL = 3u,
+
+} en_frame_queue_status_t;
+
+
+/*******************************************************************************
+*                                 API Constants
+*******************************************************************************/
+#define FRAME_QUEUE_MAX_SIZE           (0x80000000u)
+
+/*******************************************************************************
+*                              Type Definitions
+*******************************************************************************/
+/** Queue Entry */
+typedef struct
+{
+    int16_t *frame;
+    uint32_t sequence;
+    uint32_t timestamp;
+} frame_queue_entry_t;
+
+/** Object Structure. The head is only written by the producer and the tail 
+ *  only by the consumer, both count entries since the initialization. They 
+ *  are only loaded and stored, never read-modify-written, so no exclusive 
+ *  access nor critical section is needed */
+typedef struct
+{
+    frame_queue_entry_t *entries;
+    uint32_t size;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t overflows;
+} frame_queue_t;
+
+/*******************************************************************************
+*                            Function Prototypes
+*******************************************************************************/
+en_frame_queue_status_t FrameQueue_Init(frame_queue_t *queue, frame_queue_entry_t *entries, uint32_t size);
+en_frame_queue_status_t FrameQueue_Push(frame_queue_t *queue, const frame_queue_entry_t *entry);
+en_frame_queue_status_t FrameQueue_Pop(frame_queue_t *queue, frame_queue_entry_t *entry);
+uint32_t FrameQueue_GetCount(frame_queue_t *queue);
+uint32_t FrameQueue_GetOverflows(frame_queue_t *queue);
+
+
+#endif /* FRAME_QUEUE_H_ */
\ No newline at end of file
@@ -48,26 +48,127 @@
 #include "cybsp.h"
 #include "cy_retarget_io.h"
 
+#include <string.h>
+
 #include "amux.h"
 #include "sampler.h"
+#include "planner.h"
+#include "telemetry.h"
+#include "frame_queue.h"
+#include "burst.h"
 
 /*******************************************************************************
 * Macros
 *******************************************************************************/
 #define SAR_ADC_SAMPLING_RATE_SPS   920000
 #define SAR_ADC_ACQUISTION_TIME_NS  180  
+#define SAR_ADC_OVERSAMPLING        1
+
+/* Stream every frame as binary packets instead of printing a table. It needs
+ * a DW channel named CYBSP_DMA_TLM triggered by the debug UART TX FIFO */
+#define ADC_TELEMETRY_ENABLE        0
+#define ADC_TELEMETRY_BAUD_RATE     921600
+#define ADC_RING_FRAMES             64
+
+/* Scan in bursts started by the MCWDT, with Deep Sleep between the bursts, 
+ * and print the energy per frame instead of the table. The currents are 
+ * those of the board, measured with a power analyzer */
+#define ADC_BURST_ENABLE            0
+#define ADC_BURST_MCWDT             MCWDT_STRUCT0
+#define ADC_BURST_FRAMES            10
+#define ADC_BURST_PERIOD_US         100000
+#define ADC_BURST_ACTIVE_UA         3000
+#define ADC_BURST_SLEEP_UA          10
+#define ADC_BURST_SUPPLY_MV         3300
+#define ADC_BURST_REPORT_BURSTS     10
+
+#if ADC_BURST_ENABLE && ADC_TELEMETRY_ENABLE
+    #error "The burst mode does not support the ring of the telemetry"
+#endif
+
+/* Frames handed from the Sampler interrupt to the main loop, about 0.8 ms of
+ * frames at 38 kfps (24 channels at 920 ksps) */
+#define ADC_QUEUE_SIZE              32
+
+/* Frames averaged in each printed table, about one second */
+#define ADC_PRINT_FRAMES            (SAR_ADC_SAMPLING_RATE_SPS / (ADC_NUM_CHANNELS * SAR_ADC_OVERSAMPLING))
+
+/* Build the AMux DMA chain in flash, set by AMUX_FLASH_TABLE in the makefile */
+#ifndef ADC_AMUX_FLASH_TABLE
+    #define ADC_AMUX_FLASH_TABLE    0
+#endif
+
+/* Pins scanned by the AMux, in order, for the flash table */
+#define ADC_AMUX_PINS(X, t)         AMUX_TABLE_PORT(X, t, 9)  \
+                                    AMUX_TABLE_PORT(X, t, 10) \
+                                    AMUX_TABLE_PORT(X, t, 12)
+#define ADC_NUM_CHANNELS            24
 
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
 amux_t adc_mux;
+#if ADC_AMUX_FLASH_TABLE
+/* Connections and DMA chain of the AMux, built at compile time in flash */
+AMUX_TABLE_DEFINE(adc_mux_table, ADC_AMUX_PINS, AMUX_B, SAR_ADC_OVERSAMPLING);
+#else
+/* DMA chain of the AMux, built in RAM at startup */
+cy_stc_dma_descriptor_t adc_mux_desc[AMUX_NUM_DESCRIPTORS(ADC_NUM_CHANNELS)];
+#endif
 sampler_t adc_sampler;
+#if ADC_TELEMETRY_ENABLE
+/* The ring takes a single descriptor */
+cy_stc_dma_descriptor_t adc_sampler_desc[1];
+#else
+cy_stc_dma_descriptor_t adc_sampler_desc[SAMPLER_NUM_DESCRIPTORS(ADC_NUM_CHANNELS)];
+#endif
+planner_result_t adc_plan;
 
 int16_t adc_samples[SAMPLER_MAX_NUM_CHANNELS];
+int16_t adc_frame[SAMPLER_MAX_NUM_CHANNELS];
+int32_t adc_sums[SAMPLER_MAX_NUM_CHANNELS];
+int16_t adc_ping[SAMPLER_MAX_NUM_CHANNELS];
+int16_t adc_pong[SAMPLER_MAX_NUM_CHANNELS];
+
+frame_queue_t adc_queue;
+frame_queue_entry_t adc_queue_entries[ADC_QUEUE_SIZE];
+
+const cy_stc_sysint_t dma_adc_irq_cfg =
+{
+    .intrSrc = CYBSP_DMA_ADC_IRQ,
+    .intrPriority = 3u,
+};
+
+#if ADC_TELEMETRY_ENABLE
+telemetry_t adc_telemetry;
+int16_t adc_ring[ADC_RING_FRAMES * SAMPLER_MAX_NUM_CHANNELS];
+
+const cy_stc_sysint_t dma_tlm_irq_cfg =
+{
+    .intrSrc = CYBSP_DMA_TLM_IRQ,
+    .intrPriority = 3u,
+};
+#endif
+
+#if ADC_BURST_ENABLE
+burst_t adc_burst;
+
+const cy_stc_sysint_t mcwdt_irq_cfg =
+{
+    .intrSrc = srss_interrupt_mcwdt_0_IRQn,
+    .intrPriority = 3u,
+};
+#endif
 
 /*******************************************************************************
 * Function Prototypes
 *******************************************************************************/
+void dma_adc_isr(void);
+void dma_tlm_isr(void);
+void mcwdt_isr(void);
+void stream_frames(void);
+void scan_bursts(void);
+void sampler_frame_callback(const sampler_event_t *event, void *arg);
 
 
 /*******************************************************************************
@@ -95,6 +196,182 @@ void handle_error(uint32_t status)
     }
 }
 
+/*******************************************************************************
+* Function Name: dma_adc_isr
+********************************************************************************
+* Summary:
+* Interrupt service routine of the Sampler DMA. Forwards to the Sampler.
+*
+*******************************************************************************/
+void dma_adc_isr(void)
+{
+    Sampler_IRQHandler(&adc_sampler);
+}
+
+#if ADC_TELEMETRY_ENABLE
+/*******************************************************************************
+* Function Name: dma_tlm_isr
+********************************************************************************
+* Summary:
+* Interrupt service routine of the Telemetry DMA. Forwards to the Telemetry.
+*
+*******************************************************************************/
+void dma_tlm_isr(void)
+{
+    Telemetry_IRQHandler(&adc_telemetry);
+}
+
+/*******************************************************************************
+* Function Name: stream_frames
+********************************************************************************
+* Summary:
+* Send the newest frame of the ring every time the UART is free. The frame is
+* kept in the ring until it is sent, then released with the older ones. The 
+* timestamp is the time of the frame in microseconds since the start. The CPU
+* sleeps while a packet is sent, until the Telemetry interrupt.
+*
+*******************************************************************************/
+void stream_frames(void)
+{
+    bool sending = false;
+    int16_t *frames;
+    uint32_t num_frames;
+    uint32_t sequence;
+    uint32_t timestamp;
+
+    for (;;)
+    {
+        /* The interrupts are masked, so the end of the packet after the check
+         * still wakes up the CPU */
+        __disable_irq();
+        if (Telemetry_IsBusy(&adc_telemetry))
+        {
+            __WFI();
+        }
+        __enable_irq();
+
+        if (Telemetry_IsBusy(&adc_telemetry))
+        {
+            continue;
+        }
+
+        if (sending)
+        {
+            Sampler_RingRelease(&adc_sampler, 1);
+            sending = false;
+        }
+
+        /* Skip to the newest frame */
+        num_frames = Sampler_RingGetFrames(&adc_sampler, &frames);
+        while (num_frames > 1)
+        {
+            Sampler_RingRelease(&adc_sampler, num_frames - 1);
+            num_frames = Sampler_RingGetFrames(&adc_sampler, &frames);
+        }
+
+        /* Every frame takes one conversion per channel and per averaged 
+         * sample */
+        if (num_frames == 1)
+        {
+            sequence = Sampler_RingGetTail(&adc_sampler);
+            timestamp = (uint32_t)(((uint64_t) sequence * adc_mux.num_conn * SAR_ADC_OVERSAMPLING * 1000000u) / 
+                                   SAR_ADC_SAMPLING_RATE_SPS);
+            Telemetry_SendFrame(&adc_telemetry, frames, sequence, timestamp);
+            sending = true;
+        }
+    }
+}
+#endif
+
+#if ADC_BURST_ENABLE
+/*******************************************************************************
+* Function Name: mcwdt_isr
+********************************************************************************
+* Summary:
+* Interrupt service routine of the MCWDT. Starts the next burst.
+*
+*******************************************************************************/
+void mcwdt_isr(void)
+{
+    Burst_TimerIRQHandler(&adc_burst);
+}
+
+/*******************************************************************************
+* Function Name: scan_bursts
+********************************************************************************
+* Summary:
+* Scan ADC_BURST_FRAMES frames every ADC_BURST_PERIOD_US, and stay in Deep 
+* Sleep between the bursts. The Deep Sleep is refused while a burst runs, so 
+* the CPU only sleeps until the end of the burst. The measured energy per 
+* frame is printed every ADC_BURST_REPORT_BURSTS bursts.
+*
+*******************************************************************************/
+void scan_bursts(void)
+{
+    burst_stats_t stats;
+    uint32_t reported = 0;
+
+    Burst_Init(&adc_burst, &adc_mux, &adc_sampler, ADC_BURST_FRAMES);
+    Burst_SetPowerModel(&adc_burst, 0, ADC_BURST_ACTIVE_UA, ADC_BURST_SLEEP_UA, ADC_BURST_SUPPLY_MV);
+    Cy_SysInt_Init(&mcwdt_irq_cfg, mcwdt_isr);
+    NVIC_EnableIRQ(mcwdt_irq_cfg.intrSrc);
+    if (Burst_SetupTimer(&adc_burst, ADC_BURST_MCWDT, ADC_BURST_PERIOD_US) != BURST_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    for (;;)
+    {
+        if (Burst_IsActive(&adc_burst))
+        {
+            Cy_SysPm_CpuEnterSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+            continue;
+        }
+
+        Burst_GetStats(&adc_burst, &stats);
+        if ((stats.bursts - reported) >= ADC_BURST_REPORT_BURSTS)
+        {
+            reported = stats.bursts;
+            printf("Bursts: %lu, active: %lu us, average: %lu uA, energy: %lu nJ/frame, skipped: %lu\n\r",
+                   (unsigned long) stats.bursts, (unsigned long) stats.active_us, 
+                   (unsigned long) stats.average_ua, (unsigned long) stats.energy_nj_per_frame,
+                   (unsigned long) stats.bursts_skipped);
+            /* The UART stops in Deep Sleep */
+            while (cyhal_uart_is_tx_active(&cy_retarget_io_uart_obj))
+            {
+            }
+        }
+
+        /* Refused if the MCWDT started a burst since the check */
+        Cy_SysPm_CpuEnterDeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+    }
+}
+#endif
+
+/*******************************************************************************
+* Function Name: sampler_frame_callback
+********************************************************************************
+* Summary:
+* Called by the Sampler every time a frame is completed. Queues the buffer 
+* holding the frame for the main loop.
+*
+* Parameters:
+*  event - Sampler event
+*  arg - user argument (not used)
+*
+*******************************************************************************/
+void sampler_frame_callback(const sampler_event_t *event, void *arg)
+{
+    frame_queue_entry_t entry;
+
+    (void) arg;
+
+    entry.frame = event->frame;
+    entry.sequence = event->sequence;
+    entry.timestamp = event->timestamp;
+    FrameQueue_Push(&adc_queue, &entry);
+}
+
 /*******************************************************************************
 * Function Name: main
 ********************************************************************************
@@ -113,6 +390,10 @@ void handle_error(uint32_t status)
 int main(void)
 {
     cy_rslt_t result;
+    frame_queue_entry_t entry;
+    uint32_t num_frames = 0;
+    uint32_t num_skipped = 0;
+    uint32_t num_overflows = 0;
 
     /* Initialize the device and board peripherals */
     result = cybsp_init();
@@ -143,27 +424,116 @@ int main(void)
     Cy_SAR_Init(CYBSP_ADC_HW, &CYBSP_ADC_config);
     Cy_SAR_Enable(CYBSP_ADC_HW);
 
+#if ADC_AMUX_FLASH_TABLE
+    /* Initiate the Amux and setup the DMA AMux from the flash table. The 
+     * table holds each pin for all the conversions averaged by the SAR ADC */
+    AMux_Init(&adc_mux, AMUX_B);
+    AMux_SetupDMATable(&adc_mux, &adc_mux_table, CYBSP_DMA_AMUX_HW, CYBSP_DMA_AMUX_CHANNEL);
+#else
     /* Initiate the Amux and add pins to it */
     AMux_Init(&adc_mux, AMUX_B);
     AMux_AddPort(&adc_mux, GPIO_PRT9,  0xFF);
     AMux_AddPort(&adc_mux, GPIO_PRT10, 0xFF);
     AMux_AddPort(&adc_mux, GPIO_PRT12, 0xFF);
+    /* Hold each pin for all the conversions averaged by the SAR ADC */
+    AMux_SetHoldCount(&adc_mux, SAR_ADC_OVERSAMPLING);
     /* Setup the DMA AMux */
+    AMux_ConfigureDescriptors(&adc_mux, adc_mux_desc, AMUX_NUM_DESCRIPTORS(ADC_NUM_CHANNELS));
     AMux_SetupDMA(&adc_mux, CYBSP_DMA_AMUX_HW, CYBSP_DMA_AMUX_CHANNEL);
+#endif
     AMux_StartDMA(&adc_mux);
 
     /* Initalize and configure the Sampler */
     Sampler_Init(&adc_sampler, CYBSP_ADC_HW, CYBSP_TIMER_HW, CYBSP_TIMER_NUM);
     Sampler_SetScanRate(&adc_sampler, SAR_ADC_SAMPLING_RATE_SPS, SAR_ADC_ACQUISTION_TIME_NS);
-    Sampler_Configure(&adc_sampler, adc_mux.num_conn, adc_samples);
-    /* Setup the Sampler DMA and start the Sampler */
+    Sampler_SetOversampling(&adc_sampler, SAR_ADC_OVERSAMPLING);
+#if ADC_TELEMETRY_ENABLE
+    Sampler_ConfigureRing(&adc_sampler, adc_mux.num_conn, adc_ring, ADC_RING_FRAMES);
+#else
+    Sampler_ConfigurePingPong(&adc_sampler, adc_mux.num_conn, adc_ping, adc_pong);
+#endif
+    FrameQueue_Init(&adc_queue, adc_queue_entries, ADC_QUEUE_SIZE);
+    Sampler_RegisterCallback(&adc_sampler, sampler_frame_callback, NULL);
+    /* Setup the Sampler DMA and its frame complete interrupt */
+    Sampler_ConfigureDescriptors(&adc_sampler, adc_sampler_desc, 
+                                 sizeof(adc_sampler_desc) / sizeof(adc_sampler_desc[0]));
     Sampler_SetupDMA(&adc_sampler, CYBSP_DMA_ADC_HW, CYBSP_DMA_ADC_CHANNEL);
+    Cy_SysInt_Init(&dma_adc_irq_cfg, dma_adc_isr);
+    NVIC_EnableIRQ(dma_adc_irq_cfg.intrSrc);
+    /* Check the AMux and Sampler can keep up with the scan rate */
+    if (Planner_Check(&adc_mux, &adc_sampler, &adc_plan) != PLANNER_SUCCESS)
+    {
+        printf("Scan rate not supported, limited by stage %d. Max scan rate: %lu sps\r\n\n",
+               (int) adc_plan.limiting_stage, (unsigned long) adc_plan.max_scan_rate_hz);
+        CY_ASSERT(0);
+    }
+#if ADC_TELEMETRY_ENABLE
+    /* Send the packets on the debug UART, so printf is no longer used */
+    cyhal_uart_set_baud(&cy_retarget_io_uart_obj, ADC_TELEMETRY_BAUD_RATE, NULL);
+    Telemetry_Init(&adc_telemetry, cy_retarget_io_uart_obj.base, adc_mux.num_conn);
+    Telemetry_SetupDMA(&adc_telemetry, CYBSP_DMA_TLM_HW, CYBSP_DMA_TLM_CHANNEL);
+    Cy_SysInt_Init(&dma_tlm_irq_cfg, dma_tlm_isr);
+    NVIC_EnableIRQ(dma_tlm_irq_cfg.intrSrc);
+#endif
+#if ADC_BURST_ENABLE
+    scan_bursts();
+#endif
+    /* Start the Sampler */
     Sampler_Start(&adc_sampler);
 
+#if ADC_TELEMETRY_ENABLE
+    stream_frames();
+#endif
+
     for (;;)
     {
-        CyDelay(1000);
-        
+        /* Sleep until the Sampler interrupt queues the next frame. The 
+         * interrupts are masked, so a frame queued after the check still 
+         * wakes up the CPU */
+        __disable_irq();
+        if (FrameQueue_GetCount(&adc_queue) == 0)
+        {
+            __WFI();
+        }
+        __enable_irq();
+
+        if (FrameQueue_Pop(&adc_queue, &entry) != FRAME_QUEUE_SUCCESS)
+        {
+            continue;
+        }
+
+        /* The DMA rewrites the buffer of a frame once the next one is 
+         * completed. So the frame is kept only if no newer frame was queued 
+         * nor dropped before the end of the copy */
+        if (FrameQueue_GetCount(&adc_queue) != 0)
+        {
+            num_skipped++;
+            continue;
+        }
+        memcpy(adc_frame, entry.frame, adc_mux.num_conn * sizeof(int16_t));
+        if (FrameQueue_GetCount(&adc_queue) != 0 || FrameQueue_GetOverflows(&adc_queue) != num_overflows)
+        {
+            num_overflows = FrameQueue_GetOverflows(&adc_queue);
+            num_skipped++;
+            continue;
+        }
+
+        for (uint32_t ch = 0; ch < adc_mux.num_conn; ch++)
+        {
+            adc_sums[ch] += adc_frame[ch];
+        }
+        num_frames++;
+        if (num_frames < ADC_PRINT_FRAMES)
+        {
+            continue;
+        }
+
+        for (uint32_t ch = 0; ch < adc_mux.num_conn; ch++)
+        {
+            adc_samples[ch] = (int16_t)(adc_sums[ch] / (int32_t) num_frames);
+            adc_sums[ch] = 0;
+        }
+
         printf("\x1b[2J\x1b[;H");
         printf("------------------------------------------------------------\n\r");
         printf("Port| Pin0 | Pin1 | Pin2 | Pin3 | Pin4 | Pin5 | Pin6 | Pin7\n\r");
@@ -181,6 +551,12 @@ int main(void)
                                                                                   adc_samples[20], adc_samples[21], 
                                                                                   adc_samples[22], adc_samples[23]);
         printf("------------------------------------------------------------\n\r");
+        printf("Averaged frames: %lu, skipped: %lu\n\r", (unsigned long) num_frames, 
+                                                         (unsigned long) num_skipped);
+
+        /* The frames queued during the print are stale and skipped */
+        num_frames = 0;
+        num_skipped = 0;
     }
 }
 
@@ -0,0 +1,268 @@
+/*******************************************************************************
+* File Name: planner.c
+*
+*  Description: This file contains the implementation of the scan rate planner,
+*   which checks the AMux and Sampler can keep up with the scan rate.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include "planner.h"
+#include "cyhal.h"
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+#define PLANNER_NUM_STAGES             (PLANNER_STAGE_DW + 1u)
+
+/* Each slot of the AMux schedule is a channel of the Sampler frame */
+_Static_assert(AMUX_MAX_SCHEDULE_LENGTH <= SAMPLER_MAX_NUM_CHANNELS,
+               "AMUX_MAX_SCHEDULE_LENGTH exceeds SAMPLER_MAX_NUM_CHANNELS");
+
+/*******************************************************************************
+* Local Functions
+*******************************************************************************/
+static uint32_t Planner_CyclesToNs(uint32_t cycles, uint32_t clk_hz);
+
+/*******************************************************************************
+* Function Name: Planner_Check
+********************************************************************************
+* Summary:
+*   Check if the AMux and the Sampler, as configured, can sustain the scan rate
+*   set with Sampler_SetScanRate(), and find the highest scan rate they can.
+*   Each stage of the chain needs some time per trigger:
+*   - Timer: the pin is only switched after the acquisition time.
+*   - AMux DMA: the next pin is connected before the next trigger.
+*   - SAR ADC: the acquisition and conversion are done before the next trigger.
+*   - Sampler DMA: the result is read before the next result is ready.
+*   - DW: if both DMA channels share the same DW, both fit in one trigger.
+*   The DW timings are estimates, see the PLANNER_DW_... constants.
+*   It also checks the AMux and Sampler settings match, otherwise the samples
+*   would end up in the wrong channels.
+*   Only the slots enabled by the channel mask of the AMux are scanned, see 
+*   AMux_SetChannelMask(). A mask change not applied yet is taken as active.
+*   This function shall be called after AMux_SetupDMA(), Sampler_SetScanRate()
+*   and Sampler_SetupDMA().
+*
+* Parameters:
+*   amux: AMux object
+*   sampler: sampler object
+*   result: returns the rates, latency and limiting stage.
+*
+* Return:
+*   If the configuration works, returns SUCCESS, otherwise ERROR. On error, 
+*   result->limiting_stage tells the stage that fails.
+*
+*******************************************************************************/
+en_planner_status_t Planner_Check(amux_t *amux, sampler_t *sampler, planner_result_t *result)
+{
+    uint32_t stage_cycles[PLANNER_NUM_STAGES] = { 0 };
+    uint32_t clk_hz;
+    uint32_t num_slots;
+    uint32_t num_active = 0;
+    uint32_t mask;
+    uint32_t frame_triggers = 0;
+    uint32_t max_desc = 0;
+    uint32_t trigger_cycles;
+    uint32_t compare_cycles;
+    uint32_t acq_cycles;
+    uint32_t amux_cycles;
+    uint32_t sampler_cycles;
+    uint32_t min_cycles;
+    uint8_t conn;
+    uint8_t prev_conn;
+
+    if (amux == NULL || sampler == NULL || result == NULL || sampler->timer_base == NULL)
+    {
+        return PLANNER_ERROR;
+    }
+
+    result->max_scan_rate_hz = 0;
+    result->frame_rate_hz = 0;
+    result->max_frame_rate_hz = 0;
+    result->frame_latency_ns = 0;
+    result->limiting_stage = PLANNER_STAGE_CONFIG;
+
+    clk_hz = cyhal_clock_get_frequency(&CYHAL_CLOCK_PERI);
+    if (clk_hz == 0 || sampler->scan_rate_hz == 0)
+    {
+        return PLANNER_ERROR;
+    }
+
+    /* The Sampler frame shall follow the AMux schedule, slot by slot */
+    num_slots = AMux_GetScheduleLength(amux);
+    if (num_slots == 0 || num_slots != sampler->num_channels)
+    {
+        return PLANNER_ERROR;
+    }
+
+    if (amux->hold_count != sampler->oversampling)
+    {
+        return PLANNER_ERROR;
+    }
+
+    for (uint32_t i = 0; i < num_slots; i++)
+    {
+        conn = AMux_GetSlotConnection(amux, i);
+        if (amux->settle_count[conn] != sampler->discard_count[i])
+        {
+            return PLANNER_ERROR;
+        }
+    }
+
+    /* The disabled slots take no trigger, and the DMA switches from the last
+     * enabled slot to the next one */
+    mask = (amux->pending_chain != NULL) ? amux->pending_mask : amux->channel_mask;
+    prev_conn = 0;
+    for (uint32_t i = 0; i < num_slots; i++)
+    {
+        if (AMUX_SLOT_ENABLED(mask, i))
+        {
+            prev_conn = AMux_GetSlotConnection(amux, i);
+        }
+    }
+
+    for (uint32_t i = 0; i < num_slots; i++)
+    {
+        if (!AMUX_SLOT_ENABLED(mask, i))
+        {
+            continue;
+        }
+
+        conn = AMux_GetSlotConnection(amux, i);
+        num_active++;
+        frame_triggers += amux->hold_count * (1u + amux->settle_count[conn]);
+
+        /* Switching between HSIOM registers takes a clear and a set */
+        if (amux->connect_port[prev_conn] != amux->connect_port[conn])
+        {
+            max_desc = 2;
+        }
+        else if (max_desc == 0)
+        {
+            max_desc = 1;
+        }
+        prev_conn = conn;
+    }
+
+    if (num_active == 0)
+    {
+        return PLANNER_ERROR;
+    }
+
+    /* The timer counts from 0 to the period, included */
+    trigger_cycles = Cy_TCPWM_PWM_GetPeriod0(sampler->timer_base, sampler->timer_chan) + 1u;
+    compare_cycles = Cy_TCPWM_PWM_GetCompare0(sampler->timer_base, sampler->timer_chan);
+    acq_cycles = (uint32_t)((((uint64_t) sampler->acq_time_ns * clk_hz) + 999999999u) / 1000000000u);
+
+    /* The pin shall not be switched during the acquisition */
+    if (compare_cycles < acq_cycles)
+    {
+        result->limiting_stage = PLANNER_STAGE_TIMER;
+        return PLANNER_ERROR;
+    }
+
+    amux_cycles = PLANNER_DW_TRIGGER_CYCLES + 
+                  (max_desc * (PLANNER_DW_DESCRIPTOR_CYCLES + PLANNER_DW_ELEMENT_CYCLES));
+    sampler_cycles = PLANNER_DW_TRIGGER_CYCLES + PLANNER_DW_DESCRIPTOR_CYCLES + 
+                     PLANNER_DW_ELEMENT_CYCLES;
+    if (sampler->timestamp_base != NULL)
+    {
+        /* The first trigger of a frame also copies the timestamp */
+        sampler_cycles += PLANNER_DW_DESCRIPTOR_CYCLES + PLANNER_DW_ELEMENT_CYCLES;
+    }
+    if (sampler->frame_tags && num_active == 1)
+    {
+        /* The last trigger of a frame also copies the end tag, which is the 
+         * same trigger as the first one with a single channel */
+        sampler_cycles += PLANNER_DW_DESCRIPTOR_CYCLES + PLANNER_DW_ELEMENT_CYCLES;
+    }
+
+    /* Shortest trigger period each stage can handle */
+    stage_cycles[PLANNER_STAGE_TIMER] = compare_cycles + 1u;
+    stage_cycles[PLANNER_STAGE_AMUX_DMA] = compare_cycles + amux_cycles;
+    stage_cycles[PLANNER_STAGE_SAR] = acq_cycles + 
+                                      (PLANNER_SAR_CONVERSION_CLOCKS * PLANNER_SAR_CLK_DIVIDER);
+    stage_cycles[PLANNER_STAGE_SAMPLER_DMA] = (sampler_cycles + sampler->oversampling - 1u) / 
+                                              sampler->oversampling;
+    if (amux->dma_base == sampler->dma_base)
+    {
+        stage_cycles[PLANNER_STAGE_DW] = amux_cycles + sampler_cycles;
+    }
+
+    min_cycles = 0;
+    for (uint32_t stage = PLANNER_STAGE_TIMER; stage < PLANNER_NUM_STAGES; stage++)
+    {
+        if (stage_cycles[stage] > min_cycles)
+        {
+            min_cycles = stage_cycles[stage];
+            result->limiting_stage = (en_planner_stage_t) stage;
+        }
+    }
+
+    /* Sampler_SetScanRate() sets the period to the clock divided by the rate */
+    result->max_scan_rate_hz = clk_hz / (min_cycles - 1u);
+    result->max_frame_rate_hz = clk_hz / (min_cycles * frame_triggers);
+    result->frame_rate_hz = clk_hz / (trigger_cycles * frame_triggers);
+    result->frame_latency_ns = Planner_CyclesToNs(((frame_triggers - 1u) * trigger_cycles) + 
+                                                  stage_cycles[PLANNER_STAGE_SAR] + sampler_cycles, 
+                                                  clk_hz);
+
+    if (trigger_cycles < min_cycles)
+    {
+        return PLANNER_ERROR;
+    }
+
+    return PLANNER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Planner_CyclesToNs
+********************************************************************************
+* Summary:
+*   Convert a number of peripheral clock cycles to nanoseconds.
+*
+* Parameters:
+*   cycles: number of cycles
+*   clk_hz: peripheral clock frequency
+*
+* Return:
+*   Time in nanoseconds.
+*
+*******************************************************************************/
+static uint32_t Planner_CyclesToNs(uint32_t cycles, uint32_t clk_hz)
+{
+    return (uint32_t)(((uint64_t) cycles * 1000000000u) / clk_hz);
+}
+
+
+/* [] END OF FILE */
\ No newline at end of file
@@ -0,0 +1,139 @@
+/*****************************************************************************
+* File Name  : planner.h
+*
+* Description: This file contains definitions of constants and structures for
+*              the scan rate planner of the AMux and Sampler.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PLANNER_H_
+#define PLANNER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "cy_pdl.h"
+#include "amux.h"
+#include "sampler.h"
+
+/*******************************************************************************
+*                              Enumerated Types
+*******************************************************************************/
+typedef enum
+{
+    /** Return success */
+    PLANNER_SUCCESS = 0u,
+
+    /** Return error */
+    PLANNER_ERROR = 1u,
+
+} en_planner_status_t;
+
+typedef enum
+{
+    /** AMux and Sampler settings do not match, samples would be misaligned */
+    PLANNER_STAGE_CONFIG = 0u,
+
+    /** Timer compare, the acquisition time does not fit in the trigger period */
+    PLANNER_STAGE_TIMER = 1u,
+
+    /** AMux DMA, the next pin is not connected before the next trigger */
+    PLANNER_STAGE_AMUX_DMA = 2u,
+
+    /** SAR ADC, the conversion is not done before the next trigger */
+    PLANNER_STAGE_SAR = 3u,
+
+    /** Sampler DMA, the result is not read before the next one is ready */
+    PLANNER_STAGE_SAMPLER_DMA = 4u,
+
+    /** Shared DW, both DMA channels do not fit in one trigger period */
+    PLANNER_STAGE_DW = 5u,
+
+} en_planner_stage_t;
+
+/*******************************************************************************
+*                                 API Constants
+*******************************************************************************/
+/* SAR ADC clock divider from the peripheral clock, as set in the device 
+ * configurator (CYBSP_SAR_CLK_DIV) */
+#ifndef PLANNER_SAR_CLK_DIVIDER
+    #define PLANNER_SAR_CLK_DIVIDER        (6u)
+#endif
+
+/* SAR ADC clocks to convert one 12-bit sample, after the acquisition */
+#ifndef PLANNER_SAR_CONVERSION_CLOCKS
+    #define PLANNER_SAR_CONVERSION_CLOCKS  (14u)
+#endif
+
+/* Estimated DW cycles, in peripheral clock cycles, to accept a trigger, to 
+ * load a descriptor and to move one element */
+#ifndef PLANNER_DW_TRIGGER_CYCLES
+    #define PLANNER_DW_TRIGGER_CYCLES      (4u)
+#endif
+
+#ifndef PLANNER_DW_DESCRIPTOR_CYCLES
+    #define PLANNER_DW_DESCRIPTOR_CYCLES   (8u)
+#endif
+
+#ifndef PLANNER_DW_ELEMENT_CYCLES
+    #define PLANNER_DW_ELEMENT_CYCLES      (4u)
+#endif
+
+/*******************************************************************************
+*                              Type Definitions
+*******************************************************************************/
+/** Result Structure */
+typedef struct
+{
+    /* Highest trigger rate all the stages can sustain */
+    uint32_t max_scan_rate_hz;
+    /* Frame rate, which is the rate of each schedule slot, at the configured
+     * and at the highest scan rate */
+    uint32_t frame_rate_hz;
+    uint32_t max_frame_rate_hz;
+    /* Time from the first trigger of a frame to its last sample stored */
+    uint32_t frame_latency_ns;
+    /* Stage that limits the scan rate, or that fails with the configured 
+     * scan rate */
+    en_planner_stage_t limiting_stage;
+
+} planner_result_t;
+
+/*******************************************************************************
+*                            Function Prototypes
+*******************************************************************************/
+en_planner_status_t Planner_Check(amux_t *amux, sampler_t *sampler, planner_result_t *result);
+
+
+#endif /* PLANNER_H_ */
\ No newline at end of file
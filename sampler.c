@@ -36,31 +36,88 @@
 * indemnify Cypress against all liability.
 *****************************************************************************/
 
+#include <string.h>
+
 #include "sampler.h"
 #include "cyhal.h"
 
 /*******************************************************************************
 * Constants
 *******************************************************************************/
+#define SAMPLER_DEFAULT_TIMER_PERIOD   (32768u)
+#define SAMPLER_DEFAULT_TIMER_COMPARE  (16384u)
+
+/* The number of channels is stored in 8 bits */
+_Static_assert(SAMPLER_MAX_NUM_CHANNELS <= UINT8_MAX, "SAMPLER_MAX_NUM_CHANNELS exceeds 255");
+
+/* The descriptors of each buffer start at a fixed index, so the ones of the 
+ * idle buffer can be rebuilt while the DMA writes the other one */
+#define SAMPLER_BUFFER_DESCRIPTORS(sampler)     ((uint32_t)(sampler)->max_desc / SAMPLER_NUM_BUFFERS)
+
+#if (SAMPLER_MAX_NUM_CHANNELS > SAMPLER_MAX_MASK_CHANNELS)
+    /* Channels past the mask are always written */
+    #define SAMPLER_CHANNEL_ENABLED(mask, ch)   (((ch) >= SAMPLER_MAX_MASK_CHANNELS) || \
+                                                 ((((mask) >> (ch)) & 1u) != 0u))
+#else
+    #define SAMPLER_CHANNEL_ENABLED(mask, ch)   ((((mask) >> (ch)) & 1u) != 0u)
+#endif
 
 /*******************************************************************************
 * Local Functions
 *******************************************************************************/
+static uint32_t Sampler_CountFrameDescriptors(sampler_t *sampler, uint32_t mask);
+static uint32_t Sampler_SetupFrameDescriptors(sampler_t *sampler, int16_t *frame, 
+                                              uint32_t buffer, uint32_t first, uint32_t mask);
+static cy_stc_dma_descriptor_t *Sampler_SetupBuffer(sampler_t *sampler, uint32_t index, uint32_t mask);
+static void Sampler_SetupChain(sampler_t *sampler, uint32_t mask);
+static void Sampler_UpdateChannelMask(sampler_t *sampler, uint32_t buffer);
+static bool Sampler_RingScheduleStop(sampler_t *sampler);
+static void Sampler_RingCaptureComplete(sampler_t *sampler);
 
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
-cy_stc_dma_descriptor_t sampler_dma_descriptor;
+/* PWM mode, so the period and compare buffers are swapped at the terminal 
+ * count. The counter mode has no period buffer. */
+const cy_stc_tcpwm_pwm_config_t sampler_timer_config = 
+{
+    .pwmMode = CY_TCPWM_PWM_MODE_PWM,
+    .clockPrescaler = CY_TCPWM_PWM_PRESCALER_DIVBY_1,
+    .pwmAlignment = CY_TCPWM_PWM_LEFT_ALIGN,
+    .deadTimeClocks = 0,
+    .runMode = CY_TCPWM_PWM_CONTINUOUS,
+    .period0 = SAMPLER_DEFAULT_TIMER_PERIOD,
+    .period1 = SAMPLER_DEFAULT_TIMER_PERIOD,
+    .enablePeriodSwap = true,
+    .compare0 = SAMPLER_DEFAULT_TIMER_COMPARE,
+    .compare1 = SAMPLER_DEFAULT_TIMER_COMPARE,
+    .enableCompareSwap = true,
+    .interruptSources = CY_TCPWM_INT_NONE,
+    .invertPWMOut = CY_TCPWM_PWM_INVERT_DISABLE,
+    .invertPWMOutN = CY_TCPWM_PWM_INVERT_DISABLE,
+    .killMode = CY_TCPWM_PWM_STOP_ON_KILL,
+    .swapInputMode = 0x3U,
+    .swapInput = CY_TCPWM_INPUT_0,
+    .reloadInputMode = 0x3U,
+    .reloadInput = CY_TCPWM_INPUT_0,
+    .startInputMode = 0x3U,
+    .startInput = CY_TCPWM_INPUT_0,
+    .killInputMode = 0x3U,
+    .killInput = CY_TCPWM_INPUT_0,
+    .countInputMode = 0x3U,
+    .countInput = CY_TCPWM_INPUT_1,
+};
 
-const cy_stc_tcpwm_counter_config_t sampler_timer_config = 
+/* Free-running, wraps around at the maximum period */
+const cy_stc_tcpwm_counter_config_t sampler_timestamp_config = 
 {
-    .period = 32768,
+    .period = 0xFFFFFFFFu,
     .clockPrescaler = CY_TCPWM_COUNTER_PRESCALER_DIVBY_1,
     .runMode = CY_TCPWM_COUNTER_CONTINUOUS,
     .countDirection = CY_TCPWM_COUNTER_COUNT_UP,
     .compareOrCapture = CY_TCPWM_COUNTER_MODE_COMPARE,
-    .compare0 = 16384,
-    .compare1 = 16384,
+    .compare0 = 0,
+    .compare1 = 0,
     .enableCompareSwap = false,
     .interruptSources = CY_TCPWM_INT_NONE,
     .captureInputMode = 0x3U,
@@ -78,7 +135,7 @@ const cy_stc_tcpwm_counter_config_t sampler_timer_config =
 const cy_stc_dma_descriptor_config_t sampler_dma_descriptor_config = 
 {
     .retrigger = CY_DMA_RETRIG_IM,
-    .interruptType = CY_DMA_1ELEMENT,
+    .interruptType = CY_DMA_DESCR,
     .triggerOutType = CY_DMA_1ELEMENT,
     .channelState = CY_DMA_CHANNEL_ENABLED,
     .triggerInType = CY_DMA_1ELEMENT,
@@ -94,12 +151,36 @@ const cy_stc_dma_descriptor_config_t sampler_dma_descriptor_config =
     .srcYincrement = 0,
     .dstYincrement = 0,
     .yCount = 1,
-    .nextDescriptor = &sampler_dma_descriptor,
+    .nextDescriptor = NULL,
+};
+
+/* Copies the timestamp counter and goes on with the first sample of the frame
+ * on the same trigger */
+const cy_stc_dma_descriptor_config_t sampler_dma_timestamp_config = 
+{
+    .retrigger = CY_DMA_RETRIG_IM,
+    .interruptType = CY_DMA_DESCR_CHAIN,
+    .triggerOutType = CY_DMA_1ELEMENT,
+    .channelState = CY_DMA_CHANNEL_ENABLED,
+    .triggerInType = CY_DMA_DESCR_CHAIN,
+    .dataSize = CY_DMA_WORD,
+    .srcTransferSize = CY_DMA_TRANSFER_SIZE_WORD,
+    .dstTransferSize = CY_DMA_TRANSFER_SIZE_WORD,
+    .descriptorType = CY_DMA_SINGLE_TRANSFER,
+    .srcAddress = NULL,
+    .dstAddress = NULL,
+    .srcXincrement = 0,
+    .dstXincrement = 0,
+    .xCount = 1,
+    .srcYincrement = 0,
+    .dstYincrement = 0,
+    .yCount = 1,
+    .nextDescriptor = NULL,
 };
 
 const cy_stc_dma_channel_config_t sampler_dma_channel_config = 
 {
-    .descriptor = &sampler_dma_descriptor,
+    .descriptor = NULL,
     .preemptable = false,
     .priority = 3,
     .enable = false,
@@ -113,6 +194,8 @@ const cy_stc_dma_channel_config_t sampler_dma_channel_config =
 *   Initialize an Sampler object using the given SAR ADC and timer. The timer
 *   has to trigger the SAR ADC conversion on overflow. It also assumes the timer
 *   runs based on the maximum peripheral clock frequency, typically 100 MHz.
+*   The timer is set to the PWM mode, whatever its personality in the device
+*   configurator, so the scan rate can be changed while sampling.
 *   The SAR ADC has to be initialized by the application with at least one channel. 
 *   This middleware only look at the first channel of the SAR ADC. Any additional
 *   SAR ADC channel shall be handled externally.
@@ -136,15 +219,37 @@ en_sampler_status_t Sampler_Init(sampler_t *sampler, SAR_Type *sar,
     }
 
     /* Initialize the timer */
-    if ( CY_TCPWM_SUCCESS != Cy_TCPWM_Counter_Init(timer, timer_chan, &sampler_timer_config))
+    if ( CY_TCPWM_SUCCESS != Cy_TCPWM_PWM_Init(timer, timer_chan, &sampler_timer_config))
     {
         return SAMPLER_ERROR;
     }
 
     /* Set to default initial values */
     sampler->num_channels = 0;
+    sampler->scan_rate_hz = 0;
+    sampler->acq_time_ns = 0;
+    sampler->timer_period = SAMPLER_DEFAULT_TIMER_PERIOD;
+    sampler->timer_compare = SAMPLER_DEFAULT_TIMER_COMPARE;
+    sampler->oversampling = 1;
+    memset(sampler->discard_count, 0, sizeof(sampler->discard_count));
+    sampler->mode = SAMPLER_MODE_SINGLE;
     sampler->dma_base = NULL;
     sampler->samples_ptr = NULL;
+    sampler->pong_ptr = NULL;
+    sampler->callback = NULL;
+    sampler->callback_arg = NULL;
+    sampler->frame_count = 0;
+    sampler->ring_frames = 0;
+    sampler->capture_state = SAMPLER_CAPTURE_IDLE;
+    sampler->timestamp_base = NULL;
+    memset((void *) sampler->timestamp, 0, sizeof(sampler->timestamp));
+    sampler->frame_tags = false;
+    sampler->missed_triggers = 0;
+    sampler->dma_errors = 0;
+    sampler->channel_mask = SAMPLER_ALL_CHANNELS;
+    sampler->mask_state = SAMPLER_MASK_IDLE;
+    sampler->dma_desc = NULL;
+    sampler->max_desc = 0;
 
     /* Set values based on the arguments */
     sampler->sar_base = sar;
@@ -172,8 +277,16 @@ void Sampler_Deinit(sampler_t *sampler)
     }
 
     /* Deinit internal timer */
-    Cy_TCPWM_Counter_Disable(sampler->timer_base, sampler->timer_chan);
-    Cy_TCPWM_Counter_DeInit(sampler->timer_base, sampler->timer_chan, &sampler_timer_config);
+    Cy_TCPWM_PWM_Disable(sampler->timer_base, sampler->timer_chan);
+    Cy_TCPWM_PWM_DeInit(sampler->timer_base, sampler->timer_chan, &sampler_timer_config);
+
+    /* Deinit the timestamp counter */
+    if (sampler->timestamp_base != NULL)
+    {
+        Cy_TCPWM_Counter_Disable(sampler->timestamp_base, sampler->timestamp_chan);
+        Cy_TCPWM_Counter_DeInit(sampler->timestamp_base, sampler->timestamp_chan, 
+                                &sampler_timestamp_config);
+    }
 
     /* Denit any DMA channel used */
     if (sampler->dma_base != NULL)
@@ -184,9 +297,15 @@ void Sampler_Deinit(sampler_t *sampler)
 
     /* Set to default initial values */
     sampler->num_channels = 0;
+    sampler->mode = SAMPLER_MODE_SINGLE;
     sampler->dma_base = NULL;
     sampler->samples_ptr = NULL;
+    sampler->pong_ptr = NULL;
+    sampler->callback = NULL;
+    sampler->ring_frames = 0;
     sampler->timer_base = NULL;
+    sampler->timestamp_base = NULL;
+    sampler->frame_tags = false;
 
 }
 
@@ -200,6 +319,12 @@ void Sampler_Deinit(sampler_t *sampler)
 *   extracted from the device configurator in the SAR ADC personality. This 
 *   information is used in the timer, which generates an external signal for 
 *   a analog mux, for example. 
+*   While sampling, the new period and compare are written to the timer 
+*   buffers, and swapped with the active ones at the next terminal count. 
+*   Every period then still has one compare and one overflow, so the AMux 
+*   and Sampler DMAs stay in step and do not need to be restarted. A second 
+*   change is refused until the first one is applied, at most one period
+*   later.
 *
 * Parameters:
 *   sampler: sampler object
@@ -207,7 +332,8 @@ void Sampler_Deinit(sampler_t *sampler)
 *   acq_time_ns: acquisition time in nanoseconds
 *
 * Return:
-*   If set correctly, returns SUCCESS, otherwise ERROR.
+*   If set correctly, returns SUCCESS, BUSY if the previous change is not 
+*   applied yet, otherwise ERROR.
 *
 *******************************************************************************/
 en_sampler_status_t Sampler_SetScanRate(sampler_t *sampler, uint32_t scan_rate_hz, 
@@ -233,144 +359,1797 @@ en_sampler_status_t Sampler_SetScanRate(sampler_t *sampler, uint32_t scan_rate_h
     timer_period = timer_clk_hz/scan_rate_hz;
     timer_compare = (((timer_clk_hz+500000)/1000000) * acq_time_ns)/1000;
 
-    Cy_TCPWM_Counter_SetPeriod(sampler->timer_base, sampler->timer_chan, timer_period);
-    Cy_TCPWM_Counter_SetCompare0(sampler->timer_base, sampler->timer_chan, timer_compare);
+    /* The pin shall be switched within the period */
+    if (timer_compare >= timer_period)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if ((Cy_TCPWM_PWM_GetStatus(sampler->timer_base, sampler->timer_chan) &
+         CY_TCPWM_PWM_STATUS_COUNTER_RUNNING) != 0u)
+    {
+        /* The swap of the previous change is still pending */
+        if (Cy_TCPWM_PWM_GetPeriod0(sampler->timer_base, sampler->timer_chan) != sampler->timer_period ||
+            Cy_TCPWM_PWM_GetCompare0(sampler->timer_base, sampler->timer_chan) != sampler->timer_compare)
+        {
+            return SAMPLER_BUSY;
+        }
+
+        Cy_TCPWM_PWM_SetPeriod1(sampler->timer_base, sampler->timer_chan, timer_period);
+        Cy_TCPWM_PWM_SetCompare1(sampler->timer_base, sampler->timer_chan, timer_compare);
+        Cy_TCPWM_TriggerCaptureOrSwap_Single(sampler->timer_base, sampler->timer_chan);
+    }
+    else
+    {
+        Cy_TCPWM_PWM_SetPeriod0(sampler->timer_base, sampler->timer_chan, timer_period);
+        Cy_TCPWM_PWM_SetPeriod1(sampler->timer_base, sampler->timer_chan, timer_period);
+        Cy_TCPWM_PWM_SetCompare0(sampler->timer_base, sampler->timer_chan, timer_compare);
+        Cy_TCPWM_PWM_SetCompare1(sampler->timer_base, sampler->timer_chan, timer_compare);
+    }
+
+    sampler->timer_period = timer_period;
+    sampler->timer_compare = timer_compare;
+    sampler->scan_rate_hz = scan_rate_hz;
+    sampler->acq_time_ns = acq_time_ns;
 
     return SAMPLER_SUCCESS;
 }
 
 /*******************************************************************************
-* Function Name: Sampler_Configure
+* Function Name: Sampler_SetOversampling
 ********************************************************************************
 * Summary:
-*   Configure the number of samples to acquire and where to place them.
-*   The data is provided as 16-bits and the array storing should be allocated
-*   by the application. It shall be large enough to accomodate the desired
-*   number of channels.
+*   Average a number of conversions per channel in the SAR ADC hardware. The 
+*   SAR ADC is set to interleaved averaging on its first channel, so it only
+*   ends a scan, and triggers the DMA, after ratio conversions. The sampled 
+*   pins shall then be held for ratio triggers with AMux_SetHoldCount(). The 
+*   result is shifted to keep 12-bit samples. The frame rate becomes the scan 
+*   rate divided by the number of channels and the ratio.
+*   The DW cannot add values, so the averaging is left to the SAR ADC and the
+*   DMA keeps moving one result per channel.
 *
 * Parameters:
 *   sampler: sampler object
-*   num_channels: number of channels
-*   samples: array with samples to be stored.
+*   ratio: number of conversions per sample, a power of two up to 
+*          SAMPLER_MAX_OVERSAMPLING. Set to 1 to disable the averaging.
 *
 * Return:
-*   If connected correctly, returns SUCCESS, otherwise ERROR.
+*   If set correctly, returns SUCCESS, otherwise ERROR.
 *
 *******************************************************************************/
-en_sampler_status_t Sampler_Configure(sampler_t *sampler, uint8_t num_channels, 
-                                                          int16_t *samples)
+en_sampler_status_t Sampler_SetOversampling(sampler_t *sampler, uint16_t ratio)
+{
+    uint32_t avg_cnt = 0;
+
+    if (sampler == NULL || sampler->sar_base == NULL)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    /* The SAR ADC averages 2^(AVG_CNT+1) conversions */
+    if (ratio == 0 || ratio > SAMPLER_MAX_OVERSAMPLING || (ratio & (ratio - 1)) != 0)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if (ratio == 1)
+    {
+        sampler->sar_base->CHAN_CONFIG[0] &= ~SAR_CHAN_CONFIG_AVG_EN_Msk;
+    }
+    else
+    {
+        while ((2u << avg_cnt) < ratio)
+        {
+            avg_cnt++;
+        }
+
+        CY_REG32_CLR_SET(sampler->sar_base->SAMPLE_CTRL, SAR_SAMPLE_CTRL_AVG_CNT, avg_cnt);
+        CY_REG32_CLR_SET(sampler->sar_base->SAMPLE_CTRL, SAR_SAMPLE_CTRL_AVG_SHIFT, 1u);
+        CY_REG32_CLR_SET(sampler->sar_base->SAMPLE_CTRL, SAR_SAMPLE_CTRL_AVG_MODE, 1u);
+        sampler->sar_base->CHAN_CONFIG[0] |= SAR_CHAN_CONFIG_AVG_EN_Msk;
+    }
+
+    sampler->oversampling = ratio;
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_SetDiscardCount
+********************************************************************************
+* Summary:
+*   Set the number of samples to throw away before the sample of the given 
+*   channel is stored. It is used for pins that need more settling time than 
+*   the acquisition time, together with AMux_SetSettleCount(), which shall 
+*   hold the pin for the same number of extra samples. Only the slow channels
+*   then take longer, instead of lowering the scan rate of all channels.
+*   This function shall be called before Sampler_SetupDMA(). It is not 
+*   supported in the ring mode.
+*
+* Parameters:
+*   sampler: sampler object
+*   channel: channel index in the frame
+*   count: number of samples to discard, up to SAMPLER_MAX_DISCARD_COUNT.
+*
+* Return:
+*   If set correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_SetDiscardCount(sampler_t *sampler, uint8_t channel, uint16_t count)
 {
     if (sampler == NULL)
     {
         return SAMPLER_ERROR;
-    } 
+    }
 
-    if (num_channels > SAMPLER_MAX_NUM_CHANNELS)
+    if (channel >= SAMPLER_MAX_NUM_CHANNELS || count > SAMPLER_MAX_DISCARD_COUNT)
     {
         return SAMPLER_ERROR;
     }
 
-    sampler->samples_ptr = samples;
-    sampler->num_channels = num_channels;
+    sampler->discard_count[channel] = count;
 
     return SAMPLER_SUCCESS;
 }
 
 /*******************************************************************************
-* Function Name: Sampler_Start
+* Function Name: Sampler_SetTimestampTimer
 ********************************************************************************
 * Summary:
-*   Start sampling by enabling the internal timer and SAR ADC.
+*   Timestamp every frame with a free-running counter. The counter is started 
+*   by this function and counts the peripheral clock. At the first conversion
+*   of a frame, the DMA copies the counter next to the frame, before storing
+*   the first sample, so the timestamp does not depend on when the CPU handles
+*   the frame. It is given to the callback in the event, and the application 
+*   gets the current time with Sampler_GetTimestamp() to compute the age of 
+*   the frame. Use a 32-bit counter, a 16-bit one wraps around every 65536 
+*   clocks. This function shall be called before Sampler_SetupDMA(). It is not
+*   supported in the ring mode.
 *
-* Paramters:
+* Parameters:
 *   sampler: sampler object
+*   timer: TCPWM base pointer of the counter, NULL to disable the timestamps
+*   timer_chan: TCPWM channel of the counter, not the one of the scan timer
 *
 * Return:
-*   If connected correctly, returns SUCCESS, otherwise ERROR.
+*   If set correctly, returns SUCCESS, otherwise ERROR.
 *
 *******************************************************************************/
-en_sampler_status_t Sampler_Start(sampler_t *sampler)
+en_sampler_status_t Sampler_SetTimestampTimer(sampler_t *sampler, TCPWM_Type *timer, uint8_t timer_chan)
 {
-    if (sampler == NULL || sampler->sar_base == NULL || sampler->timer_base == NULL)
+    if (sampler == NULL || sampler->timer_base == NULL)
     {
         return SAMPLER_ERROR;
-    } 
+    }
 
-    Cy_SAR_Enable(sampler->sar_base);
-    Cy_DMA_Channel_Enable(sampler->dma_base, sampler->dma_chan);
-    Cy_DMA_Enable(sampler->dma_base);
-    Cy_TCPWM_Counter_SetCounter(sampler->timer_base, sampler->timer_chan, 0);
-    Cy_TCPWM_Counter_Enable(sampler->timer_base, sampler->timer_chan);
-    Cy_TCPWM_TriggerStart_Single(sampler->timer_base, sampler->timer_chan);
+    if (timer == sampler->timer_base && timer_chan == sampler->timer_chan)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if (sampler->timestamp_base != NULL)
+    {
+        Cy_TCPWM_Counter_Disable(sampler->timestamp_base, sampler->timestamp_chan);
+        Cy_TCPWM_Counter_DeInit(sampler->timestamp_base, sampler->timestamp_chan, 
+                                &sampler_timestamp_config);
+        sampler->timestamp_base = NULL;
+    }
+
+    if (timer == NULL)
+    {
+        /* The frame tags are copies of the timestamps */
+        sampler->frame_tags = false;
+        return SAMPLER_SUCCESS;
+    }
+
+    if (CY_TCPWM_SUCCESS != Cy_TCPWM_Counter_Init(timer, timer_chan, &sampler_timestamp_config))
+    {
+        return SAMPLER_ERROR;
+    }
+
+    Cy_TCPWM_Counter_Enable(timer, timer_chan);
+    Cy_TCPWM_TriggerStart_Single(timer, timer_chan);
+
+    sampler->timestamp_base = timer;
+    sampler->timestamp_chan = timer_chan;
 
     return SAMPLER_SUCCESS;
 }
 
 /*******************************************************************************
-* Function Name: Sampler_Stop
+* Function Name: Sampler_GetTimestamp
 ********************************************************************************
 * Summary:
-*   Stop sampling by disabling the internal timer and SAR ADC.
+*   Get the current value of the timestamp counter. The age of a frame, in 
+*   peripheral clocks, is this value minus the timestamp of the frame, 
+*   computed with unsigned arithmetic to handle the wrap around.
 *
-* Paramters:
-*   sampler_t: sampler object
+* Parameters:
+*   sampler: sampler object
 *
 * Return:
-*   If disconnected correctly, returns SUCCESS, otherwise ERROR.
+*   Counter value, 0 if the timestamps are not enabled.
 *
 *******************************************************************************/
-en_sampler_status_t Sampler_Stop(sampler_t *sampler)
+uint32_t Sampler_GetTimestamp(sampler_t *sampler)
 {
-    if (sampler == NULL || sampler->sar_base == NULL || sampler->timer_base == NULL)
+    if (sampler == NULL || sampler->timestamp_base == NULL)
+    {
+        return 0;
+    }
+
+    return Cy_TCPWM_Counter_GetCounter(sampler->timestamp_base, sampler->timestamp_chan);
+}
+
+/*******************************************************************************
+* Function Name: Sampler_SetFrameTags
+********************************************************************************
+* Summary:
+*   Tag the frames so they can be read while the DMA is running. The timestamp
+*   written by the DMA before the first sample is the begin tag, and the DMA 
+*   copies it to an end tag right after the last sample, on the same trigger.
+*   A frame read between two equal tags, the end tag first, was not changed 
+*   by the DMA, see Sampler_ReadFrame(). The timestamps shall be enabled with 
+*   Sampler_SetTimestampTimer() first. This function shall be called before 
+*   Sampler_SetupDMA(). It is not supported in the ring mode.
+*
+* Parameters:
+*   sampler: sampler object
+*   enable: true to write the tags
+*
+* Return:
+*   If set correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_SetFrameTags(sampler_t *sampler, bool enable)
+{
+    if (sampler == NULL)
     {
         return SAMPLER_ERROR;
-    } 
+    }
 
-    Cy_DMA_Channel_Disable(sampler->dma_base, sampler->dma_chan);
-    Cy_SAR_Disable(sampler->sar_base);
-    Cy_TCPWM_Counter_Disable(sampler->timer_base, sampler->timer_chan);
+    if (enable && sampler->timestamp_base == NULL)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    sampler->frame_tags = enable;
 
     return SAMPLER_SUCCESS;
 }
 
 /*******************************************************************************
-* Function Name: Sampler_SetupDMA
+* Function Name: Sampler_ReadFrame
 ********************************************************************************
 * Summary:
-*   Setup a DMA to change the AMux connections without the CPU. 
-*   This function shall only be called after AMux_AddPort() was executed for 
-*   all connections.
+*   Copy the last frame stored in a buffer without stopping the DMA nor 
+*   disabling the interrupts, seqlock style. The end tag is read before the 
+*   samples and the begin tag after them. If they differ, the DMA started a 
+*   new frame in the buffer during the copy, or has not completed one yet, 
+*   and the copy shall be retried or dropped. It needs the frame tags, see 
+*   Sampler_SetFrameTags(). The begin tag is a 32-bit counter, so a frame is 
+*   wrongly accepted only if the copy is preempted for exactly a multiple of 
+*   2^32 peripheral clocks.
 *
 * Parameters:
-*   amux: AMux object
-*   dma_base: DW base
-*   dma_chan: DW channel
+*   sampler: sampler object
+*   buffer: buffer to read, 0 in the single mode, 0 or 1 in the ping-pong mode
+*   frame: returns the samples, num_channels of them
+*   timestamp: returns the timestamp of the frame, can be NULL
 *
 * Return:
-*   If setup correctly, returns SUCCESS, otherwise ERROR.
+*   If the copy is intact, returns SUCCESS, otherwise ERROR.
 *
 *******************************************************************************/
-en_sampler_status_t Sampler_SetupDMA(sampler_t *sampler, DW_Type *dma_base, uint32_t dma_chan)
+en_sampler_status_t Sampler_ReadFrame(sampler_t *sampler, uint8_t buffer, int16_t *frame, uint32_t *timestamp)
 {
-    if (sampler == NULL || sampler->sar_base == NULL || sampler->timer_base == NULL)
+    const volatile int16_t *samples;
+    uint32_t end_tag;
+    uint32_t begin_tag;
+
+    if (sampler == NULL || frame == NULL || !sampler->frame_tags)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if ((sampler->mode != SAMPLER_MODE_PING_PONG && buffer != 0) || buffer >= SAMPLER_NUM_BUFFERS)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    samples = (buffer == 0) ? sampler->samples_ptr : sampler->pong_ptr;
+
+    end_tag = sampler->timestamp_end[buffer];
+    __DMB();
+    for (uint32_t ch = 0; ch < sampler->num_channels; ch++)
+    {
+        frame[ch] = samples[ch];
+    }
+    __DMB();
+    begin_tag = sampler->timestamp[buffer];
+
+    if (end_tag != begin_tag)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if (timestamp != NULL)
+    {
+        *timestamp = begin_tag;
+    }
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_Configure
+********************************************************************************
+* Summary:
+*   Configure the number of samples to acquire and where to place them.
+*   The data is provided as 16-bits and the array storing should be allocated
+*   by the application. It shall be large enough to accomodate the desired
+*   number of channels.
+*
+* Parameters:
+*   sampler: sampler object
+*   num_channels: number of channels
+*   samples: array with samples to be stored.
+*
+* Return:
+*   If connected correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_Configure(sampler_t *sampler, uint8_t num_channels, 
+                                                          int16_t *samples)
+{
+    if (sampler == NULL)
     {
         return SAMPLER_ERROR;
     } 
 
-    sampler->dma_base = dma_base;
-    sampler->dma_chan = dma_chan;
+    if (num_channels > SAMPLER_MAX_NUM_CHANNELS)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    sampler->mode = SAMPLER_MODE_SINGLE;
+    sampler->samples_ptr = samples;
+    sampler->pong_ptr = NULL;
+    sampler->ring_frames = 0;
+    sampler->num_channels = num_channels;
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_ConfigurePingPong
+********************************************************************************
+* Summary:
+*   Configure the number of samples to acquire and two buffers to place them.
+*   The DMA fills the buffers alternately, so while one buffer is being written
+*   the other holds the last complete frame. Both arrays are allocated by the
+*   application and shall be large enough to accomodate the desired number of
+*   channels.
+*
+* Parameters:
+*   sampler: sampler object
+*   num_channels: number of channels
+*   ping: first array to store the samples.
+*   pong: second array to store the samples.
+*
+* Return:
+*   If configured correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_ConfigurePingPong(sampler_t *sampler, uint8_t num_channels,
+                                              int16_t *ping, int16_t *pong)
+{
+    if (sampler == NULL || ping == NULL || pong == NULL || ping == pong)
+    {
+        return SAMPLER_ERROR;
+    }
 
-    /* Initialize the DMA Descriptor */
-    Cy_DMA_Descriptor_Init(&sampler_dma_descriptor, &sampler_dma_descriptor_config);
-    Cy_DMA_Descriptor_SetDstAddress(&sampler_dma_descriptor, (void *) sampler->samples_ptr);
-    Cy_DMA_Descriptor_SetSrcAddress(&sampler_dma_descriptor, (void *) &sampler->sar_base->CHAN_RESULT[0]);
-    Cy_DMA_Descriptor_SetXloopDataCount(&sampler_dma_descriptor, sampler->num_channels);
+    if (num_channels > SAMPLER_MAX_NUM_CHANNELS)
+    {
+        return SAMPLER_ERROR;
+    }
 
-    /* Initialize the DMA channel */
-    Cy_DMA_Channel_Init(dma_base, dma_chan, &sampler_dma_channel_config);
+    sampler->mode = SAMPLER_MODE_PING_PONG;
+    sampler->samples_ptr = ping;
+    sampler->pong_ptr = pong;
+    sampler->ring_frames = 0;
+    sampler->num_channels = num_channels;
 
     return SAMPLER_SUCCESS;
 }
 
+/*******************************************************************************
+* Function Name: Sampler_ConfigureRing
+********************************************************************************
+* Summary:
+*   Configure the number of samples to acquire and a ring of frames to place
+*   them. The DMA fills one frame after the other and wraps around at the end
+*   of the ring, without any CPU intervention. The application drains the 
+*   completed frames with Sampler_RingGetFrames() and Sampler_RingRelease().
+*   The array is allocated by the application and shall be large enough to 
+*   accomodate num_channels * num_frames samples.
+*
+* Parameters:
+*   sampler: sampler object
+*   num_channels: number of channels per frame
+*   ring: array to store the frames.
+*   num_frames: number of frames in the ring.
+*
+* Return:
+*   If configured correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_ConfigureRing(sampler_t *sampler, uint8_t num_channels,
+                                          int16_t *ring, uint16_t num_frames)
+{
+    if (sampler == NULL || ring == NULL)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if (num_channels == 0 || num_channels > SAMPLER_MAX_NUM_CHANNELS)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if (num_frames < SAMPLER_MIN_RING_FRAMES || num_frames > SAMPLER_MAX_RING_FRAMES)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    sampler->mode = SAMPLER_MODE_RING;
+    sampler->samples_ptr = ring;
+    sampler->pong_ptr = NULL;
+    sampler->ring_frames = num_frames;
+    sampler->num_channels = num_channels;
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_ConfigureDescriptors
+********************************************************************************
+* Summary:
+*   Give the DMA descriptors Sampler_SetupDMA() builds the frames in, 
+*   allocated by the application. SAMPLER_NUM_DESCRIPTORS() of the number of
+*   channels is enough for any discard count, timestamps, frame tags and 
+*   channel mask. The ring mode only takes one descriptor. The descriptors 
+*   shall stay allocated while the DMA runs, and shall not be shared with 
+*   another object. This function shall be called before Sampler_SetupDMA().
+*
+* Parameters:
+*   sampler: sampler object
+*   descriptors: array of num_descriptors descriptors
+*   num_descriptors: number of descriptors
+*
+* Return:
+*   If configured correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_ConfigureDescriptors(sampler_t *sampler, cy_stc_dma_descriptor_t *descriptors, 
+                                                 uint16_t num_descriptors)
+{
+    if (sampler == NULL || descriptors == NULL || num_descriptors == 0)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    sampler->dma_desc = descriptors;
+    sampler->max_desc = num_descriptors;
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_RegisterCallback
+********************************************************************************
+* Summary:
+*   Register a function to be called from Sampler_IRQHandler() every time a 
+*   frame is completed. The event tells which buffer is ready to be read.
+*   Pass NULL to remove the callback.
+*
+* Parameters:
+*   sampler: sampler object
+*   callback: function to be called on events
+*   arg: user argument passed to the callback
+*
+* Return:
+*   If registered correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_RegisterCallback(sampler_t *sampler, 
+                                             sampler_callback_t callback, void *arg)
+{
+    if (sampler == NULL)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    sampler->callback_arg = arg;
+    sampler->callback = callback;
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_Start
+********************************************************************************
+* Summary:
+*   Start sampling by enabling the internal timer and SAR ADC.
+*
+* Paramters:
+*   sampler: sampler object
+*
+* Return:
+*   If connected correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_Start(sampler_t *sampler)
+{
+    if (sampler == NULL || sampler->sar_base == NULL || sampler->timer_base == NULL)
+    {
+        return SAMPLER_ERROR;
+    } 
+
+    sampler->frame_count = 0;
+    sampler->ring_wraps = 0;
+    sampler->ring_tail = 0;
+    sampler->ring_tail_slot = 0;
+    sampler->ring_overruns = 0;
+    sampler->missed_triggers = 0;
+    sampler->dma_errors = 0;
+    sampler->stats_frames = 0;
+    sampler->stats_timestamp = Sampler_GetTimestamp(sampler);
+
+    /* No frame is complete until the DMA writes the end tags */
+    for (uint32_t i = 0; i < SAMPLER_NUM_BUFFERS; i++)
+    {
+        sampler->timestamp[i] = 0;
+        sampler->timestamp_end[i] = ~0u;
+    }
+
+    /* A previous capture left the ring descriptor set to stop the DMA */
+    if (sampler->capture_state != SAMPLER_CAPTURE_ARMED)
+    {
+        sampler->capture_state = SAMPLER_CAPTURE_IDLE;
+    }
+    if (sampler->mode == SAMPLER_MODE_RING)
+    {
+        Cy_DMA_Descriptor_SetYloopDataCount(&sampler->dma_desc[0], sampler->ring_frames);
+        Cy_DMA_Descriptor_SetChannelState(&sampler->dma_desc[0], CY_DMA_CHANNEL_ENABLED);
+    }
+
+    Cy_SAR_ClearInterrupt(sampler->sar_base, CY_SAR_INTR_HW_COLLISION);
+    Cy_SAR_Enable(sampler->sar_base);
+    Cy_DMA_Channel_SetDescriptor(sampler->dma_base, sampler->dma_chan,
+                                 &sampler->dma_desc[0]);
+    Cy_DMA_Channel_Enable(sampler->dma_base, sampler->dma_chan);
+    Cy_DMA_Enable(sampler->dma_base);
+    /* A change made just before a stop may not have been swapped in */
+    Cy_TCPWM_PWM_SetPeriod0(sampler->timer_base, sampler->timer_chan, sampler->timer_period);
+    Cy_TCPWM_PWM_SetPeriod1(sampler->timer_base, sampler->timer_chan, sampler->timer_period);
+    Cy_TCPWM_PWM_SetCompare0(sampler->timer_base, sampler->timer_chan, sampler->timer_compare);
+    Cy_TCPWM_PWM_SetCompare1(sampler->timer_base, sampler->timer_chan, sampler->timer_compare);
+    Cy_TCPWM_PWM_SetCounter(sampler->timer_base, sampler->timer_chan, 0);
+    Cy_TCPWM_PWM_Enable(sampler->timer_base, sampler->timer_chan);
+    Cy_TCPWM_TriggerStart_Single(sampler->timer_base, sampler->timer_chan);
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_Stop
+********************************************************************************
+* Summary:
+*   Stop sampling by disabling the internal timer and SAR ADC.
+*
+* Paramters:
+*   sampler_t: sampler object
+*
+* Return:
+*   If disconnected correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_Stop(sampler_t *sampler)
+{
+    if (sampler == NULL || sampler->sar_base == NULL || sampler->timer_base == NULL)
+    {
+        return SAMPLER_ERROR;
+    } 
+
+    Cy_DMA_Channel_Disable(sampler->dma_base, sampler->dma_chan);
+    Cy_DMA_Channel_ClearInterrupt(sampler->dma_base, sampler->dma_chan);
+    Cy_SAR_Disable(sampler->sar_base);
+    Cy_TCPWM_PWM_Disable(sampler->timer_base, sampler->timer_chan);
+
+    /* A channel mask change not completed yet is applied at once, the AMux 
+     * moves to its new chain before the next start */
+    if (sampler->mask_state != SAMPLER_MASK_IDLE)
+    {
+        Sampler_SetupChain(sampler, sampler->pending_mask);
+        if (sampler->mask_state == SAMPLER_MASK_PENDING && sampler->mask_link != NULL)
+        {
+            Cy_DMA_Descriptor_SetNextDescriptor(sampler->mask_link, sampler->mask_link_next);
+        }
+        sampler->channel_mask = sampler->pending_mask;
+        sampler->mask_state = SAMPLER_MASK_IDLE;
+    }
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_SetupDMA
+********************************************************************************
+* Summary:
+*   Setup a DMA to change the AMux connections without the CPU. 
+*   This function shall only be called after AMux_AddPort() was executed for 
+*   all connections.
+*
+* Parameters:
+*   amux: AMux object
+*   dma_base: DW base
+*   dma_chan: DW channel
+*
+* Return:
+*   If setup correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_SetupDMA(sampler_t *sampler, DW_Type *dma_base, uint32_t dma_chan)
+{
+    cy_stc_dma_channel_config_t channel_config = sampler_dma_channel_config;
+    uint32_t num_desc;
+
+    if (sampler == NULL || sampler->sar_base == NULL || sampler->timer_base == NULL)
+    {
+        return SAMPLER_ERROR;
+    } 
+
+    if (sampler->mode == SAMPLER_MODE_PING_PONG && sampler->pong_ptr == NULL)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if (sampler->samples_ptr == NULL || sampler->num_channels == 0)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    num_desc = Sampler_CountFrameDescriptors(sampler, SAMPLER_ALL_CHANNELS);
+
+    /* The ring is a single descriptor, so it cannot discard samples nor take
+     * timestamps */
+    if (sampler->mode == SAMPLER_MODE_RING && num_desc > 1)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if (sampler->dma_desc == NULL || 
+        num_desc > ((sampler->mode == SAMPLER_MODE_PING_PONG) ? SAMPLER_BUFFER_DESCRIPTORS(sampler) : 
+                                                                sampler->max_desc))
+    {
+        return SAMPLER_ERROR;
+    }
+
+    sampler->dma_base = dma_base;
+    sampler->dma_chan = dma_chan;
+    sampler->channel_mask = SAMPLER_ALL_CHANNELS;
+    sampler->mask_state = SAMPLER_MASK_IDLE;
+
+    /* Initialize the DMA Descriptors of the buffers, the ping buffer hands 
+     * over to the pong buffer, which hands back to ping */
+    Sampler_SetupChain(sampler, SAMPLER_ALL_CHANNELS);
+
+    if (sampler->mode == SAMPLER_MODE_RING)
+    {
+        /* The Y loop walks the frames of the ring, so the descriptor only 
+         * completes, and loops back to itself, once per ring */
+        Cy_DMA_Descriptor_SetDescriptorType(&sampler->dma_desc[0], CY_DMA_2D_TRANSFER);
+        Cy_DMA_Descriptor_SetYloopDataCount(&sampler->dma_desc[0], sampler->ring_frames);
+        Cy_DMA_Descriptor_SetYloopSrcIncrement(&sampler->dma_desc[0], 0);
+        Cy_DMA_Descriptor_SetYloopDstIncrement(&sampler->dma_desc[0], sampler->num_channels);
+    }
+
+    /* Initialize the DMA channel and enable the frame complete interrupt */
+    channel_config.descriptor = &sampler->dma_desc[0];
+    Cy_DMA_Channel_Init(dma_base, dma_chan, &channel_config);
+    Cy_DMA_Channel_SetInterruptMask(dma_base, dma_chan, CY_DMA_INTR_MASK);
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_IRQHandler
+********************************************************************************
+* Summary:
+*   Handle the frame complete interrupt of the Sampler DMA. This function shall
+*   be called from the interrupt service routine of the DW channel given to 
+*   Sampler_SetupDMA(). It finds which buffer was just completed and reports it
+*   to the registered callback. It also counts the DW errors and the triggers 
+*   the SAR ADC missed since the previous interrupt.
+*
+* Parameters:
+*   sampler: sampler object
+*
+*******************************************************************************/
+void Sampler_IRQHandler(sampler_t *sampler)
+{
+    sampler_event_t event;
+
+    if (sampler == NULL || sampler->dma_base == NULL)
+    {
+        return;
+    }
+
+    /* Raised before Sampler_Stop() and served late, after it or after the 
+     * next Sampler_Start(): there is no frame to report */
+    if (Cy_DMA_Channel_GetInterruptStatus(sampler->dma_base, sampler->dma_chan) == 0u)
+    {
+        return;
+    }
+
+    Cy_DMA_Channel_ClearInterrupt(sampler->dma_base, sampler->dma_chan);
+
+    /* A DW error stops the channel, there is no frame to report */
+    if (Cy_DMA_Channel_GetStatus(sampler->dma_base, sampler->dma_chan) != 
+        CY_DMA_INTR_CAUSE_COMPLETION)
+    {
+        sampler->dma_errors++;
+        return;
+    }
+
+    /* The timer triggered the SAR ADC while it was still converting */
+    if ((Cy_SAR_GetInterruptStatus(sampler->sar_base) & CY_SAR_INTR_HW_COLLISION) != 0u)
+    {
+        Cy_SAR_ClearInterrupt(sampler->sar_base, CY_SAR_INTR_HW_COLLISION);
+        sampler->missed_triggers++;
+    }
+
+    if (sampler->mode == SAMPLER_MODE_RING)
+    {
+        /* The patched descriptor completed and disabled the channel. The 
+         * state is set only when no wrap is pending, and the DMA cannot wrap
+         * before the new end, so this is not a wrap. */
+        if (sampler->capture_state == SAMPLER_CAPTURE_STOPPING)
+        {
+            sampler->capture_head = sampler->capture_stop + 1u;
+            sampler->capture_oldest = sampler->capture_head - sampler->ring_frames;
+            Sampler_RingCaptureComplete(sampler);
+            return;
+        }
+
+        sampler->ring_wraps++;
+
+        /* The last frame of the capture may be in this pass */
+        if (sampler->capture_state == SAMPLER_CAPTURE_TRIGGERED)
+        {
+            if (Sampler_RingScheduleStop(sampler))
+            {
+                Sampler_RingCaptureComplete(sampler);
+                return;
+            }
+        }
+
+        event.event = SAMPLER_EVENT_RING_WRAP;
+        event.buffer = 0;
+        event.frame = sampler->samples_ptr;
+        event.sequence = sampler->ring_wraps * sampler->ring_frames;
+        event.timestamp = 0;
+        event.channel_mask = sampler->channel_mask;
+
+        if (sampler->callback != NULL)
+        {
+            sampler->callback(&event, sampler->callback_arg);
+        }
+        return;
+    }
+
+    /* The channel already moved to the chain of the next buffer, so the
+     * completed buffer is the one not being written. When the interrupt is
+     * late, the channel may be past the first descriptor of that chain (the
+     * timestamp, the discards), so the whole half of dma_desc is checked. */
+    event.buffer = 0;
+    if (sampler->mode == SAMPLER_MODE_PING_PONG)
+    {
+        if (Cy_DMA_Channel_GetCurrentDescriptor(sampler->dma_base, sampler->dma_chan) 
+            < &sampler->dma_desc[SAMPLER_BUFFER_DESCRIPTORS(sampler)])
+        {
+            event.buffer = 1;
+        }
+    }
+
+    if (sampler->mask_state != SAMPLER_MASK_IDLE)
+    {
+        Sampler_UpdateChannelMask(sampler, event.buffer);
+    }
+
+    event.event = SAMPLER_EVENT_FRAME_COMPLETE;
+    event.frame = (event.buffer == 0) ? sampler->samples_ptr : sampler->pong_ptr;
+    event.sequence = sampler->frame_count++;
+    event.timestamp = sampler->timestamp[event.buffer];
+    event.channel_mask = sampler->channel_mask;
+
+    if (sampler->callback != NULL)
+    {
+        sampler->callback(&event, sampler->callback_arg);
+    }
+}
+
+/*******************************************************************************
+* Function Name: Sampler_GetStats
+********************************************************************************
+* Summary:
+*   Get the health counters of the Sampler. The frame count is compared with 
+*   the one of the previous call, so when this function is called periodically,
+*   slower than the frame rate, a stalled DMA or SAR ADC is reported. With the
+*   timestamps enabled, the trigger rate actually achieved since the previous 
+*   call is measured, to be compared with the configured scan rate. Missed 
+*   triggers are checked once per frame interrupt, or per wrap in the ring 
+*   mode. Shall not be called from an interrupt with higher priority than the 
+*   Sampler DMA interrupt.
+*
+* Parameters:
+*   sampler: sampler object
+*   stats: returns the statistics
+*
+* Return:
+*   If read correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_GetStats(sampler_t *sampler, sampler_stats_t *stats)
+{
+    uint32_t triggers_per_frame;
+    uint32_t now;
+    uint32_t elapsed;
+
+    if (sampler == NULL || stats == NULL || sampler->dma_base == NULL)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    now = Sampler_GetTimestamp(sampler);
+    stats->frames = (sampler->mode == SAMPLER_MODE_RING) ? Sampler_RingGetHead(sampler) : 
+                                                          sampler->frame_count;
+    stats->new_frames = stats->frames - sampler->stats_frames;
+    stats->stalled = (stats->new_frames == 0);
+    stats->missed_triggers = sampler->missed_triggers;
+    stats->dma_errors = sampler->dma_errors;
+    stats->dma_status = Cy_DMA_Channel_GetStatus(sampler->dma_base, sampler->dma_chan);
+    stats->ring_overruns = sampler->ring_overruns;
+
+    /* Every stored or discarded sample of the enabled channels takes 
+     * oversampling triggers */
+    triggers_per_frame = 0;
+    for (uint32_t ch = 0; ch < sampler->num_channels; ch++)
+    {
+        if (SAMPLER_CHANNEL_ENABLED(sampler->channel_mask, ch))
+        {
+            triggers_per_frame += 1u + sampler->discard_count[ch];
+        }
+    }
+    triggers_per_frame *= sampler->oversampling;
+
+    stats->scan_rate_hz = 0;
+    elapsed = now - sampler->stats_timestamp;
+    if (sampler->timestamp_base != NULL && elapsed != 0)
+    {
+        stats->scan_rate_hz = (uint32_t)(((uint64_t) stats->new_frames * triggers_per_frame * 
+                                          cyhal_clock_get_frequency(&CYHAL_CLOCK_PERI)) / elapsed);
+    }
+
+    sampler->stats_frames = stats->frames;
+    sampler->stats_timestamp = now;
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_SetChannelMask
+********************************************************************************
+* Summary:
+*   Select the channels written by the DMA, without stopping it. The frames 
+*   keep their layout, and the disabled channels keep their previous value. 
+*   The AMux shall skip the same slots with AMux_SetChannelMask(), which 
+*   returns the descriptor link that moves its DMA to the new chain.
+*   While sampling, the change is applied by Sampler_IRQHandler(). The next 
+*   frame interrupt rebuilds the descriptors the DMA is not running and writes
+*   the AMux link, so both DMAs move to the new mask at the end of the frame 
+*   after it. The interrupt shall then be served within that frame. The 
+*   frame events report the mask of each frame. A second change is refused 
+*   until the first one is applied, two frames later, see 
+*   Sampler_GetChannelMask(). When not sampling, the change is applied at 
+*   once. The ring mode is not supported, as its single descriptor cannot skip
+*   channels.
+*
+* Parameters:
+*   sampler: sampler object
+*   mask: bit n enables the channel n, at least one channel shall be enabled.
+*         The frames shall have at most SAMPLER_MAX_MASK_CHANNELS channels.
+*   link: AMux descriptor to link when the DMAs switch, or NULL
+*   link_next: descriptor to link it to
+*
+* Return:
+*   If set correctly, returns SUCCESS, BUSY if the previous change is not 
+*   applied yet, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_SetChannelMask(sampler_t *sampler, uint32_t mask,
+                                           cy_stc_dma_descriptor_t *link,
+                                           cy_stc_dma_descriptor_t *link_next)
+{
+    if (sampler == NULL || sampler->dma_base == NULL || sampler->mode == SAMPLER_MODE_RING ||
+        ((link == NULL) != (link_next == NULL)))
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if (sampler->num_channels > SAMPLER_MAX_MASK_CHANNELS)
+    {
+        return SAMPLER_ERROR;
+    }
+    if (sampler->num_channels < SAMPLER_MAX_MASK_CHANNELS)
+    {
+        mask &= (1UL << sampler->num_channels) - 1u;
+    }
+    if (mask == 0)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if (sampler->mask_state != SAMPLER_MASK_IDLE)
+    {
+        return SAMPLER_BUSY;
+    }
+
+    /* The descriptors of both masks shall fit in their half of dma_desc */
+    if (sampler->num_desc[0] > SAMPLER_BUFFER_DESCRIPTORS(sampler) ||
+        Sampler_CountFrameDescriptors(sampler, mask) > SAMPLER_BUFFER_DESCRIPTORS(sampler))
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if ((Cy_TCPWM_PWM_GetStatus(sampler->timer_base, sampler->timer_chan) &
+         CY_TCPWM_PWM_STATUS_COUNTER_RUNNING) == 0u)
+    {
+        Sampler_SetupChain(sampler, mask);
+        sampler->channel_mask = mask;
+        if (link != NULL)
+        {
+            Cy_DMA_Descriptor_SetNextDescriptor(link, link_next);
+        }
+        return SAMPLER_SUCCESS;
+    }
+
+    sampler->pending_mask = mask;
+    sampler->mask_link = link;
+    sampler->mask_link_next = link_next;
+    sampler->mask_state = SAMPLER_MASK_PENDING;
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_GetChannelMask
+********************************************************************************
+* Summary:
+*   Get the channels written in the frames reported now. A new mask shall only
+*   be given to AMux_SetChannelMask() and Sampler_SetChannelMask() once the 
+*   previous one is applied.
+*
+* Parameters:
+*   sampler: sampler object
+*   mask: returns the enabled channels
+*
+* Return:
+*   If the last change is applied, returns SUCCESS, BUSY if it is not applied 
+*   yet, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_GetChannelMask(sampler_t *sampler, uint32_t *mask)
+{
+    if (sampler == NULL || mask == NULL)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    *mask = sampler->channel_mask;
+
+    return (sampler->mask_state != SAMPLER_MASK_IDLE) ? SAMPLER_BUSY : SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_RingGetHead
+********************************************************************************
+* Summary:
+*   Get the producer index of the ring, which is the number of frames completed
+*   by the DMA since Sampler_Start(). It is computed from the wrap count and 
+*   the frame the DMA is currently writing, so no interrupt per frame is 
+*   needed. Shall not be called from an interrupt with higher priority than the
+*   Sampler DMA interrupt.
+*
+* Parameters:
+*   sampler: sampler object
+*
+* Return:
+*   Number of completed frames.
+*
+*******************************************************************************/
+uint32_t Sampler_RingGetHead(sampler_t *sampler)
+{
+    uint32_t wraps;
+    uint32_t pending;
+    uint32_t frame;
+
+    if (sampler == NULL || sampler->dma_base == NULL || sampler->mode != SAMPLER_MODE_RING)
+    {
+        return 0;
+    }
+
+    /* The DMA stopped at the end of a capture */
+    if (sampler->capture_state == SAMPLER_CAPTURE_DONE)
+    {
+        return sampler->capture_head;
+    }
+
+    /* Retry if the DMA wrapped around while reading the position */
+    do
+    {
+        wraps = sampler->ring_wraps;
+        pending = Cy_DMA_Channel_GetInterruptStatus(sampler->dma_base, sampler->dma_chan);
+        frame = Cy_DMA_Channel_GetCurrentYloopIndex(sampler->dma_base, sampler->dma_chan);
+    } while ((wraps != sampler->ring_wraps) || 
+             (pending != Cy_DMA_Channel_GetInterruptStatus(sampler->dma_base, sampler->dma_chan)));
+
+    /* A wrap not yet counted by the interrupt */
+    if (pending != 0)
+    {
+        /* Or the stop of a capture */
+        if (sampler->capture_state == SAMPLER_CAPTURE_STOPPING)
+        {
+            return sampler->capture_stop + 1u;
+        }
+        wraps++;
+    }
+
+    return (wraps * sampler->ring_frames) + frame;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_RingGetTail
+********************************************************************************
+* Summary:
+*   Get the consumer index of the ring, which is the index, as counted by 
+*   Sampler_RingGetHead(), of the first frame returned by 
+*   Sampler_RingGetFrames(). It is the sequence number of that frame.
+*
+* Parameters:
+*   sampler: sampler object
+*
+* Return:
+*   Number of frames released or skipped since Sampler_Start().
+*
+*******************************************************************************/
+uint32_t Sampler_RingGetTail(sampler_t *sampler)
+{
+    if (sampler == NULL || sampler->mode != SAMPLER_MODE_RING)
+    {
+        return 0;
+    }
+
+    return sampler->ring_tail;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_RingGetFrames
+********************************************************************************
+* Summary:
+*   Get the oldest frames not yet released by the application. The frames are
+*   contiguous in memory, so at the end of the ring only the frames up to the
+*   last one are returned; the remaining ones are returned by the next call.
+*   If the application fell behind and the DMA overwrote frames, the lost 
+*   frames are skipped and counted in ring_overruns.
+*
+* Parameters:
+*   sampler: sampler object
+*   frames: returns the address of the first frame
+*
+* Return:
+*   Number of frames available at the returned address.
+*
+*******************************************************************************/
+uint32_t Sampler_RingGetFrames(sampler_t *sampler, int16_t **frames)
+{
+    uint32_t available;
+    uint32_t contiguous;
+
+    if (sampler == NULL || frames == NULL || sampler->mode != SAMPLER_MODE_RING)
+    {
+        return 0;
+    }
+
+    /* The frame being written is not available, so at most N-1 frames are */
+    available = Sampler_RingGetHead(sampler) - sampler->ring_tail;
+    if (available > (uint32_t)(sampler->ring_frames - 1))
+    {
+        uint32_t lost = available - (sampler->ring_frames - 1);
+
+        sampler->ring_overruns += lost;
+        sampler->ring_tail += lost;
+        sampler->ring_tail_slot = (sampler->ring_tail_slot + lost) % sampler->ring_frames;
+        available = sampler->ring_frames - 1;
+    }
+
+    contiguous = sampler->ring_frames - sampler->ring_tail_slot;
+    if (available > contiguous)
+    {
+        available = contiguous;
+    }
+
+    *frames = (int16_t *) sampler->samples_ptr + 
+              ((uint32_t) sampler->ring_tail_slot * sampler->num_channels);
+
+    return available;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_RingRelease
+********************************************************************************
+* Summary:
+*   Give back frames obtained with Sampler_RingGetFrames() once the application
+*   is done with them. It also checks the DMA did not overwrite the frames
+*   while they were being processed.
+*
+* Parameters:
+*   sampler: sampler object
+*   num_frames: number of frames to release, at most the frames completed and
+*               not released yet
+*
+* Return:
+*   If the released frames were intact, returns SUCCESS, otherwise ERROR. 
+*   Nothing is released if num_frames is too large.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_RingRelease(sampler_t *sampler, uint32_t num_frames)
+{
+    uint32_t used;
+
+    if (sampler == NULL || sampler->mode != SAMPLER_MODE_RING)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if (num_frames > (uint32_t)(sampler->ring_frames - 1))
+    {
+        return SAMPLER_ERROR;
+    }
+
+    /* Frames not completed yet cannot be released, the tail would pass the
+     * head */
+    used = Sampler_RingGetHead(sampler) - sampler->ring_tail;
+    if (num_frames > used)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    sampler->ring_tail += num_frames;
+    sampler->ring_tail_slot = (sampler->ring_tail_slot + num_frames) % sampler->ring_frames;
+
+    /* The oldest released frame was rewritten if the DMA got N frames ahead */
+    if (used > (uint32_t)(sampler->ring_frames - 1))
+    {
+        sampler->ring_overruns++;
+        return SAMPLER_ERROR;
+    }
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_RingArm
+********************************************************************************
+* Summary:
+*   Arm a triggered capture of the ring, like the single trigger of an 
+*   oscilloscope. The DMA keeps filling the ring until Sampler_RingTrigger(), 
+*   then stops on its own after post_frames more frames, so the ring holds the
+*   frames around the trigger. It can be armed before Sampler_Start() or while
+*   the ring is running. The SAR ADC and the AMux keep running after the 
+*   capture, so to capture again, stop the Sampler, restart the AMux DMA for 
+*   the frames to start at the first connection, arm, and start the Sampler.
+*
+* Parameters:
+*   sampler: sampler object
+*   pre_frames: number of frames to keep before the trigger frame
+*   post_frames: number of frames to keep after the trigger frame
+*
+* Return:
+*   If armed correctly, returns SUCCESS, BUSY if a triggered capture is not
+*   complete yet, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_RingArm(sampler_t *sampler, uint16_t pre_frames, uint16_t post_frames)
+{
+    if (sampler == NULL || sampler->mode != SAMPLER_MODE_RING)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    /* The trigger frame and the frames around it shall fit in the ring */
+    if (((uint32_t) pre_frames + post_frames + 1u) > sampler->ring_frames)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if (sampler->capture_state == SAMPLER_CAPTURE_TRIGGERED || 
+        sampler->capture_state == SAMPLER_CAPTURE_STOPPING)
+    {
+        return SAMPLER_BUSY;
+    }
+
+    sampler->capture_pre = pre_frames;
+    sampler->capture_post = post_frames;
+    sampler->capture_state = SAMPLER_CAPTURE_ARMED;
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_RingTrigger
+********************************************************************************
+* Summary:
+*   Trigger an armed capture. The trigger can be software, the interrupt of a
+*   hardware event, or a frame found crossing a threshold while draining the
+*   ring. When the last frame of the capture is in the current pass of the 
+*   ring, the ring descriptor is changed to end at that frame and disable the
+*   channel, otherwise this is done at the wrap interrupt of that pass. The 
+*   DMA then stops without the CPU and SAMPLER_EVENT_CAPTURE_COMPLETE is 
+*   reported. If that frame is being written, the DMA stops once it is 
+*   complete. If it is already written, the DMA is stopped at once and the 
+*   event is reported from this function.
+*
+* Parameters:
+*   sampler: sampler object
+*   frame: index of the trigger frame, as counted by Sampler_RingGetHead(). 
+*          Pass Sampler_RingGetHead() to trigger on the frame being written.
+*
+* Return:
+*   If triggered correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_RingTrigger(sampler_t *sampler, uint32_t frame)
+{
+    uint32_t interrupt_state;
+    bool stopped;
+
+    if (sampler == NULL || sampler->dma_base == NULL || sampler->mode != SAMPLER_MODE_RING)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    /* The wrap interrupt also schedules the stop */
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+    if (sampler->capture_state != SAMPLER_CAPTURE_ARMED)
+    {
+        Cy_SysLib_ExitCriticalSection(interrupt_state);
+        return SAMPLER_ERROR;
+    }
+
+    sampler->capture_trigger = frame;
+    sampler->capture_stop = frame + sampler->capture_post;
+    sampler->capture_state = SAMPLER_CAPTURE_TRIGGERED;
+    stopped = Sampler_RingScheduleStop(sampler);
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    if (stopped)
+    {
+        Sampler_RingCaptureComplete(sampler);
+    }
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_RingGetCapture
+********************************************************************************
+* Summary:
+*   Get the frames of a completed capture: up to pre_frames before the 
+*   trigger frame, the trigger frame, and up to post_frames after it. There 
+*   are fewer frames before the trigger if it came shortly after 
+*   Sampler_Start() or if the trigger was late. Read the frames with 
+*   Sampler_RingGetFrame(), as they may wrap around the end of the ring.
+*
+* Parameters:
+*   sampler: sampler object
+*   first: returns the index of the first captured frame
+*   num_frames: returns the number of captured frames
+*
+* Return:
+*   SUCCESS if the capture is complete, BUSY if it is armed or triggered, 
+*   otherwise ERROR.
+*
+*******************************************************************************/
+en_sampler_status_t Sampler_RingGetCapture(sampler_t *sampler, uint32_t *first, uint32_t *num_frames)
+{
+    uint32_t start;
+    uint32_t end;
+
+    if (sampler == NULL || first == NULL || num_frames == NULL || sampler->mode != SAMPLER_MODE_RING)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if (sampler->capture_state == SAMPLER_CAPTURE_IDLE)
+    {
+        return SAMPLER_ERROR;
+    }
+
+    if (sampler->capture_state != SAMPLER_CAPTURE_DONE)
+    {
+        return SAMPLER_BUSY;
+    }
+
+    /* Window around the trigger, clipped to the frames still in the ring */
+    start = (sampler->capture_trigger > sampler->capture_pre) ? 
+            (sampler->capture_trigger - sampler->capture_pre) : 0u;
+    if ((int32_t)(sampler->capture_oldest - start) > 0)
+    {
+        start = sampler->capture_oldest;
+    }
+
+    end = sampler->capture_stop + 1u;
+    if ((int32_t)(end - sampler->capture_head) > 0)
+    {
+        end = sampler->capture_head;
+    }
+
+    *first = start;
+    *num_frames = ((int32_t)(end - start) > 0) ? (end - start) : 0u;
+
+    return SAMPLER_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_RingGetFrame
+********************************************************************************
+* Summary:
+*   Get the address of a frame of the ring from its index. The frame is only 
+*   valid while the DMA does not write it again, so while the ring is stopped 
+*   at the end of a capture, or for the frames returned by 
+*   Sampler_RingGetFrames().
+*
+* Parameters:
+*   sampler: sampler object
+*   frame: index of the frame, as counted by Sampler_RingGetHead()
+*
+* Return:
+*   Address of the frame, or NULL if the Sampler is not in ring mode.
+*
+*******************************************************************************/
+int16_t *Sampler_RingGetFrame(sampler_t *sampler, uint32_t frame)
+{
+    if (sampler == NULL || sampler->mode != SAMPLER_MODE_RING || sampler->ring_frames == 0)
+    {
+        return NULL;
+    }
+
+    return (int16_t *) sampler->samples_ptr + 
+           ((frame % sampler->ring_frames) * sampler->num_channels);
+}
+
+/*******************************************************************************
+* Function Name: Sampler_CountFrameDescriptors
+********************************************************************************
+* Summary:
+*   Count the descriptors needed to fill one frame. Each channel with discarded
+*   samples takes one descriptor to discard them, and starts a new descriptor 
+*   to store its sample and the ones of the following channels. So does an 
+*   enabled channel after a disabled one. The timestamp takes one more 
+*   descriptor, and the frame tags up to two more.
+*
+* Parameters:
+*   sampler: sampler object
+*   mask: enabled channels, at least one
+*
+* Return:
+*   Number of descriptors per frame.
+*
+*******************************************************************************/
+static uint32_t Sampler_CountFrameDescriptors(sampler_t *sampler, uint32_t mask)
+{
+    uint32_t num_desc = (sampler->timestamp_base != NULL) ? 1u : 0u;
+    uint32_t last = 0;
+
+    for (uint32_t ch = 0; ch < sampler->num_channels; ch++)
+    {
+        if (!SAMPLER_CHANNEL_ENABLED(mask, ch))
+        {
+            continue;
+        }
+        if (sampler->discard_count[ch] != 0)
+        {
+            num_desc += 2u;
+        }
+        else if (ch == 0 || !SAMPLER_CHANNEL_ENABLED(mask, ch - 1))
+        {
+            num_desc += 1u;
+        }
+        last = ch;
+    }
+
+    /* The end tag, and the last sample when it has to be split from its run */
+    if (sampler->frame_tags)
+    {
+        num_desc += ((last > 0) && SAMPLER_CHANNEL_ENABLED(mask, last - 1) &&
+                     (sampler->discard_count[last] == 0)) ? 2u : 1u;
+    }
+
+    return num_desc;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_SetupFrameDescriptors
+********************************************************************************
+* Summary:
+*   Initialize the descriptors to fill one frame, starting at the given 
+*   descriptor index. The descriptors are linked to each other, except the 
+*   last one, which shall be linked by the caller. Only the last descriptor
+*   raises the frame complete interrupt. The disabled channels are not 
+*   visited by the AMux, so they take no trigger and keep their previous value
+*   in the frame.
+*
+* Parameters:
+*   sampler: sampler object
+*   frame: buffer to store the samples
+*   buffer: index of the buffer, for its timestamp and frame tags
+*   first: index of the first descriptor
+*   mask: enabled channels, at least one
+*
+* Return:
+*   Number of descriptors initialized.
+*
+*******************************************************************************/
+static uint32_t Sampler_SetupFrameDescriptors(sampler_t *sampler, int16_t *frame, 
+                                              uint32_t buffer, uint32_t first, uint32_t mask)
+{
+    uint32_t d = first;
+    uint32_t ch = 0;
+    uint32_t run = 0;
+    uint32_t end = 0;
+
+    if (sampler->timestamp_base != NULL)
+    {
+        /* Copy the counter on the first trigger of the frame, then store the
+         * first sample on the same trigger */
+        Cy_DMA_Descriptor_Init(&sampler->dma_desc[d], &sampler_dma_timestamp_config);
+        Cy_DMA_Descriptor_SetDstAddress(&sampler->dma_desc[d], (void *) &sampler->timestamp[buffer]);
+        Cy_DMA_Descriptor_SetSrcAddress(&sampler->dma_desc[d], 
+            (void *) &TCPWM_CNT_COUNTER(sampler->timestamp_base, sampler->timestamp_chan));
+        Cy_DMA_Descriptor_SetNextDescriptor(&sampler->dma_desc[d], &sampler->dma_desc[d+1]);
+        d++;
+    }
+
+    while (ch < sampler->num_channels)
+    {
+        if (!SAMPLER_CHANNEL_ENABLED(mask, ch))
+        {
+            ch++;
+            continue;
+        }
+
+        if (sampler->discard_count[ch] != 0)
+        {
+            /* Throw away the samples taken while the pin settles */
+            Cy_DMA_Descriptor_Init(&sampler->dma_desc[d], &sampler_dma_descriptor_config);
+            Cy_DMA_Descriptor_SetDstAddress(&sampler->dma_desc[d], (void *) &sampler->discard);
+            Cy_DMA_Descriptor_SetSrcAddress(&sampler->dma_desc[d], (void *) &sampler->sar_base->CHAN_RESULT[0]);
+            Cy_DMA_Descriptor_SetXloopDataCount(&sampler->dma_desc[d], sampler->discard_count[ch]);
+            Cy_DMA_Descriptor_SetXloopDstIncrement(&sampler->dma_desc[d], 0);
+            Cy_DMA_Descriptor_SetInterruptType(&sampler->dma_desc[d], CY_DMA_DESCR_CHAIN);
+            Cy_DMA_Descriptor_SetNextDescriptor(&sampler->dma_desc[d], &sampler->dma_desc[d+1]);
+            d++;
+        }
+
+        /* Store this channel and the following enabled ones that have no 
+         * discards */
+        run = 1;
+        while (((ch + run) < sampler->num_channels) && (sampler->discard_count[ch + run] == 0) &&
+               SAMPLER_CHANNEL_ENABLED(mask, ch + run))
+        {
+            run++;
+        }
+
+        Cy_DMA_Descriptor_Init(&sampler->dma_desc[d], &sampler_dma_descriptor_config);
+        Cy_DMA_Descriptor_SetDstAddress(&sampler->dma_desc[d], (void *) &frame[ch]);
+        Cy_DMA_Descriptor_SetSrcAddress(&sampler->dma_desc[d], (void *) &sampler->sar_base->CHAN_RESULT[0]);
+        Cy_DMA_Descriptor_SetXloopDataCount(&sampler->dma_desc[d], run);
+        Cy_DMA_Descriptor_SetInterruptType(&sampler->dma_desc[d], CY_DMA_DESCR_CHAIN);
+        Cy_DMA_Descriptor_SetNextDescriptor(&sampler->dma_desc[d], &sampler->dma_desc[d+1]);
+        d++;
+
+        ch += run;
+        end = ch;
+    }
+
+    if (sampler->frame_tags)
+    {
+        /* The last sample gets its own descriptor, chained to the end tag, so 
+         * both are written on the same trigger */
+        if (run > 1)
+        {
+            Cy_DMA_Descriptor_SetXloopDataCount(&sampler->dma_desc[d-1], run - 1);
+
+            Cy_DMA_Descriptor_Init(&sampler->dma_desc[d], &sampler_dma_descriptor_config);
+            Cy_DMA_Descriptor_SetDstAddress(&sampler->dma_desc[d], (void *) &frame[end-1]);
+            Cy_DMA_Descriptor_SetSrcAddress(&sampler->dma_desc[d], (void *) &sampler->sar_base->CHAN_RESULT[0]);
+            Cy_DMA_Descriptor_SetXloopDataCount(&sampler->dma_desc[d], 1);
+            Cy_DMA_Descriptor_SetInterruptType(&sampler->dma_desc[d], CY_DMA_DESCR_CHAIN);
+            Cy_DMA_Descriptor_SetNextDescriptor(&sampler->dma_desc[d], &sampler->dma_desc[d+1]);
+            d++;
+        }
+        Cy_DMA_Descriptor_SetTriggerInType(&sampler->dma_desc[d-1], CY_DMA_DESCR_CHAIN);
+
+        /* Copy the begin tag to the end tag, then wait for the next frame */
+        Cy_DMA_Descriptor_Init(&sampler->dma_desc[d], &sampler_dma_timestamp_config);
+        Cy_DMA_Descriptor_SetDstAddress(&sampler->dma_desc[d], (void *) &sampler->timestamp_end[buffer]);
+        Cy_DMA_Descriptor_SetSrcAddress(&sampler->dma_desc[d], (void *) &sampler->timestamp[buffer]);
+        Cy_DMA_Descriptor_SetTriggerInType(&sampler->dma_desc[d], CY_DMA_1ELEMENT);
+        Cy_DMA_Descriptor_SetNextDescriptor(&sampler->dma_desc[d], &sampler->dma_desc[d+1]);
+        d++;
+    }
+
+    /* The descriptors before the last are not at the end of a chain, so the 
+     * chain interrupt type never fires for them */
+    Cy_DMA_Descriptor_SetInterruptType(&sampler->dma_desc[d-1], CY_DMA_DESCR);
+
+    return d - first;
+}
+
+
+/*******************************************************************************
+* Function Name: Sampler_SetupBuffer
+********************************************************************************
+* Summary:
+*   Initialize the descriptors of one half of dma_desc for a frame. With the 
+*   ping-pong buffers, each half fills its own buffer. Otherwise the second
+*   half only runs while the first one is rebuilt for a new channel mask.
+*
+* Parameters:
+*   sampler: sampler object
+*   index: half of dma_desc
+*   mask: enabled channels
+*
+* Return:
+*   Last descriptor, to be linked by the caller.
+*
+*******************************************************************************/
+static cy_stc_dma_descriptor_t *Sampler_SetupBuffer(sampler_t *sampler, uint32_t index, uint32_t mask)
+{
+    uint32_t buffer = (sampler->mode == SAMPLER_MODE_PING_PONG) ? index : 0u;
+    uint32_t first = index * SAMPLER_BUFFER_DESCRIPTORS(sampler);
+
+    sampler->num_desc[index] = (uint16_t) Sampler_SetupFrameDescriptors(sampler, 
+        (buffer == 0u) ? sampler->samples_ptr : sampler->pong_ptr, buffer, first, mask);
+
+    return &sampler->dma_desc[first + sampler->num_desc[index] - 1u];
+}
+
+/*******************************************************************************
+* Function Name: Sampler_SetupChain
+********************************************************************************
+* Summary:
+*   Initialize the descriptors of all the buffers. Shall not be called while 
+*   the DMA runs them.
+*
+* Parameters:
+*   sampler: sampler object
+*   mask: enabled channels
+*
+*******************************************************************************/
+static void Sampler_SetupChain(sampler_t *sampler, uint32_t mask)
+{
+    cy_stc_dma_descriptor_t *last = Sampler_SetupBuffer(sampler, 0u, mask);
+
+    if (sampler->mode == SAMPLER_MODE_PING_PONG)
+    {
+        Cy_DMA_Descriptor_SetNextDescriptor(last, &sampler->dma_desc[SAMPLER_BUFFER_DESCRIPTORS(sampler)]);
+        last = Sampler_SetupBuffer(sampler, 1u, mask);
+    }
+    Cy_DMA_Descriptor_SetNextDescriptor(last, &sampler->dma_desc[0]);
+}
+
+/*******************************************************************************
+* Function Name: Sampler_UpdateChannelMask
+********************************************************************************
+* Summary:
+*   Apply a channel mask change, one step per frame interrupt. When the frame
+*   of the given buffer completes, the DMA is at the start of the next frame:
+*   - PENDING: the descriptors of the completed ping-pong buffer are rebuilt 
+*     for the frame after. In the single buffer mode, the second half of 
+*     dma_desc is built and linked after the running chain. The AMux link is 
+*     written, so both DMAs switch at the end of the running frame.
+*   - SWITCHING: the other ping-pong buffer is rebuilt, or the first half, 
+*     which the second half links back to.
+*   - SWITCHED: the reported frame is the first one with the new mask.
+*
+* Parameters:
+*   sampler: sampler object
+*   buffer: buffer of the completed frame
+*
+*******************************************************************************/
+static void Sampler_UpdateChannelMask(sampler_t *sampler, uint32_t buffer)
+{
+    cy_stc_dma_descriptor_t *last;
+
+    if (sampler->mask_state == SAMPLER_MASK_PENDING)
+    {
+        if (sampler->mode == SAMPLER_MODE_PING_PONG)
+        {
+            last = Sampler_SetupBuffer(sampler, buffer, sampler->pending_mask);
+            Cy_DMA_Descriptor_SetNextDescriptor(last, 
+                &sampler->dma_desc[(1u - buffer) * SAMPLER_BUFFER_DESCRIPTORS(sampler)]);
+        }
+        else
+        {
+            /* Loops on itself until the first half is rebuilt */
+            last = Sampler_SetupBuffer(sampler, 1u, sampler->pending_mask);
+            Cy_DMA_Descriptor_SetNextDescriptor(last, &sampler->dma_desc[SAMPLER_BUFFER_DESCRIPTORS(sampler)]);
+            Cy_DMA_Descriptor_SetNextDescriptor(&sampler->dma_desc[sampler->num_desc[0] - 1u], 
+                                                &sampler->dma_desc[SAMPLER_BUFFER_DESCRIPTORS(sampler)]);
+        }
+        if (sampler->mask_link != NULL)
+        {
+            Cy_DMA_Descriptor_SetNextDescriptor(sampler->mask_link, sampler->mask_link_next);
+        }
+        sampler->mask_state = SAMPLER_MASK_SWITCHING;
+    }
+    else if (sampler->mask_state == SAMPLER_MASK_SWITCHING)
+    {
+        if (sampler->mode == SAMPLER_MODE_PING_PONG)
+        {
+            last = Sampler_SetupBuffer(sampler, buffer, sampler->pending_mask);
+            Cy_DMA_Descriptor_SetNextDescriptor(last, 
+                &sampler->dma_desc[(1u - buffer) * SAMPLER_BUFFER_DESCRIPTORS(sampler)]);
+        }
+        else
+        {
+            last = Sampler_SetupBuffer(sampler, 0u, sampler->pending_mask);
+            Cy_DMA_Descriptor_SetNextDescriptor(last, &sampler->dma_desc[0]);
+            Cy_DMA_Descriptor_SetNextDescriptor(
+                &sampler->dma_desc[SAMPLER_BUFFER_DESCRIPTORS(sampler) + sampler->num_desc[1] - 1u], 
+                &sampler->dma_desc[0]);
+        }
+        sampler->mask_state = SAMPLER_MASK_SWITCHED;
+    }
+    else
+    {
+        sampler->channel_mask = sampler->pending_mask;
+        sampler->mask_state = SAMPLER_MASK_IDLE;
+    }
+}
+
+/*******************************************************************************
+* Function Name: Sampler_RingScheduleStop
+********************************************************************************
+* Summary:
+*   Stop the ring after the last frame of a triggered capture. If that frame 
+*   is later in the pass the DMA is writing, the ring descriptor is changed to
+*   end at it and disable the channel. The DW reads the descriptor for every 
+*   transfer, so the change applies to the running pass, including the frame
+*   being written. If the frame is in a later pass, nothing is done until the
+*   wrap interrupt of that pass. If it is already written, the channel is 
+*   disabled at once. If the DMA wraps or moves while the descriptor is 
+*   changed, the change is undone and made again from the new position.
+*   Shall be called with the Sampler DMA interrupt masked, or from it.
+*
+* Parameters:
+*   sampler: sampler object
+*
+* Return:
+*   True if the DMA was stopped at once.
+*
+*******************************************************************************/
+static bool Sampler_RingScheduleStop(sampler_t *sampler)
+{
+    uint32_t interrupt_state;
+    uint32_t head;
+    uint32_t index;
+    uint32_t ahead;
+    bool patched;
+
+    do
+    {
+        /* Let the pending wrap interrupt count the pass first, so the 
+         * completion of the changed descriptor cannot be taken for it */
+        if (Cy_DMA_Channel_GetInterruptStatus(sampler->dma_base, sampler->dma_chan) != 0)
+        {
+            return false;
+        }
+
+        /* A single read of the position, the frame index in the pass is 
+         * derived from it */
+        head = Sampler_RingGetHead(sampler);
+        index = head % sampler->ring_frames;
+        ahead = sampler->capture_stop - head;
+
+        if ((int32_t) ahead < 0)
+        {
+            /* The frame being written holds the oldest frame of the ring, it
+             * is no longer valid once partially overwritten */
+            Cy_DMA_Channel_Disable(sampler->dma_base, sampler->dma_chan);
+            sampler->capture_head = Sampler_RingGetHead(sampler);
+            sampler->capture_oldest = sampler->capture_head - sampler->ring_frames + 1u;
+            sampler->capture_state = SAMPLER_CAPTURE_DONE;
+            return true;
+        }
+
+        /* The frame is in a later pass */
+        if ((index + ahead) >= sampler->ring_frames)
+        {
+            return false;
+        }
+
+        /* The DMA may wrap, or move to the next frame, before it reads the 
+         * changed descriptor. It is then restored and the stop scheduled 
+         * again from the new position. With the interrupts disabled, the DMA
+         * cannot write the frames up to the new end during the check. */
+        interrupt_state = Cy_SysLib_EnterCriticalSection();
+        Cy_DMA_Descriptor_SetYloopDataCount(&sampler->dma_desc[0], index + ahead + 1u);
+        Cy_DMA_Descriptor_SetChannelState(&sampler->dma_desc[0], CY_DMA_CHANNEL_DISABLED);
+        patched = (Cy_DMA_Channel_GetInterruptStatus(sampler->dma_base, sampler->dma_chan) == 0) &&
+                  (Cy_DMA_Channel_GetCurrentYloopIndex(sampler->dma_base, sampler->dma_chan) == index);
+        if (!patched)
+        {
+            Cy_DMA_Descriptor_SetYloopDataCount(&sampler->dma_desc[0], sampler->ring_frames);
+            Cy_DMA_Descriptor_SetChannelState(&sampler->dma_desc[0], CY_DMA_CHANNEL_ENABLED);
+        }
+        Cy_SysLib_ExitCriticalSection(interrupt_state);
+    } while (!patched);
+
+    /* No wrap is pending and the DMA is before the new end, so the next 
+     * interrupt is the completion of the changed descriptor */
+    sampler->capture_state = SAMPLER_CAPTURE_STOPPING;
+
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: Sampler_RingCaptureComplete
+********************************************************************************
+* Summary:
+*   Restore the ring descriptor after a capture and report the captured frames
+*   to the registered callback.
+*
+* Parameters:
+*   sampler: sampler object
+*
+*******************************************************************************/
+static void Sampler_RingCaptureComplete(sampler_t *sampler)
+{
+    sampler_event_t event;
+    uint32_t num_frames;
+
+    sampler->capture_state = SAMPLER_CAPTURE_DONE;
+
+    Cy_DMA_Descriptor_SetYloopDataCount(&sampler->dma_desc[0], sampler->ring_frames);
+    Cy_DMA_Descriptor_SetChannelState(&sampler->dma_desc[0], CY_DMA_CHANNEL_ENABLED);
+
+    event.event = SAMPLER_EVENT_CAPTURE_COMPLETE;
+    event.buffer = 0;
+    Sampler_RingGetCapture(sampler, &event.sequence, &num_frames);
+    event.frame = Sampler_RingGetFrame(sampler, event.sequence);
+    event.timestamp = 0;
+    event.channel_mask = sampler->channel_mask;
+
+    if (sampler->callback != NULL)
+    {
+        sampler->callback(&event, sampler->callback_arg);
+    }
+}
 
 /* [] END OF FILE */
\ No newline at end of file
@@ -56,8 +56,72 @@ typedef enum
     /** Return error */
     SAMPLER_ERROR = 1u,
 
+    /** The triggered capture or the scan rate change is not complete yet */
+    SAMPLER_BUSY = 2u,
+
 } en_sampler_status_t;
 
+typedef enum
+{
+    /** Single buffer, overwritten by every frame */
+    SAMPLER_MODE_SINGLE = 0u,
+
+    /** Two buffers, filled alternately by the DMA */
+    SAMPLER_MODE_PING_PONG = 1u,
+
+    /** Ring of frames, drained by the application */
+    SAMPLER_MODE_RING = 2u,
+
+} en_sampler_mode_t;
+
+typedef enum
+{
+    /** A complete frame is available in one of the buffers */
+    SAMPLER_EVENT_FRAME_COMPLETE = 0u,
+
+    /** The DMA wrapped around the ring and restarted from its first frame */
+    SAMPLER_EVENT_RING_WRAP = 1u,
+
+    /** The DMA stopped after the frames following the trigger of the ring */
+    SAMPLER_EVENT_CAPTURE_COMPLETE = 2u,
+
+} en_sampler_event_t;
+
+typedef enum
+{
+    /** No triggered capture */
+    SAMPLER_CAPTURE_IDLE = 0u,
+
+    /** Waiting for Sampler_RingTrigger() */
+    SAMPLER_CAPTURE_ARMED = 1u,
+
+    /** Triggered, the last frame of the capture is in a later pass of the ring */
+    SAMPLER_CAPTURE_TRIGGERED = 2u,
+
+    /** The ring descriptor stops the DMA after the last frame of the capture */
+    SAMPLER_CAPTURE_STOPPING = 3u,
+
+    /** The DMA stopped, the captured frames can be read */
+    SAMPLER_CAPTURE_DONE = 4u,
+
+} en_sampler_capture_t;
+
+typedef enum
+{
+    /** The frames use the channel mask */
+    SAMPLER_MASK_IDLE = 0u,
+
+    /** Waiting for the next frame interrupt to rebuild the idle descriptors */
+    SAMPLER_MASK_PENDING = 1u,
+
+    /** The DMA moves to the new mask at the end of the frame being written */
+    SAMPLER_MASK_SWITCHING = 2u,
+
+    /** The frame being written is the first one with the new mask */
+    SAMPLER_MASK_SWITCHED = 3u,
+
+} en_sampler_mask_t;
+
 
 /*******************************************************************************
 *                                 API Constants
@@ -66,10 +130,71 @@ typedef enum
     #define SAMPLER_MAX_NUM_CHANNELS       (32u)
 #endif
 
+#define SAMPLER_NUM_BUFFERS            (2u)
+
+/* Channels covered by a channel mask, see Sampler_SetChannelMask() */
+#define SAMPLER_MAX_MASK_CHANNELS      (32u)
+#define SAMPLER_ALL_CHANNELS           (0xFFFFFFFFu)
+
+/* A channel with discarded conversions takes up to two descriptors per buffer,
+ * plus one for the timestamp and two for the frame tags. The application 
+ * allocates them, see Sampler_ConfigureDescriptors() */
+#define SAMPLER_NUM_DESCRIPTORS(num_channels) \
+    (SAMPLER_NUM_BUFFERS*((2u*(num_channels)) + 3u))
+#define SAMPLER_MAX_NUM_DESCRIPTORS    (SAMPLER_NUM_DESCRIPTORS(SAMPLER_MAX_NUM_CHANNELS))
+
+#define SAMPLER_MAX_DISCARD_COUNT      (CY_DMA_LOOP_COUNT_MAX)
+
+#define SAMPLER_MAX_OVERSAMPLING       (256u)
+
+#define SAMPLER_MIN_RING_FRAMES        (2u)
+#define SAMPLER_MAX_RING_FRAMES        (CY_DMA_LOOP_COUNT_MAX)
+
 /*******************************************************************************
 *                              Type Definitions
 *******************************************************************************/
 
+/** Event Structure */
+typedef struct
+{
+    en_sampler_event_t event;
+    uint8_t buffer;
+    int16_t *frame;
+    uint32_t sequence;
+    /* Timestamp counter at the first conversion of the frame, 0 if the 
+     * timestamps are not enabled */
+    uint32_t timestamp;
+    /* Channels written in this frame, see Sampler_SetChannelMask() */
+    uint32_t channel_mask;
+
+} sampler_event_t;
+
+/** Statistics Structure */
+typedef struct
+{
+    /* Frames completed since Sampler_Start() */
+    uint32_t frames;
+    /* Frames completed since the previous call */
+    uint32_t new_frames;
+    /* No frame was completed since the previous call */
+    bool stalled;
+    /* Measured trigger rate since the previous call, 0 without timestamps */
+    uint32_t scan_rate_hz;
+    /* Times the SAR ADC was found triggered while converting */
+    uint32_t missed_triggers;
+    /* Interrupts of the DW channel other than frame completion */
+    uint32_t dma_errors;
+    /* Cause of the last interrupt of the DW channel */
+    cy_en_dma_intr_cause_t dma_status;
+    /* Frames of the ring overwritten by the DMA before the application read 
+     * or released them, see Sampler_RingGetFrames() */
+    uint32_t ring_overruns;
+
+} sampler_stats_t;
+
+/** Event Callback */
+typedef void (*sampler_callback_t)(const sampler_event_t *event, void *arg);
+
 /** Object Structure */
 typedef struct
 {
@@ -77,9 +202,63 @@ typedef struct
     uint8_t timer_chan;
     SAR_Type *sar_base;
     uint8_t num_channels;
+    uint32_t scan_rate_hz;
+    uint32_t acq_time_ns;
+    /* Timer values of the last Sampler_SetScanRate(), the active ones from
+     * the next terminal count */
+    uint32_t timer_period;
+    uint32_t timer_compare;
+    uint16_t oversampling;
+    uint16_t discard_count[SAMPLER_MAX_NUM_CHANNELS];
+    volatile int16_t discard;
+    en_sampler_mode_t mode;
     void *samples_ptr;
+    void *pong_ptr;
     DW_Type* dma_base;
     uint8_t dma_chan;
+    sampler_callback_t callback;
+    void *callback_arg;
+    volatile uint32_t frame_count;
+    uint16_t ring_frames;
+    volatile uint32_t ring_wraps;
+    uint32_t ring_tail;
+    uint16_t ring_tail_slot;
+    /* Frames lost by the consumer of the ring, see sampler_stats_t */
+    uint32_t ring_overruns;
+    /* Triggered capture of the ring, as frame indexes of Sampler_RingGetHead() */
+    volatile en_sampler_capture_t capture_state;
+    uint16_t capture_pre;
+    uint16_t capture_post;
+    uint32_t capture_trigger;
+    uint32_t capture_stop;
+    uint32_t capture_head;
+    uint32_t capture_oldest;
+    TCPWM_Type *timestamp_base;
+    uint8_t timestamp_chan;
+    /* Written by the DMA at the first conversion of each frame */
+    volatile uint32_t timestamp[SAMPLER_NUM_BUFFERS];
+    /* Copy of the timestamp written by the DMA after the last sample */
+    bool frame_tags;
+    volatile uint32_t timestamp_end[SAMPLER_NUM_BUFFERS];
+    uint32_t missed_triggers;
+    uint32_t dma_errors;
+    uint32_t stats_frames;
+    uint32_t stats_timestamp;
+    /* Channels of the reported frames, and the change being applied by the 
+     * frame interrupt, see Sampler_SetChannelMask() */
+    uint32_t channel_mask;
+    uint32_t pending_mask;
+    volatile en_sampler_mask_t mask_state;
+    cy_stc_dma_descriptor_t *mask_link;
+    cy_stc_dma_descriptor_t *mask_link_next;
+    /* Descriptors of each buffer, the second buffer starts half way in 
+     * dma_desc */
+    uint16_t num_desc[SAMPLER_NUM_BUFFERS];
+    /* Descriptors given by Sampler_ConfigureDescriptors(), used by this 
+     * object only, so several objects can run at the same time on different
+     * DW channels */
+    cy_stc_dma_descriptor_t *dma_desc;
+    uint16_t max_desc;
 
 } sampler_t;
 
@@ -88,10 +267,35 @@ typedef struct
 *******************************************************************************/
 en_sampler_status_t Sampler_Init(sampler_t *sampler, SAR_Type *sar, TCPWM_Type *timer, uint8_t timer_chan);
 en_sampler_status_t Sampler_SetScanRate(sampler_t *sampler, uint32_t scan_rate_hz, uint32_t acq_time_ns);
+en_sampler_status_t Sampler_SetOversampling(sampler_t *sampler, uint16_t ratio);
+en_sampler_status_t Sampler_SetDiscardCount(sampler_t *sampler, uint8_t channel, uint16_t count);
+en_sampler_status_t Sampler_SetTimestampTimer(sampler_t *sampler, TCPWM_Type *timer, uint8_t timer_chan);
+uint32_t Sampler_GetTimestamp(sampler_t *sampler);
+en_sampler_status_t Sampler_SetFrameTags(sampler_t *sampler, bool enable);
+en_sampler_status_t Sampler_ReadFrame(sampler_t *sampler, uint8_t buffer, int16_t *frame, uint32_t *timestamp);
 en_sampler_status_t Sampler_Configure(sampler_t *sampler, uint8_t num_channels, int16_t *samples);
+en_sampler_status_t Sampler_ConfigurePingPong(sampler_t *sampler, uint8_t num_channels, int16_t *ping, int16_t *pong);
+en_sampler_status_t Sampler_ConfigureRing(sampler_t *sampler, uint8_t num_channels, int16_t *ring, uint16_t num_frames);
+en_sampler_status_t Sampler_ConfigureDescriptors(sampler_t *sampler, cy_stc_dma_descriptor_t *descriptors, 
+                                                 uint16_t num_descriptors);
+en_sampler_status_t Sampler_RegisterCallback(sampler_t *sampler, sampler_callback_t callback, void *arg);
 en_sampler_status_t Sampler_Start(sampler_t *sampler);
 en_sampler_status_t Sampler_Stop(sampler_t *sampler);
 en_sampler_status_t Sampler_SetupDMA(sampler_t *sampler, DW_Type *dma_base, uint32_t dma_chan);
+void Sampler_IRQHandler(sampler_t *sampler);
+en_sampler_status_t Sampler_GetStats(sampler_t *sampler, sampler_stats_t *stats);
+en_sampler_status_t Sampler_SetChannelMask(sampler_t *sampler, uint32_t mask,
+                                           cy_stc_dma_descriptor_t *link,
+                                           cy_stc_dma_descriptor_t *link_next);
+en_sampler_status_t Sampler_GetChannelMask(sampler_t *sampler, uint32_t *mask);
+uint32_t Sampler_RingGetHead(sampler_t *sampler);
+uint32_t Sampler_RingGetTail(sampler_t *sampler);
+uint32_t Sampler_RingGetFrames(sampler_t *sampler, int16_t **frames);
+en_sampler_status_t Sampler_RingRelease(sampler_t *sampler, uint32_t num_frames);
+en_sampler_status_t Sampler_RingArm(sampler_t *sampler, uint16_t pre_frames, uint16_t post_frames);
+en_sampler_status_t Sampler_RingTrigger(sampler_t *sampler, uint32_t frame);
+en_sampler_status_t Sampler_RingGetCapture(sampler_t *sampler, uint32_t *first, uint32_t *num_frames);
+int16_t *Sampler_RingGetFrame(sampler_t *sampler, uint32_t frame);
 void Sampler_Deinit(sampler_t *sampler);
 
 
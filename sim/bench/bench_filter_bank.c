@@ -0,0 +1,199 @@
+/*******************************************************************************
+* File Name: bench_filter_bank.c
+*
+*  Description: This file contains the benchmark of the filter bank, run by
+*   "make -C sim bench": 24 channels, each with a low-pass biquad and a
+*   third-order CIC decimating by 8. It prints the largest error of the
+*   first channel against a double-precision reference, and the host time
+*   per input frame and channel samples per second of FilterBank_Process().
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include "filter_bank.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (24u)
+#define DECIMATION                     (8u)
+#define CIC_ORDER                      (3u)
+#define CHECK_FRAMES                   (80000u)
+#define BENCH_FRAMES                   (2000000u)
+
+/* The filters settle during the first frames */
+#define SETTLE_FRAMES                  (1000u)
+
+/* Cut-off of the biquad, as a fraction of the sample rate, and its Q */
+#define BIQUAD_CUTOFF                  (0.05)
+#define BIQUAD_Q                       (0.7071)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static filter_bank_t bank;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static double Bench_Now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((double)now.tv_sec * 1e9) + (double)now.tv_nsec;
+}
+
+int main(void)
+{
+    const double pi = 3.14159265358979323846;
+    const double w = 2.0 * pi * BIQUAD_CUTOFF;
+    const double alpha = sin(w) / (2.0 * BIQUAD_Q);
+    const double a0 = 1.0 + alpha;
+    /* Normalized by a0, in the order of FilterBank_SetBiquads() */
+    const double ref[FILTER_BANK_COEFFS_PER_BIQUAD] =
+    {
+        (1.0 - cos(w)) / 2.0 / a0, (1.0 - cos(w)) / a0, (1.0 - cos(w)) / 2.0 / a0,
+        -2.0 * cos(w) / a0, (1.0 - alpha) / a0,
+    };
+    int16_t coeffs[FILTER_BANK_COEFFS_PER_BIQUAD];
+    int16_t input[NUM_CHANNELS];
+    int16_t output[NUM_CHANNELS];
+    double x[2] = { 0.0, 0.0 };
+    double y[2] = { 0.0, 0.0 };
+    double integrator[CIC_ORDER] = { 0.0 };
+    double comb[CIC_ORDER] = { 0.0 };
+    double max_error = 0.0;
+    uint32_t checksum = 0;
+    double start;
+    double ns_per_frame;
+    volatile int16_t sink = 0;
+    en_filter_bank_status_t status;
+
+    for (uint32_t i = 0; i < FILTER_BANK_COEFFS_PER_BIQUAD; i++)
+    {
+        coeffs[i] = (int16_t)lround(ref[i] * (double)(1u << FILTER_BANK_COEFF_SHIFT));
+    }
+
+    if (FilterBank_Init(&bank, NUM_CHANNELS, DECIMATION) != FILTER_BANK_SUCCESS)
+    {
+        return 1;
+    }
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        if ((FilterBank_SetBiquads(&bank, ch, coeffs, 1u) != FILTER_BANK_SUCCESS) ||
+            (FilterBank_SetCic(&bank, ch, CIC_ORDER) != FILTER_BANK_SUCCESS))
+        {
+            return 1;
+        }
+    }
+
+    /* Accuracy of the first channel: noisy sine waves of different rates */
+    srand(1);
+    for (uint32_t n = 0; n < CHECK_FRAMES; n++)
+    {
+        double value;
+
+        for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+        {
+            input[ch] = (int16_t)(2048.0 + (1500.0 * sin((double)n * 0.01 * (double)(ch + 1u))) + 
+                                  (double)((rand() % 64) - 32));
+        }
+        status = FilterBank_Process(&bank, input, output);
+
+        value = (ref[0] * input[0]) + (ref[1] * x[0]) + (ref[2] * x[1]) - (ref[3] * y[0]) - (ref[4] * y[1]);
+        x[1] = x[0];
+        x[0] = input[0];
+        y[1] = y[0];
+        y[0] = value;
+        for (uint32_t k = 0; k < CIC_ORDER; k++)
+        {
+            integrator[k] += value;
+            value = integrator[k];
+        }
+
+        if (status == FILTER_BANK_SUCCESS)
+        {
+            for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+            {
+                checksum = (checksum * 31u) + (uint16_t)output[ch];
+            }
+            for (uint32_t k = 0; k < CIC_ORDER; k++)
+            {
+                double previous = comb[k];
+
+                comb[k] = value;
+                value -= previous;
+            }
+            /* Gain of the CIC: decimation^order */
+            value /= pow(DECIMATION, CIC_ORDER);
+            if ((n > SETTLE_FRAMES) && (fabs(value - output[0]) > max_error))
+            {
+                max_error = fabs(value - output[0]);
+            }
+        }
+        else if (status != FILTER_BANK_PENDING)
+        {
+            return 1;
+        }
+    }
+
+    /* Speed */
+    FilterBank_Reset(&bank);
+    start = Bench_Now();
+    for (uint32_t n = 0; n < BENCH_FRAMES; n++)
+    {
+        input[n % NUM_CHANNELS] ^= (int16_t)(n & 7u);
+        if (FilterBank_Process(&bank, input, output) == FILTER_BANK_SUCCESS)
+        {
+            sink += output[3];
+        }
+    }
+    ns_per_frame = (Bench_Now() - start) / BENCH_FRAMES;
+
+    printf("bench_filter_bank: %u channels, 1 biquad, CIC order %u, decimation %u, %s path\n",
+           (unsigned)NUM_CHANNELS, (unsigned)CIC_ORDER, (unsigned)DECIMATION,
+           (FILTER_BANK_USE_SIMD != 0) ? "SIMD" : "portable C");
+    printf("max error %.2f LSB, checksum %08x, %.1f ns/frame, %.1f M channel samples/s\n",
+           max_error, (unsigned)checksum, ns_per_frame, (NUM_CHANNELS * 1e3) / ns_per_frame);
+
+    /* Within 4 LSB of the reference */
+    return (max_error <= 4.0) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,169 @@
+/*******************************************************************************
+* File Name: bench_frame_codec.c
+*
+*  Description: This file contains the benchmark of the delta frame codec, run by
+*   "make -C sim bench": 24-channel frames of slowly drifting 12-bit signals,
+*   with 0, 4 or 24 channels dithered by +/-1 LSB. It prints the encoded
+*   bytes per frame, the compression ratio with and without the telemetry
+*   packet overhead, and the host time to encode and decode a frame. Every
+*   frame shall decode bit-exact.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include "frame_codec.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (24u)
+#define NUM_FRAMES                     (50000u)
+#define KEY_INTERVAL                   (100u)
+#define ENCODED_SIZE                   (FRAME_CODEC_MAX_SIZE(NUM_CHANNELS))
+
+/* Header and CRC of a telemetry packet */
+#define PACKET_OVERHEAD                (TELEMETRY_HEADER_SIZE + TELEMETRY_CRC_SIZE)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static int16_t frames[NUM_FRAMES][NUM_CHANNELS];
+static uint8_t encoded[NUM_FRAMES][ENCODED_SIZE];
+static uint32_t lengths[NUM_FRAMES];
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static double Bench_Now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((double)now.tv_sec * 1e9) + (double)now.tv_nsec;
+}
+
+/* The dithered channels move by +/-1 LSB, the quiet ones in steps of 8 LSB */
+static void Bench_MakeFrames(uint32_t num_dithered)
+{
+    srand(3);
+    for (uint32_t f = 0; f < NUM_FRAMES; f++)
+    {
+        for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+        {
+            int32_t value = (int32_t)(2048.0 + (1000.0 * sin((double)f * 1e-4 * (double)(ch + 1u))));
+
+            if (ch < num_dithered)
+            {
+                value += (rand() % 3) - 1;
+            }
+            else
+            {
+                value &= ~7;
+            }
+            frames[f][ch] = (int16_t)value;
+        }
+    }
+}
+
+static int Bench_Run(uint32_t num_dithered)
+{
+    frame_codec_t encoder;
+    frame_codec_t decoder;
+    int16_t frame[NUM_CHANNELS];
+    uint32_t length;
+    uint64_t bytes = 0;
+    uint32_t errors = 0;
+    double start;
+    double encode_ns;
+    double decode_ns;
+    double bytes_per_frame;
+
+    Bench_MakeFrames(num_dithered);
+    FrameCodec_Init(&encoder, NUM_CHANNELS, KEY_INTERVAL);
+    FrameCodec_Init(&decoder, NUM_CHANNELS, 0u);
+
+    start = Bench_Now();
+    for (uint32_t f = 0; f < NUM_FRAMES; f++)
+    {
+        if (FrameCodec_Encode(&encoder, frames[f], encoded[f], ENCODED_SIZE, &lengths[f]) != 
+            FRAME_CODEC_SUCCESS)
+        {
+            errors++;
+        }
+        bytes += lengths[f];
+    }
+    encode_ns = (Bench_Now() - start) / NUM_FRAMES;
+
+    start = Bench_Now();
+    for (uint32_t f = 0; f < NUM_FRAMES; f++)
+    {
+        if ((FrameCodec_Decode(&decoder, encoded[f], lengths[f], frame, &length) != FRAME_CODEC_SUCCESS) ||
+            (length != lengths[f]) || (memcmp(frame, frames[f], sizeof(frame)) != 0))
+        {
+            errors++;
+        }
+    }
+    decode_ns = (Bench_Now() - start) / NUM_FRAMES;
+
+    bytes_per_frame = (double)bytes / NUM_FRAMES;
+    printf("%2u dithered: %5.2f B/frame (raw %u), ratio %.1fx, %.1fx per packet, "
+           "encode %.0f ns/frame, decode %.0f ns/frame, errors %u\n",
+           (unsigned)num_dithered, bytes_per_frame, (unsigned)(NUM_CHANNELS * sizeof(int16_t)),
+           (double)(NUM_CHANNELS * sizeof(int16_t)) / bytes_per_frame,
+           (double)((NUM_CHANNELS * sizeof(int16_t)) + PACKET_OVERHEAD) / (bytes_per_frame + PACKET_OVERHEAD),
+           encode_ns, decode_ns, (unsigned)errors);
+
+    return (errors == 0u) ? 0 : 1;
+}
+
+int main(void)
+{
+    int status = 0;
+
+    printf("bench_frame_codec: %u frames of %u channels, key frame every %u\n",
+           (unsigned)NUM_FRAMES, (unsigned)NUM_CHANNELS, (unsigned)KEY_INTERVAL);
+    status |= Bench_Run(0u);
+    status |= Bench_Run(4u);
+    status |= Bench_Run(NUM_CHANNELS);
+
+    return status;
+}
+
+/* [] END OF FILE */
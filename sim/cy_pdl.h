@@ -0,0 +1,713 @@
+/*****************************************************************************
+* File Name  : cy_pdl.h
+*
+* Description: This file is a host replacement of the subset of the PDL used by
+*              the AMux and Sampler middleware. The peripherals are emulated by
+*              sim.c, see sim.h for the simulator controls.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef CY_PDL_SIM_H_
+#define CY_PDL_SIM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*                                 Utilities
+*******************************************************************************/
+#define CY_ASSERT(x)                    do { if (!(x)) { Sim_Assert(__FILE__, __LINE__); } } while (0)
+
+#define _VAL2FLD(field, value)          (((uint32_t)(value) << field ## _Pos) & field ## _Msk)
+#define _FLD2VAL(field, value)          (((uint32_t)(value) & field ## _Msk) >> field ## _Pos)
+#define _BOOL2FLD(field, value)         (((value) != false) ? (field ## _Msk) : 0UL)
+
+#define CY_SET_REG32(addr, value)       (*((volatile uint32_t *)(uintptr_t)(addr)) = (uint32_t)(value))
+#define CY_GET_REG32(addr)              (*((volatile uint32_t const *)(uintptr_t)(addr)))
+#define CY_REG32_CLR_SET(reg, field, value) \
+    ((reg) = (((reg) & ~(field ## _Msk)) | _VAL2FLD(field, value)))
+
+#define __DMB()                         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __DSB()                         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __enable_irq()                  do { } while (0)
+#define __disable_irq()                 do { } while (0)
+
+/* Cortex-M4 SIMD intrinsics, so the DSP code paths can also be run on a PC */
+#define __PKHBT(ARG1, ARG2, ARG3)       ((((uint32_t)(ARG1)) & 0x0000FFFFUL) | \
+                                         ((((uint32_t)(ARG2)) << (ARG3)) & 0xFFFF0000UL))
+#define __PKHTB(ARG1, ARG2, ARG3)       ((((uint32_t)(ARG1)) & 0xFFFF0000UL) | \
+                                         ((((uint32_t)(ARG2)) >> (ARG3)) & 0x0000FFFFUL))
+
+static inline uint32_t __SMLAD(uint32_t op1, uint32_t op2, uint32_t op3)
+{
+    return op3 + (uint32_t)(((int32_t)(int16_t) op1 * (int16_t) op2) + 
+                            ((int32_t)(int16_t)(op1 >> 16) * (int16_t)(op2 >> 16)));
+}
+
+static inline int32_t __SSAT(int32_t val, uint32_t sat)
+{
+    int32_t max = (int32_t)((1UL << (sat - 1u)) - 1u);
+
+    return (val > max) ? max : ((val < (-max - 1)) ? (-max - 1) : val);
+}
+
+static inline uint32_t __QSUB16(uint32_t op1, uint32_t op2)
+{
+    int32_t lo = __SSAT((int32_t)(int16_t) op1 - (int16_t) op2, 16);
+    int32_t hi = __SSAT((int32_t)(int16_t)(op1 >> 16) - (int16_t)(op2 >> 16), 16);
+
+    return ((uint32_t) lo & 0x0000FFFFUL) | ((uint32_t) hi << 16);
+}
+
+uint32_t Cy_SysLib_EnterCriticalSection(void);
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus);
+void CyDelay(uint32_t milliseconds);
+void Sim_Assert(const char *file, int line);
+
+/*******************************************************************************
+*                              System Power (SysPm)
+*******************************************************************************/
+typedef enum
+{
+    CY_SYSPM_SUCCESS = 0x0U,
+    CY_SYSPM_BAD_PARAM = 0x1U,
+    CY_SYSPM_TIMEOUT = 0x2U,
+    CY_SYSPM_INVALID_STATE = 0x3U,
+    CY_SYSPM_CANCELED = 0x4U,
+    CY_SYSPM_SYSCALL_PENDING = 0x5U,
+    CY_SYSPM_FAIL = 0x6U,
+} cy_en_syspm_status_t;
+
+typedef enum
+{
+    CY_SYSPM_WAIT_FOR_INTERRUPT,
+    CY_SYSPM_WAIT_FOR_EVENT,
+} cy_en_syspm_waitfor_t;
+
+typedef enum
+{
+    CY_SYSPM_SLEEP = 0U,
+    CY_SYSPM_DEEPSLEEP = 1U,
+    CY_SYSPM_HIBERNATE = 2U,
+    CY_SYSPM_ULP = 3U,
+    CY_SYSPM_LP = 4U,
+} cy_en_syspm_callback_type_t;
+
+typedef enum
+{
+    CY_SYSPM_CHECK_READY = 0x01U,
+    CY_SYSPM_CHECK_FAIL = 0x02U,
+    CY_SYSPM_BEFORE_TRANSITION = 0x04U,
+    CY_SYSPM_AFTER_TRANSITION = 0x08U,
+} cy_en_syspm_callback_mode_t;
+
+typedef struct
+{
+    void *base;
+    void *context;
+} cy_stc_syspm_callback_params_t;
+
+typedef cy_en_syspm_status_t (*Cy_SysPmCallback)(cy_stc_syspm_callback_params_t *callbackParams,
+                                                 cy_en_syspm_callback_mode_t mode);
+
+typedef struct cy_stc_syspm_callback
+{
+    Cy_SysPmCallback callback;
+    cy_en_syspm_callback_type_t type;
+    uint32_t skipMode;
+    cy_stc_syspm_callback_params_t *callbackParams;
+    struct cy_stc_syspm_callback *prevItm;
+    struct cy_stc_syspm_callback *nextItm;
+    uint8_t order;
+} cy_stc_syspm_callback_t;
+
+bool Cy_SysPm_RegisterCallback(cy_stc_syspm_callback_t *handler);
+bool Cy_SysPm_UnregisterCallback(cy_stc_syspm_callback_t const *handler);
+cy_en_syspm_status_t Cy_SysPm_CpuEnterDeepSleep(cy_en_syspm_waitfor_t waitFor);
+
+/*******************************************************************************
+*                          Memory map of the emulated part
+*******************************************************************************/
+#define CY_SIM_PERI_BASE                (0x40000000UL)
+#define CY_SIM_PERI_SIZE                (0x01000000UL)
+
+#define CY_DW0_BASE                     (0x40280000UL)
+#define CY_DW1_BASE                     (0x40290000UL)
+#define HSIOM_BASE                      (0x40310000UL)
+#define CY_GPIO_BASE                    (0x40320000UL)
+#define CY_SCB0_BASE                    (0x40600000UL)
+#define CY_TCPWM0_BASE                  (0x40380000UL)
+#define CY_TCPWM1_BASE                  (0x40390000UL)
+#define CY_SAR0_BASE                    (0x409D0000UL)
+#define CY_SAR1_BASE                    (0x409E0000UL)
+#define CY_MCWDT_BASE                   (0x40260200UL)
+
+/* As in the PDL, CY_HSIOM_BASE is read from the device description at run 
+ * time, so it is not a constant expression. HSIOM_BASE of the device header 
+ * is the constant */
+extern const uint32_t cy_sim_hsiom_base;
+#define CY_HSIOM_BASE                   (cy_sim_hsiom_base)
+
+/*******************************************************************************
+*                                GPIO / HSIOM
+*******************************************************************************/
+#define IOSS_GPIO_GPIO_PORT_NR          (15u)
+#define CY_GPIO_PINS_MAX                (8u)
+#define CY_GPIO_PRT_HALF                (4u)
+#define GPIO_PRT_SECTION_SIZE           (0x00000080UL)
+#define HSIOM_PRT_SECTION_SIZE          (0x00000010UL)
+
+#define HSIOM_SEL_GPIO                  (0u)
+#define HSIOM_SEL_AMUXA                 (4u)
+#define HSIOM_SEL_AMUXB                 (5u)
+
+typedef struct
+{
+    volatile uint32_t OUT;
+    volatile uint32_t OUT_CLR;
+    volatile uint32_t OUT_SET;
+    volatile uint32_t OUT_INV;
+    volatile uint32_t IN;
+    uint32_t RESERVED[27];
+} GPIO_PRT_Type;
+
+typedef struct
+{
+    volatile uint32_t PORT_SEL0;
+    volatile uint32_t PORT_SEL1;
+    uint32_t RESERVED[2];
+} HSIOM_PRT_Type;
+
+#define GPIO_PRT0                       ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0000UL))
+#define GPIO_PRT1                       ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0080UL))
+#define GPIO_PRT2                       ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0100UL))
+#define GPIO_PRT3                       ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0180UL))
+#define GPIO_PRT4                       ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0200UL))
+#define GPIO_PRT5                       ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0280UL))
+#define GPIO_PRT6                       ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0300UL))
+#define GPIO_PRT7                       ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0380UL))
+#define GPIO_PRT8                       ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0400UL))
+#define GPIO_PRT9                       ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0480UL))
+#define GPIO_PRT10                      ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0500UL))
+#define GPIO_PRT11                      ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0580UL))
+#define GPIO_PRT12                      ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0600UL))
+#define GPIO_PRT13                      ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0680UL))
+#define GPIO_PRT14                      ((GPIO_PRT_Type*) (CY_GPIO_BASE + 0x0700UL))
+
+/*******************************************************************************
+*                               DataWire (DW)
+*******************************************************************************/
+typedef struct
+{
+    volatile uint32_t CTL;
+    uint32_t RESERVED[0x3FFF];
+} DW_Type;
+
+#define DW0                             ((DW_Type*) CY_DW0_BASE)
+#define DW1                             ((DW_Type*) CY_DW1_BASE)
+#define CY_DMA_NUM_CHANNELS             (32u)
+
+#define CY_DMA_LOOP_COUNT_MIN           (1UL)
+#define CY_DMA_LOOP_COUNT_MAX           (256UL)
+#define CY_DMA_LOOP_INCREMENT_MIN       (-2048L)
+#define CY_DMA_LOOP_INCREMENT_MAX       (2047L)
+#define CY_DMA_INTR_MASK                (0x01UL)
+
+#define CY_DMA_CTL_RETRIG_Pos           (0UL)
+#define CY_DMA_CTL_RETRIG_Msk           ((uint32_t)0x3UL << CY_DMA_CTL_RETRIG_Pos)
+#define CY_DMA_CTL_INTR_TYPE_Pos        (2UL)
+#define CY_DMA_CTL_INTR_TYPE_Msk        ((uint32_t)0x3UL << CY_DMA_CTL_INTR_TYPE_Pos)
+#define CY_DMA_CTL_TR_OUT_TYPE_Pos      (4UL)
+#define CY_DMA_CTL_TR_OUT_TYPE_Msk      ((uint32_t)0x3UL << CY_DMA_CTL_TR_OUT_TYPE_Pos)
+#define CY_DMA_CTL_TR_IN_TYPE_Pos       (8UL)
+#define CY_DMA_CTL_TR_IN_TYPE_Msk       ((uint32_t)0x3UL << CY_DMA_CTL_TR_IN_TYPE_Pos)
+#define CY_DMA_CTL_CH_DISABLE_Pos       (24UL)
+#define CY_DMA_CTL_CH_DISABLE_Msk       ((uint32_t)0x1UL << CY_DMA_CTL_CH_DISABLE_Pos)
+#define CY_DMA_CTL_SRC_SIZE_Pos         (26UL)
+#define CY_DMA_CTL_SRC_SIZE_Msk         ((uint32_t)0x1UL << CY_DMA_CTL_SRC_SIZE_Pos)
+#define CY_DMA_CTL_DST_SIZE_Pos         (27UL)
+#define CY_DMA_CTL_DST_SIZE_Msk         ((uint32_t)0x1UL << CY_DMA_CTL_DST_SIZE_Pos)
+#define CY_DMA_CTL_DATA_SIZE_Pos        (28UL)
+#define CY_DMA_CTL_DATA_SIZE_Msk        ((uint32_t)0x3UL << CY_DMA_CTL_DATA_SIZE_Pos)
+#define CY_DMA_CTL_TYPE_Pos             (30UL)
+#define CY_DMA_CTL_TYPE_Msk             ((uint32_t)0x3UL << CY_DMA_CTL_TYPE_Pos)
+
+#define CY_DMA_CTL_SRC_INCR_Pos         (0UL)
+#define CY_DMA_CTL_SRC_INCR_Msk         ((uint32_t)0xFFFUL << CY_DMA_CTL_SRC_INCR_Pos)
+#define CY_DMA_CTL_DST_INCR_Pos         (12UL)
+#define CY_DMA_CTL_DST_INCR_Msk         ((uint32_t)0xFFFUL << CY_DMA_CTL_DST_INCR_Pos)
+#define CY_DMA_CTL_COUNT_Pos            (24UL)
+#define CY_DMA_CTL_COUNT_Msk            ((uint32_t)0xFFUL << CY_DMA_CTL_COUNT_Pos)
+
+typedef enum
+{
+    CY_DMA_SUCCESS   = 0x00UL,
+    CY_DMA_BAD_PARAM = 0x01UL,
+} cy_en_dma_status_t;
+
+typedef enum
+{
+    CY_DMA_RETRIG_IM      = 0UL,
+    CY_DMA_RETRIG_4CYC    = 1UL,
+    CY_DMA_RETRIG_16CYC   = 2UL,
+    CY_DMA_WAIT_FOR_REACT = 3UL,
+} cy_en_dma_retrigger_t;
+
+typedef enum
+{
+    CY_DMA_1ELEMENT    = 0UL,
+    CY_DMA_X_LOOP      = 1UL,
+    CY_DMA_DESCR       = 2UL,
+    CY_DMA_DESCR_CHAIN = 3UL,
+} cy_en_dma_trigger_type_t;
+
+typedef enum
+{
+    CY_DMA_CHANNEL_ENABLED  = 0UL,
+    CY_DMA_CHANNEL_DISABLED = 1UL,
+} cy_en_dma_channel_state_t;
+
+typedef enum
+{
+    CY_DMA_BYTE     = 0UL,
+    CY_DMA_HALFWORD = 1UL,
+    CY_DMA_WORD     = 2UL,
+} cy_en_dma_data_size_t;
+
+typedef enum
+{
+    CY_DMA_TRANSFER_SIZE_DATA = 0UL,
+    CY_DMA_TRANSFER_SIZE_WORD = 1UL,
+} cy_en_dma_transfer_size_t;
+
+typedef enum
+{
+    CY_DMA_SINGLE_TRANSFER = 0UL,
+    CY_DMA_1D_TRANSFER     = 1UL,
+    CY_DMA_2D_TRANSFER     = 2UL,
+    CY_DMA_CRC_TRANSFER    = 3UL,
+} cy_en_dma_descriptor_type_t;
+
+typedef enum
+{
+    CY_DMA_INTR_CAUSE_NO_INTR            = 0x00UL,
+    CY_DMA_INTR_CAUSE_COMPLETION         = 0x01UL,
+    CY_DMA_INTR_CAUSE_SRC_BUS_ERROR      = 0x02UL,
+    CY_DMA_INTR_CAUSE_DST_BUS_ERROR      = 0x03UL,
+    CY_DMA_INTR_CAUSE_SRC_MISAL          = 0x04UL,
+    CY_DMA_INTR_CAUSE_DST_MISAL          = 0x05UL,
+    CY_DMA_INTR_CAUSE_CURR_PTR_NULL      = 0x06UL,
+    CY_DMA_INTR_CAUSE_ACTIVE_CH_DISABLED = 0x07UL,
+    CY_DMA_INTR_CAUSE_DESCR_BUS_ERROR    = 0x08UL,
+} cy_en_dma_intr_cause_t;
+
+typedef struct
+{
+    uint32_t ctl;
+    uint32_t src;
+    uint32_t dst;
+    uint32_t xCtl;
+    uint32_t yCtl;
+    uint32_t nextPtr;
+} cy_stc_dma_descriptor_t;
+
+typedef struct
+{
+    cy_en_dma_retrigger_t       retrigger;
+    cy_en_dma_trigger_type_t    interruptType;
+    cy_en_dma_trigger_type_t    triggerOutType;
+    cy_en_dma_channel_state_t   channelState;
+    cy_en_dma_trigger_type_t    triggerInType;
+    cy_en_dma_data_size_t       dataSize;
+    cy_en_dma_transfer_size_t   srcTransferSize;
+    cy_en_dma_transfer_size_t   dstTransferSize;
+    cy_en_dma_descriptor_type_t descriptorType;
+    void *                      srcAddress;
+    void *                      dstAddress;
+    int32_t                     srcXincrement;
+    int32_t                     dstXincrement;
+    uint32_t                    xCount;
+    int32_t                     srcYincrement;
+    int32_t                     dstYincrement;
+    uint32_t                    yCount;
+    cy_stc_dma_descriptor_t *   nextDescriptor;
+} cy_stc_dma_descriptor_config_t;
+
+typedef struct
+{
+    cy_stc_dma_descriptor_t * descriptor;
+    bool                      preemptable;
+    uint32_t                  priority;
+    bool                      enable;
+    bool                      bufferable;
+} cy_stc_dma_channel_config_t;
+
+cy_en_dma_status_t Cy_DMA_Descriptor_Init(cy_stc_dma_descriptor_t * descriptor, cy_stc_dma_descriptor_config_t const * config);
+void Cy_DMA_Descriptor_DeInit(cy_stc_dma_descriptor_t * descriptor);
+void Cy_DMA_Descriptor_SetSrcAddress(cy_stc_dma_descriptor_t * descriptor, void const * srcAddress);
+void Cy_DMA_Descriptor_SetDstAddress(cy_stc_dma_descriptor_t * descriptor, void const * dstAddress);
+void * Cy_DMA_Descriptor_GetSrcAddress(cy_stc_dma_descriptor_t const * descriptor);
+void * Cy_DMA_Descriptor_GetDstAddress(cy_stc_dma_descriptor_t const * descriptor);
+void Cy_DMA_Descriptor_SetNextDescriptor(cy_stc_dma_descriptor_t * descriptor, cy_stc_dma_descriptor_t const * nextDescriptor);
+cy_stc_dma_descriptor_t * Cy_DMA_Descriptor_GetNextDescriptor(cy_stc_dma_descriptor_t const * descriptor);
+void Cy_DMA_Descriptor_SetDescriptorType(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_descriptor_type_t descriptorType);
+void Cy_DMA_Descriptor_SetInterruptType(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_trigger_type_t interruptType);
+void Cy_DMA_Descriptor_SetTriggerInType(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_trigger_type_t triggerInType);
+void Cy_DMA_Descriptor_SetTriggerOutType(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_trigger_type_t triggerOutType);
+void Cy_DMA_Descriptor_SetChannelState(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_channel_state_t channelState);
+void Cy_DMA_Descriptor_SetDataSize(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_data_size_t dataSize);
+void Cy_DMA_Descriptor_SetSrcTransferSize(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_transfer_size_t srcTransferSize);
+void Cy_DMA_Descriptor_SetDstTransferSize(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_transfer_size_t dstTransferSize);
+void Cy_DMA_Descriptor_SetXloopDataCount(cy_stc_dma_descriptor_t * descriptor, uint32_t xCount);
+uint32_t Cy_DMA_Descriptor_GetXloopDataCount(cy_stc_dma_descriptor_t const * descriptor);
+void Cy_DMA_Descriptor_SetXloopSrcIncrement(cy_stc_dma_descriptor_t * descriptor, int32_t srcXincrement);
+void Cy_DMA_Descriptor_SetXloopDstIncrement(cy_stc_dma_descriptor_t * descriptor, int32_t dstXincrement);
+void Cy_DMA_Descriptor_SetYloopDataCount(cy_stc_dma_descriptor_t * descriptor, uint32_t yCount);
+uint32_t Cy_DMA_Descriptor_GetYloopDataCount(cy_stc_dma_descriptor_t const * descriptor);
+void Cy_DMA_Descriptor_SetYloopSrcIncrement(cy_stc_dma_descriptor_t * descriptor, int32_t srcYincrement);
+void Cy_DMA_Descriptor_SetYloopDstIncrement(cy_stc_dma_descriptor_t * descriptor, int32_t dstYincrement);
+
+cy_en_dma_status_t Cy_DMA_Channel_Init(DW_Type * base, uint32_t channel, cy_stc_dma_channel_config_t const * config);
+void Cy_DMA_Channel_DeInit(DW_Type * base, uint32_t channel);
+void Cy_DMA_Channel_SetDescriptor(DW_Type * base, uint32_t channel, cy_stc_dma_descriptor_t const * descriptor);
+cy_stc_dma_descriptor_t * Cy_DMA_Channel_GetCurrentDescriptor(DW_Type const * base, uint32_t channel);
+uint32_t Cy_DMA_Channel_GetCurrentXloopIndex(DW_Type const * base, uint32_t channel);
+uint32_t Cy_DMA_Channel_GetCurrentYloopIndex(DW_Type const * base, uint32_t channel);
+void Cy_DMA_Channel_Enable(DW_Type * base, uint32_t channel);
+void Cy_DMA_Channel_Disable(DW_Type * base, uint32_t channel);
+cy_en_dma_intr_cause_t Cy_DMA_Channel_GetStatus(DW_Type const * base, uint32_t channel);
+uint32_t Cy_DMA_Channel_GetInterruptStatus(DW_Type const * base, uint32_t channel);
+uint32_t Cy_DMA_Channel_GetInterruptStatusMasked(DW_Type const * base, uint32_t channel);
+void Cy_DMA_Channel_ClearInterrupt(DW_Type * base, uint32_t channel);
+void Cy_DMA_Channel_SetInterruptMask(DW_Type * base, uint32_t channel, uint32_t interrupt);
+uint32_t Cy_DMA_Channel_GetInterruptMask(DW_Type const * base, uint32_t channel);
+void Cy_DMA_Enable(DW_Type * base);
+void Cy_DMA_Disable(DW_Type * base);
+
+/*******************************************************************************
+*                                  TCPWM
+*******************************************************************************/
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t STATUS;
+    volatile uint32_t COUNTER;
+    volatile uint32_t CC;
+    volatile uint32_t CC_BUFF;
+    volatile uint32_t PERIOD;
+    volatile uint32_t PERIOD_BUFF;
+    uint32_t RESERVED;
+    volatile uint32_t TR_CTRL0;
+    volatile uint32_t TR_CTRL1;
+    volatile uint32_t TR_CTRL2;
+    uint32_t RESERVED1;
+    volatile uint32_t INTR;
+    volatile uint32_t INTR_SET;
+    volatile uint32_t INTR_MASK;
+    volatile uint32_t INTR_MASKED;
+} TCPWM_CNT_Type;
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    uint32_t RESERVED[63];
+    TCPWM_CNT_Type CNT[32];
+} TCPWM_Type;
+
+#define TCPWM0                          ((TCPWM_Type*) CY_TCPWM0_BASE)
+#define TCPWM1                          ((TCPWM_Type*) CY_TCPWM1_BASE)
+
+#define TCPWM_CNT_COUNTER(base, cntNum) (((TCPWM_Type *)(base))->CNT[cntNum].COUNTER)
+#define TCPWM_CNT_CTRL_AUTO_RELOAD_CC_Msk (0x00000001UL)
+#define TCPWM_CNT_CTRL_AUTO_RELOAD_PERIOD_Msk (0x00000002UL)
+
+#define CY_TCPWM_SUCCESS                (0UL)
+#define CY_TCPWM_BAD_PARAM              (1UL)
+
+#define CY_TCPWM_INT_NONE               (0U)
+#define CY_TCPWM_INT_ON_TC              (1U)
+#define CY_TCPWM_INT_ON_CC              (2U)
+#define CY_TCPWM_INT_ON_CC_OR_TC        (3U)
+
+#define CY_TCPWM_INPUT_0                (0U)
+#define CY_TCPWM_INPUT_1                (1U)
+#define CY_TCPWM_INPUT_DISABLED         (7U)
+
+#define CY_TCPWM_COUNTER_PRESCALER_DIVBY_1 (0U)
+#define CY_TCPWM_COUNTER_ONESHOT        (1U)
+#define CY_TCPWM_COUNTER_CONTINUOUS     (0U)
+#define CY_TCPWM_COUNTER_COUNT_UP       (0U)
+#define CY_TCPWM_COUNTER_MODE_CAPTURE   (2U)
+#define CY_TCPWM_COUNTER_MODE_COMPARE   (0U)
+#define CY_TCPWM_COUNTER_STATUS_COUNTER_RUNNING (0x80000000UL)
+
+#define CY_TCPWM_PWM_MODE_PWM           (4U)
+#define CY_TCPWM_PWM_PRESCALER_DIVBY_1  (0U)
+#define CY_TCPWM_PWM_LEFT_ALIGN         (0U)
+#define CY_TCPWM_PWM_CONTINUOUS         (0U)
+#define CY_TCPWM_PWM_ONESHOT            (1U)
+#define CY_TCPWM_PWM_INVERT_DISABLE     (0U)
+#define CY_TCPWM_PWM_STOP_ON_KILL       (2U)
+#define CY_TCPWM_PWM_STATUS_COUNTER_RUNNING (0x80000000UL)
+
+typedef uint32_t cy_en_tcpwm_status_t;
+
+typedef struct
+{
+    uint32_t period;
+    uint32_t clockPrescaler;
+    uint32_t runMode;
+    uint32_t countDirection;
+    uint32_t compareOrCapture;
+    uint32_t compare0;
+    uint32_t compare1;
+    bool     enableCompareSwap;
+    uint32_t interruptSources;
+    uint32_t captureInputMode;
+    uint32_t captureInput;
+    uint32_t reloadInputMode;
+    uint32_t reloadInput;
+    uint32_t startInputMode;
+    uint32_t startInput;
+    uint32_t stopInputMode;
+    uint32_t stopInput;
+    uint32_t countInputMode;
+    uint32_t countInput;
+} cy_stc_tcpwm_counter_config_t;
+
+typedef struct
+{
+    uint32_t pwmMode;
+    uint32_t clockPrescaler;
+    uint32_t pwmAlignment;
+    uint32_t deadTimeClocks;
+    uint32_t runMode;
+    uint32_t period0;
+    uint32_t period1;
+    bool     enablePeriodSwap;
+    uint32_t compare0;
+    uint32_t compare1;
+    bool     enableCompareSwap;
+    uint32_t interruptSources;
+    uint32_t invertPWMOut;
+    uint32_t invertPWMOutN;
+    uint32_t killMode;
+    uint32_t swapInputMode;
+    uint32_t swapInput;
+    uint32_t reloadInputMode;
+    uint32_t reloadInput;
+    uint32_t startInputMode;
+    uint32_t startInput;
+    uint32_t killInputMode;
+    uint32_t killInput;
+    uint32_t countInputMode;
+    uint32_t countInput;
+} cy_stc_tcpwm_pwm_config_t;
+
+cy_en_tcpwm_status_t Cy_TCPWM_Counter_Init(TCPWM_Type *base, uint32_t cntNum, cy_stc_tcpwm_counter_config_t const *config);
+void Cy_TCPWM_Counter_DeInit(TCPWM_Type *base, uint32_t cntNum, cy_stc_tcpwm_counter_config_t const *config);
+void Cy_TCPWM_Counter_Enable(TCPWM_Type *base, uint32_t cntNum);
+void Cy_TCPWM_Counter_Disable(TCPWM_Type *base, uint32_t cntNum);
+void Cy_TCPWM_Counter_SetCounter(TCPWM_Type *base, uint32_t cntNum, uint32_t count);
+uint32_t Cy_TCPWM_Counter_GetCounter(TCPWM_Type const *base, uint32_t cntNum);
+void Cy_TCPWM_Counter_SetPeriod(TCPWM_Type *base, uint32_t cntNum, uint32_t period);
+uint32_t Cy_TCPWM_Counter_GetPeriod(TCPWM_Type const *base, uint32_t cntNum);
+void Cy_TCPWM_Counter_SetCompare0(TCPWM_Type *base, uint32_t cntNum, uint32_t compare0);
+uint32_t Cy_TCPWM_Counter_GetCompare0(TCPWM_Type const *base, uint32_t cntNum);
+void Cy_TCPWM_Counter_SetCompare1(TCPWM_Type *base, uint32_t cntNum, uint32_t compare1);
+uint32_t Cy_TCPWM_Counter_GetCompare1(TCPWM_Type const *base, uint32_t cntNum);
+void Cy_TCPWM_Counter_EnableCompareSwap(TCPWM_Type *base, uint32_t cntNum, bool enable);
+cy_en_tcpwm_status_t Cy_TCPWM_PWM_Init(TCPWM_Type *base, uint32_t cntNum, cy_stc_tcpwm_pwm_config_t const *config);
+void Cy_TCPWM_PWM_DeInit(TCPWM_Type *base, uint32_t cntNum, cy_stc_tcpwm_pwm_config_t const *config);
+void Cy_TCPWM_PWM_Enable(TCPWM_Type *base, uint32_t cntNum);
+void Cy_TCPWM_PWM_Disable(TCPWM_Type *base, uint32_t cntNum);
+uint32_t Cy_TCPWM_PWM_GetStatus(TCPWM_Type const *base, uint32_t cntNum);
+void Cy_TCPWM_PWM_SetCounter(TCPWM_Type *base, uint32_t cntNum, uint32_t count);
+uint32_t Cy_TCPWM_PWM_GetCounter(TCPWM_Type const *base, uint32_t cntNum);
+void Cy_TCPWM_PWM_SetPeriod0(TCPWM_Type *base, uint32_t cntNum, uint32_t period0);
+uint32_t Cy_TCPWM_PWM_GetPeriod0(TCPWM_Type const *base, uint32_t cntNum);
+void Cy_TCPWM_PWM_SetPeriod1(TCPWM_Type *base, uint32_t cntNum, uint32_t period1);
+uint32_t Cy_TCPWM_PWM_GetPeriod1(TCPWM_Type const *base, uint32_t cntNum);
+void Cy_TCPWM_PWM_SetCompare0(TCPWM_Type *base, uint32_t cntNum, uint32_t compare0);
+uint32_t Cy_TCPWM_PWM_GetCompare0(TCPWM_Type const *base, uint32_t cntNum);
+void Cy_TCPWM_PWM_SetCompare1(TCPWM_Type *base, uint32_t cntNum, uint32_t compare1);
+uint32_t Cy_TCPWM_PWM_GetCompare1(TCPWM_Type const *base, uint32_t cntNum);
+void Cy_TCPWM_TriggerStart_Single(TCPWM_Type *base, uint32_t cntNum);
+void Cy_TCPWM_TriggerCaptureOrSwap_Single(TCPWM_Type *base, uint32_t cntNum);
+void Cy_TCPWM_TriggerStopOrKill_Single(TCPWM_Type *base, uint32_t cntNum);
+uint32_t Cy_TCPWM_GetInterruptStatus(TCPWM_Type const *base, uint32_t cntNum);
+uint32_t Cy_TCPWM_GetInterruptStatusMasked(TCPWM_Type const *base, uint32_t cntNum);
+void Cy_TCPWM_ClearInterrupt(TCPWM_Type *base, uint32_t cntNum, uint32_t source);
+void Cy_TCPWM_SetInterruptMask(TCPWM_Type *base, uint32_t cntNum, uint32_t mask);
+uint32_t Cy_TCPWM_GetInterruptMask(TCPWM_Type const *base, uint32_t cntNum);
+
+/*******************************************************************************
+*                                 SCB (UART)
+*******************************************************************************/
+#define SCB_SECTION_SIZE                (0x00010000UL)
+#define CY_SCB_NUM                      (8u)
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    uint32_t RESERVED[143];
+    volatile uint32_t TX_FIFO_CTRL;
+    volatile uint32_t TX_FIFO_STATUS;
+    uint32_t RESERVED1[14];
+    volatile uint32_t TX_FIFO_WR;
+} CySCB_Type;
+
+#define SCB0                            ((CySCB_Type*) (CY_SCB0_BASE + 0x00000UL))
+#define SCB1                            ((CySCB_Type*) (CY_SCB0_BASE + 0x10000UL))
+#define SCB2                            ((CySCB_Type*) (CY_SCB0_BASE + 0x20000UL))
+#define SCB3                            ((CySCB_Type*) (CY_SCB0_BASE + 0x30000UL))
+#define SCB4                            ((CySCB_Type*) (CY_SCB0_BASE + 0x40000UL))
+#define SCB5                            ((CySCB_Type*) (CY_SCB0_BASE + 0x50000UL))
+#define SCB6                            ((CySCB_Type*) (CY_SCB0_BASE + 0x60000UL))
+#define SCB7                            ((CySCB_Type*) (CY_SCB0_BASE + 0x70000UL))
+
+#define SCB_TX_FIFO_CTRL_TRIGGER_LEVEL_Pos (0UL)
+#define SCB_TX_FIFO_CTRL_TRIGGER_LEVEL_Msk (0xFFUL)
+#define SCB_TX_FIFO_STATUS_USED_Pos     (0UL)
+#define SCB_TX_FIFO_STATUS_USED_Msk     (0x1FFUL)
+
+void Cy_SCB_UART_SetTxFifoLevel(CySCB_Type *base, uint32_t level);
+uint32_t Cy_SCB_UART_GetNumInTxFifo(CySCB_Type const *base);
+
+/*******************************************************************************
+*                                   MCWDT
+*******************************************************************************/
+typedef struct
+{
+    uint32_t RESERVED;
+    volatile uint32_t MCWDT_CNTLOW;
+    volatile uint32_t MCWDT_CNTHIGH;
+    volatile uint32_t MCWDT_MATCH;
+    volatile uint32_t MCWDT_CONFIG;
+    volatile uint32_t MCWDT_CTL;
+    volatile uint32_t MCWDT_INTR;
+    volatile uint32_t MCWDT_INTR_SET;
+    volatile uint32_t MCWDT_INTR_MASK;
+    volatile uint32_t MCWDT_INTR_MASKED;
+    volatile uint32_t MCWDT_LOCK;
+    uint32_t RESERVED1[5];
+} MCWDT_STRUCT_Type;
+
+#define MCWDT_STRUCT_SECTION_SIZE       (0x00000040UL)
+#define CY_MCWDT_NUM                    (2u)
+
+#define MCWDT_STRUCT0                   ((MCWDT_STRUCT_Type*) (CY_MCWDT_BASE + 0x00UL))
+#define MCWDT_STRUCT1                   ((MCWDT_STRUCT_Type*) (CY_MCWDT_BASE + 0x40UL))
+
+/* Only the two 16-bit counters are emulated */
+typedef enum
+{
+    CY_MCWDT_COUNTER0,
+    CY_MCWDT_COUNTER1,
+    CY_MCWDT_COUNTER2,
+} cy_en_mcwdtctr_t;
+
+typedef enum
+{
+    CY_MCWDT_MODE_NONE,
+    CY_MCWDT_MODE_INT,
+    CY_MCWDT_MODE_RESET,
+    CY_MCWDT_MODE_INT_RESET,
+} cy_en_mcwdtmode_t;
+
+#define CY_MCWDT_CTR0                   (1UL)
+#define CY_MCWDT_CTR1                   (2UL)
+#define CY_MCWDT_CTR2                   (4UL)
+
+void Cy_MCWDT_Enable(MCWDT_STRUCT_Type *base, uint32_t counters, uint16_t waitUs);
+void Cy_MCWDT_Disable(MCWDT_STRUCT_Type *base, uint32_t counters, uint16_t waitUs);
+void Cy_MCWDT_SetMode(MCWDT_STRUCT_Type *base, cy_en_mcwdtctr_t counter, cy_en_mcwdtmode_t mode);
+void Cy_MCWDT_SetClearOnMatch(MCWDT_STRUCT_Type *base, cy_en_mcwdtctr_t counter, uint32_t enable);
+void Cy_MCWDT_SetMatch(MCWDT_STRUCT_Type *base, cy_en_mcwdtctr_t counter, uint32_t match, uint16_t waitUs);
+uint32_t Cy_MCWDT_GetCount(MCWDT_STRUCT_Type const *base, cy_en_mcwdtctr_t counter);
+void Cy_MCWDT_ResetCounters(MCWDT_STRUCT_Type *base, uint32_t counters, uint16_t waitUs);
+uint32_t Cy_MCWDT_GetInterruptStatusMasked(MCWDT_STRUCT_Type const *base);
+void Cy_MCWDT_ClearInterrupt(MCWDT_STRUCT_Type *base, uint32_t counters);
+void Cy_MCWDT_SetInterruptMask(MCWDT_STRUCT_Type *base, uint32_t counters);
+
+/*******************************************************************************
+*                                  SAR ADC
+*******************************************************************************/
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t SAMPLE_CTRL;
+    volatile uint32_t SAMPLE_TIME01;
+    volatile uint32_t SAMPLE_TIME23;
+    volatile uint32_t RANGE_THRES;
+    volatile uint32_t RANGE_COND;
+    volatile uint32_t CHAN_EN;
+    volatile uint32_t START_CTRL;
+    volatile uint32_t CHAN_CONFIG[16];
+    volatile uint32_t CHAN_WORK[16];
+    volatile uint32_t CHAN_RESULT[16];
+    volatile uint32_t STATUS;
+    volatile uint32_t INTR;
+    volatile uint32_t INTR_SET;
+    volatile uint32_t INTR_MASK;
+    volatile uint32_t INTR_MASKED;
+    volatile uint32_t RANGE_INTR;
+} SAR_Type;
+
+#define SAR0                            ((SAR_Type*) CY_SAR0_BASE)
+#define SAR1                            ((SAR_Type*) CY_SAR1_BASE)
+
+#define SAR_SAMPLE_CTRL_AVG_CNT_Pos     (4UL)
+#define SAR_SAMPLE_CTRL_AVG_CNT_Msk     (0x70UL)
+#define SAR_SAMPLE_CTRL_AVG_SHIFT_Pos   (7UL)
+#define SAR_SAMPLE_CTRL_AVG_SHIFT_Msk   (0x80UL)
+#define SAR_SAMPLE_CTRL_AVG_MODE_Pos    (8UL)
+#define SAR_SAMPLE_CTRL_AVG_MODE_Msk    (0x100UL)
+#define SAR_CHAN_CONFIG_AVG_EN_Pos      (10UL)
+#define SAR_CHAN_CONFIG_AVG_EN_Msk      (0x400UL)
+
+#define CY_SAR_INTR_EOS                 (0x00000001UL)
+#define CY_SAR_INTR_OVERFLOW            (0x00000002UL)
+#define CY_SAR_INTR_FW_COLLISION        (0x00000004UL)
+#define CY_SAR_INTR_HW_COLLISION        (0x00000008UL)
+
+void Cy_SAR_Enable(SAR_Type *base);
+void Cy_SAR_Disable(SAR_Type *base);
+void Cy_SAR_DeepSleep(SAR_Type *base);
+void Cy_SAR_Wakeup(SAR_Type *base);
+uint32_t Cy_SAR_GetInterruptStatus(const SAR_Type *base);
+void Cy_SAR_ClearInterrupt(SAR_Type *base, uint32_t intrMask);
+int16_t Cy_SAR_CountsTo_mVolts(const SAR_Type *base, uint32_t chan, int16_t adcCounts);
+
+#endif /* CY_PDL_SIM_H_ */
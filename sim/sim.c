@@ -0,0 +1,1896 @@
+/*******************************************************************************
+* File Name: sim.c
+*
+*  Description: This file contains a host simulator of the HSIOM, DW, TCPWM,
+*   SAR and UART blocks, executing the real DW descriptor chains built
+*   by the middleware one trigger at a time.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "sim.h"
+#include "cyhal.h"
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+#define SIM_NUM_DW                     (2u)
+#define SIM_NUM_TCPWM                  (2u)
+#define SIM_NUM_TCPWM_CNT              (32u)
+#define SIM_NUM_SAR                    (2u)
+#define SIM_NUM_PORTS                  (IOSS_GPIO_GPIO_PORT_NR)
+#define SIM_NUM_SCB                    (CY_SCB_NUM)
+#define SIM_NUM_MCWDT                  (CY_MCWDT_NUM)
+#define SIM_NUM_MCWDT_COUNTERS         (2u)
+
+/* Fields of counter n of the MCWDT registers are 8 or 16 bits apart */
+#define SIM_MCWDT_CTL_ENABLE(n)        (1UL << ((n) * 8u))
+#define SIM_MCWDT_CONFIG_MODE_Pos(n)   ((n) * 8u)
+#define SIM_MCWDT_CONFIG_MODE_Msk      (0x3UL)
+#define SIM_MCWDT_CONFIG_CLEAR(n)      (1UL << (((n) * 8u) + 2u))
+#define SIM_MCWDT_COUNT_Pos(n)         ((n) * 16u)
+#define SIM_MCWDT_COUNT_Msk            (0xFFFFUL)
+
+/* Start, 8 data and stop bits */
+#define SIM_UART_BITS_PER_BYTE         (10u)
+
+#define SIM_UNIT_ELEMENT               (0u)
+#define SIM_UNIT_X_LOOP                (1u)
+#define SIM_UNIT_DESCR                 (2u)
+
+/* Guard against descriptor chains that never wait for a trigger */
+#define SIM_MAX_DESCR_PER_TRIGGER      (4096u)
+
+/*******************************************************************************
+* Local Types
+*******************************************************************************/
+typedef struct
+{
+    bool init;
+    bool enabled;
+    uint32_t curr;
+    uint32_t x_idx;
+    uint32_t y_idx;
+    uint32_t intr;
+    uint32_t intr_mask;
+    cy_en_dma_intr_cause_t status;
+    sim_isr_t isr;
+    /* Ticks between the interrupt and the call of its handler */
+    uint32_t isr_latency;
+    bool isr_pending;
+    uint32_t isr_countdown;
+} sim_dma_chan_t;
+
+typedef struct
+{
+    bool init;
+    bool enabled;
+    bool running;
+    bool one_shot;
+    /* PWM mode, the buffers are swapped at the terminal count */
+    bool pwm;
+    bool swap_pending;
+    sim_isr_t isr;
+    DW_Type *cc_dma;
+    uint32_t cc_dma_chan;
+    SAR_Type *tc_sar;
+} sim_timer_t;
+
+typedef struct
+{
+    bool enabled;
+    bool busy;
+    uint32_t done_tick;
+    int32_t sample;
+    int32_t avg_acc;
+    uint32_t avg_num;
+    uint32_t amux_sel;
+    DW_Type *done_dma;
+    uint32_t done_dma_chan;
+} sim_sar_t;
+
+typedef struct
+{
+    uint32_t baud;
+    uint8_t fifo[SIM_UART_FIFO_SIZE];
+    uint32_t fifo_head;
+    uint32_t fifo_count;
+    bool shifting;
+    uint8_t shift_data;
+    uint32_t shift_done_tick;
+    DW_Type *tx_dma;
+    uint32_t tx_dma_chan;
+    uint8_t capture[SIM_UART_CAPTURE_SIZE];
+    uint32_t capture_len;
+} sim_scb_t;
+
+typedef struct
+{
+    sim_isr_t isr;
+} sim_mcwdt_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+const cyhal_clock_t CYHAL_CLOCK_PERI = { 0u };
+const cyhal_clock_t CYHAL_CLOCK_LF = { 1u };
+const uint32_t cy_sim_hsiom_base = HSIOM_BASE;
+
+static sim_dma_chan_t sim_dma[SIM_NUM_DW][CY_DMA_NUM_CHANNELS];
+static bool sim_dma_enabled[SIM_NUM_DW];
+static uint32_t sim_dma_isr_pending;
+static sim_timer_t sim_timer[SIM_NUM_TCPWM][SIM_NUM_TCPWM_CNT];
+static sim_sar_t sim_sar[SIM_NUM_SAR];
+static sim_scb_t sim_scb[SIM_NUM_SCB];
+static sim_mcwdt_t sim_mcwdt[SIM_NUM_MCWDT];
+/* Peripheral clocks counted towards the next LFCLK edge */
+static uint32_t sim_clk_lf_acc;
+static int16_t sim_pin_value[SIM_NUM_PORTS][CY_GPIO_PINS_MAX];
+static sim_counters_t sim_counters;
+static uint32_t sim_clk_peri_hz = 100000000u;
+static cy_stc_syspm_callback_t *sim_syspm_callbacks;
+
+/*******************************************************************************
+* Local Functions
+*******************************************************************************/
+static void Sim_DmaTrigger(uint32_t dw, uint32_t chan);
+
+/*******************************************************************************
+* Function Name: Sim_MapPeripherals
+********************************************************************************
+* Summary:
+*   Map host memory at the peripheral addresses of the device, so the register
+*   addresses computed by the middleware can be dereferenced. Runs before main.
+*
+*******************************************************************************/
+__attribute__((constructor))
+static void Sim_MapPeripherals(void)
+{
+    void *mem = mmap((void *) CY_SIM_PERI_BASE, CY_SIM_PERI_SIZE,
+                     PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if (mem != (void *) CY_SIM_PERI_BASE)
+    {
+        fprintf(stderr, "sim: unable to map the peripheral space\n");
+        exit(1);
+    }
+}
+
+/*******************************************************************************
+* Function Name: Sim_DwIndex / Sim_TcpwmIndex / Sim_SarIndex / Sim_ScbIndex /
+*                Sim_McwdtIndex
+********************************************************************************
+* Summary:
+*   Translate a peripheral base into the simulator instance index.
+*
+*******************************************************************************/
+static uint32_t Sim_DwIndex(DW_Type const *base)
+{
+    CY_ASSERT((base == DW0) || (base == DW1));
+    return (base == DW0) ? 0u : 1u;
+}
+
+static uint32_t Sim_TcpwmIndex(TCPWM_Type const *base)
+{
+    CY_ASSERT((base == TCPWM0) || (base == TCPWM1));
+    return (base == TCPWM0) ? 0u : 1u;
+}
+
+static uint32_t Sim_SarIndex(SAR_Type const *base)
+{
+    CY_ASSERT((base == SAR0) || (base == SAR1));
+    return (base == SAR0) ? 0u : 1u;
+}
+
+static uint32_t Sim_ScbIndex(CySCB_Type const *base)
+{
+    uint32_t offset = (uint32_t)(uintptr_t) base - CY_SCB0_BASE;
+
+    CY_ASSERT(((offset % SCB_SECTION_SIZE) == 0u) && ((offset / SCB_SECTION_SIZE) < SIM_NUM_SCB));
+    return offset / SCB_SECTION_SIZE;
+}
+
+static uint32_t Sim_McwdtIndex(MCWDT_STRUCT_Type const *base)
+{
+    uint32_t offset = (uint32_t)(uintptr_t) base - CY_MCWDT_BASE;
+
+    CY_ASSERT(((offset % MCWDT_STRUCT_SECTION_SIZE) == 0u) && 
+              ((offset / MCWDT_STRUCT_SECTION_SIZE) < SIM_NUM_MCWDT));
+    return offset / MCWDT_STRUCT_SECTION_SIZE;
+}
+
+/*******************************************************************************
+* Function Name: Sim_Init
+********************************************************************************
+* Summary:
+*   Reset the state of all simulated blocks and counters.
+*
+* Parameters:
+*   clk_peri_hz: peripheral clock frequency, one simulator tick per cycle
+*
+*******************************************************************************/
+void Sim_Init(uint32_t clk_peri_hz)
+{
+    memset((void *) CY_SIM_PERI_BASE, 0, CY_SIM_PERI_SIZE);
+    memset(sim_dma, 0, sizeof(sim_dma));
+    memset(sim_dma_enabled, 0, sizeof(sim_dma_enabled));
+    sim_dma_isr_pending = 0u;
+    memset(sim_timer, 0, sizeof(sim_timer));
+    memset(sim_sar, 0, sizeof(sim_sar));
+    memset(sim_scb, 0, sizeof(sim_scb));
+    memset(sim_mcwdt, 0, sizeof(sim_mcwdt));
+    sim_clk_lf_acc = 0u;
+    memset(sim_pin_value, 0, sizeof(sim_pin_value));
+    memset(&sim_counters, 0, sizeof(sim_counters));
+    sim_syspm_callbacks = NULL;
+
+    for (uint32_t i = 0; i < SIM_NUM_SAR; i++)
+    {
+        sim_sar[i].amux_sel = HSIOM_SEL_AMUXB;
+    }
+
+    sim_clk_peri_hz = clk_peri_hz;
+}
+
+/*******************************************************************************
+* Function Name: Sim_SetPinValue
+********************************************************************************
+* Summary:
+*   Set the value the SAR converts when the given pin is on its AMux bus.
+*
+*******************************************************************************/
+void Sim_SetPinValue(uint32_t port, uint32_t pin, int16_t value)
+{
+    CY_ASSERT((port < SIM_NUM_PORTS) && (pin < CY_GPIO_PINS_MAX));
+    sim_pin_value[port][pin] = value;
+}
+
+/*******************************************************************************
+* Function Name: Sim_SetSarAmux
+********************************************************************************
+* Summary:
+*   Select which global analog mux (HSIOM_SEL_AMUXA/B) feeds the SAR.
+*
+*******************************************************************************/
+void Sim_SetSarAmux(SAR_Type *sar, uint32_t amux_sel)
+{
+    sim_sar[Sim_SarIndex(sar)].amux_sel = amux_sel;
+}
+
+/*******************************************************************************
+* Function Name: Sim_Route*
+********************************************************************************
+* Summary:
+*   Connect the trigger signals between the simulated blocks, as done by the
+*   trigger mux on the device.
+*
+*******************************************************************************/
+void Sim_RouteTimerCompareToDma(TCPWM_Type *timer, uint32_t cnt, DW_Type *dma, uint32_t chan)
+{
+    sim_timer_t *t = &sim_timer[Sim_TcpwmIndex(timer)][cnt];
+
+    t->cc_dma = dma;
+    t->cc_dma_chan = chan;
+}
+
+void Sim_RouteTimerOverflowToSar(TCPWM_Type *timer, uint32_t cnt, SAR_Type *sar)
+{
+    sim_timer[Sim_TcpwmIndex(timer)][cnt].tc_sar = sar;
+}
+
+void Sim_RouteSarDoneToDma(SAR_Type *sar, DW_Type *dma, uint32_t chan)
+{
+    sim_sar_t *s = &sim_sar[Sim_SarIndex(sar)];
+
+    s->done_dma = dma;
+    s->done_dma_chan = chan;
+}
+
+/*******************************************************************************
+* Function Name: Sim_SetDmaIsr / Sim_SetTimerIsr / Sim_SetMcwdtIsr
+********************************************************************************
+* Summary:
+*   Register the function called when the interrupt of the block is raised and
+*   unmasked. It is called synchronously, from within Sim_Run().
+*
+*******************************************************************************/
+void Sim_SetDmaIsr(DW_Type *dma, uint32_t chan, sim_isr_t isr)
+{
+    sim_dma[Sim_DwIndex(dma)][chan].isr = isr;
+}
+
+/*******************************************************************************
+* Function Name: Sim_SetDmaIsrLatency
+********************************************************************************
+* Summary:
+*   Delay the handler of a DW channel interrupt by the given number of ticks,
+*   as if the CPU was busy in a higher priority interrupt. The DMA keeps
+*   running meanwhile, and the interrupts raised while the handler is pending
+*   are merged, as in the NVIC.
+*
+*******************************************************************************/
+void Sim_SetDmaIsrLatency(DW_Type *dma, uint32_t chan, uint32_t ticks)
+{
+    sim_dma[Sim_DwIndex(dma)][chan].isr_latency = ticks;
+}
+
+void Sim_SetTimerIsr(TCPWM_Type *timer, uint32_t cnt, sim_isr_t isr)
+{
+    sim_timer[Sim_TcpwmIndex(timer)][cnt].isr = isr;
+}
+
+void Sim_SetMcwdtIsr(MCWDT_STRUCT_Type *mcwdt, sim_isr_t isr)
+{
+    sim_mcwdt[Sim_McwdtIndex(mcwdt)].isr = isr;
+}
+
+/*******************************************************************************
+* Function Name: Sim_TriggerDma
+********************************************************************************
+* Summary:
+*   Send a trigger to the given DW channel, for example a software trigger.
+*
+*******************************************************************************/
+void Sim_TriggerDma(DW_Type *dma, uint32_t chan)
+{
+    Sim_DmaTrigger(Sim_DwIndex(dma), chan);
+}
+
+/*******************************************************************************
+* Function Name: Sim_SetUartBaud
+********************************************************************************
+* Summary:
+*   Set the baud rate the UART shifts the TX FIFO out. The UART does not send 
+*   until a baud rate is set.
+*
+*******************************************************************************/
+void Sim_SetUartBaud(CySCB_Type *scb, uint32_t baud)
+{
+    sim_scb[Sim_ScbIndex(scb)].baud = baud;
+}
+
+/*******************************************************************************
+* Function Name: Sim_RouteUartTxToDma
+********************************************************************************
+* Summary:
+*   Connect the TX trigger of the UART to a DW channel. The trigger is active
+*   while the TX FIFO holds less bytes than its trigger level.
+*
+*******************************************************************************/
+void Sim_RouteUartTxToDma(CySCB_Type *scb, DW_Type *dma, uint32_t chan)
+{
+    sim_scb_t *u = &sim_scb[Sim_ScbIndex(scb)];
+
+    u->tx_dma = dma;
+    u->tx_dma_chan = chan;
+}
+
+/*******************************************************************************
+* Function Name: Sim_ReadUart
+********************************************************************************
+* Summary:
+*   Read the bytes sent by the UART since the last call.
+*
+* Return:
+*   Number of bytes copied to data.
+*
+*******************************************************************************/
+uint32_t Sim_ReadUart(CySCB_Type *scb, uint8_t *data, uint32_t max)
+{
+    sim_scb_t *u = &sim_scb[Sim_ScbIndex(scb)];
+    uint32_t len = (u->capture_len < max) ? u->capture_len : max;
+
+    memcpy(data, u->capture, len);
+    memmove(u->capture, &u->capture[len], u->capture_len - len);
+    u->capture_len -= len;
+
+    return len;
+}
+
+/*******************************************************************************
+* Function Name: Sim_GetCounters / Sim_ResetCounters / Sim_GetClockFrequency
+*******************************************************************************/
+void Sim_GetCounters(sim_counters_t *counters)
+{
+    *counters = sim_counters;
+}
+
+void Sim_ResetCounters(void)
+{
+    memset(&sim_counters, 0, sizeof(sim_counters));
+}
+
+uint32_t Sim_GetClockFrequency(void)
+{
+    return sim_clk_peri_hz;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysPm_CpuEnterDeepSleep
+********************************************************************************
+* Summary:
+*   Run the Deep Sleep callbacks as the PDL does. The emulated clocks do not 
+*   stop, so the caller runs the simulator for the sleep period itself.
+*
+*******************************************************************************/
+cy_en_syspm_status_t Cy_SysPm_CpuEnterDeepSleep(cy_en_syspm_waitfor_t waitFor)
+{
+    cy_stc_syspm_callback_t *item;
+    cy_stc_syspm_callback_t *last = NULL;
+
+    (void) waitFor;
+
+    for (item = sim_syspm_callbacks; item != NULL; item = item->nextItm)
+    {
+        if (item->type != CY_SYSPM_DEEPSLEEP)
+        {
+            continue;
+        }
+        if (item->callback(item->callbackParams, CY_SYSPM_CHECK_READY) != CY_SYSPM_SUCCESS)
+        {
+            /* Undo the checks that passed, in reverse order */
+            for (item = item->prevItm; item != NULL; item = item->prevItm)
+            {
+                if (item->type == CY_SYSPM_DEEPSLEEP)
+                {
+                    (void) item->callback(item->callbackParams, CY_SYSPM_CHECK_FAIL);
+                }
+            }
+            sim_counters.deep_sleeps_denied++;
+            return CY_SYSPM_FAIL;
+        }
+        last = item;
+    }
+
+    for (item = sim_syspm_callbacks; item != NULL; item = item->nextItm)
+    {
+        if (item->type == CY_SYSPM_DEEPSLEEP)
+        {
+            (void) item->callback(item->callbackParams, CY_SYSPM_BEFORE_TRANSITION);
+        }
+    }
+
+    sim_counters.deep_sleeps++;
+
+    for (item = last; item != NULL; item = item->prevItm)
+    {
+        if (item->type == CY_SYSPM_DEEPSLEEP)
+        {
+            (void) item->callback(item->callbackParams, CY_SYSPM_AFTER_TRANSITION);
+        }
+    }
+
+    return CY_SYSPM_SUCCESS;
+}
+
+/*******************************************************************************
+*                            DataWire execution
+*******************************************************************************/
+static int32_t Sim_SignExtend12(uint32_t value)
+{
+    return ((value & 0x800u) != 0u) ? (int32_t)(value | 0xFFFFF000u) : (int32_t) value;
+}
+
+static uint32_t Sim_DescrType(cy_stc_dma_descriptor_t const *descr)
+{
+    return _FLD2VAL(CY_DMA_CTL_TYPE, descr->ctl);
+}
+
+static uint32_t Sim_DescrNext(cy_stc_dma_descriptor_t const *descr)
+{
+    switch (Sim_DescrType(descr))
+    {
+        case CY_DMA_SINGLE_TRANSFER: return descr->xCtl;
+        case CY_DMA_1D_TRANSFER:     return descr->yCtl;
+        default:                     return descr->nextPtr;
+    }
+}
+
+static uint32_t Sim_ReadData(uint32_t addr, uint32_t size)
+{
+    switch (size)
+    {
+        case CY_DMA_BYTE:     return *(volatile uint8_t *)(uintptr_t) addr;
+        case CY_DMA_HALFWORD: return *(volatile uint16_t *)(uintptr_t) addr;
+        default:              return *(volatile uint32_t *)(uintptr_t) addr;
+    }
+}
+
+static void Sim_UartWrite(uint32_t scb, uint8_t data);
+
+static void Sim_WriteData(uint32_t addr, uint32_t size, uint32_t value)
+{
+    if ((addr >= CY_SCB0_BASE) && (addr < (CY_SCB0_BASE + (SIM_NUM_SCB * SCB_SECTION_SIZE))) &&
+        ((addr % SCB_SECTION_SIZE) == offsetof(CySCB_Type, TX_FIFO_WR)))
+    {
+        Sim_UartWrite((addr - CY_SCB0_BASE) / SCB_SECTION_SIZE, (uint8_t) value);
+        return;
+    }
+
+    switch (size)
+    {
+        case CY_DMA_BYTE:     *(volatile uint8_t *)(uintptr_t) addr = (uint8_t) value;   break;
+        case CY_DMA_HALFWORD: *(volatile uint16_t *)(uintptr_t) addr = (uint16_t) value; break;
+        default:              *(volatile uint32_t *)(uintptr_t) addr = value;            break;
+    }
+
+    if ((addr >= CY_HSIOM_BASE) && (addr < (CY_HSIOM_BASE + (SIM_NUM_PORTS * HSIOM_PRT_SECTION_SIZE))))
+    {
+        sim_counters.hsiom_writes++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: Sim_DmaElement
+********************************************************************************
+* Summary:
+*   Execute one element transfer of the descriptor at the given loop indexes.
+*
+*******************************************************************************/
+static void Sim_DmaElement(cy_stc_dma_descriptor_t const *descr, uint32_t x, uint32_t y)
+{
+    uint32_t type = Sim_DescrType(descr);
+    uint32_t data_size = _FLD2VAL(CY_DMA_CTL_DATA_SIZE, descr->ctl);
+    uint32_t bytes = 1u << data_size;
+    int32_t src_offset = 0;
+    int32_t dst_offset = 0;
+    uint32_t value;
+
+    if (type != CY_DMA_SINGLE_TRANSFER)
+    {
+        src_offset += (int32_t) x * Sim_SignExtend12(_FLD2VAL(CY_DMA_CTL_SRC_INCR, descr->xCtl));
+        dst_offset += (int32_t) x * Sim_SignExtend12(_FLD2VAL(CY_DMA_CTL_DST_INCR, descr->xCtl));
+    }
+    if (type == CY_DMA_2D_TRANSFER)
+    {
+        src_offset += (int32_t) y * Sim_SignExtend12(_FLD2VAL(CY_DMA_CTL_SRC_INCR, descr->yCtl));
+        dst_offset += (int32_t) y * Sim_SignExtend12(_FLD2VAL(CY_DMA_CTL_DST_INCR, descr->yCtl));
+    }
+
+    if (_FLD2VAL(CY_DMA_CTL_SRC_SIZE, descr->ctl) == CY_DMA_TRANSFER_SIZE_WORD)
+    {
+        value = Sim_ReadData(descr->src + (uint32_t)(src_offset * (int32_t) bytes), CY_DMA_WORD);
+    }
+    else
+    {
+        value = Sim_ReadData(descr->src + (uint32_t)(src_offset * (int32_t) bytes), data_size);
+    }
+    value &= (data_size == CY_DMA_WORD) ? 0xFFFFFFFFu : ((1u << (8u * bytes)) - 1u);
+
+    if (_FLD2VAL(CY_DMA_CTL_DST_SIZE, descr->ctl) == CY_DMA_TRANSFER_SIZE_WORD)
+    {
+        Sim_WriteData(descr->dst + (uint32_t)(dst_offset * (int32_t) bytes), CY_DMA_WORD, value);
+    }
+    else
+    {
+        Sim_WriteData(descr->dst + (uint32_t)(dst_offset * (int32_t) bytes), data_size, value);
+    }
+
+    sim_counters.dma_transfers++;
+}
+
+/*******************************************************************************
+* Function Name: Sim_DmaRaiseInterrupt
+*******************************************************************************/
+static void Sim_DmaRaiseInterrupt(sim_dma_chan_t *c, cy_en_dma_intr_cause_t cause)
+{
+    c->status = cause;
+    c->intr |= CY_DMA_INTR_MASK;
+
+    if (((c->intr & c->intr_mask) != 0u) && (c->isr != NULL))
+    {
+        if (c->isr_latency == 0u)
+        {
+            c->isr();
+        }
+        else if (!c->isr_pending)
+        {
+            c->isr_pending = true;
+            c->isr_countdown = c->isr_latency;
+            sim_dma_isr_pending++;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: Sim_DmaServiceInterrupts
+********************************************************************************
+* Summary:
+*   Call the delayed DW channel interrupt handlers that are due.
+*
+*******************************************************************************/
+static void Sim_DmaServiceInterrupts(void)
+{
+    for (uint32_t dw = 0; dw < SIM_NUM_DW; dw++)
+    {
+        for (uint32_t chan = 0; chan < CY_DMA_NUM_CHANNELS; chan++)
+        {
+            sim_dma_chan_t *c = &sim_dma[dw][chan];
+
+            if (c->isr_pending && (--c->isr_countdown == 0u))
+            {
+                c->isr_pending = false;
+                sim_dma_isr_pending--;
+                if (((c->intr & c->intr_mask) != 0u) && (c->isr != NULL))
+                {
+                    c->isr();
+                }
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: Sim_DmaTrigger
+********************************************************************************
+* Summary:
+*   Execute the work of one input trigger on a DW channel. The trigger input
+*   type of the current descriptor defines how much is transferred: one
+*   element, one X loop, the descriptor, or the descriptor and then the next
+*   one as if it was triggered again.
+*
+*******************************************************************************/
+static void Sim_DmaTrigger(uint32_t dw, uint32_t chan)
+{
+    sim_dma_chan_t *c = &sim_dma[dw][chan];
+    uint32_t guard = 0;
+
+    sim_counters.dma_triggers++;
+
+    if (!sim_dma_enabled[dw] || !c->enabled)
+    {
+        sim_counters.dma_missed_triggers++;
+        return;
+    }
+
+    for (;;)
+    {
+        cy_stc_dma_descriptor_t const *descr;
+        uint32_t type, x_count, y_count, unit, tr_in, intr_type;
+        bool chain = false;
+        bool disable = false;
+
+        if (c->curr == 0u)
+        {
+            c->enabled = false;
+            Sim_DmaRaiseInterrupt(c, CY_DMA_INTR_CAUSE_CURR_PTR_NULL);
+            return;
+        }
+
+        descr = (cy_stc_dma_descriptor_t const *)(uintptr_t) c->curr;
+        type = Sim_DescrType(descr);
+        tr_in = _FLD2VAL(CY_DMA_CTL_TR_IN_TYPE, descr->ctl);
+        intr_type = _FLD2VAL(CY_DMA_CTL_INTR_TYPE, descr->ctl);
+        x_count = (type == CY_DMA_SINGLE_TRANSFER) ? 1u : (_FLD2VAL(CY_DMA_CTL_COUNT, descr->xCtl) + 1u);
+        y_count = (type == CY_DMA_2D_TRANSFER) ? (_FLD2VAL(CY_DMA_CTL_COUNT, descr->yCtl) + 1u) : 1u;
+
+        Sim_DmaElement(descr, c->x_idx, c->y_idx);
+
+        unit = SIM_UNIT_ELEMENT;
+        if (++c->x_idx >= x_count)
+        {
+            c->x_idx = 0;
+            unit = SIM_UNIT_X_LOOP;
+            if (++c->y_idx >= y_count)
+            {
+                c->y_idx = 0;
+                unit = SIM_UNIT_DESCR;
+            }
+        }
+
+        if (unit == SIM_UNIT_DESCR)
+        {
+            disable = (_FLD2VAL(CY_DMA_CTL_CH_DISABLE, descr->ctl) != 0u);
+
+            sim_counters.dma_descriptors++;
+            c->curr = Sim_DescrNext(descr);
+            if (disable)
+            {
+                c->enabled = false;
+            }
+            chain = (tr_in == CY_DMA_DESCR_CHAIN) && c->enabled;
+        }
+
+        /* A chain interrupt is only raised at the end of the chain */
+        if (intr_type == CY_DMA_DESCR_CHAIN)
+        {
+            if ((unit == SIM_UNIT_DESCR) && (disable || (c->curr == 0u)))
+            {
+                Sim_DmaRaiseInterrupt(c, CY_DMA_INTR_CAUSE_COMPLETION);
+            }
+        }
+        else if (unit >= intr_type)
+        {
+            Sim_DmaRaiseInterrupt(c, CY_DMA_INTR_CAUSE_COMPLETION);
+        }
+
+        /* Stop once the unit of work of this trigger is done */
+        if (!chain)
+        {
+            if (!c->enabled)
+            {
+                return;
+            }
+            if ((tr_in != CY_DMA_DESCR_CHAIN) && (unit >= tr_in))
+            {
+                return;
+            }
+        }
+
+        if (++guard > SIM_MAX_DESCR_PER_TRIGGER)
+        {
+            fprintf(stderr, "sim: DW%u channel %u never waits for a trigger\n",
+                    (unsigned) dw, (unsigned) chan);
+            exit(1);
+        }
+    }
+}
+
+/*******************************************************************************
+*                                SAR execution
+*******************************************************************************/
+static int32_t Sim_SarSampleInput(sim_sar_t *s)
+{
+    HSIOM_PRT_Type *hsiom;
+    uint32_t num_connected = 0;
+    int32_t acc = 0;
+
+    for (uint32_t port = 0; port < SIM_NUM_PORTS; port++)
+    {
+        hsiom = (HSIOM_PRT_Type *)(CY_HSIOM_BASE + (port * HSIOM_PRT_SECTION_SIZE));
+        for (uint32_t pin = 0; pin < CY_GPIO_PINS_MAX; pin++)
+        {
+            uint32_t reg = (pin < CY_GPIO_PRT_HALF) ? hsiom->PORT_SEL0 : hsiom->PORT_SEL1;
+            uint32_t sel = (reg >> (8u * (pin % CY_GPIO_PRT_HALF))) & 0x1Fu;
+
+            if (sel == s->amux_sel)
+            {
+                acc += sim_pin_value[port][pin];
+                num_connected++;
+            }
+        }
+    }
+
+    if (num_connected == 0u)
+    {
+        sim_counters.sar_open_samples++;
+        return SIM_SAR_OPEN_INPUT;
+    }
+    if (num_connected > 1u)
+    {
+        sim_counters.sar_short_samples++;
+    }
+
+    return acc / (int32_t) num_connected;
+}
+
+static void Sim_SarTrigger(SAR_Type *sar)
+{
+    sim_sar_t *s = &sim_sar[Sim_SarIndex(sar)];
+
+    if (!s->enabled)
+    {
+        return;
+    }
+    if (s->busy)
+    {
+        sar->INTR |= CY_SAR_INTR_HW_COLLISION;
+        sim_counters.sar_collisions++;
+        return;
+    }
+
+    s->sample = Sim_SarSampleInput(s);
+    s->busy = true;
+    s->done_tick = sim_counters.ticks + SIM_SAR_CONVERSION_TICKS;
+}
+
+static void Sim_SarComplete(SAR_Type *sar)
+{
+    sim_sar_t *s = &sim_sar[Sim_SarIndex(sar)];
+    int32_t result = s->sample;
+
+    s->busy = false;
+    sim_counters.sar_conversions++;
+
+    /* Interleaved averaging: only report once all samples were accumulated */
+    if (((sar->SAMPLE_CTRL & SAR_SAMPLE_CTRL_AVG_MODE_Msk) != 0u) &&
+        ((sar->CHAN_CONFIG[0] & SAR_CHAN_CONFIG_AVG_EN_Msk) != 0u))
+    {
+        uint32_t avg_cnt = 1u << (_FLD2VAL(SAR_SAMPLE_CTRL_AVG_CNT, sar->SAMPLE_CTRL) + 1u);
+
+        s->avg_acc += s->sample;
+        if (++s->avg_num < avg_cnt)
+        {
+            return;
+        }
+        result = s->avg_acc / (int32_t) avg_cnt;
+        s->avg_acc = 0;
+        s->avg_num = 0;
+    }
+
+    sar->CHAN_RESULT[0] = (uint16_t)(int16_t) result;
+    if ((sar->INTR & CY_SAR_INTR_EOS) != 0u)
+    {
+        sar->INTR |= CY_SAR_INTR_OVERFLOW;
+    }
+    sar->INTR |= CY_SAR_INTR_EOS;
+
+    if (s->done_dma != NULL)
+    {
+        Sim_DmaTrigger(Sim_DwIndex(s->done_dma), s->done_dma_chan);
+    }
+}
+
+/*******************************************************************************
+*                               Timer execution
+*******************************************************************************/
+static void Sim_TimerEvent(TCPWM_Type *base, uint32_t cnt, sim_timer_t *t, uint32_t event)
+{
+    TCPWM_CNT_Type *reg = &base->CNT[cnt];
+
+    reg->INTR |= event;
+    if (((reg->INTR & reg->INTR_MASK) != 0u) && (t->isr != NULL))
+    {
+        t->isr();
+    }
+
+    if ((event == CY_TCPWM_INT_ON_TC) && (t->tc_sar != NULL))
+    {
+        Sim_SarTrigger(t->tc_sar);
+    }
+    if ((event == CY_TCPWM_INT_ON_CC) && (t->cc_dma != NULL))
+    {
+        Sim_DmaTrigger(Sim_DwIndex(t->cc_dma), t->cc_dma_chan);
+    }
+}
+
+static void Sim_TimerTick(TCPWM_Type *base, uint32_t cnt, sim_timer_t *t)
+{
+    TCPWM_CNT_Type *reg = &base->CNT[cnt];
+
+    if (reg->COUNTER >= reg->PERIOD)
+    {
+        reg->COUNTER = 0;
+        if (t->one_shot)
+        {
+            t->running = false;
+        }
+        if (t->pwm && t->swap_pending)
+        {
+            t->swap_pending = false;
+            if ((reg->CTRL & TCPWM_CNT_CTRL_AUTO_RELOAD_PERIOD_Msk) != 0u)
+            {
+                uint32_t period = reg->PERIOD;
+                reg->PERIOD = reg->PERIOD_BUFF;
+                reg->PERIOD_BUFF = period;
+            }
+            if ((reg->CTRL & TCPWM_CNT_CTRL_AUTO_RELOAD_CC_Msk) != 0u)
+            {
+                uint32_t cc = reg->CC;
+                reg->CC = reg->CC_BUFF;
+                reg->CC_BUFF = cc;
+            }
+        }
+        Sim_TimerEvent(base, cnt, t, CY_TCPWM_INT_ON_TC);
+    }
+    else
+    {
+        reg->COUNTER++;
+    }
+
+    if (t->running && (reg->COUNTER == reg->CC))
+    {
+        /* The counter mode swaps on the compare match */
+        if (!t->pwm && ((reg->CTRL & TCPWM_CNT_CTRL_AUTO_RELOAD_CC_Msk) != 0u))
+        {
+            uint32_t cc = reg->CC;
+            reg->CC = reg->CC_BUFF;
+            reg->CC_BUFF = cc;
+        }
+        Sim_TimerEvent(base, cnt, t, CY_TCPWM_INT_ON_CC);
+    }
+}
+
+/*******************************************************************************
+*                               MCWDT execution
+*******************************************************************************/
+static void Sim_McwdtUpdateInterrupt(MCWDT_STRUCT_Type *base)
+{
+    base->MCWDT_INTR_MASKED = base->MCWDT_INTR & base->MCWDT_INTR_MASK;
+}
+
+/* One LFCLK edge: the enabled counters count up and raise their interrupt
+ * when they reach the match value, then restart from 0 if cleared on match */
+static void Sim_McwdtTick(uint32_t index)
+{
+    MCWDT_STRUCT_Type *base = (MCWDT_STRUCT_Type *)(CY_MCWDT_BASE + (index * MCWDT_STRUCT_SECTION_SIZE));
+    bool raised = false;
+
+    for (uint32_t n = 0; n < SIM_NUM_MCWDT_COUNTERS; n++)
+    {
+        uint32_t pos = SIM_MCWDT_COUNT_Pos(n);
+        uint32_t count = (base->MCWDT_CNTLOW >> pos) & SIM_MCWDT_COUNT_Msk;
+        uint32_t match = (base->MCWDT_MATCH >> pos) & SIM_MCWDT_COUNT_Msk;
+        uint32_t mode = (base->MCWDT_CONFIG >> SIM_MCWDT_CONFIG_MODE_Pos(n)) & SIM_MCWDT_CONFIG_MODE_Msk;
+
+        if ((base->MCWDT_CTL & SIM_MCWDT_CTL_ENABLE(n)) == 0u)
+        {
+            continue;
+        }
+
+        if ((count == match) && ((base->MCWDT_CONFIG & SIM_MCWDT_CONFIG_CLEAR(n)) != 0u))
+        {
+            count = 0u;
+        }
+        else
+        {
+            count = (count + 1u) & SIM_MCWDT_COUNT_Msk;
+        }
+        base->MCWDT_CNTLOW = (base->MCWDT_CNTLOW & ~(SIM_MCWDT_COUNT_Msk << pos)) | (count << pos);
+
+        if ((count == match) && ((mode == CY_MCWDT_MODE_INT) || (mode == CY_MCWDT_MODE_INT_RESET)))
+        {
+            base->MCWDT_INTR |= (1UL << n);
+            raised = true;
+        }
+    }
+
+    Sim_McwdtUpdateInterrupt(base);
+    if (raised && (base->MCWDT_INTR_MASKED != 0u) && (sim_mcwdt[index].isr != NULL))
+    {
+        sim_mcwdt[index].isr();
+    }
+}
+
+/*******************************************************************************
+*                               UART execution
+*******************************************************************************/
+static void Sim_UartUpdateStatus(uint32_t scb)
+{
+    CySCB_Type *base = (CySCB_Type *)(CY_SCB0_BASE + (scb * SCB_SECTION_SIZE));
+
+    base->TX_FIFO_STATUS = _VAL2FLD(SCB_TX_FIFO_STATUS_USED, sim_scb[scb].fifo_count);
+}
+
+static void Sim_UartWrite(uint32_t scb, uint8_t data)
+{
+    sim_scb_t *u = &sim_scb[scb];
+
+    if (u->fifo_count >= SIM_UART_FIFO_SIZE)
+    {
+        sim_counters.uart_overflows++;
+        return;
+    }
+
+    u->fifo[(u->fifo_head + u->fifo_count) % SIM_UART_FIFO_SIZE] = data;
+    u->fifo_count++;
+    Sim_UartUpdateStatus(scb);
+}
+
+static void Sim_UartTick(uint32_t scb)
+{
+    CySCB_Type *base = (CySCB_Type *)(CY_SCB0_BASE + (scb * SCB_SECTION_SIZE));
+    sim_scb_t *u = &sim_scb[scb];
+
+    if (u->baud == 0u)
+    {
+        return;
+    }
+
+    if (u->shifting && (u->shift_done_tick == sim_counters.ticks))
+    {
+        u->shifting = false;
+        if (u->capture_len < SIM_UART_CAPTURE_SIZE)
+        {
+            u->capture[u->capture_len++] = u->shift_data;
+        }
+        sim_counters.uart_tx_bytes++;
+    }
+
+    if (!u->shifting && (u->fifo_count > 0u))
+    {
+        u->shift_data = u->fifo[u->fifo_head];
+        u->fifo_head = (u->fifo_head + 1u) % SIM_UART_FIFO_SIZE;
+        u->fifo_count--;
+        u->shifting = true;
+        u->shift_done_tick = sim_counters.ticks + 
+                             (uint32_t)(((uint64_t) sim_clk_peri_hz * SIM_UART_BITS_PER_BYTE) / u->baud);
+        Sim_UartUpdateStatus(scb);
+    }
+
+    /* The TX trigger is a level, only sent to an enabled channel */
+    if ((u->tx_dma != NULL) && 
+        (u->fifo_count < _FLD2VAL(SCB_TX_FIFO_CTRL_TRIGGER_LEVEL, base->TX_FIFO_CTRL)))
+    {
+        uint32_t dw = Sim_DwIndex(u->tx_dma);
+
+        if (sim_dma_enabled[dw] && sim_dma[dw][u->tx_dma_chan].enabled)
+        {
+            Sim_DmaTrigger(dw, u->tx_dma_chan);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: Sim_Run
+********************************************************************************
+* Summary:
+*   Advance the simulation by the given number of peripheral clock cycles.
+*
+*******************************************************************************/
+void Sim_Run(uint32_t ticks)
+{
+    TCPWM_Type *const timers[SIM_NUM_TCPWM] = { TCPWM0, TCPWM1 };
+    SAR_Type *const sars[SIM_NUM_SAR] = { SAR0, SAR1 };
+
+    while (ticks-- > 0u)
+    {
+        sim_counters.ticks++;
+
+        for (uint32_t i = 0; i < SIM_NUM_SAR; i++)
+        {
+            if (sim_sar[i].busy && (sim_sar[i].done_tick == sim_counters.ticks))
+            {
+                Sim_SarComplete(sars[i]);
+            }
+        }
+
+        for (uint32_t i = 0; i < SIM_NUM_TCPWM; i++)
+        {
+            for (uint32_t cnt = 0; cnt < SIM_NUM_TCPWM_CNT; cnt++)
+            {
+                sim_timer_t *t = &sim_timer[i][cnt];
+                if (t->enabled && t->running)
+                {
+                    Sim_TimerTick(timers[i], cnt, t);
+                }
+            }
+        }
+
+        for (uint32_t i = 0; i < SIM_NUM_SCB; i++)
+        {
+            Sim_UartTick(i);
+        }
+
+        sim_clk_lf_acc += SIM_CLK_LF_HZ;
+        if (sim_clk_lf_acc >= sim_clk_peri_hz)
+        {
+            sim_clk_lf_acc -= sim_clk_peri_hz;
+            for (uint32_t i = 0; i < SIM_NUM_MCWDT; i++)
+            {
+                Sim_McwdtTick(i);
+            }
+        }
+
+        if (sim_dma_isr_pending != 0u)
+        {
+            Sim_DmaServiceInterrupts();
+        }
+    }
+}
+
+/*******************************************************************************
+*                              PDL: System
+*******************************************************************************/
+uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    return 0u;
+}
+
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    (void) savedIntrStatus;
+}
+
+void CyDelay(uint32_t milliseconds)
+{
+    while (milliseconds-- > 0u)
+    {
+        Sim_Run(sim_clk_peri_hz / 1000u);
+    }
+}
+
+void Sim_Assert(const char *file, int line)
+{
+    fprintf(stderr, "sim: assertion failed at %s:%d\n", file, line);
+    abort();
+}
+
+uint32_t cyhal_clock_get_frequency(const cyhal_clock_t *clock)
+{
+    return (clock == &CYHAL_CLOCK_LF) ? SIM_CLK_LF_HZ : sim_clk_peri_hz;
+}
+
+/*******************************************************************************
+*                              PDL: SysPm
+*******************************************************************************/
+bool Cy_SysPm_RegisterCallback(cy_stc_syspm_callback_t *handler)
+{
+    cy_stc_syspm_callback_t **last = &sim_syspm_callbacks;
+
+    if (handler == NULL || handler->callback == NULL)
+    {
+        return false;
+    }
+
+    handler->prevItm = NULL;
+
+    while (*last != NULL)
+    {
+        if (*last == handler)
+        {
+            return false;
+        }
+        handler->prevItm = *last;
+        last = &(*last)->nextItm;
+    }
+
+    handler->nextItm = NULL;
+    *last = handler;
+    return true;
+}
+
+bool Cy_SysPm_UnregisterCallback(cy_stc_syspm_callback_t const *handler)
+{
+    cy_stc_syspm_callback_t **item = &sim_syspm_callbacks;
+
+    while (*item != NULL)
+    {
+        if (*item == handler)
+        {
+            *item = handler->nextItm;
+            if (handler->nextItm != NULL)
+            {
+                handler->nextItm->prevItm = handler->prevItm;
+            }
+            return true;
+        }
+        item = &(*item)->nextItm;
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+*                              PDL: MCWDT
+********************************************************************************
+* The counters start and stop at once, so the waits are not emulated.
+*******************************************************************************/
+void Cy_MCWDT_Enable(MCWDT_STRUCT_Type *base, uint32_t counters, uint16_t waitUs)
+{
+    (void) waitUs;
+    for (uint32_t n = 0; n < SIM_NUM_MCWDT_COUNTERS; n++)
+    {
+        if ((counters & (1UL << n)) != 0u)
+        {
+            base->MCWDT_CTL |= SIM_MCWDT_CTL_ENABLE(n);
+        }
+    }
+}
+
+void Cy_MCWDT_Disable(MCWDT_STRUCT_Type *base, uint32_t counters, uint16_t waitUs)
+{
+    (void) waitUs;
+    for (uint32_t n = 0; n < SIM_NUM_MCWDT_COUNTERS; n++)
+    {
+        if ((counters & (1UL << n)) != 0u)
+        {
+            base->MCWDT_CTL &= ~SIM_MCWDT_CTL_ENABLE(n);
+        }
+    }
+}
+
+void Cy_MCWDT_SetMode(MCWDT_STRUCT_Type *base, cy_en_mcwdtctr_t counter, cy_en_mcwdtmode_t mode)
+{
+    uint32_t pos = SIM_MCWDT_CONFIG_MODE_Pos((uint32_t) counter);
+
+    CY_ASSERT((uint32_t) counter < SIM_NUM_MCWDT_COUNTERS);
+    base->MCWDT_CONFIG = (base->MCWDT_CONFIG & ~(SIM_MCWDT_CONFIG_MODE_Msk << pos)) | ((uint32_t) mode << pos);
+}
+
+void Cy_MCWDT_SetClearOnMatch(MCWDT_STRUCT_Type *base, cy_en_mcwdtctr_t counter, uint32_t enable)
+{
+    CY_ASSERT((uint32_t) counter < SIM_NUM_MCWDT_COUNTERS);
+    if (enable != 0u)
+    {
+        base->MCWDT_CONFIG |= SIM_MCWDT_CONFIG_CLEAR((uint32_t) counter);
+    }
+    else
+    {
+        base->MCWDT_CONFIG &= ~SIM_MCWDT_CONFIG_CLEAR((uint32_t) counter);
+    }
+}
+
+void Cy_MCWDT_SetMatch(MCWDT_STRUCT_Type *base, cy_en_mcwdtctr_t counter, uint32_t match, uint16_t waitUs)
+{
+    uint32_t pos = SIM_MCWDT_COUNT_Pos((uint32_t) counter);
+
+    (void) waitUs;
+    CY_ASSERT((uint32_t) counter < SIM_NUM_MCWDT_COUNTERS);
+    base->MCWDT_MATCH = (base->MCWDT_MATCH & ~(SIM_MCWDT_COUNT_Msk << pos)) | 
+                        ((match & SIM_MCWDT_COUNT_Msk) << pos);
+}
+
+uint32_t Cy_MCWDT_GetCount(MCWDT_STRUCT_Type const *base, cy_en_mcwdtctr_t counter)
+{
+    CY_ASSERT((uint32_t) counter < SIM_NUM_MCWDT_COUNTERS);
+    return (base->MCWDT_CNTLOW >> SIM_MCWDT_COUNT_Pos((uint32_t) counter)) & SIM_MCWDT_COUNT_Msk;
+}
+
+void Cy_MCWDT_ResetCounters(MCWDT_STRUCT_Type *base, uint32_t counters, uint16_t waitUs)
+{
+    (void) waitUs;
+    for (uint32_t n = 0; n < SIM_NUM_MCWDT_COUNTERS; n++)
+    {
+        if ((counters & (1UL << n)) != 0u)
+        {
+            base->MCWDT_CNTLOW &= ~(SIM_MCWDT_COUNT_Msk << SIM_MCWDT_COUNT_Pos(n));
+        }
+    }
+}
+
+uint32_t Cy_MCWDT_GetInterruptStatusMasked(MCWDT_STRUCT_Type const *base)
+{
+    return base->MCWDT_INTR_MASKED;
+}
+
+void Cy_MCWDT_ClearInterrupt(MCWDT_STRUCT_Type *base, uint32_t counters)
+{
+    base->MCWDT_INTR &= ~counters;
+    Sim_McwdtUpdateInterrupt(base);
+}
+
+void Cy_MCWDT_SetInterruptMask(MCWDT_STRUCT_Type *base, uint32_t counters)
+{
+    base->MCWDT_INTR_MASK = counters;
+    Sim_McwdtUpdateInterrupt(base);
+}
+
+/*******************************************************************************
+*                              PDL: DMA (DW)
+*******************************************************************************/
+static uint32_t Sim_LoopCtl(int32_t src_incr, int32_t dst_incr, uint32_t count)
+{
+    return _VAL2FLD(CY_DMA_CTL_SRC_INCR, src_incr) |
+           _VAL2FLD(CY_DMA_CTL_DST_INCR, dst_incr) |
+           _VAL2FLD(CY_DMA_CTL_COUNT, count - 1u);
+}
+
+cy_en_dma_status_t Cy_DMA_Descriptor_Init(cy_stc_dma_descriptor_t * descriptor,
+                                          cy_stc_dma_descriptor_config_t const * config)
+{
+    if ((descriptor == NULL) || (config == NULL))
+    {
+        return CY_DMA_BAD_PARAM;
+    }
+
+    descriptor->ctl = _VAL2FLD(CY_DMA_CTL_RETRIG, config->retrigger) |
+                      _VAL2FLD(CY_DMA_CTL_INTR_TYPE, config->interruptType) |
+                      _VAL2FLD(CY_DMA_CTL_TR_OUT_TYPE, config->triggerOutType) |
+                      _VAL2FLD(CY_DMA_CTL_TR_IN_TYPE, config->triggerInType) |
+                      _VAL2FLD(CY_DMA_CTL_CH_DISABLE, config->channelState) |
+                      _VAL2FLD(CY_DMA_CTL_SRC_SIZE, config->srcTransferSize) |
+                      _VAL2FLD(CY_DMA_CTL_DST_SIZE, config->dstTransferSize) |
+                      _VAL2FLD(CY_DMA_CTL_DATA_SIZE, config->dataSize) |
+                      _VAL2FLD(CY_DMA_CTL_TYPE, config->descriptorType);
+    descriptor->src = (uint32_t)(uintptr_t) config->srcAddress;
+    descriptor->dst = (uint32_t)(uintptr_t) config->dstAddress;
+    descriptor->xCtl = 0;
+    descriptor->yCtl = 0;
+    descriptor->nextPtr = 0;
+
+    switch (config->descriptorType)
+    {
+        case CY_DMA_SINGLE_TRANSFER:
+            descriptor->xCtl = (uint32_t)(uintptr_t) config->nextDescriptor;
+            break;
+        case CY_DMA_1D_TRANSFER:
+            descriptor->xCtl = Sim_LoopCtl(config->srcXincrement, config->dstXincrement, config->xCount);
+            descriptor->yCtl = (uint32_t)(uintptr_t) config->nextDescriptor;
+            break;
+        case CY_DMA_2D_TRANSFER:
+            descriptor->xCtl = Sim_LoopCtl(config->srcXincrement, config->dstXincrement, config->xCount);
+            descriptor->yCtl = Sim_LoopCtl(config->srcYincrement, config->dstYincrement, config->yCount);
+            descriptor->nextPtr = (uint32_t)(uintptr_t) config->nextDescriptor;
+            break;
+        default:
+            return CY_DMA_BAD_PARAM;
+    }
+
+    return CY_DMA_SUCCESS;
+}
+
+void Cy_DMA_Descriptor_DeInit(cy_stc_dma_descriptor_t * descriptor)
+{
+    memset(descriptor, 0, sizeof(*descriptor));
+}
+
+void Cy_DMA_Descriptor_SetSrcAddress(cy_stc_dma_descriptor_t * descriptor, void const * srcAddress)
+{
+    descriptor->src = (uint32_t)(uintptr_t) srcAddress;
+}
+
+void Cy_DMA_Descriptor_SetDstAddress(cy_stc_dma_descriptor_t * descriptor, void const * dstAddress)
+{
+    descriptor->dst = (uint32_t)(uintptr_t) dstAddress;
+}
+
+void * Cy_DMA_Descriptor_GetSrcAddress(cy_stc_dma_descriptor_t const * descriptor)
+{
+    return (void *)(uintptr_t) descriptor->src;
+}
+
+void * Cy_DMA_Descriptor_GetDstAddress(cy_stc_dma_descriptor_t const * descriptor)
+{
+    return (void *)(uintptr_t) descriptor->dst;
+}
+
+void Cy_DMA_Descriptor_SetNextDescriptor(cy_stc_dma_descriptor_t * descriptor,
+                                         cy_stc_dma_descriptor_t const * nextDescriptor)
+{
+    switch (Sim_DescrType(descriptor))
+    {
+        case CY_DMA_SINGLE_TRANSFER: descriptor->xCtl = (uint32_t)(uintptr_t) nextDescriptor;    break;
+        case CY_DMA_1D_TRANSFER:     descriptor->yCtl = (uint32_t)(uintptr_t) nextDescriptor;    break;
+        default:                     descriptor->nextPtr = (uint32_t)(uintptr_t) nextDescriptor; break;
+    }
+}
+
+cy_stc_dma_descriptor_t * Cy_DMA_Descriptor_GetNextDescriptor(cy_stc_dma_descriptor_t const * descriptor)
+{
+    return (cy_stc_dma_descriptor_t *)(uintptr_t) Sim_DescrNext(descriptor);
+}
+
+void Cy_DMA_Descriptor_SetDescriptorType(cy_stc_dma_descriptor_t * descriptor,
+                                         cy_en_dma_descriptor_type_t descriptorType)
+{
+    if (descriptorType != Sim_DescrType(descriptor))
+    {
+        /* Move the next descriptor pointer to its new location */
+        uint32_t next = Sim_DescrNext(descriptor);
+        CY_REG32_CLR_SET(descriptor->ctl, CY_DMA_CTL_TYPE, descriptorType);
+        Cy_DMA_Descriptor_SetNextDescriptor(descriptor, (cy_stc_dma_descriptor_t *)(uintptr_t) next);
+    }
+}
+
+void Cy_DMA_Descriptor_SetInterruptType(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_trigger_type_t interruptType)
+{
+    CY_REG32_CLR_SET(descriptor->ctl, CY_DMA_CTL_INTR_TYPE, interruptType);
+}
+
+void Cy_DMA_Descriptor_SetTriggerInType(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_trigger_type_t triggerInType)
+{
+    CY_REG32_CLR_SET(descriptor->ctl, CY_DMA_CTL_TR_IN_TYPE, triggerInType);
+}
+
+void Cy_DMA_Descriptor_SetTriggerOutType(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_trigger_type_t triggerOutType)
+{
+    CY_REG32_CLR_SET(descriptor->ctl, CY_DMA_CTL_TR_OUT_TYPE, triggerOutType);
+}
+
+void Cy_DMA_Descriptor_SetChannelState(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_channel_state_t channelState)
+{
+    CY_REG32_CLR_SET(descriptor->ctl, CY_DMA_CTL_CH_DISABLE, channelState);
+}
+
+void Cy_DMA_Descriptor_SetDataSize(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_data_size_t dataSize)
+{
+    CY_REG32_CLR_SET(descriptor->ctl, CY_DMA_CTL_DATA_SIZE, dataSize);
+}
+
+void Cy_DMA_Descriptor_SetSrcTransferSize(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_transfer_size_t srcTransferSize)
+{
+    CY_REG32_CLR_SET(descriptor->ctl, CY_DMA_CTL_SRC_SIZE, srcTransferSize);
+}
+
+void Cy_DMA_Descriptor_SetDstTransferSize(cy_stc_dma_descriptor_t * descriptor, cy_en_dma_transfer_size_t dstTransferSize)
+{
+    CY_REG32_CLR_SET(descriptor->ctl, CY_DMA_CTL_DST_SIZE, dstTransferSize);
+}
+
+void Cy_DMA_Descriptor_SetXloopDataCount(cy_stc_dma_descriptor_t * descriptor, uint32_t xCount)
+{
+    CY_ASSERT((xCount >= CY_DMA_LOOP_COUNT_MIN) && (xCount <= CY_DMA_LOOP_COUNT_MAX));
+    CY_REG32_CLR_SET(descriptor->xCtl, CY_DMA_CTL_COUNT, xCount - 1u);
+}
+
+uint32_t Cy_DMA_Descriptor_GetXloopDataCount(cy_stc_dma_descriptor_t const * descriptor)
+{
+    return _FLD2VAL(CY_DMA_CTL_COUNT, descriptor->xCtl) + 1u;
+}
+
+void Cy_DMA_Descriptor_SetXloopSrcIncrement(cy_stc_dma_descriptor_t * descriptor, int32_t srcXincrement)
+{
+    CY_REG32_CLR_SET(descriptor->xCtl, CY_DMA_CTL_SRC_INCR, srcXincrement);
+}
+
+void Cy_DMA_Descriptor_SetXloopDstIncrement(cy_stc_dma_descriptor_t * descriptor, int32_t dstXincrement)
+{
+    CY_REG32_CLR_SET(descriptor->xCtl, CY_DMA_CTL_DST_INCR, dstXincrement);
+}
+
+void Cy_DMA_Descriptor_SetYloopDataCount(cy_stc_dma_descriptor_t * descriptor, uint32_t yCount)
+{
+    CY_ASSERT((yCount >= CY_DMA_LOOP_COUNT_MIN) && (yCount <= CY_DMA_LOOP_COUNT_MAX));
+    CY_REG32_CLR_SET(descriptor->yCtl, CY_DMA_CTL_COUNT, yCount - 1u);
+}
+
+uint32_t Cy_DMA_Descriptor_GetYloopDataCount(cy_stc_dma_descriptor_t const * descriptor)
+{
+    return _FLD2VAL(CY_DMA_CTL_COUNT, descriptor->yCtl) + 1u;
+}
+
+void Cy_DMA_Descriptor_SetYloopSrcIncrement(cy_stc_dma_descriptor_t * descriptor, int32_t srcYincrement)
+{
+    CY_REG32_CLR_SET(descriptor->yCtl, CY_DMA_CTL_SRC_INCR, srcYincrement);
+}
+
+void Cy_DMA_Descriptor_SetYloopDstIncrement(cy_stc_dma_descriptor_t * descriptor, int32_t dstYincrement)
+{
+    CY_REG32_CLR_SET(descriptor->yCtl, CY_DMA_CTL_DST_INCR, dstYincrement);
+}
+
+cy_en_dma_status_t Cy_DMA_Channel_Init(DW_Type * base, uint32_t channel,
+                                       cy_stc_dma_channel_config_t const * config)
+{
+    sim_dma_chan_t *c = &sim_dma[Sim_DwIndex(base)][channel];
+
+    if (config == NULL)
+    {
+        return CY_DMA_BAD_PARAM;
+    }
+
+    c->init = true;
+    c->enabled = config->enable;
+    c->curr = (uint32_t)(uintptr_t) config->descriptor;
+    c->x_idx = 0;
+    c->y_idx = 0;
+    c->intr = 0;
+    c->intr_mask = 0;
+    c->status = CY_DMA_INTR_CAUSE_NO_INTR;
+
+    return CY_DMA_SUCCESS;
+}
+
+void Cy_DMA_Channel_DeInit(DW_Type * base, uint32_t channel)
+{
+    sim_dma_chan_t *c = &sim_dma[Sim_DwIndex(base)][channel];
+    sim_isr_t isr = c->isr;
+    uint32_t isr_latency = c->isr_latency;
+
+    if (c->isr_pending)
+    {
+        sim_dma_isr_pending--;
+    }
+    memset(c, 0, sizeof(*c));
+    c->isr = isr;
+    c->isr_latency = isr_latency;
+}
+
+void Cy_DMA_Channel_SetDescriptor(DW_Type * base, uint32_t channel,
+                                  cy_stc_dma_descriptor_t const * descriptor)
+{
+    sim_dma_chan_t *c = &sim_dma[Sim_DwIndex(base)][channel];
+
+    c->curr = (uint32_t)(uintptr_t) descriptor;
+    c->x_idx = 0;
+    c->y_idx = 0;
+}
+
+cy_stc_dma_descriptor_t * Cy_DMA_Channel_GetCurrentDescriptor(DW_Type const * base, uint32_t channel)
+{
+    return (cy_stc_dma_descriptor_t *)(uintptr_t) sim_dma[Sim_DwIndex(base)][channel].curr;
+}
+
+uint32_t Cy_DMA_Channel_GetCurrentXloopIndex(DW_Type const * base, uint32_t channel)
+{
+    return sim_dma[Sim_DwIndex(base)][channel].x_idx;
+}
+
+uint32_t Cy_DMA_Channel_GetCurrentYloopIndex(DW_Type const * base, uint32_t channel)
+{
+    return sim_dma[Sim_DwIndex(base)][channel].y_idx;
+}
+
+void Cy_DMA_Channel_Enable(DW_Type * base, uint32_t channel)
+{
+    sim_dma[Sim_DwIndex(base)][channel].enabled = true;
+}
+
+void Cy_DMA_Channel_Disable(DW_Type * base, uint32_t channel)
+{
+    sim_dma[Sim_DwIndex(base)][channel].enabled = false;
+}
+
+cy_en_dma_intr_cause_t Cy_DMA_Channel_GetStatus(DW_Type const * base, uint32_t channel)
+{
+    return sim_dma[Sim_DwIndex(base)][channel].status;
+}
+
+uint32_t Cy_DMA_Channel_GetInterruptStatus(DW_Type const * base, uint32_t channel)
+{
+    return sim_dma[Sim_DwIndex(base)][channel].intr;
+}
+
+uint32_t Cy_DMA_Channel_GetInterruptStatusMasked(DW_Type const * base, uint32_t channel)
+{
+    sim_dma_chan_t const *c = &sim_dma[Sim_DwIndex(base)][channel];
+    return c->intr & c->intr_mask;
+}
+
+void Cy_DMA_Channel_ClearInterrupt(DW_Type * base, uint32_t channel)
+{
+    sim_dma[Sim_DwIndex(base)][channel].intr = 0;
+}
+
+void Cy_DMA_Channel_SetInterruptMask(DW_Type * base, uint32_t channel, uint32_t interrupt)
+{
+    sim_dma[Sim_DwIndex(base)][channel].intr_mask = interrupt;
+}
+
+uint32_t Cy_DMA_Channel_GetInterruptMask(DW_Type const * base, uint32_t channel)
+{
+    return sim_dma[Sim_DwIndex(base)][channel].intr_mask;
+}
+
+void Cy_DMA_Enable(DW_Type * base)
+{
+    sim_dma_enabled[Sim_DwIndex(base)] = true;
+}
+
+void Cy_DMA_Disable(DW_Type * base)
+{
+    sim_dma_enabled[Sim_DwIndex(base)] = false;
+}
+
+/*******************************************************************************
+*                               PDL: TCPWM
+*******************************************************************************/
+cy_en_tcpwm_status_t Cy_TCPWM_Counter_Init(TCPWM_Type *base, uint32_t cntNum,
+                                           cy_stc_tcpwm_counter_config_t const *config)
+{
+    sim_timer_t *t = &sim_timer[Sim_TcpwmIndex(base)][cntNum];
+    TCPWM_CNT_Type *reg = &base->CNT[cntNum];
+
+    if (config == NULL)
+    {
+        return CY_TCPWM_BAD_PARAM;
+    }
+
+    t->init = true;
+    t->pwm = false;
+    t->swap_pending = false;
+    t->one_shot = (config->runMode == CY_TCPWM_COUNTER_ONESHOT);
+    reg->CTRL = config->enableCompareSwap ? TCPWM_CNT_CTRL_AUTO_RELOAD_CC_Msk : 0u;
+    reg->COUNTER = 0;
+    reg->PERIOD = config->period;
+    reg->CC = config->compare0;
+    reg->CC_BUFF = config->compare1;
+    reg->INTR = 0;
+    reg->INTR_MASK = config->interruptSources;
+
+    return CY_TCPWM_SUCCESS;
+}
+
+void Cy_TCPWM_Counter_DeInit(TCPWM_Type *base, uint32_t cntNum, cy_stc_tcpwm_counter_config_t const *config)
+{
+    sim_timer_t *t = &sim_timer[Sim_TcpwmIndex(base)][cntNum];
+
+    (void) config;
+    t->init = false;
+    t->enabled = false;
+    t->running = false;
+    memset(&base->CNT[cntNum], 0, sizeof(TCPWM_CNT_Type));
+}
+
+void Cy_TCPWM_Counter_Enable(TCPWM_Type *base, uint32_t cntNum)
+{
+    sim_timer[Sim_TcpwmIndex(base)][cntNum].enabled = true;
+}
+
+void Cy_TCPWM_Counter_Disable(TCPWM_Type *base, uint32_t cntNum)
+{
+    sim_timer_t *t = &sim_timer[Sim_TcpwmIndex(base)][cntNum];
+
+    t->enabled = false;
+    t->running = false;
+}
+
+void Cy_TCPWM_Counter_SetCounter(TCPWM_Type *base, uint32_t cntNum, uint32_t count)
+{
+    base->CNT[cntNum].COUNTER = count;
+}
+
+uint32_t Cy_TCPWM_Counter_GetCounter(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return base->CNT[cntNum].COUNTER;
+}
+
+void Cy_TCPWM_Counter_SetPeriod(TCPWM_Type *base, uint32_t cntNum, uint32_t period)
+{
+    base->CNT[cntNum].PERIOD = period;
+}
+
+uint32_t Cy_TCPWM_Counter_GetPeriod(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return base->CNT[cntNum].PERIOD;
+}
+
+void Cy_TCPWM_Counter_SetCompare0(TCPWM_Type *base, uint32_t cntNum, uint32_t compare0)
+{
+    base->CNT[cntNum].CC = compare0;
+}
+
+uint32_t Cy_TCPWM_Counter_GetCompare0(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return base->CNT[cntNum].CC;
+}
+
+void Cy_TCPWM_Counter_SetCompare1(TCPWM_Type *base, uint32_t cntNum, uint32_t compare1)
+{
+    base->CNT[cntNum].CC_BUFF = compare1;
+}
+
+uint32_t Cy_TCPWM_Counter_GetCompare1(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return base->CNT[cntNum].CC_BUFF;
+}
+
+void Cy_TCPWM_Counter_EnableCompareSwap(TCPWM_Type *base, uint32_t cntNum, bool enable)
+{
+    if (enable)
+    {
+        base->CNT[cntNum].CTRL |= TCPWM_CNT_CTRL_AUTO_RELOAD_CC_Msk;
+    }
+    else
+    {
+        base->CNT[cntNum].CTRL &= ~TCPWM_CNT_CTRL_AUTO_RELOAD_CC_Msk;
+    }
+}
+
+cy_en_tcpwm_status_t Cy_TCPWM_PWM_Init(TCPWM_Type *base, uint32_t cntNum,
+                                       cy_stc_tcpwm_pwm_config_t const *config)
+{
+    sim_timer_t *t = &sim_timer[Sim_TcpwmIndex(base)][cntNum];
+    TCPWM_CNT_Type *reg = &base->CNT[cntNum];
+
+    if (config == NULL || config->pwmMode != CY_TCPWM_PWM_MODE_PWM ||
+        config->pwmAlignment != CY_TCPWM_PWM_LEFT_ALIGN)
+    {
+        return CY_TCPWM_BAD_PARAM;
+    }
+
+    t->init = true;
+    t->pwm = true;
+    t->swap_pending = false;
+    t->one_shot = (config->runMode == CY_TCPWM_PWM_ONESHOT);
+    reg->CTRL = (config->enableCompareSwap ? TCPWM_CNT_CTRL_AUTO_RELOAD_CC_Msk : 0u) |
+                (config->enablePeriodSwap ? TCPWM_CNT_CTRL_AUTO_RELOAD_PERIOD_Msk : 0u);
+    reg->COUNTER = 0;
+    reg->PERIOD = config->period0;
+    reg->PERIOD_BUFF = config->period1;
+    reg->CC = config->compare0;
+    reg->CC_BUFF = config->compare1;
+    reg->INTR = 0;
+    reg->INTR_MASK = config->interruptSources;
+
+    return CY_TCPWM_SUCCESS;
+}
+
+void Cy_TCPWM_PWM_DeInit(TCPWM_Type *base, uint32_t cntNum, cy_stc_tcpwm_pwm_config_t const *config)
+{
+    (void) config;
+    Cy_TCPWM_Counter_DeInit(base, cntNum, NULL);
+}
+
+void Cy_TCPWM_PWM_Enable(TCPWM_Type *base, uint32_t cntNum)
+{
+    Cy_TCPWM_Counter_Enable(base, cntNum);
+}
+
+void Cy_TCPWM_PWM_Disable(TCPWM_Type *base, uint32_t cntNum)
+{
+    Cy_TCPWM_Counter_Disable(base, cntNum);
+}
+
+uint32_t Cy_TCPWM_PWM_GetStatus(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return sim_timer[Sim_TcpwmIndex(base)][cntNum].running ? 
+           CY_TCPWM_PWM_STATUS_COUNTER_RUNNING : 0u;
+}
+
+void Cy_TCPWM_PWM_SetCounter(TCPWM_Type *base, uint32_t cntNum, uint32_t count)
+{
+    base->CNT[cntNum].COUNTER = count;
+}
+
+uint32_t Cy_TCPWM_PWM_GetCounter(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return base->CNT[cntNum].COUNTER;
+}
+
+void Cy_TCPWM_PWM_SetPeriod0(TCPWM_Type *base, uint32_t cntNum, uint32_t period0)
+{
+    base->CNT[cntNum].PERIOD = period0;
+}
+
+uint32_t Cy_TCPWM_PWM_GetPeriod0(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return base->CNT[cntNum].PERIOD;
+}
+
+void Cy_TCPWM_PWM_SetPeriod1(TCPWM_Type *base, uint32_t cntNum, uint32_t period1)
+{
+    base->CNT[cntNum].PERIOD_BUFF = period1;
+}
+
+uint32_t Cy_TCPWM_PWM_GetPeriod1(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return base->CNT[cntNum].PERIOD_BUFF;
+}
+
+void Cy_TCPWM_PWM_SetCompare0(TCPWM_Type *base, uint32_t cntNum, uint32_t compare0)
+{
+    base->CNT[cntNum].CC = compare0;
+}
+
+uint32_t Cy_TCPWM_PWM_GetCompare0(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return base->CNT[cntNum].CC;
+}
+
+void Cy_TCPWM_PWM_SetCompare1(TCPWM_Type *base, uint32_t cntNum, uint32_t compare1)
+{
+    base->CNT[cntNum].CC_BUFF = compare1;
+}
+
+uint32_t Cy_TCPWM_PWM_GetCompare1(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return base->CNT[cntNum].CC_BUFF;
+}
+
+void Cy_TCPWM_TriggerCaptureOrSwap_Single(TCPWM_Type *base, uint32_t cntNum)
+{
+    sim_timer_t *t = &sim_timer[Sim_TcpwmIndex(base)][cntNum];
+
+    if (t->pwm)
+    {
+        t->swap_pending = true;
+    }
+}
+
+void Cy_TCPWM_TriggerStart_Single(TCPWM_Type *base, uint32_t cntNum)
+{
+    sim_timer_t *t = &sim_timer[Sim_TcpwmIndex(base)][cntNum];
+
+    if (t->enabled)
+    {
+        t->running = true;
+    }
+}
+
+void Cy_TCPWM_TriggerStopOrKill_Single(TCPWM_Type *base, uint32_t cntNum)
+{
+    sim_timer[Sim_TcpwmIndex(base)][cntNum].running = false;
+}
+
+uint32_t Cy_TCPWM_GetInterruptStatus(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return base->CNT[cntNum].INTR;
+}
+
+uint32_t Cy_TCPWM_GetInterruptStatusMasked(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return base->CNT[cntNum].INTR & base->CNT[cntNum].INTR_MASK;
+}
+
+void Cy_TCPWM_ClearInterrupt(TCPWM_Type *base, uint32_t cntNum, uint32_t source)
+{
+    base->CNT[cntNum].INTR &= ~source;
+}
+
+void Cy_TCPWM_SetInterruptMask(TCPWM_Type *base, uint32_t cntNum, uint32_t mask)
+{
+    base->CNT[cntNum].INTR_MASK = mask;
+}
+
+uint32_t Cy_TCPWM_GetInterruptMask(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return base->CNT[cntNum].INTR_MASK;
+}
+
+/*******************************************************************************
+*                                PDL: SCB
+*******************************************************************************/
+void Cy_SCB_UART_SetTxFifoLevel(CySCB_Type *base, uint32_t level)
+{
+    CY_REG32_CLR_SET(base->TX_FIFO_CTRL, SCB_TX_FIFO_CTRL_TRIGGER_LEVEL, level);
+}
+
+uint32_t Cy_SCB_UART_GetNumInTxFifo(CySCB_Type const *base)
+{
+    return _FLD2VAL(SCB_TX_FIFO_STATUS_USED, base->TX_FIFO_STATUS);
+}
+
+/*******************************************************************************
+*                                PDL: SAR
+*******************************************************************************/
+void Cy_SAR_Enable(SAR_Type *base)
+{
+    sim_sar[Sim_SarIndex(base)].enabled = true;
+}
+
+void Cy_SAR_Disable(SAR_Type *base)
+{
+    sim_sar_t *s = &sim_sar[Sim_SarIndex(base)];
+
+    s->enabled = false;
+    s->busy = false;
+    s->avg_acc = 0;
+    s->avg_num = 0;
+}
+
+void Cy_SAR_DeepSleep(SAR_Type *base)
+{
+    Cy_SAR_Disable(base);
+}
+
+void Cy_SAR_Wakeup(SAR_Type *base)
+{
+    Cy_SAR_Enable(base);
+}
+
+uint32_t Cy_SAR_GetInterruptStatus(const SAR_Type *base)
+{
+    return base->INTR;
+}
+
+void Cy_SAR_ClearInterrupt(SAR_Type *base, uint32_t intrMask)
+{
+    base->INTR &= ~intrMask;
+}
+
+int16_t Cy_SAR_CountsTo_mVolts(const SAR_Type *base, uint32_t chan, int16_t adcCounts)
+{
+    (void) base;
+    (void) chan;
+    return (int16_t)(((int32_t) adcCounts * 3300) / 2048);
+}
+
+/* [] END OF FILE */
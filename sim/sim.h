@@ -0,0 +1,115 @@
+/*****************************************************************************
+* File Name  : sim.h
+*
+* Description: This file contains the controls of the host simulator of the
+*              HSIOM, DW, TCPWM, SAR and UART blocks used by the middleware.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SIM_H_
+#define SIM_H_
+
+#include "cy_pdl.h"
+
+/*******************************************************************************
+*                                 API Constants
+*******************************************************************************/
+#ifndef SIM_SAR_CONVERSION_TICKS
+    #define SIM_SAR_CONVERSION_TICKS       (90u)
+#endif
+
+#ifndef SIM_UART_FIFO_SIZE
+    #define SIM_UART_FIFO_SIZE             (128u)
+#endif
+
+/* Bytes sent by a UART and not yet read with Sim_ReadUart() */
+#ifndef SIM_UART_CAPTURE_SIZE
+    #define SIM_UART_CAPTURE_SIZE          (65536u)
+#endif
+
+/* Frequency of the LFCLK counted by the MCWDT */
+#ifndef SIM_CLK_LF_HZ
+    #define SIM_CLK_LF_HZ                  (32768u)
+#endif
+
+/** Value returned by the SAR when no pin is connected to its AMux bus */
+#define SIM_SAR_OPEN_INPUT             (-1)
+
+/*******************************************************************************
+*                              Type Definitions
+*******************************************************************************/
+/** Interrupt handler */
+typedef void (*sim_isr_t)(void);
+
+/** Counters of the simulated hardware */
+typedef struct
+{
+    uint32_t ticks;
+    uint32_t hsiom_writes;
+    uint32_t dma_triggers;
+    uint32_t dma_missed_triggers;
+    uint32_t dma_transfers;
+    uint32_t dma_descriptors;
+    uint32_t sar_conversions;
+    uint32_t sar_collisions;
+    uint32_t sar_open_samples;
+    uint32_t sar_short_samples;
+    uint32_t uart_tx_bytes;
+    uint32_t uart_overflows;
+    uint32_t deep_sleeps;
+    uint32_t deep_sleeps_denied;
+} sim_counters_t;
+
+/*******************************************************************************
+*                            Function Prototypes
+*******************************************************************************/
+void Sim_Init(uint32_t clk_peri_hz);
+void Sim_SetPinValue(uint32_t port, uint32_t pin, int16_t value);
+void Sim_SetSarAmux(SAR_Type *sar, uint32_t amux_sel);
+void Sim_RouteTimerCompareToDma(TCPWM_Type *timer, uint32_t cnt, DW_Type *dma, uint32_t chan);
+void Sim_RouteTimerOverflowToSar(TCPWM_Type *timer, uint32_t cnt, SAR_Type *sar);
+void Sim_RouteSarDoneToDma(SAR_Type *sar, DW_Type *dma, uint32_t chan);
+void Sim_SetDmaIsr(DW_Type *dma, uint32_t chan, sim_isr_t isr);
+void Sim_SetDmaIsrLatency(DW_Type *dma, uint32_t chan, uint32_t ticks);
+void Sim_SetTimerIsr(TCPWM_Type *timer, uint32_t cnt, sim_isr_t isr);
+void Sim_SetMcwdtIsr(MCWDT_STRUCT_Type *mcwdt, sim_isr_t isr);
+void Sim_TriggerDma(DW_Type *dma, uint32_t chan);
+void Sim_SetUartBaud(CySCB_Type *scb, uint32_t baud);
+void Sim_RouteUartTxToDma(CySCB_Type *scb, DW_Type *dma, uint32_t chan);
+uint32_t Sim_ReadUart(CySCB_Type *scb, uint8_t *data, uint32_t max);
+void Sim_Run(uint32_t ticks);
+void Sim_GetCounters(sim_counters_t *counters);
+void Sim_ResetCounters(void);
+uint32_t Sim_GetClockFrequency(void);
+
+#endif /* SIM_H_ */
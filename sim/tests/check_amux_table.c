@@ -0,0 +1,65 @@
+/*******************************************************************************
+* File Name: check_amux_table.c
+*
+*  Description: This file contains the build check of the AMux flash tables. The tables 
+*   hold 32-bit addresses, so this file is only compiled for a 32-bit target, 
+*   see the Makefile. The whole table shall be a constant expression.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+
+#include "amux.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+/* Pins of the code example board, plus two pins sharing a register */
+#define CHECK_AMUX_PINS(X, t) \
+    AMUX_TABLE_PORT(X, t, 9) AMUX_TABLE_PORT(X, t, 10) X(t, 12, 0) X(t, 12, 1)
+
+_Static_assert(sizeof(void *) == 4u, "The flash tables are only built for a 32-bit target");
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+AMUX_TABLE_DEFINE(check_amux, CHECK_AMUX_PINS, AMUX_B, 2u);
+
+_Static_assert(check_amux_NUM_CONN == 18, "One connection per pin");
+_Static_assert(check_amux_REG_9_0 == (HSIOM_BASE + 0x90u), "PORT_SEL0 of port 9");
+_Static_assert(check_amux_REG_10_5 == (HSIOM_BASE + 0xA4u), "PORT_SEL1 of port 10");
+_Static_assert(!AMUX_TABLE_SAME_REG(check_amux, 9, 0), "The first pin clears the last one");
+_Static_assert(AMUX_TABLE_SAME_REG(check_amux, 9, 1), "Pins 0 and 1 share PORT_SEL0");
+_Static_assert(!AMUX_TABLE_SAME_REG(check_amux, 9, 4), "Pin 4 is in PORT_SEL1");
+_Static_assert(AMUX_TABLE_SAME_REG(check_amux, 12, 1), "Pins 0 and 1 share PORT_SEL0");
+
+/* [] END OF FILE */
@@ -0,0 +1,151 @@
+/*****************************************************************************
+* File Name  : sim_test.h
+*
+* Description: This file contains the helpers shared by the regression tests of the
+*              simulator, run by "make -C sim test".
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SIM_TEST_H_
+#define SIM_TEST_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim.h"
+
+/*******************************************************************************
+*                                 API Constants
+*******************************************************************************/
+#define SIM_TEST_CLK_PERI_HZ           (100000000u)
+
+/* Board of the code example: the AMux DW channel is triggered by the timer
+ * compare, the SAR by the timer overflow, and the Sampler DW channel by the
+ * end of the conversion */
+#define SIM_TEST_AMUX_DMA_CHAN         (0u)
+#define SIM_TEST_SAMPLER_DMA_CHAN      (28u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static uint32_t sim_test_failures;
+
+/*******************************************************************************
+*                                    Macros
+*******************************************************************************/
+/** Count and report a failed check, without stopping the test */
+#define SIM_TEST_CHECK(cond) \
+    do \
+    { \
+        if (!(cond)) \
+        { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            sim_test_failures++; \
+        } \
+    } while (0)
+
+/** Compare a counter with its expected value */
+#define SIM_TEST_EXPECT(value, expected) \
+    do \
+    { \
+        if ((uint32_t)(value) != (uint32_t)(expected)) \
+        { \
+            fprintf(stderr, "%s:%d: %s is %u, expected %u\n", __FILE__, __LINE__, #value, \
+                    (unsigned)(value), (unsigned)(expected)); \
+            sim_test_failures++; \
+        } \
+    } while (0)
+
+/*******************************************************************************
+* Function Name: SimTest_Init
+********************************************************************************
+* Summary:
+*   Initialize the simulator with the trigger routing of the code example. 
+*   Every pin reads its port times 100 plus its pin number, so a sample stored
+*   for the wrong pin is found.
+*
+* Parameters:
+*   sampler_isr: handler of the Sampler DW channel interrupt, or NULL
+*
+*******************************************************************************/
+static inline void SimTest_Init(sim_isr_t sampler_isr)
+{
+    Sim_Init(SIM_TEST_CLK_PERI_HZ);
+
+    for (uint32_t port = 0; port < IOSS_GPIO_GPIO_PORT_NR; port++)
+    {
+        for (uint32_t pin = 0; pin < CY_GPIO_PINS_MAX; pin++)
+        {
+            Sim_SetPinValue(port, pin, (int16_t)((port * 100u) + pin));
+        }
+    }
+
+    Sim_RouteTimerCompareToDma(TCPWM0, 0, DW0, SIM_TEST_AMUX_DMA_CHAN);
+    Sim_RouteTimerOverflowToSar(TCPWM0, 0, SAR0);
+    Sim_RouteSarDoneToDma(SAR0, DW0, SIM_TEST_SAMPLER_DMA_CHAN);
+    if (sampler_isr != NULL)
+    {
+        Sim_SetDmaIsr(DW0, SIM_TEST_SAMPLER_DMA_CHAN, sampler_isr);
+    }
+}
+
+/*******************************************************************************
+* Function Name: SimTest_PinValue
+********************************************************************************
+* Summary:
+*   Get the value read from a pin, see SimTest_Init().
+*
+*******************************************************************************/
+static inline int16_t SimTest_PinValue(uint32_t port, uint32_t pin)
+{
+    return (int16_t)((port * 100u) + pin);
+}
+
+/*******************************************************************************
+* Function Name: SimTest_Result
+********************************************************************************
+* Summary:
+*   Print the result of the test.
+*
+* Return:
+*   Exit status of the test program.
+*
+*******************************************************************************/
+static inline int SimTest_Result(const char *name)
+{
+    printf("%s: %s\n", name, (sim_test_failures == 0u) ? "PASS" : "FAIL");
+    return (sim_test_failures == 0u) ? 0 : 1;
+}
+
+#endif /* SIM_TEST_H_ */
@@ -0,0 +1,220 @@
+/*******************************************************************************
+* File Name: test_amux_pins.c
+*
+*  Description: This file contains the test of AMux_AddPins() with pins of several
+*   ports and HSIOM registers listed out of order. The connection order is
+*   checked with and without grouping, with the HSIOM selection of every pin
+*   after each connection and with the frames sampled by the DMA. Digital pins
+*   sharing the registers keep their selection, and a list with a repeated,
+*   already added or missing pin is refused without changing the connections.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_PINS                       (7u)
+#define SAMPLE_RATE_SPS                (500000u)
+#define ACQUISITION_TIME_NS            (180u)
+
+/* Digital pins in registers used by the AMux */
+#define DIGITAL_SEL                    (8u)
+#define NUM_DIGITAL                    (2u)
+
+/* 1 ms of scanning at the peripheral clock */
+#define RUN_TICKS                      (SIM_TEST_CLK_PERI_HZ / 1000u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static amux_t amux;
+static cy_stc_dma_descriptor_t amux_desc[AMUX_MAX_NUM_DESCRIPTORS];
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static int16_t ping[NUM_PINS];
+static int16_t pong[NUM_PINS];
+
+/* Ports 9, 10 and 12, both HSIOM registers of each, out of order */
+static const amux_pin_t pins[NUM_PINS] =
+{
+    { GPIO_PRT10, 5u }, { GPIO_PRT9, 1u }, { GPIO_PRT10, 2u }, { GPIO_PRT12, 7u },
+    { GPIO_PRT9, 6u }, { GPIO_PRT10, 4u }, { GPIO_PRT12, 0u },
+};
+static const uint32_t list_order[NUM_PINS][2] =
+{
+    { 10u, 5u }, { 9u, 1u }, { 10u, 2u }, { 12u, 7u }, { 9u, 6u }, { 10u, 4u }, { 12u, 0u },
+};
+/* Grouped by register, in the order of the first pin of each register */
+static const uint32_t group_order[NUM_PINS][2] =
+{
+    { 10u, 5u }, { 10u, 4u }, { 9u, 1u }, { 10u, 2u }, { 12u, 7u }, { 9u, 6u }, { 12u, 0u },
+};
+static const uint32_t digital[NUM_DIGITAL][2] =
+{
+    { 10u, 6u }, { 9u, 0u },
+};
+
+static const uint32_t (*expected_order)[2];
+static uint32_t frames;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static volatile uint32_t *Test_GetSelReg(uint32_t port, uint32_t pin)
+{
+    HSIOM_PRT_Type *hsiom = (HSIOM_PRT_Type *)(HSIOM_BASE + (HSIOM_PRT_SECTION_SIZE * port));
+
+    return (pin < CY_GPIO_PRT_HALF) ? &hsiom->PORT_SEL0 : &hsiom->PORT_SEL1;
+}
+
+static uint32_t Test_GetSel(uint32_t port, uint32_t pin)
+{
+    return (*Test_GetSelReg(port, pin) >> (8u * (pin % CY_GPIO_PRT_HALF))) & 0xFFu;
+}
+
+static void Test_SetSel(uint32_t port, uint32_t pin, uint32_t sel)
+{
+    volatile uint32_t *reg = Test_GetSelReg(port, pin);
+    uint32_t shift = 8u * (pin % CY_GPIO_PRT_HALF);
+
+    *reg = (*reg & ~(0xFFu << shift)) | (sel << shift);
+}
+
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+static void Test_FrameCallback(const sampler_event_t *event, void *arg)
+{
+    (void)arg;
+    for (uint32_t ch = 0; ch < NUM_PINS; ch++)
+    {
+        SIM_TEST_EXPECT(event->frame[ch], SimTest_PinValue(expected_order[ch][0], expected_order[ch][1]));
+    }
+    frames++;
+}
+
+/* Connect each pin with the CPU and check only it is on the AMux bus */
+static void Test_Connections(const uint32_t (*order)[2])
+{
+    for (uint32_t i = 0; i < NUM_PINS; i++)
+    {
+        SIM_TEST_CHECK(AMux_Connect(&amux, (uint8_t)i) == AMUX_SUCCESS);
+        for (uint32_t j = 0; j < NUM_PINS; j++)
+        {
+            SIM_TEST_EXPECT(Test_GetSel(order[j][0], order[j][1]), 
+                            (i == j) ? HSIOM_SEL_AMUXB : HSIOM_SEL_GPIO);
+        }
+        for (uint32_t j = 0; j < NUM_DIGITAL; j++)
+        {
+            SIM_TEST_EXPECT(Test_GetSel(digital[j][0], digital[j][1]), DIGITAL_SEL);
+        }
+    }
+    SIM_TEST_CHECK(AMux_DisconnectAll(&amux) == AMUX_SUCCESS);
+}
+
+/* Scan the pins with the DMAs and check the frames follow the order */
+static void Test_Scan(const uint32_t (*order)[2])
+{
+    expected_order = order;
+    frames = 0;
+
+    SIM_TEST_CHECK(AMux_ConfigureDescriptors(&amux, amux_desc, AMUX_MAX_NUM_DESCRIPTORS) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetupDMA(&amux, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_StartDMA(&amux) == AMUX_SUCCESS);
+
+    Sampler_Init(&sampler, SAR0, TCPWM0, 0);
+    Sampler_SetScanRate(&sampler, SAMPLE_RATE_SPS, ACQUISITION_TIME_NS);
+    Sampler_ConfigurePingPong(&sampler, NUM_PINS, ping, pong);
+    Sampler_RegisterCallback(&sampler, Test_FrameCallback, NULL);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_Start(&sampler) == SAMPLER_SUCCESS);
+
+    Sim_Run(RUN_TICKS);
+    Sampler_Stop(&sampler);
+    AMux_StopDMA(&amux);
+
+    SIM_TEST_CHECK(frames > 0u);
+    for (uint32_t j = 0; j < NUM_DIGITAL; j++)
+    {
+        SIM_TEST_EXPECT(Test_GetSel(digital[j][0], digital[j][1]), DIGITAL_SEL);
+    }
+}
+
+int main(void)
+{
+    const amux_pin_t repeated[] = { { GPIO_PRT12, 3u }, { GPIO_PRT12, 3u } };
+    const amux_pin_t added[] = { { GPIO_PRT12, 3u }, { GPIO_PRT9, 6u } };
+    const amux_pin_t missing[] = { { GPIO_PRT12, 3u }, { GPIO_PRT9, CY_GPIO_PINS_MAX } };
+
+    SimTest_Init(Test_SamplerIsr);
+    for (uint32_t j = 0; j < NUM_DIGITAL; j++)
+    {
+        Test_SetSel(digital[j][0], digital[j][1], DIGITAL_SEL);
+    }
+
+    /* In the order of the list */
+    AMux_Init(&amux, AMUX_B);
+    SIM_TEST_CHECK(AMux_AddPins(&amux, pins, NUM_PINS, false) == AMUX_SUCCESS);
+    SIM_TEST_EXPECT(amux.num_conn, NUM_PINS);
+    Test_Connections(list_order);
+    Test_Scan(list_order);
+
+    /* A list with a bad pin adds none of its pins */
+    SIM_TEST_CHECK(AMux_AddPins(&amux, repeated, 2u, true) == AMUX_ERROR);
+    SIM_TEST_CHECK(AMux_AddPins(&amux, added, 2u, true) == AMUX_ERROR);
+    SIM_TEST_CHECK(AMux_AddPins(&amux, missing, 2u, true) == AMUX_ERROR);
+    SIM_TEST_EXPECT(amux.num_conn, NUM_PINS);
+    AMux_Deinit(&amux);
+
+    /* Grouped by HSIOM register */
+    AMux_Init(&amux, AMUX_B);
+    SIM_TEST_CHECK(AMux_AddPins(&amux, pins, NUM_PINS, true) == AMUX_SUCCESS);
+    SIM_TEST_EXPECT(amux.num_conn, NUM_PINS);
+    Test_Connections(group_order);
+    Test_Scan(group_order);
+
+    return SimTest_Result("test_amux_pins");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,164 @@
+/*******************************************************************************
+* File Name: test_amux_table.c
+*
+*  Description: This file contains the regression test of the AMux flash tables: the 
+*   frames sampled with a table built by the macros of AMUX_TABLE_DEFINE(), 
+*   and the check of the other pins of the HSIOM registers of the table. 
+*   The host addresses are not constants, so the table is built in RAM from 
+*   the same initializers; check_amux_table.c checks the build in flash.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+
+/* The descriptors hold 32-bit addresses, which the host program has with 
+ * -no-pie */
+#pragma GCC diagnostic ignored "-Wpointer-to-int-cast"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define HOLD_COUNT                     (4u)
+#define SAMPLING_RATE_SPS              (500000u)
+#define SAMPLING_TIME_NS               (180u)
+#define RUN_TICKS                      (200000u)
+
+/* A digital function of a pin that is not in the table */
+#define OTHER_PIN_PORT                 (10u)
+#define OTHER_PIN                      (3u)
+#define OTHER_PIN_SEL                  (8u)
+
+/* Pins of the code example board, plus two pins sharing a register */
+#define TEST_PINS(X, t) \
+    AMUX_TABLE_PORT(X, t, 9) X(t, 10, 2) X(t, 10, 5) X(t, 12, 0) X(t, 12, 1)
+
+AMUX_TABLE_ENUMS(test_table, TEST_PINS, AMUX_B, HOLD_COUNT);
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static const uint32_t test_table_connect_port[] = { TEST_PINS(AMUX_TABLE_PORT_ENTRY, test_table) };
+static const uint32_t test_table_connect_pin[] = { TEST_PINS(AMUX_TABLE_PIN_ENTRY, test_table) };
+static cy_stc_dma_descriptor_t test_table_chain[2u * test_table_NUM_CONN];
+static amux_table_t test_table;
+
+static const uint8_t test_ports[test_table_NUM_CONN] = { 9, 9, 9, 9, 9, 9, 9, 9, 10, 10, 12, 12 };
+static const uint8_t test_pins[test_table_NUM_CONN] = { 0, 1, 2, 3, 4, 5, 6, 7, 2, 5, 0, 1 };
+
+static amux_t amux;
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static int16_t ping[test_table_NUM_CONN];
+static int16_t pong[test_table_NUM_CONN];
+static uint32_t num_frames;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+static void Test_FrameCallback(const sampler_event_t *event, void *arg)
+{
+    (void) arg;
+    num_frames++;
+    for (uint32_t ch = 0; ch < test_table_NUM_CONN; ch++)
+    {
+        SIM_TEST_EXPECT(event->frame[ch], SimTest_PinValue(test_ports[ch], test_pins[ch]));
+    }
+}
+
+int main(void)
+{
+    sim_counters_t counters;
+    HSIOM_PRT_Type *other_hsiom = (HSIOM_PRT_Type *)(HSIOM_BASE + (HSIOM_PRT_SECTION_SIZE * OTHER_PIN_PORT));
+
+    /* Same descriptors as the flash table, with the addresses of this run */
+    const cy_stc_dma_descriptor_t chain[] = { TEST_PINS(AMUX_TABLE_DESCR, test_table) };
+    memcpy(test_table_chain, chain, sizeof(chain));
+    test_table = (amux_table_t)
+    {
+        .amux_sel = AMUX_B,
+        .connect_port = test_table_connect_port,
+        .connect_pin = test_table_connect_pin,
+        .num_conn = test_table_NUM_CONN,
+        .hold_count = HOLD_COUNT,
+        .dma_chain = test_table_chain,
+    };
+
+    SimTest_Init(Test_SamplerIsr);
+
+    AMux_Init(&amux, AMUX_B);
+
+    /* The table would set another pin of a used register to GPIO */
+    other_hsiom->PORT_SEL0 = OTHER_PIN_SEL << (8u * OTHER_PIN);
+    SIM_TEST_CHECK(AMux_SetupDMATable(&amux, &test_table, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_ERROR);
+    other_hsiom->PORT_SEL0 = 0u;
+
+    SIM_TEST_CHECK(AMux_SetupDMATable(&amux, &test_table, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+    SIM_TEST_EXPECT(amux.num_conn, test_table_NUM_CONN);
+    SIM_TEST_CHECK(AMux_StartDMA(&amux) == AMUX_SUCCESS);
+
+    Sampler_Init(&sampler, SAR0, TCPWM0, 0);
+    Sampler_SetScanRate(&sampler, SAMPLING_RATE_SPS, SAMPLING_TIME_NS);
+    Sampler_SetOversampling(&sampler, HOLD_COUNT);
+    Sampler_ConfigurePingPong(&sampler, amux.num_conn, ping, pong);
+    Sampler_RegisterCallback(&sampler, Test_FrameCallback, NULL);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_Start(&sampler) == SAMPLER_SUCCESS);
+
+    Sim_Run(RUN_TICKS);
+    Sampler_Stop(&sampler);
+    AMux_StopDMA(&amux);
+
+    /* Every sample is taken after the pin was connected for a whole hold */
+    Sim_GetCounters(&counters);
+    SIM_TEST_CHECK(num_frames > 0u);
+    SIM_TEST_EXPECT(counters.sar_short_samples, 0u);
+    SIM_TEST_EXPECT(counters.sar_open_samples, 0u);
+
+    return SimTest_Result("test_amux_table");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,253 @@
+/*******************************************************************************
+* File Name: test_burst.c
+*
+*  Description: This file contains the regression test of the burst mode woken up by the
+*   MCWDT: the bursts started by the timer, the frames of each burst, the
+*   switches opened and the SAR ADC idle between the bursts, the Deep Sleep
+*   refused during a burst, and the energy report with the timer period.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+#include "burst.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (24u)
+#define SAMPLE_RATE_SPS                (920000u)
+#define ACQUISITION_TIME_NS            (180u)
+
+#define FRAMES_PER_BURST               (10u)
+/* 164 LFCLK cycles, 5004.9 us */
+#define PERIOD_US                      (5000u)
+#define EXPECTED_PERIOD_US             (5005u)
+#define NUM_BURSTS                     (20u)
+
+/* Power model: 3 mA while scanning, 5 uA in Deep Sleep, 3.3 V */
+#define ACTIVE_UA                      (3000u)
+#define SLEEP_UA                       (5u)
+#define SUPPLY_MV                      (3300u)
+
+/* The main loop wakes up every 10 us */
+#define LOOP_TICKS                     (SIM_TEST_CLK_PERI_HZ / 100000u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static amux_t amux;
+static cy_stc_dma_descriptor_t amux_desc[AMUX_MAX_NUM_DESCRIPTORS];
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static burst_t burst;
+static int16_t ping[NUM_CHANNELS];
+static int16_t pong[NUM_CHANNELS];
+
+static uint32_t frames;
+static uint32_t bad_samples;
+static uint32_t bad_sequences;
+static uint32_t conversions_asleep;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+static void Test_TimerIsr(void)
+{
+    Burst_TimerIRQHandler(&burst);
+}
+
+static void Test_FrameCallback(const sampler_event_t *event, void *arg)
+{
+    static const uint32_t ports[] = { 9u, 10u, 12u };
+
+    (void)arg;
+    if (event->sequence != (frames % FRAMES_PER_BURST))
+    {
+        bad_sequences++;
+    }
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        if (event->frame[ch] != SimTest_PinValue(ports[ch / 8u], ch % 8u))
+        {
+            bad_samples++;
+        }
+    }
+    frames++;
+}
+
+/* Main loop of a battery node: Deep Sleep between the bursts, refused while
+ * a burst runs. Returns the number of Deep Sleep transitions */
+static uint32_t Test_Run(uint32_t num_ticks)
+{
+    sim_counters_t counters;
+    uint32_t sleeps = 0;
+    uint32_t conversions;
+
+    for (uint32_t i = 0; i < num_ticks; i += LOOP_TICKS)
+    {
+        Sim_GetCounters(&counters);
+        conversions = counters.sar_conversions;
+        if (Cy_SysPm_CpuEnterDeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT) == CY_SYSPM_SUCCESS)
+        {
+            sleeps++;
+            SIM_TEST_CHECK(!Burst_IsActive(&burst));
+        }
+        else
+        {
+            SIM_TEST_CHECK(Burst_IsActive(&burst));
+        }
+        Sim_Run(LOOP_TICKS);
+
+        /* Nothing converted while asleep, unless a burst ended in this step */
+        Sim_GetCounters(&counters);
+        if (!Burst_IsActive(&burst) && (counters.sar_conversions != conversions) && 
+            (frames % FRAMES_PER_BURST) != 0u)
+        {
+            conversions_asleep++;
+        }
+    }
+
+    return sleeps;
+}
+
+static bool Test_SwitchesOpen(void)
+{
+    for (uint32_t i = 0; i < amux.num_conn; i++)
+    {
+        if (CY_GET_REG32(amux.connect_port[i]) != 0u)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(void)
+{
+    burst_stats_t stats;
+    sim_counters_t counters;
+    uint32_t sleeps;
+    uint64_t charge;
+
+    SimTest_Init(Test_SamplerIsr);
+    Sim_SetMcwdtIsr(MCWDT_STRUCT0, Test_TimerIsr);
+
+    SIM_TEST_CHECK(AMux_Init(&amux, AMUX_B) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT9, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT10, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT12, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_ConfigureDescriptors(&amux, amux_desc, AMUX_MAX_NUM_DESCRIPTORS) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetupDMA(&amux, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+
+    SIM_TEST_CHECK(Sampler_Init(&sampler, SAR0, TCPWM0, 0u) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetScanRate(&sampler, SAMPLE_RATE_SPS, ACQUISITION_TIME_NS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_ConfigurePingPong(&sampler, NUM_CHANNELS, ping, pong) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+
+    SIM_TEST_CHECK(Burst_Init(&burst, &amux, &sampler, FRAMES_PER_BURST) == BURST_SUCCESS);
+    SIM_TEST_CHECK(Burst_RegisterCallback(&burst, Test_FrameCallback, NULL) == BURST_SUCCESS);
+    SIM_TEST_CHECK(Burst_SetPowerModel(&burst, 0u, ACTIVE_UA, SLEEP_UA, SUPPLY_MV) == BURST_SUCCESS);
+
+    /* Out of the range of the 16-bit counter */
+    SIM_TEST_CHECK(Burst_SetupTimer(&burst, MCWDT_STRUCT0, 30u) == BURST_ERROR);
+    SIM_TEST_CHECK(Burst_SetupTimer(&burst, MCWDT_STRUCT0, 2100000u) == BURST_ERROR);
+    SIM_TEST_CHECK(Burst_SetupTimer(&burst, MCWDT_STRUCT0, PERIOD_US) == BURST_SUCCESS);
+
+    /* Asleep until the first wake-up, one period later */
+    Sim_ResetCounters();
+    sleeps = Test_Run((PERIOD_US - 100u) * (SIM_TEST_CLK_PERI_HZ / 1000000u));
+    Sim_GetCounters(&counters);
+    SIM_TEST_EXPECT(frames, 0u);
+    SIM_TEST_EXPECT(counters.sar_conversions, 0u);
+    SIM_TEST_CHECK(sleeps > 0u);
+
+    /* The timer starts every burst */
+    Test_Run((NUM_BURSTS * PERIOD_US + 100u) * (SIM_TEST_CLK_PERI_HZ / 1000000u));
+    Sim_GetCounters(&counters);
+    SIM_TEST_CHECK(Burst_GetStats(&burst, &stats) == BURST_SUCCESS);
+
+    printf("bursts %u, frames %u, active %u us, period %u us, average %u uA, %u nJ/frame, sleeps %u, denied %u\n",
+           (unsigned)stats.bursts, (unsigned)frames, (unsigned)stats.active_us, (unsigned)burst.period_us,
+           (unsigned)stats.average_ua, (unsigned)stats.energy_nj_per_frame, (unsigned)counters.deep_sleeps,
+           (unsigned)stats.sleeps_denied);
+
+    SIM_TEST_EXPECT(stats.bursts, NUM_BURSTS);
+    SIM_TEST_EXPECT(stats.frames, NUM_BURSTS * FRAMES_PER_BURST);
+    SIM_TEST_EXPECT(frames, NUM_BURSTS * FRAMES_PER_BURST);
+    SIM_TEST_EXPECT(counters.sar_conversions, NUM_BURSTS * FRAMES_PER_BURST * NUM_CHANNELS);
+    SIM_TEST_EXPECT(stats.bursts_skipped, 0u);
+    SIM_TEST_CHECK(stats.sleeps_denied > 0u);
+    SIM_TEST_EXPECT(counters.deep_sleeps_denied, stats.sleeps_denied);
+    SIM_TEST_EXPECT(bad_samples, 0u);
+    SIM_TEST_EXPECT(bad_sequences, 0u);
+    SIM_TEST_EXPECT(conversions_asleep, 0u);
+    SIM_TEST_CHECK(!Burst_IsActive(&burst));
+    SIM_TEST_CHECK(Test_SwitchesOpen());
+
+    /* The energy report uses the rounded timer period */
+    SIM_TEST_EXPECT(burst.period_us, EXPECTED_PERIOD_US);
+    charge = ((uint64_t) ACTIVE_UA * stats.active_us) + 
+             ((uint64_t) SLEEP_UA * (EXPECTED_PERIOD_US - stats.active_us));
+    SIM_TEST_EXPECT(stats.average_ua, charge / EXPECTED_PERIOD_US);
+    SIM_TEST_EXPECT(stats.energy_nj_per_frame, (charge * SUPPLY_MV) / (1000000u * FRAMES_PER_BURST));
+
+    /* A period shorter than a burst skips the wake-ups during the bursts */
+    SIM_TEST_CHECK(Burst_SetupTimer(&burst, MCWDT_STRUCT0, 100u) == BURST_SUCCESS);
+    Test_Run(SIM_TEST_CLK_PERI_HZ / 100u);
+    SIM_TEST_CHECK(Burst_GetStats(&burst, &stats) == BURST_SUCCESS);
+    SIM_TEST_CHECK(stats.bursts_skipped > 0u);
+    SIM_TEST_EXPECT(bad_samples, 0u);
+
+    /* No more bursts once de-initialized */
+    Burst_Deinit(&burst);
+    frames = 0;
+    Test_Run(SIM_TEST_CLK_PERI_HZ / 100u);
+    SIM_TEST_EXPECT(frames, 0u);
+    SIM_TEST_CHECK(Test_SwitchesOpen());
+
+    return SimTest_Result("test_burst");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,295 @@
+/*******************************************************************************
+* File Name: test_calib.c
+*
+*  Description: This file contains the regression test of the calibration: the rounding of
+*   the gains and offsets, the saturation at the limits of the counts and of the
+*   millivolts, and the two-point fit. Random frames, gains and offsets are
+*   compared with a double-precision reference, and random two-point fits 
+*   with the gain and offset they were made from. It is built once with the
+*   portable C path and once with the emulated Cortex-M4 SIMD path, so both
+*   paths give the same results as the reference.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "sim_test.h"
+#include "calib.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+/* Odd, so the SIMD path converts two pairs and one last channel */
+#define NUM_CHANNELS                   (5u)
+
+#define GAIN_HALF                      (CALIB_GAIN_ONE / 2)
+
+/* Random frames, with new gains and offsets every RANDOM_TABLE_FRAMES */
+#define RANDOM_FRAMES                  (200000u)
+#define RANDOM_TABLE_FRAMES            (1000u)
+#define RANDOM_FITS                    (10000u)
+
+/* Largest error of a two-point fit, in mV per count and in counts */
+#define FIT_GAIN_ERROR                 (0.002)
+#define FIT_OFFSET_ERROR               (2)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static calib_t calib;
+static uint32_t random_state = 1u;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+/* Convert the same counts on every channel */
+static int16_t Test_Convert(uint32_t channel, int16_t counts)
+{
+    int16_t frame[NUM_CHANNELS];
+
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        frame[ch] = counts;
+    }
+    SIM_TEST_CHECK(Calib_Convert(&calib, frame, frame) == CALIB_SUCCESS);
+
+    return frame[channel];
+}
+
+static uint32_t Test_Random(void)
+{
+    random_state = (random_state * 1103515245u) + 12345u;
+    return random_state >> 8;
+}
+
+static int16_t Test_Saturate(double value)
+{
+    return (value > INT16_MAX) ? INT16_MAX : ((value < INT16_MIN) ? INT16_MIN : (int16_t) value);
+}
+
+/* Same conversion in double precision, rounding halves up */
+static int16_t Test_Reference(int16_t counts, int16_t offset, int16_t gain)
+{
+    double x = Test_Saturate((double) counts - offset);
+
+    return Test_Saturate(floor(((x * gain) / CALIB_GAIN_ONE) + 0.5));
+}
+
+static void Test_RandomFrames(void)
+{
+    int16_t frame[NUM_CHANNELS];
+    int16_t output[NUM_CHANNELS];
+    uint32_t errors = 0;
+
+    SIM_TEST_CHECK(Calib_Init(&calib, NUM_CHANNELS) == CALIB_SUCCESS);
+
+    for (uint32_t i = 0; i < RANDOM_FRAMES; i++)
+    {
+        if ((i % RANDOM_TABLE_FRAMES) == 0u)
+        {
+            for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+            {
+                SIM_TEST_CHECK(Calib_SetChannel(&calib, (uint8_t) ch, (int16_t) Test_Random(), 
+                                                (int16_t) Test_Random()) == CALIB_SUCCESS);
+            }
+        }
+
+        /* Half of the frames are 12-bit counts, the others any value */
+        for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+        {
+            frame[ch] = ((i % 2u) == 0u) ? (int16_t)(Test_Random() % 4096u) : (int16_t) Test_Random();
+        }
+
+        SIM_TEST_CHECK(Calib_Convert(&calib, frame, output) == CALIB_SUCCESS);
+        for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+        {
+            if (output[ch] != Test_Reference(frame[ch], calib.offset[ch], calib.gain[ch]))
+            {
+                errors++;
+            }
+        }
+    }
+
+    SIM_TEST_EXPECT(errors, 0u);
+}
+
+static void Test_RandomFits(void)
+{
+    double gain;
+    int16_t offset;
+    int16_t counts_low;
+    int16_t counts_high;
+    uint32_t errors = 0;
+
+    SIM_TEST_CHECK(Calib_Init(&calib, NUM_CHANNELS) == CALIB_SUCCESS);
+
+    for (uint32_t i = 0; i < RANDOM_FITS; i++)
+    {
+        /* 0.5 to 2 mV per count, up to 100 counts of offset, and two 
+         * inputs near the ends of the 12-bit range. The inputs are whole
+         * millivolts, so lower gains give larger offset errors */
+        gain = 0.5 + ((Test_Random() % 1500u) / 1000.0);
+        offset = (int16_t)((int32_t)(Test_Random() % 201u) - 100);
+        counts_low = (int16_t)(offset + 200 + (int32_t)(Test_Random() % 200u));
+        counts_high = (int16_t)(offset + 3600 + (int32_t)(Test_Random() % 200u));
+
+        SIM_TEST_CHECK(Calib_TwoPoint(&calib, 0u, 
+                                      counts_low, (int16_t) lround(gain * (counts_low - offset)),
+                                      counts_high, (int16_t) lround(gain * (counts_high - offset))) 
+                       == CALIB_SUCCESS);
+        if (fabs(((double) calib.gain[0] / CALIB_GAIN_ONE) - gain) > FIT_GAIN_ERROR ||
+            abs(calib.offset[0] - offset) > FIT_OFFSET_ERROR)
+        {
+            errors++;
+        }
+    }
+
+    SIM_TEST_EXPECT(errors, 0u);
+}
+
+static void Test_Rounding(void)
+{
+    int16_t frame[NUM_CHANNELS] = { INT16_MIN, -1, 0, 1, INT16_MAX };
+    int16_t output[NUM_CHANNELS];
+
+    /* No calibration: the counts are unchanged */
+    SIM_TEST_CHECK(Calib_Convert(&calib, frame, output) == CALIB_SUCCESS);
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        SIM_TEST_EXPECT(output[ch], frame[ch]);
+    }
+
+    /* Halves are rounded up */
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        SIM_TEST_CHECK(Calib_SetChannel(&calib, (uint8_t) ch, 0, GAIN_HALF) == CALIB_SUCCESS);
+    }
+    SIM_TEST_EXPECT(Test_Convert(4u, 3), 2);
+    SIM_TEST_EXPECT(Test_Convert(3u, 1), 1);
+    SIM_TEST_EXPECT(Test_Convert(2u, -1), 0);
+    SIM_TEST_EXPECT(Test_Convert(1u, -3), -1);
+    SIM_TEST_EXPECT(Test_Convert(0u, 4), 2);
+
+    /* Just below and above a half */
+    SIM_TEST_CHECK(Calib_SetChannel(&calib, 4u, 0, GAIN_HALF - 1) == CALIB_SUCCESS);
+    SIM_TEST_EXPECT(Test_Convert(4u, 1), 0);
+    SIM_TEST_CHECK(Calib_SetChannel(&calib, 4u, 0, GAIN_HALF + 1) == CALIB_SUCCESS);
+    SIM_TEST_EXPECT(Test_Convert(4u, -1), -1);
+
+    /* Offset, then gain */
+    SIM_TEST_CHECK(Calib_SetChannel(&calib, 1u, 100, 3 * CALIB_GAIN_ONE) == CALIB_SUCCESS);
+    SIM_TEST_EXPECT(Test_Convert(1u, 50), -150);
+    SIM_TEST_EXPECT(Test_Convert(1u, 100), 0);
+}
+
+static void Test_Saturation(void)
+{
+    SIM_TEST_CHECK(Calib_Init(&calib, NUM_CHANNELS) == CALIB_SUCCESS);
+
+    /* The counts minus the offset saturate before the gain */
+    SIM_TEST_CHECK(Calib_SetChannel(&calib, 0u, -100, CALIB_GAIN_ONE) == CALIB_SUCCESS);
+    SIM_TEST_CHECK(Calib_SetChannel(&calib, 1u, 100, CALIB_GAIN_ONE) == CALIB_SUCCESS);
+    SIM_TEST_CHECK(Calib_SetChannel(&calib, 2u, -100, -CALIB_GAIN_ONE) == CALIB_SUCCESS);
+    SIM_TEST_EXPECT(Test_Convert(0u, INT16_MAX), INT16_MAX);
+    SIM_TEST_EXPECT(Test_Convert(1u, INT16_MIN), INT16_MIN);
+    SIM_TEST_EXPECT(Test_Convert(2u, INT16_MAX), -INT16_MAX);
+
+    /* The millivolts saturate after the gain, up to the largest product */
+    SIM_TEST_CHECK(Calib_SetChannel(&calib, 3u, 0, INT16_MAX) == CALIB_SUCCESS);
+    SIM_TEST_CHECK(Calib_SetChannel(&calib, 4u, 0, INT16_MIN) == CALIB_SUCCESS);
+    SIM_TEST_EXPECT(Test_Convert(3u, 4096), INT16_MAX);
+    SIM_TEST_EXPECT(Test_Convert(3u, 4097), INT16_MAX);
+    SIM_TEST_EXPECT(Test_Convert(3u, -4097), INT16_MIN);
+    SIM_TEST_EXPECT(Test_Convert(3u, INT16_MIN), INT16_MIN);
+    SIM_TEST_EXPECT(Test_Convert(4u, 4096), INT16_MIN);
+    SIM_TEST_EXPECT(Test_Convert(4u, -4095), 32760);
+    SIM_TEST_EXPECT(Test_Convert(4u, -4096), INT16_MAX);
+    SIM_TEST_EXPECT(Test_Convert(4u, INT16_MIN), INT16_MAX);
+    SIM_TEST_EXPECT(Test_Convert(4u, INT16_MAX), INT16_MIN);
+}
+
+static void Test_TwoPoint(void)
+{
+    SIM_TEST_CHECK(Calib_Init(&calib, NUM_CHANNELS) == CALIB_SUCCESS);
+
+    /* 12-bit counts of a 0.806 mV per count input: 330 mV and 2970 mV */
+    SIM_TEST_CHECK(Calib_TwoPoint(&calib, 0u, 410, 330, 3686, 2970) == CALIB_SUCCESS);
+    SIM_TEST_EXPECT(calib.gain[0], 3301);
+    SIM_TEST_EXPECT(calib.offset[0], 1);
+    SIM_TEST_EXPECT(Test_Convert(0u, 410), 330);
+    SIM_TEST_EXPECT(Test_Convert(0u, 3686), 2970);
+    SIM_TEST_EXPECT(Test_Convert(0u, 2048), 1650);
+    SIM_TEST_EXPECT(Test_Convert(0u, 1), 0);
+
+    /* Decreasing, and points given in any order */
+    SIM_TEST_CHECK(Calib_TwoPoint(&calib, 4u, 3000, 0, 1000, 2000) == CALIB_SUCCESS);
+    SIM_TEST_EXPECT(calib.gain[4], -CALIB_GAIN_ONE);
+    SIM_TEST_EXPECT(calib.offset[4], 3000);
+    SIM_TEST_EXPECT(Test_Convert(4u, 1000), 2000);
+    SIM_TEST_EXPECT(Test_Convert(4u, 2000), 1000);
+
+    /* Refused fits leave the channel unchanged */
+    SIM_TEST_CHECK(Calib_TwoPoint(&calib, 0u, 1000, 0, 1000, 100) == CALIB_ERROR);
+    /* 100 mV per count does not fit in Q3.12 */
+    SIM_TEST_CHECK(Calib_TwoPoint(&calib, 0u, 0, 0, 100, 10000) == CALIB_ERROR);
+    /* The gain rounds to 0 */
+    SIM_TEST_CHECK(Calib_TwoPoint(&calib, 0u, 0, 0, 30000, 1) == CALIB_ERROR);
+    /* The counts at 0 mV do not fit in 16 bits */
+    SIM_TEST_CHECK(Calib_TwoPoint(&calib, 0u, 0, 3000, 30000, 3100) == CALIB_ERROR);
+    SIM_TEST_CHECK(Calib_TwoPoint(&calib, NUM_CHANNELS, 0, 0, 100, 100) == CALIB_ERROR);
+    SIM_TEST_EXPECT(calib.gain[0], 3301);
+    SIM_TEST_EXPECT(calib.offset[0], 1);
+}
+
+int main(void)
+{
+    SIM_TEST_CHECK(Calib_Init(NULL, NUM_CHANNELS) == CALIB_ERROR);
+    SIM_TEST_CHECK(Calib_Init(&calib, 0u) == CALIB_ERROR);
+    SIM_TEST_CHECK(Calib_Init(&calib, CALIB_MAX_NUM_CHANNELS + 1u) == CALIB_ERROR);
+    SIM_TEST_CHECK(Calib_Init(&calib, NUM_CHANNELS) == CALIB_SUCCESS);
+    SIM_TEST_CHECK(Calib_SetChannel(&calib, NUM_CHANNELS, 0, CALIB_GAIN_ONE) == CALIB_ERROR);
+
+    Test_Rounding();
+    Test_Saturation();
+    Test_TwoPoint();
+    Test_RandomFrames();
+    Test_RandomFits();
+
+    return SimTest_Result(CALIB_USE_SIMD ? "test_calib_simd" : "test_calib");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,195 @@
+/*******************************************************************************
+* File Name: test_capture.c
+*
+*  Description: This file contains the regression test of the capture file writer: the
+*   blocks written to a file in memory are checked, then a write callback
+*   that fails halfway through a block shall leave the file with its
+*   complete blocks and that partial block at its end, and nothing after.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+#include "capture.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (8u)
+#define FRAMES_PER_BLOCK               (16u)
+#define FILE_SIZE                      (16384u)
+
+#define HEADER_SIZE                    (sizeof(capture_file_header_t) + \
+                                        (NUM_CHANNELS * sizeof(capture_channel_t)))
+#define BLOCK_SIZE                     (sizeof(capture_block_header_t) + \
+                                        (NUM_CHANNELS * FRAMES_PER_BLOCK * sizeof(int16_t)))
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static amux_t amux;
+static sampler_t sampler;
+static capture_t capture;
+static int16_t samples[NUM_CHANNELS];
+static int16_t block[NUM_CHANNELS * FRAMES_PER_BLOCK];
+
+static uint8_t file[FILE_SIZE];
+static uint32_t file_size;
+/* Bytes stored before the write callback fails, ~0 to never fail */
+static uint32_t fail_at;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+/* Appends to the file, and stores part of the bytes when it fails, as a full 
+ * SD card would */
+static bool Test_Write(const void *data, uint32_t size, void *arg)
+{
+    uint32_t stored = size;
+
+    (void)arg;
+    if ((file_size + size) > fail_at)
+    {
+        stored = fail_at - file_size;
+    }
+    SIM_TEST_CHECK((file_size + stored) <= FILE_SIZE);
+    memcpy(&file[file_size], data, stored);
+    file_size += stored;
+
+    return (stored == size);
+}
+
+static void Test_AddFrames(uint32_t first, uint32_t num_frames, en_capture_status_t expected)
+{
+    int16_t frame[NUM_CHANNELS];
+
+    for (uint32_t i = first; i < (first + num_frames); i++)
+    {
+        for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+        {
+            frame[ch] = (int16_t)((i * NUM_CHANNELS) + ch);
+        }
+        SIM_TEST_CHECK(Capture_AddFrame(&capture, frame, i) == expected);
+    }
+}
+
+/* Check the block of the file holds the frames from first */
+static void Test_CheckBlock(uint32_t index, uint32_t first)
+{
+    capture_block_header_t header;
+    int16_t value;
+    const uint8_t *data = &file[HEADER_SIZE + (index * BLOCK_SIZE)];
+
+    memcpy(&header, data, sizeof(header));
+    SIM_TEST_EXPECT(header.magic, CAPTURE_BLOCK_MAGIC);
+    SIM_TEST_EXPECT(header.index, index);
+    SIM_TEST_EXPECT(header.first_sequence, first);
+    SIM_TEST_EXPECT(header.num_frames, FRAMES_PER_BLOCK);
+
+    /* Channel after channel */
+    data += sizeof(header);
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        for (uint32_t i = 0; i < FRAMES_PER_BLOCK; i++)
+        {
+            memcpy(&value, data, sizeof(value));
+            data += sizeof(value);
+            SIM_TEST_CHECK(value == (int16_t)(((first + i) * NUM_CHANNELS) + ch));
+        }
+    }
+}
+
+int main(void)
+{
+    uint32_t size;
+
+    SimTest_Init(NULL);
+
+    SIM_TEST_CHECK(AMux_Init(&amux, AMUX_B) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT9, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(Sampler_Init(&sampler, SAR0, TCPWM0, 0u) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_Configure(&sampler, NUM_CHANNELS, samples) == SAMPLER_SUCCESS);
+
+    /* Three blocks */
+    fail_at = ~0u;
+    SIM_TEST_CHECK(Capture_Init(&capture, &amux, &sampler, block, FRAMES_PER_BLOCK, 
+                                Test_Write, NULL) == CAPTURE_SUCCESS);
+    SIM_TEST_CHECK(Capture_Start(&capture) == CAPTURE_SUCCESS);
+    Test_AddFrames(0u, 3u * FRAMES_PER_BLOCK, CAPTURE_SUCCESS);
+    SIM_TEST_EXPECT(file_size, HEADER_SIZE + (3u * BLOCK_SIZE));
+    for (uint32_t i = 0; i < 3u; i++)
+    {
+        Test_CheckBlock(i, i * FRAMES_PER_BLOCK);
+    }
+
+    /* The callback fails in the samples of the fifth block: the header and 
+     * part of the samples are stored */
+    fail_at = HEADER_SIZE + (4u * BLOCK_SIZE) + sizeof(capture_block_header_t) + 10u;
+    Test_AddFrames(3u * FRAMES_PER_BLOCK, FRAMES_PER_BLOCK, CAPTURE_SUCCESS);
+    Test_AddFrames(4u * FRAMES_PER_BLOCK, FRAMES_PER_BLOCK - 1u, CAPTURE_SUCCESS);
+    Test_AddFrames(5u * FRAMES_PER_BLOCK - 1u, 1u, CAPTURE_ERROR);
+    SIM_TEST_EXPECT(capture.write_errors, 1u);
+    SIM_TEST_EXPECT(capture.blocks, 4u);
+    Test_CheckBlock(3u, 3u * FRAMES_PER_BLOCK);
+
+    /* Nothing is appended after the partial block, even if the storage 
+     * recovers */
+    size = file_size;
+    fail_at = ~0u;
+    Test_AddFrames(5u * FRAMES_PER_BLOCK, 2u * FRAMES_PER_BLOCK, CAPTURE_ERROR);
+    SIM_TEST_CHECK(Capture_Flush(&capture) == CAPTURE_ERROR);
+    SIM_TEST_EXPECT(file_size, size);
+    SIM_TEST_EXPECT(capture.write_errors, 1u);
+
+    /* The readers take the complete blocks only */
+    SIM_TEST_EXPECT((file_size - HEADER_SIZE) / BLOCK_SIZE, 4u);
+
+    /* A new file */
+    file_size = 0;
+    SIM_TEST_CHECK(Capture_Start(&capture) == CAPTURE_SUCCESS);
+    Test_AddFrames(100u, FRAMES_PER_BLOCK, CAPTURE_SUCCESS);
+    SIM_TEST_EXPECT(file_size, HEADER_SIZE + BLOCK_SIZE);
+    Test_CheckBlock(0u, 100u);
+
+    Capture_Deinit(&capture);
+
+    return SimTest_Result("test_capture");
+}
+
+/* [] END OF FILE */
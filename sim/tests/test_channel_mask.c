@@ -0,0 +1,309 @@
+/*******************************************************************************
+* File Name: test_channel_mask.c
+*
+*  Description: This file contains the regression test of the channel masks: the contents
+*   of every channel of the frames while the AMux and the Sampler switch 
+*   between random masks at 920 ksps, with settle and discard counts, and a 
+*   mask change still pending when the Sampler is stopped.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (24u)
+#define ALL_CHANNELS                   (0x00FFFFFFUL)
+#define SIX_CHANNELS                   (0x00030303UL)
+#define SAMPLING_RATE_SPS              (920000u)
+#define SAMPLING_TIME_NS               (180u)
+
+/* 10 ms of peripheral clocks */
+#define RATE_TICKS                     (SIM_TEST_CLK_PERI_HZ / 100u)
+#define NUM_CHANGES                    (1000u)
+/* The scan is stopped and restarted every few changes */
+#define RESTART_CHANGES                (100u)
+#define MAX_CHANGE_TICKS               (3000u)
+
+/* Written in the frames after they are reported, so a channel not written 
+ * again is found */
+#define POISON                         (-1)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static amux_t amux;
+static cy_stc_dma_descriptor_t amux_desc[AMUX_MAX_NUM_DESCRIPTORS];
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static int16_t ping[NUM_CHANNELS];
+static int16_t pong[NUM_CHANNELS];
+
+static uint32_t num_frames;
+/* Mask of the reported frames, and the one being applied */
+static uint32_t current_mask;
+static uint32_t next_mask;
+static uint32_t random_state = 1u;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+/* Pins 0-7 of ports 9, 10 and 12 */
+static int16_t Test_ChannelValue(uint32_t ch)
+{
+    static const uint8_t ports[] = { 9u, 10u, 12u };
+
+    return SimTest_PinValue(ports[ch / 8u], ch % 8u);
+}
+
+static void Test_FrameCallback(const sampler_event_t *event, void *arg)
+{
+    (void) arg;
+    num_frames++;
+
+    /* A frame has the old or the new mask, never a mix */
+    if (event->channel_mask != current_mask)
+    {
+        SIM_TEST_EXPECT(event->channel_mask, next_mask);
+        current_mask = event->channel_mask;
+    }
+
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        if ((event->channel_mask & (1UL << ch)) != 0u)
+        {
+            SIM_TEST_EXPECT(event->frame[ch], Test_ChannelValue(ch));
+        }
+        else
+        {
+            SIM_TEST_EXPECT(event->frame[ch], POISON);
+        }
+        event->frame[ch] = POISON;
+    }
+}
+
+static uint32_t Test_Random(void)
+{
+    random_state = (random_state * 1103515245u) + 12345u;
+    return random_state >> 8;
+}
+
+/* Returns the frames per second of the current mask */
+static uint32_t Test_MeasureRate(void)
+{
+    uint32_t first = num_frames;
+
+    Sim_Run(RATE_TICKS);
+    return (num_frames - first) * 100u;
+}
+
+/* Returns false while the previous change is applied */
+static bool Test_SetMask(uint32_t mask)
+{
+    uint32_t applied;
+    cy_stc_dma_descriptor_t *link;
+    cy_stc_dma_descriptor_t *link_next;
+    en_amux_status_t status;
+
+    if (Sampler_GetChannelMask(&sampler, &applied) != SAMPLER_SUCCESS)
+    {
+        return false;
+    }
+
+    status = AMux_SetChannelMask(&amux, mask, &link, &link_next);
+    if (status == AMUX_BUSY)
+    {
+        return false;
+    }
+    SIM_TEST_CHECK(status == AMUX_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetChannelMask(&sampler, mask, link, link_next) == SAMPLER_SUCCESS);
+    next_mask = mask;
+
+    return true;
+}
+
+/* Stop the scan, and clear the frames partly written before the stop */
+static void Test_Stop(void)
+{
+    uint32_t mask;
+
+    SIM_TEST_CHECK(Sampler_Stop(&sampler) == SAMPLER_SUCCESS);
+    AMux_StopDMA(&amux);
+    AMux_DisconnectAll(&amux);
+
+    /* A change not applied yet is applied by the stop */
+    SIM_TEST_CHECK(Sampler_GetChannelMask(&sampler, &mask) == SAMPLER_SUCCESS);
+    SIM_TEST_EXPECT(mask, next_mask);
+    current_mask = mask;
+
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        ping[ch] = POISON;
+        pong[ch] = POISON;
+    }
+}
+
+static void Test_Restart(void)
+{
+    Test_Stop();
+    SIM_TEST_CHECK(AMux_StartDMA(&amux) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(Sampler_Start(&sampler) == SAMPLER_SUCCESS);
+}
+
+int main(void)
+{
+    uint32_t mask;
+    uint32_t rate_all;
+    uint32_t rate_six;
+    uint32_t num_changes = 0;
+    uint32_t first_frame;
+    sim_counters_t counters;
+
+    SimTest_Init(Test_SamplerIsr);
+
+    AMux_Init(&amux, AMUX_B);
+    AMux_AddPort(&amux, GPIO_PRT9, 0xFF);
+    AMux_AddPort(&amux, GPIO_PRT10, 0xFF);
+    AMux_AddPort(&amux, GPIO_PRT12, 0xFF);
+    AMux_SetSettleCount(&amux, 0u, 2u);
+    AMux_SetSettleCount(&amux, 5u, 1u);
+    AMux_SetSettleCount(&amux, 17u, 3u);
+    SIM_TEST_CHECK(AMux_ConfigureDescriptors(&amux, amux_desc, AMUX_MAX_NUM_DESCRIPTORS) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetupDMA(&amux, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_StartDMA(&amux) == AMUX_SUCCESS);
+
+    Sampler_Init(&sampler, SAR0, TCPWM0, 0);
+    Sampler_SetScanRate(&sampler, SAMPLING_RATE_SPS, SAMPLING_TIME_NS);
+    Sampler_ConfigurePingPong(&sampler, amux.num_conn, ping, pong);
+    Sampler_SetDiscardCount(&sampler, 0u, 2u);
+    Sampler_SetDiscardCount(&sampler, 5u, 1u);
+    Sampler_SetDiscardCount(&sampler, 17u, 3u);
+    Sampler_RegisterCallback(&sampler, Test_FrameCallback, NULL);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+
+    current_mask = SAMPLER_ALL_CHANNELS;
+    next_mask = SAMPLER_ALL_CHANNELS;
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        ping[ch] = POISON;
+        pong[ch] = POISON;
+    }
+    SIM_TEST_CHECK(Sampler_Start(&sampler) == SAMPLER_SUCCESS);
+    rate_all = Test_MeasureRate();
+
+    /* The disabled channels take no trigger, so 6 channels scan faster */
+    while (!Test_SetMask(SIX_CHANNELS))
+    {
+        Sim_Run(10u);
+    }
+    Sim_Run(RATE_TICKS);
+    rate_six = Test_MeasureRate();
+    SIM_TEST_EXPECT(current_mask, SIX_CHANNELS);
+    SIM_TEST_CHECK(rate_six > (2u * rate_all));
+
+    /* Random masks, at random times of the frames */
+    for (uint32_t i = 0; i < NUM_CHANGES; i++)
+    {
+        Sim_Run((Test_Random() % MAX_CHANGE_TICKS) + 1u);
+        mask = Test_Random() & ALL_CHANNELS;
+        if (mask == 0u)
+        {
+            mask = 1u;
+        }
+        if (Test_SetMask(mask))
+        {
+            num_changes++;
+        }
+        /* Either after the change, or while it is applied */
+        if ((i % RESTART_CHANGES) == 0u)
+        {
+            Test_Restart();
+        }
+    }
+    SIM_TEST_CHECK(num_changes > (NUM_CHANGES / 4u));
+
+    /* A change still pending when the Sampler is stopped is applied by the 
+     * stop, and both DMAs start with it */
+    while (!Test_SetMask(0x00F000F0UL))
+    {
+        Sim_Run(10u);
+    }
+    SIM_TEST_CHECK(Sampler_GetChannelMask(&sampler, &mask) == SAMPLER_BUSY);
+    Test_Stop();
+    SIM_TEST_EXPECT(current_mask, 0x00F000F0UL);
+    first_frame = num_frames;
+    SIM_TEST_CHECK(AMux_StartDMA(&amux) == AMUX_SUCCESS);
+    SIM_TEST_EXPECT(amux.channel_mask, 0x00F000F0UL);
+    SIM_TEST_CHECK(Sampler_Start(&sampler) == SAMPLER_SUCCESS);
+    Sim_Run(RATE_TICKS);
+    SIM_TEST_CHECK(num_frames > first_frame);
+    SIM_TEST_EXPECT(current_mask, 0x00F000F0UL);
+
+    /* Back to all the channels while stopped */
+    Test_Stop();
+    SIM_TEST_CHECK(Test_SetMask(ALL_CHANNELS));
+    SIM_TEST_CHECK(Sampler_GetChannelMask(&sampler, &mask) == SAMPLER_SUCCESS);
+    SIM_TEST_EXPECT(mask, ALL_CHANNELS);
+    current_mask = mask;
+    SIM_TEST_CHECK(AMux_StartDMA(&amux) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(Sampler_Start(&sampler) == SAMPLER_SUCCESS);
+    Sim_Run(RATE_TICKS);
+    SIM_TEST_CHECK(Test_MeasureRate() >= (rate_all - 100u));
+
+    Sampler_Stop(&sampler);
+    AMux_StopDMA(&amux);
+
+    Sim_GetCounters(&counters);
+    printf("frames %u, changes %u, rate all %u fps, six %u fps\n", 
+           (unsigned) num_frames, (unsigned) num_changes, (unsigned) rate_all, (unsigned) rate_six);
+    SIM_TEST_EXPECT(counters.sar_short_samples, 0u);
+    SIM_TEST_EXPECT(counters.sar_open_samples, 0u);
+
+    return SimTest_Result("test_channel_mask");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,308 @@
+/*******************************************************************************
+* File Name: test_filter_bank.c
+*
+*  Description: This file contains the regression test of the filter bank: the
+*   output cadence of the decimation, the accuracy of a low-pass biquad and a
+*   third-order CIC against a double-precision reference, within the worst-case
+*   rounding error, and the saturation of resonant biquads driven at full
+*   scale. It is built once with the portable C path and once with the emulated
+*   Cortex-M4 SIMD path. Both builds compare a checksum of all the outputs with
+*   the same constant, so the two paths give bit-identical results.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "sim_test.h"
+#include "filter_bank.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (24u)
+#define DECIMATION                     (8u)
+#define CIC_ORDER                      (3u)
+#define ACCURACY_FRAMES                (80000u)
+#define SATURATION_FRAMES              (20000u)
+
+/* The filters settle during the first frames */
+#define SETTLE_FRAMES                  (1000u)
+
+/* Cut-off of the low-pass biquad, as a fraction of the sample rate, and its Q */
+#define BIQUAD_CUTOFF                  (0.05)
+#define BIQUAD_Q                       (0.7071)
+
+/* Samples of the impulse response summed for the error bound */
+#define IMPULSE_SAMPLES                (10000u)
+
+/* Checksum of all the outputs, the same on both paths */
+#define OUTPUT_CHECKSUM                (0xd4049388u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static filter_bank_t bank;
+static uint32_t random_state = 1u;
+static uint32_t checksum = 0u;
+
+/* Low-pass biquad, normalized by a0, in the order of FilterBank_SetBiquads(),
+ * rounded as the Q2.14 coefficients */
+static double ref[FILTER_BANK_COEFFS_PER_BIQUAD];
+static int16_t coeffs[FILTER_BANK_COEFFS_PER_BIQUAD];
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static uint32_t Test_Random(void)
+{
+    random_state = (random_state * 1103515245u) + 12345u;
+    return random_state >> 8;
+}
+
+static void Test_Checksum(const int16_t *output)
+{
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        checksum = (checksum * 31u) + (uint16_t) output[ch];
+    }
+}
+
+/* The biquad rounds its output, within 0.5 LSB, and feeds it back through
+ * 1 / (1 + a1*z^-1 + a2*z^-2): the error is at most 0.5 LSB times the sum of
+ * the magnitudes of its impulse response. The CIC adds the truncation of its
+ * final shift, below 1 LSB. */
+static double Test_ErrorBound(void)
+{
+    double y[2] = { 0.0, 0.0 };
+    double x = 1.0;
+    double sum = 0.0;
+
+    for (uint32_t n = 0; n < IMPULSE_SAMPLES; n++)
+    {
+        double value = x - (ref[3] * y[0]) - (ref[4] * y[1]);
+
+        x = 0.0;
+        sum += fabs(value);
+        y[1] = y[0];
+        y[0] = value;
+    }
+
+    return (0.5 * sum) + 1.0;
+}
+
+static void Test_Cadence(void)
+{
+    int16_t frame[NUM_CHANNELS] = { 0 };
+    int16_t output[NUM_CHANNELS];
+
+    SIM_TEST_CHECK(FilterBank_Init(&bank, NUM_CHANNELS, DECIMATION) == FILTER_BANK_SUCCESS);
+    for (uint32_t n = 0; n < (4u * DECIMATION); n++)
+    {
+        SIM_TEST_EXPECT(FilterBank_Process(&bank, frame, output),
+                        ((n % DECIMATION) == (DECIMATION - 1u)) ? FILTER_BANK_SUCCESS : FILTER_BANK_PENDING);
+    }
+
+    /* A reset restarts the decimation period */
+    SIM_TEST_EXPECT(FilterBank_Process(&bank, frame, output), FILTER_BANK_PENDING);
+    FilterBank_Reset(&bank);
+    for (uint32_t n = 0; n < (DECIMATION - 1u); n++)
+    {
+        SIM_TEST_EXPECT(FilterBank_Process(&bank, frame, output), FILTER_BANK_PENDING);
+    }
+    SIM_TEST_EXPECT(FilterBank_Process(&bank, frame, output), FILTER_BANK_SUCCESS);
+
+    SIM_TEST_CHECK(FilterBank_Process(&bank, NULL, output) == FILTER_BANK_ERROR);
+    SIM_TEST_CHECK(FilterBank_Process(&bank, frame, NULL) == FILTER_BANK_ERROR);
+}
+
+/* Noisy triangle waves of different rates on every channel, through the
+ * low-pass biquad and the CIC, compared with a double-precision reference */
+static void Test_Accuracy(void)
+{
+    int16_t input[NUM_CHANNELS];
+    int16_t output[NUM_CHANNELS];
+    double x[NUM_CHANNELS][2] = { { 0.0 } };
+    double y[NUM_CHANNELS][2] = { { 0.0 } };
+    double integrator[NUM_CHANNELS][CIC_ORDER] = { { 0.0 } };
+    double comb[NUM_CHANNELS][CIC_ORDER] = { { 0.0 } };
+    double max_error = 0.0;
+    double bound = Test_ErrorBound();
+    en_filter_bank_status_t status;
+
+    SIM_TEST_CHECK(FilterBank_Init(&bank, NUM_CHANNELS, DECIMATION) == FILTER_BANK_SUCCESS);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        SIM_TEST_CHECK(FilterBank_SetBiquads(&bank, ch, coeffs, 1u) == FILTER_BANK_SUCCESS);
+        SIM_TEST_CHECK(FilterBank_SetCic(&bank, ch, CIC_ORDER) == FILTER_BANK_SUCCESS);
+    }
+
+    for (uint32_t n = 0; n < ACCURACY_FRAMES; n++)
+    {
+        for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+        {
+            /* 548 to 3548, with a period of 6000 / (ch + 1) frames */
+            uint32_t phase = (n * (ch + 1u)) % 6000u;
+            int32_t triangle = (phase < 3000u) ? (int32_t) phase : (int32_t)(6000u - phase);
+
+            input[ch] = (int16_t)(548 + triangle + (int32_t)(Test_Random() % 64u) - 32);
+        }
+        status = FilterBank_Process(&bank, input, output);
+
+        for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+        {
+            double value = (ref[0] * input[ch]) + (ref[1] * x[ch][0]) + (ref[2] * x[ch][1]) -
+                           (ref[3] * y[ch][0]) - (ref[4] * y[ch][1]);
+
+            x[ch][1] = x[ch][0];
+            x[ch][0] = input[ch];
+            y[ch][1] = y[ch][0];
+            y[ch][0] = value;
+            for (uint32_t k = 0; k < CIC_ORDER; k++)
+            {
+                integrator[ch][k] += value;
+                value = integrator[ch][k];
+            }
+
+            if (status == FILTER_BANK_SUCCESS)
+            {
+                for (uint32_t k = 0; k < CIC_ORDER; k++)
+                {
+                    double previous = comb[ch][k];
+
+                    comb[ch][k] = value;
+                    value -= previous;
+                }
+                /* Gain of the CIC: decimation^order */
+                value /= pow(DECIMATION, CIC_ORDER);
+                if ((n > SETTLE_FRAMES) && (fabs(value - output[ch]) > max_error))
+                {
+                    max_error = fabs(value - output[ch]);
+                }
+            }
+        }
+
+        if (status == FILTER_BANK_SUCCESS)
+        {
+            Test_Checksum(output);
+        }
+    }
+
+    printf("test_filter_bank: max error %.2f LSB, bound %.2f LSB\n", max_error, bound);
+    SIM_TEST_CHECK(max_error <= bound);
+}
+
+/* Full-scale random samples through two resonant biquads, so the accumulators
+ * and the 16-bit states saturate, with every CIC order */
+static void Test_Saturation(void)
+{
+    /* Gain of about 4 near a quarter of the sample rate, then a low-pass */
+    const int16_t resonant[2u * FILTER_BANK_COEFFS_PER_BIQUAD] =
+    {
+        4096, 0, -4096, 0, 14745,
+        coeffs[0], coeffs[1], coeffs[2], coeffs[3], coeffs[4],
+    };
+    int16_t input[NUM_CHANNELS];
+    int16_t output[NUM_CHANNELS];
+    uint32_t saturated = 0u;
+    en_filter_bank_status_t status;
+
+    SIM_TEST_CHECK(FilterBank_Init(&bank, NUM_CHANNELS, DECIMATION) == FILTER_BANK_SUCCESS);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        SIM_TEST_CHECK(FilterBank_SetBiquads(&bank, ch, resonant, (uint8_t)(ch % 3u)) == FILTER_BANK_SUCCESS);
+        SIM_TEST_CHECK(FilterBank_SetCic(&bank, ch, (uint8_t)(ch % (FILTER_BANK_MAX_CIC_ORDER + 1u))) ==
+                       FILTER_BANK_SUCCESS);
+    }
+
+    for (uint32_t n = 0; n < SATURATION_FRAMES; n++)
+    {
+        for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+        {
+            input[ch] = (int16_t) Test_Random();
+        }
+        status = FilterBank_Process(&bank, input, output);
+        SIM_TEST_CHECK(status != FILTER_BANK_ERROR);
+
+        if (status == FILTER_BANK_SUCCESS)
+        {
+            for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+            {
+                if ((output[ch] == INT16_MAX) || (output[ch] == INT16_MIN))
+                {
+                    saturated++;
+                }
+            }
+            Test_Checksum(output);
+        }
+    }
+
+    /* The saturation is exercised */
+    SIM_TEST_CHECK(saturated > 0u);
+}
+
+int main(void)
+{
+    const double pi = 3.14159265358979323846;
+    const double w = 2.0 * pi * BIQUAD_CUTOFF;
+    const double alpha = sin(w) / (2.0 * BIQUAD_Q);
+    const double a0 = 1.0 + alpha;
+
+    ref[0] = (1.0 - cos(w)) / 2.0 / a0;
+    ref[1] = (1.0 - cos(w)) / a0;
+    ref[2] = (1.0 - cos(w)) / 2.0 / a0;
+    ref[3] = -2.0 * cos(w) / a0;
+    ref[4] = (1.0 - alpha) / a0;
+    for (uint32_t i = 0; i < FILTER_BANK_COEFFS_PER_BIQUAD; i++)
+    {
+        coeffs[i] = (int16_t) lround(ref[i] * (double)(1u << FILTER_BANK_COEFF_SHIFT));
+        ref[i] = (double) coeffs[i] / (double)(1u << FILTER_BANK_COEFF_SHIFT);
+    }
+
+    SIM_TEST_CHECK(FilterBank_Init(NULL, NUM_CHANNELS, DECIMATION) == FILTER_BANK_ERROR);
+    SIM_TEST_CHECK(FilterBank_Init(&bank, 0u, DECIMATION) == FILTER_BANK_ERROR);
+    SIM_TEST_CHECK(FilterBank_Init(&bank, FILTER_BANK_MAX_NUM_CHANNELS + 1u, DECIMATION) == FILTER_BANK_ERROR);
+
+    Test_Cadence();
+    Test_Accuracy();
+    Test_Saturation();
+
+    printf("test_filter_bank: checksum %08x\n", (unsigned) checksum);
+    SIM_TEST_EXPECT(checksum, OUTPUT_CHECKSUM);
+
+    return SimTest_Result(FILTER_BANK_USE_SIMD ? "test_filter_bank_simd" : "test_filter_bank");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,269 @@
+/*******************************************************************************
+* File Name: test_frame_queue.c
+*
+*  Description: This file contains the regression test of the frame queue: the order, the
+*   wrap around and the overflows of the queue, then the queue filled by the
+*   Sampler interrupt at 38 kfps and drained by a main loop that sleeps until
+*   the next frame, as in main.c.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+#include "frame_queue.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (24u)
+#define SAMPLE_RATE_SPS                (920000u)
+#define ACQUISITION_TIME_NS            (180u)
+
+/* Same size as main.c, about 0.8 ms of frames at 38 kfps */
+#define QUEUE_SIZE                     (32u)
+
+/* The main loop wakes up within 1 us of the interrupt */
+#define WAKE_UP_TICKS                  (SIM_TEST_CLK_PERI_HZ / 1000000u)
+/* 20 ms of frames, with a 2 ms stall of the main loop in the middle, like
+ * the print of main.c */
+#define RUN_FRAMES                     (766u)
+#define STALL_FRAME                    (300u)
+#define STALL_TICKS                    (SIM_TEST_CLK_PERI_HZ / 500u)
+
+/* First sample of each frame, as stored by the DMA */
+#define SEEN_SIZE                      (1024u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static amux_t amux;
+static cy_stc_dma_descriptor_t amux_desc[AMUX_MAX_NUM_DESCRIPTORS];
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static int16_t ping[NUM_CHANNELS];
+static int16_t pong[NUM_CHANNELS];
+
+static frame_queue_t queue;
+static frame_queue_entry_t entries[QUEUE_SIZE];
+
+static int16_t seen[SEEN_SIZE];
+static uint32_t ticks;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+static void Test_FrameCallback(const sampler_event_t *event, void *arg)
+{
+    frame_queue_entry_t entry;
+
+    (void)arg;
+    seen[event->sequence % SEEN_SIZE] = event->frame[0];
+    entry.frame = event->frame;
+    entry.sequence = event->sequence;
+    entry.timestamp = event->timestamp;
+    FrameQueue_Push(&queue, &entry);
+}
+
+/* Run the simulator, the first pin reads the time in microseconds, so the
+ * first sample tells which frame a buffer holds */
+static void Test_Run(uint32_t num_ticks)
+{
+    for (uint32_t i = 0; i < num_ticks; i += WAKE_UP_TICKS)
+    {
+        ticks += WAKE_UP_TICKS;
+        Sim_SetPinValue(9u, 0u, (int16_t)((ticks / WAKE_UP_TICKS) & 0x7FFFu));
+        Sim_Run(WAKE_UP_TICKS);
+    }
+}
+
+static void Test_Queue(void)
+{
+    frame_queue_t q;
+    frame_queue_entry_t e[4];
+    frame_queue_entry_t entry = { NULL, 0u, 0u };
+    uint32_t next = 0;
+
+    SIM_TEST_CHECK(FrameQueue_Init(NULL, e, 4u) == FRAME_QUEUE_ERROR);
+    SIM_TEST_CHECK(FrameQueue_Init(&q, NULL, 4u) == FRAME_QUEUE_ERROR);
+    SIM_TEST_CHECK(FrameQueue_Init(&q, e, 0u) == FRAME_QUEUE_ERROR);
+    SIM_TEST_CHECK(FrameQueue_Init(&q, e, 3u) == FRAME_QUEUE_ERROR);
+    SIM_TEST_CHECK(FrameQueue_Init(&q, e, 4u) == FRAME_QUEUE_SUCCESS);
+    SIM_TEST_CHECK(FrameQueue_Pop(&q, &entry) == FRAME_QUEUE_EMPTY);
+
+    /* Many times around the entries, one to four at a time */
+    for (uint32_t i = 0; i < 1000u; i++)
+    {
+        uint32_t num = (i % 4u) + 1u;
+
+        for (uint32_t k = 0; k < num; k++)
+        {
+            entry.sequence = next + k;
+            SIM_TEST_CHECK(FrameQueue_Push(&q, &entry) == FRAME_QUEUE_SUCCESS);
+        }
+        SIM_TEST_EXPECT(FrameQueue_GetCount(&q), num);
+        for (uint32_t k = 0; k < num; k++)
+        {
+            SIM_TEST_CHECK(FrameQueue_Pop(&q, &entry) == FRAME_QUEUE_SUCCESS);
+            SIM_TEST_EXPECT(entry.sequence, next + k);
+        }
+        next += num;
+        SIM_TEST_CHECK(FrameQueue_Pop(&q, &entry) == FRAME_QUEUE_EMPTY);
+    }
+
+    /* When full, the new entries are dropped and the oldest ones kept */
+    for (uint32_t k = 0; k < 6u; k++)
+    {
+        entry.sequence = k;
+        SIM_TEST_CHECK(FrameQueue_Push(&q, &entry) == ((k < 4u) ? FRAME_QUEUE_SUCCESS : FRAME_QUEUE_FULL));
+    }
+    SIM_TEST_EXPECT(FrameQueue_GetCount(&q), 4u);
+    SIM_TEST_EXPECT(FrameQueue_GetOverflows(&q), 2u);
+    for (uint32_t k = 0; k < 4u; k++)
+    {
+        SIM_TEST_CHECK(FrameQueue_Pop(&q, &entry) == FRAME_QUEUE_SUCCESS);
+        SIM_TEST_EXPECT(entry.sequence, k);
+    }
+    SIM_TEST_EXPECT(FrameQueue_GetCount(&q), 0u);
+}
+
+int main(void)
+{
+    frame_queue_entry_t entry;
+    int16_t frame[NUM_CHANNELS];
+    uint32_t copied = 0;
+    uint32_t skipped = 0;
+    uint32_t stale = 0;
+    uint32_t bad_samples = 0;
+    uint32_t gaps = 0;
+    uint32_t last_sequence = 0;
+    uint32_t overflows = 0;
+    bool stalled = false;
+
+    Test_Queue();
+
+    SimTest_Init(Test_SamplerIsr);
+
+    SIM_TEST_CHECK(AMux_Init(&amux, AMUX_B) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT9, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT10, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT12, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_ConfigureDescriptors(&amux, amux_desc, AMUX_MAX_NUM_DESCRIPTORS) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetupDMA(&amux, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+
+    SIM_TEST_CHECK(Sampler_Init(&sampler, SAR0, TCPWM0, 0u) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetScanRate(&sampler, SAMPLE_RATE_SPS, ACQUISITION_TIME_NS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_ConfigurePingPong(&sampler, NUM_CHANNELS, ping, pong) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(FrameQueue_Init(&queue, entries, QUEUE_SIZE) == FRAME_QUEUE_SUCCESS);
+    Sampler_RegisterCallback(&sampler, Test_FrameCallback, NULL);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+
+    AMux_StartDMA(&amux);
+    Sampler_Start(&sampler);
+
+    /* Main loop of main.c */
+    while (copied + skipped < RUN_FRAMES)
+    {
+        while (FrameQueue_Pop(&queue, &entry) != FRAME_QUEUE_SUCCESS)
+        {
+            Test_Run(WAKE_UP_TICKS);
+        }
+
+        if (FrameQueue_GetCount(&queue) != 0u)
+        {
+            skipped++;
+            continue;
+        }
+        memcpy(frame, entry.frame, sizeof(frame));
+        if (FrameQueue_GetCount(&queue) != 0u || FrameQueue_GetOverflows(&queue) != overflows)
+        {
+            overflows = FrameQueue_GetOverflows(&queue);
+            skipped++;
+            continue;
+        }
+
+        if (frame[0] != seen[entry.sequence % SEEN_SIZE])
+        {
+            stale++;
+        }
+        for (uint32_t ch = 1; ch < NUM_CHANNELS; ch++)
+        {
+            if (frame[ch] != SimTest_PinValue((ch < 8u) ? 9u : ((ch < 16u) ? 10u : 12u), ch % 8u))
+            {
+                bad_samples++;
+            }
+        }
+        if (copied != 0u && entry.sequence != last_sequence + 1u)
+        {
+            gaps++;
+        }
+        last_sequence = entry.sequence;
+        copied++;
+
+        if (!stalled && copied == STALL_FRAME)
+        {
+            Test_Run(STALL_TICKS);
+            stalled = true;
+        }
+    }
+
+    Sampler_Stop(&sampler);
+    AMux_StopDMA(&amux);
+
+    printf("copied %u, skipped %u, overflows %u, gaps %u\n", (unsigned)copied, (unsigned)skipped,
+           (unsigned)FrameQueue_GetOverflows(&queue), (unsigned)gaps);
+
+    /* Only the stall loses frames: those dropped by the full queue, and all 
+     * the queued ones, whose buffers were rewritten. The last queued one is 
+     * only found stale by the overflows */
+    SIM_TEST_EXPECT(gaps, 1u);
+    SIM_TEST_EXPECT(skipped, QUEUE_SIZE);
+    SIM_TEST_CHECK(FrameQueue_GetOverflows(&queue) > 0u);
+    SIM_TEST_EXPECT(stale, 0u);
+    SIM_TEST_EXPECT(bad_samples, 0u);
+
+    return SimTest_Result("test_frame_queue");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,155 @@
+/*******************************************************************************
+* File Name: test_isr_latency.c
+*
+*  Description: This file contains the regression test of the ping-pong buffer reported
+*   by the Sampler interrupt when the handler is late: 8 channels at
+*   920 ksps with timestamps, frame tags and discarded conversions, and a
+*   handler delayed by 150 peripheral clocks. The DMA is then already past
+*   the first descriptor of the next buffer when the handler runs.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (8u)
+#define SAMPLE_RATE_SPS                (920000u)
+#define ACQUISITION_TIME_NS            (180u)
+#define ISR_LATENCY_TICKS              (150u)
+#define PORT                           (9u)
+
+/* 10 ms of scanning at the peripheral clock */
+#define RUN_TICKS                      (SIM_TEST_CLK_PERI_HZ / 100u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static amux_t amux;
+static cy_stc_dma_descriptor_t amux_desc[AMUX_MAX_NUM_DESCRIPTORS];
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static int16_t ping[NUM_CHANNELS];
+static int16_t pong[NUM_CHANNELS];
+
+static uint32_t frames;
+static uint32_t bad_samples;
+static uint32_t buffer_errors;
+static uint32_t read_errors;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+static void Test_FrameCallback(const sampler_event_t *event, void *arg)
+{
+    int16_t frame[NUM_CHANNELS];
+
+    (void)arg;
+    if ((event->buffer != (frames % 2u)) || (event->frame != ((event->buffer == 0u) ? ping : pong)))
+    {
+        buffer_errors++;
+    }
+    /* The reported buffer is not written before the next frame completes */
+    if (Sampler_ReadFrame(&sampler, event->buffer, frame, NULL) != SAMPLER_SUCCESS)
+    {
+        read_errors++;
+    }
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        if (event->frame[ch] != SimTest_PinValue(PORT, ch))
+        {
+            bad_samples++;
+        }
+        event->frame[ch] = -1;
+    }
+    frames++;
+}
+
+int main(void)
+{
+    sim_counters_t counters;
+
+    SimTest_Init(Test_SamplerIsr);
+    Sim_SetDmaIsrLatency(DW0, SIM_TEST_SAMPLER_DMA_CHAN, ISR_LATENCY_TICKS);
+
+    SIM_TEST_CHECK(AMux_Init(&amux, AMUX_B) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT9, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetSettleCount(&amux, 0u, 2u) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetSettleCount(&amux, 5u, 1u) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_ConfigureDescriptors(&amux, amux_desc, AMUX_MAX_NUM_DESCRIPTORS) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetupDMA(&amux, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+
+    SIM_TEST_CHECK(Sampler_Init(&sampler, SAR0, TCPWM0, 0u) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetScanRate(&sampler, SAMPLE_RATE_SPS, ACQUISITION_TIME_NS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_ConfigurePingPong(&sampler, NUM_CHANNELS, ping, pong) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetTimestampTimer(&sampler, TCPWM0, 1u) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetFrameTags(&sampler, true) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetDiscardCount(&sampler, 0u, 2u) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetDiscardCount(&sampler, 5u, 1u) == SAMPLER_SUCCESS);
+    Sampler_RegisterCallback(&sampler, Test_FrameCallback, NULL);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+
+    AMux_StartDMA(&amux);
+    Sampler_Start(&sampler);
+    Sim_ResetCounters();
+    Sim_Run(RUN_TICKS);
+    Sampler_Stop(&sampler);
+    AMux_StopDMA(&amux);
+    Sim_GetCounters(&counters);
+
+    printf("frames %u, buffer errors %u, read errors %u, bad samples %u\n",
+           (unsigned)frames, (unsigned)buffer_errors, (unsigned)read_errors, (unsigned)bad_samples);
+
+    SIM_TEST_CHECK(frames > 0u);
+    SIM_TEST_EXPECT(counters.dma_missed_triggers, 0u);
+    SIM_TEST_EXPECT(buffer_errors, 0u);
+    SIM_TEST_EXPECT(read_errors, 0u);
+    SIM_TEST_EXPECT(bad_samples, 0u);
+
+    return SimTest_Result("test_isr_latency");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,174 @@
+/*******************************************************************************
+* File Name: test_oversampling.c
+*
+*  Description: This file contains the test of the hardware oversampling: 24 channels
+*   scanned with the SAR ADC averaging 1 to 16 conversions per sample and
+*   the AMux holding each pin for as many triggers. Every sample shall be
+*   the average of its own pin only, taken after a whole acquisition, and
+*   each frame shall take the number of channels times the ratio conversions.
+*   A hold count shorter than the ratio mixes the pins and shall be seen.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (24u)
+#define SAMPLE_RATE_SPS                (920000u)
+#define ACQUISITION_TIME_NS            (180u)
+
+/* 5 ms of scanning at the peripheral clock */
+#define RUN_TICKS                      (SIM_TEST_CLK_PERI_HZ / 200u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static amux_t amux;
+static cy_stc_dma_descriptor_t amux_desc[AMUX_MAX_NUM_DESCRIPTORS];
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static int16_t ping[NUM_CHANNELS];
+static int16_t pong[NUM_CHANNELS];
+
+static uint32_t frames;
+static uint32_t bad_samples;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+static void Test_FrameCallback(const sampler_event_t *event, void *arg)
+{
+    static const uint32_t ports[] = { 9u, 10u, 12u };
+
+    (void)arg;
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        if (event->frame[ch] != SimTest_PinValue(ports[ch / 8u], ch % 8u))
+        {
+            bad_samples++;
+        }
+    }
+    frames++;
+}
+
+/* Scan with the given ratio and hold count, return the SAR conversions */
+static uint32_t Test_Run(uint16_t ratio, uint16_t hold_count)
+{
+    sim_counters_t counters;
+
+    SimTest_Init(Test_SamplerIsr);
+    frames = 0;
+    bad_samples = 0;
+
+    AMux_Init(&amux, AMUX_B);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT9, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT10, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT12, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetHoldCount(&amux, hold_count) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_ConfigureDescriptors(&amux, amux_desc, AMUX_MAX_NUM_DESCRIPTORS) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetupDMA(&amux, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_StartDMA(&amux) == AMUX_SUCCESS);
+
+    Sampler_Init(&sampler, SAR0, TCPWM0, 0);
+    SIM_TEST_CHECK(Sampler_SetScanRate(&sampler, SAMPLE_RATE_SPS, ACQUISITION_TIME_NS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetOversampling(&sampler, ratio) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_ConfigurePingPong(&sampler, NUM_CHANNELS, ping, pong) == SAMPLER_SUCCESS);
+    Sampler_RegisterCallback(&sampler, Test_FrameCallback, NULL);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_Start(&sampler) == SAMPLER_SUCCESS);
+
+    Sim_Run(RUN_TICKS);
+    Sampler_Stop(&sampler);
+    AMux_StopDMA(&amux);
+
+    /* The pin is never switched during an acquisition */
+    Sim_GetCounters(&counters);
+    SIM_TEST_EXPECT(counters.sar_short_samples, 0u);
+    SIM_TEST_EXPECT(counters.sar_open_samples, 0u);
+    SIM_TEST_EXPECT(counters.sar_collisions, 0u);
+
+    AMux_Deinit(&amux);
+    Sampler_Deinit(&sampler);
+
+    return counters.sar_conversions;
+}
+
+int main(void)
+{
+    static const uint16_t ratios[] = { 1u, 2u, 4u, 16u };
+    uint32_t conversions;
+    uint32_t expected_frames;
+
+    /* The SAR ADC only averages powers of two */
+    SimTest_Init(NULL);
+    Sampler_Init(&sampler, SAR0, TCPWM0, 0);
+    SIM_TEST_CHECK(Sampler_SetOversampling(&sampler, 0u) == SAMPLER_ERROR);
+    SIM_TEST_CHECK(Sampler_SetOversampling(&sampler, 3u) == SAMPLER_ERROR);
+    SIM_TEST_CHECK(Sampler_SetOversampling(&sampler, 2u * SAMPLER_MAX_OVERSAMPLING) == SAMPLER_ERROR);
+    SIM_TEST_CHECK(Sampler_SetOversampling(&sampler, SAMPLER_MAX_OVERSAMPLING) == SAMPLER_SUCCESS);
+    Sampler_Deinit(&sampler);
+
+    for (uint32_t i = 0; i < (sizeof(ratios) / sizeof(ratios[0])); i++)
+    {
+        conversions = Test_Run(ratios[i], ratios[i]);
+
+        /* Each frame takes ratio conversions per channel, the frame being
+         * converted when stopped is not reported */
+        expected_frames = conversions / (NUM_CHANNELS * ratios[i]);
+        SIM_TEST_CHECK(frames > 0u);
+        SIM_TEST_CHECK(frames == expected_frames || (frames + 1u) == expected_frames);
+        SIM_TEST_EXPECT(bad_samples, 0u);
+    }
+
+    /* Pins switched within an average give wrong samples */
+    (void)Test_Run(4u, 2u);
+    SIM_TEST_CHECK(bad_samples > 0u);
+
+    return SimTest_Result("test_oversampling");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,200 @@
+/*******************************************************************************
+* File Name: test_planner.c
+*
+*  Description: This file contains the test of Planner_Check(): the scan rate, frame
+*   rate and limiting stage it returns are compared with 24 channels scanned
+*   in the simulator. A scan rate above the returned maximum shall be
+*   refused and make the SAR ADC miss triggers, a channel mask shall raise
+*   the frame rate, and AMux and Sampler settings that do not match shall
+*   be refused as a configuration error.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+#include "planner.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (24u)
+#define ACQUISITION_TIME_NS            (180u)
+
+/* 10 ms of scanning at the peripheral clock */
+#define RUN_TICKS                      (SIM_TEST_CLK_PERI_HZ / 100u)
+#define RUN_PER_SECOND                 (100u)
+
+/* 6 of the 24 channels */
+#define MASK_6_CHANNELS                (0x00810243u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static amux_t amux;
+static cy_stc_dma_descriptor_t amux_desc[AMUX_MAX_NUM_DESCRIPTORS];
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static int16_t ping[NUM_CHANNELS];
+static int16_t pong[NUM_CHANNELS];
+
+static uint32_t frames;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+static void Test_FrameCallback(const sampler_event_t *event, void *arg)
+{
+    (void)event;
+    (void)arg;
+    frames++;
+}
+
+/* Configure the AMux and the Sampler, and check them with the planner */
+static en_planner_status_t Test_Check(uint32_t rate, uint16_t hold_count, uint16_t ratio, 
+                                      uint8_t settle_count, uint32_t mask, planner_result_t *result)
+{
+    SimTest_Init(Test_SamplerIsr);
+    frames = 0;
+
+    AMux_Init(&amux, AMUX_B);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT9, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT10, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT12, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetHoldCount(&amux, hold_count) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetSettleCount(&amux, 5u, settle_count) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_ConfigureDescriptors(&amux, amux_desc, AMUX_MAX_NUM_DESCRIPTORS) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetupDMA(&amux, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+
+    Sampler_Init(&sampler, SAR0, TCPWM0, 0);
+    SIM_TEST_CHECK(Sampler_SetScanRate(&sampler, rate, ACQUISITION_TIME_NS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetOversampling(&sampler, ratio) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_ConfigurePingPong(&sampler, NUM_CHANNELS, ping, pong) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetDiscardCount(&sampler, 5u, 1u) == SAMPLER_SUCCESS);
+    Sampler_RegisterCallback(&sampler, Test_FrameCallback, NULL);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+
+    /* Not sampling yet, so both masks apply at once */
+    SIM_TEST_CHECK(AMux_SetChannelMask(&amux, mask, NULL, NULL) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetChannelMask(&sampler, mask, NULL, NULL) == SAMPLER_SUCCESS);
+
+    return Planner_Check(&amux, &sampler, result);
+}
+
+/* Scan for RUN_TICKS and return the conversions the SAR ADC missed */
+static uint32_t Test_Run(void)
+{
+    sim_counters_t counters;
+
+    SIM_TEST_CHECK(AMux_StartDMA(&amux) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(Sampler_Start(&sampler) == SAMPLER_SUCCESS);
+    Sim_Run(RUN_TICKS);
+    Sampler_Stop(&sampler);
+    AMux_StopDMA(&amux);
+
+    Sim_GetCounters(&counters);
+    AMux_Deinit(&amux);
+    Sampler_Deinit(&sampler);
+
+    return counters.sar_collisions;
+}
+
+/* The frames of the run match the frame rate of the planner */
+static void Test_CheckFrames(const planner_result_t *result)
+{
+    uint32_t expected = result->frame_rate_hz / RUN_PER_SECOND;
+
+    SIM_TEST_CHECK(frames + 1u >= expected && frames <= expected + 1u);
+}
+
+int main(void)
+{
+    planner_result_t result;
+    planner_result_t masked;
+    uint32_t max_rate;
+
+    /* Within the limit, the SAR ADC converts every trigger */
+    SIM_TEST_CHECK(Test_Check(920000u, 1u, 1u, 1u, AMUX_ALL_CHANNELS, &result) == PLANNER_SUCCESS);
+    SIM_TEST_EXPECT(result.limiting_stage, PLANNER_STAGE_SAR);
+    SIM_TEST_CHECK(result.max_scan_rate_hz >= 920000u);
+    SIM_TEST_CHECK(result.frame_rate_hz <= result.max_frame_rate_hz);
+    SIM_TEST_CHECK(result.frame_latency_ns > 0u);
+    max_rate = result.max_scan_rate_hz;
+    SIM_TEST_EXPECT(Test_Run(), 0u);
+    Test_CheckFrames(&result);
+
+    /* At the highest scan rate returned, still no trigger is missed */
+    SIM_TEST_CHECK(Test_Check(max_rate, 1u, 1u, 1u, AMUX_ALL_CHANNELS, &result) == PLANNER_SUCCESS);
+    SIM_TEST_EXPECT(Test_Run(), 0u);
+
+    /* Above it, the planner refuses and the SAR ADC misses triggers */
+    SIM_TEST_CHECK(Test_Check(max_rate + (max_rate / 5u), 1u, 1u, 1u, AMUX_ALL_CHANNELS, &result) == PLANNER_ERROR);
+    SIM_TEST_EXPECT(result.limiting_stage, PLANNER_STAGE_SAR);
+    SIM_TEST_CHECK(Test_Run() > 0u);
+
+    /* Oversampling divides the frame rate */
+    SIM_TEST_CHECK(Test_Check(920000u, 4u, 4u, 1u, AMUX_ALL_CHANNELS, &result) == PLANNER_SUCCESS);
+    SIM_TEST_EXPECT(Test_Run(), 0u);
+    Test_CheckFrames(&result);
+
+    /* Only the enabled slots take triggers */
+    SIM_TEST_CHECK(Test_Check(920000u, 1u, 1u, 1u, AMUX_ALL_CHANNELS, &result) == PLANNER_SUCCESS);
+    (void)Test_Run();
+    SIM_TEST_CHECK(Test_Check(920000u, 1u, 1u, 1u, MASK_6_CHANNELS, &masked) == PLANNER_SUCCESS);
+    SIM_TEST_CHECK(masked.frame_rate_hz > (3u * result.frame_rate_hz));
+    SIM_TEST_CHECK(masked.frame_latency_ns < result.frame_latency_ns);
+    SIM_TEST_EXPECT(Test_Run(), 0u);
+    Test_CheckFrames(&masked);
+
+    /* The AMux and Sampler settings shall match */
+    SIM_TEST_CHECK(Test_Check(920000u, 2u, 4u, 1u, AMUX_ALL_CHANNELS, &result) == PLANNER_ERROR);
+    SIM_TEST_EXPECT(result.limiting_stage, PLANNER_STAGE_CONFIG);
+    (void)Test_Run();
+    SIM_TEST_CHECK(Test_Check(920000u, 1u, 1u, 2u, AMUX_ALL_CHANNELS, &result) == PLANNER_ERROR);
+    SIM_TEST_EXPECT(result.limiting_stage, PLANNER_STAGE_CONFIG);
+    (void)Test_Run();
+
+    return SimTest_Result("test_planner");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,199 @@
+/*******************************************************************************
+* File Name: test_ring_capture.c
+*
+*  Description: This file contains the regression test of the triggered captures of the
+*   Sampler ring: 24 channels at 920 ksps into a ring of 64 frames, with the
+*   trigger at many positions of the pass, including just after a wrap
+*   whose interrupt is still pending (the handler is delayed by 150
+*   peripheral clocks). Each capture shall hold exactly the frames around
+*   the trigger, and the ring shall not be written after the capture.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (24u)
+#define SAMPLE_RATE_SPS                (920000u)
+#define ACQUISITION_TIME_NS            (180u)
+#define ISR_LATENCY_TICKS              (150u)
+#define RING_FRAMES                    (64u)
+#define PRE_FRAMES                     (20u)
+#define POST_FRAMES                    (20u)
+#define NUM_CAPTURES                   (200u)
+
+/* Ticks between two updates of the first pin, so the frames are ordered */
+#define RUN_STEP_TICKS                 (100u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static amux_t amux;
+static cy_stc_dma_descriptor_t amux_desc[AMUX_MAX_NUM_DESCRIPTORS];
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static int16_t ring[RING_FRAMES * NUM_CHANNELS];
+static int16_t ring_copy[RING_FRAMES * NUM_CHANNELS];
+static uint32_t run_steps;
+static uint32_t capture_events;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+static void Test_FrameCallback(const sampler_event_t *event, void *arg)
+{
+    (void)arg;
+    if (event->event == SAMPLER_EVENT_CAPTURE_COMPLETE)
+    {
+        capture_events++;
+    }
+}
+
+/* The first pin reads the time, in steps, and the others their address */
+static void Test_Run(uint32_t ticks)
+{
+    for (uint32_t i = 0; i < ticks; i += RUN_STEP_TICKS)
+    {
+        run_steps++;
+        Sim_SetPinValue(9u, 0u, (int16_t)(run_steps & 0x7FFFu));
+        Sim_Run(RUN_STEP_TICKS);
+    }
+}
+
+static void Test_CheckCapture(uint32_t trigger)
+{
+    static const uint32_t ports[] = { 9u, 10u, 12u };
+    uint32_t first;
+    uint32_t num_frames;
+    int32_t previous = -1;
+    uint32_t steps;
+
+    SIM_TEST_CHECK(Sampler_RingGetCapture(&sampler, &first, &num_frames) == SAMPLER_SUCCESS);
+    SIM_TEST_EXPECT(first, trigger - PRE_FRAMES);
+    SIM_TEST_EXPECT(num_frames, PRE_FRAMES + 1u + POST_FRAMES);
+
+    for (uint32_t frame = first; frame < (first + num_frames); frame++)
+    {
+        int16_t *samples = Sampler_RingGetFrame(&sampler, frame);
+
+        SIM_TEST_CHECK(samples != NULL);
+        if (samples == NULL)
+        {
+            return;
+        }
+        /* Consecutive frames, 26 steps apart at 38.3 kfps */
+        if (previous >= 0)
+        {
+            steps = ((uint32_t)samples[0] - (uint32_t)previous) & 0x7FFFu;
+            SIM_TEST_CHECK((steps >= 25u) && (steps <= 27u));
+        }
+        previous = samples[0];
+        for (uint32_t ch = 1; ch < NUM_CHANNELS; ch++)
+        {
+            SIM_TEST_CHECK(samples[ch] == SimTest_PinValue(ports[ch / 8u], ch % 8u));
+        }
+    }
+
+    /* The DMA is stopped */
+    memcpy(ring_copy, ring, sizeof(ring));
+    Test_Run(10000u);
+    SIM_TEST_CHECK(memcmp(ring_copy, ring, sizeof(ring)) == 0);
+}
+
+int main(void)
+{
+    uint32_t trigger;
+
+    SimTest_Init(Test_SamplerIsr);
+    Sim_SetDmaIsrLatency(DW0, SIM_TEST_SAMPLER_DMA_CHAN, ISR_LATENCY_TICKS);
+
+    SIM_TEST_CHECK(AMux_Init(&amux, AMUX_B) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT9, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT10, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT12, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_ConfigureDescriptors(&amux, amux_desc, AMUX_MAX_NUM_DESCRIPTORS) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetupDMA(&amux, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+
+    SIM_TEST_CHECK(Sampler_Init(&sampler, SAR0, TCPWM0, 0u) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetScanRate(&sampler, SAMPLE_RATE_SPS, ACQUISITION_TIME_NS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_ConfigureRing(&sampler, NUM_CHANNELS, ring, RING_FRAMES) == SAMPLER_SUCCESS);
+    Sampler_RegisterCallback(&sampler, Test_FrameCallback, NULL);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+
+    for (uint32_t i = 0; i < NUM_CAPTURES; i++)
+    {
+        AMux_StartDMA(&amux);
+        SIM_TEST_CHECK(Sampler_RingArm(&sampler, PRE_FRAMES, POST_FRAMES) == SAMPLER_SUCCESS);
+        SIM_TEST_CHECK(Sampler_Start(&sampler) == SAMPLER_SUCCESS);
+
+        /* Fill the ring, then move the trigger across a pass, one step at a
+         * time around the wraps */
+        Test_Run(RING_FRAMES * 3000u);
+        while (Cy_DMA_Channel_GetCurrentYloopIndex(DW0, SIM_TEST_SAMPLER_DMA_CHAN) != 
+               ((i * 7u) % RING_FRAMES))
+        {
+            Test_Run(RUN_STEP_TICKS);
+        }
+        Test_Run((i % 4u) * RUN_STEP_TICKS);
+
+        trigger = Sampler_RingGetHead(&sampler);
+        SIM_TEST_CHECK(Sampler_RingTrigger(&sampler, trigger) == SAMPLER_SUCCESS);
+        Test_Run((POST_FRAMES + 2u) * 3000u);
+        Test_CheckCapture(trigger);
+
+        SIM_TEST_CHECK(Sampler_Stop(&sampler) == SAMPLER_SUCCESS);
+        AMux_StopDMA(&amux);
+        AMux_DisconnectAll(&amux);
+    }
+
+    SIM_TEST_EXPECT(capture_events, NUM_CAPTURES);
+
+    return SimTest_Result("test_ring_capture");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,134 @@
+/*******************************************************************************
+* File Name: test_ring_release.c
+*
+*  Description: This file contains the regression test of the consumer side of the
+*   Sampler ring: the frames are read with Sampler_RingGetFrames() and given
+*   back with Sampler_RingRelease(), which shall refuse to release frames
+*   the DMA has not completed.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (8u)
+#define SAMPLE_RATE_SPS                (920000u)
+#define ACQUISITION_TIME_NS            (180u)
+#define RING_FRAMES                    (16u)
+#define PORT                           (9u)
+
+/* Ticks of one frame: 8 conversions at 920 ksps */
+#define FRAME_TICKS                    (870u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static amux_t amux;
+static cy_stc_dma_descriptor_t amux_desc[AMUX_MAX_NUM_DESCRIPTORS];
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static int16_t ring[RING_FRAMES * NUM_CHANNELS];
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+int main(void)
+{
+    int16_t *frames;
+    uint32_t available;
+    uint32_t released = 0;
+    sampler_stats_t stats;
+
+    SimTest_Init(Test_SamplerIsr);
+
+    SIM_TEST_CHECK(AMux_Init(&amux, AMUX_B) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT9, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_ConfigureDescriptors(&amux, amux_desc, AMUX_MAX_NUM_DESCRIPTORS) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetupDMA(&amux, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+
+    SIM_TEST_CHECK(Sampler_Init(&sampler, SAR0, TCPWM0, 0u) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetScanRate(&sampler, SAMPLE_RATE_SPS, ACQUISITION_TIME_NS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_ConfigureRing(&sampler, NUM_CHANNELS, ring, RING_FRAMES) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+
+    AMux_StartDMA(&amux);
+    Sampler_Start(&sampler);
+
+    /* Nothing completed yet */
+    SIM_TEST_EXPECT(Sampler_RingGetFrames(&sampler, &frames), 0u);
+    SIM_TEST_CHECK(Sampler_RingRelease(&sampler, 1u) == SAMPLER_ERROR);
+
+    /* Drain the ring for several passes, trying to release one frame more 
+     * than completed each time */
+    for (uint32_t i = 0; i < 100u; i++)
+    {
+        Sim_Run(FRAME_TICKS * (1u + (i % 5u)));
+        available = Sampler_RingGetFrames(&sampler, &frames);
+        SIM_TEST_CHECK(Sampler_RingRelease(&sampler, Sampler_RingGetHead(&sampler) - released + 1u) == 
+                       SAMPLER_ERROR);
+        for (uint32_t k = 0; k < (available * NUM_CHANNELS); k++)
+        {
+            SIM_TEST_CHECK(frames[k] == SimTest_PinValue(PORT, k % NUM_CHANNELS));
+        }
+        SIM_TEST_CHECK(Sampler_RingRelease(&sampler, available) == SAMPLER_SUCCESS);
+        released += available;
+    }
+
+    /* The refused releases moved nothing, so the tail stays behind the head */
+    SIM_TEST_CHECK(Sampler_RingGetFrames(&sampler, &frames) < RING_FRAMES);
+    SIM_TEST_CHECK(Sampler_GetStats(&sampler, &stats) == SAMPLER_SUCCESS);
+    SIM_TEST_EXPECT(stats.ring_overruns, 0u);
+    SIM_TEST_CHECK(released > (2u * RING_FRAMES));
+    SIM_TEST_CHECK(released <= Sampler_RingGetHead(&sampler));
+
+    Sampler_Stop(&sampler);
+    AMux_StopDMA(&amux);
+
+    return SimTest_Result("test_ring_release");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,195 @@
+/*******************************************************************************
+* File Name: test_scan_rate.c
+*
+*  Description: This file contains the regression test of the scan rate changes while 
+*   sampling: random rates and acquisition times are set at random times, 
+*   and every timer period shall still trigger the AMux DMA and the SAR ADC 
+*   once, so the frames keep their channels.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (24u)
+#define SAMPLING_RATE_SPS              (920000u)
+#define SAMPLING_TIME_NS               (180u)
+
+#define NUM_CHANGES                    (4000u)
+#define MAX_CHANGE_TICKS               (300u)
+#define NUM_RATES                      (6u)
+
+/* 10 ms of peripheral clocks */
+#define RATE_TICKS                     (SIM_TEST_CLK_PERI_HZ / 100u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static const uint32_t rates_sps[NUM_RATES] = { 920000u, 500000u, 250000u, 800000u, 100000u, 900000u };
+static const uint32_t times_ns[NUM_RATES] = { 180u, 180u, 400u, 180u, 1000u, 250u };
+
+static amux_t amux;
+static cy_stc_dma_descriptor_t amux_desc[AMUX_MAX_NUM_DESCRIPTORS];
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static int16_t ping[NUM_CHANNELS];
+static int16_t pong[NUM_CHANNELS];
+
+static uint32_t num_frames;
+static uint32_t random_state = 1u;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+/* Pins 0-7 of ports 9, 10 and 12 */
+static int16_t Test_ChannelValue(uint32_t ch)
+{
+    static const uint8_t ports[] = { 9u, 10u, 12u };
+
+    return SimTest_PinValue(ports[ch / 8u], ch % 8u);
+}
+
+/* A lost or doubled compare or overflow would shift the channels */
+static void Test_FrameCallback(const sampler_event_t *event, void *arg)
+{
+    (void) arg;
+    num_frames++;
+
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        SIM_TEST_EXPECT(event->frame[ch], Test_ChannelValue(ch));
+    }
+}
+
+static uint32_t Test_Random(void)
+{
+    random_state = (random_state * 1103515245u) + 12345u;
+    return random_state >> 8;
+}
+
+int main(void)
+{
+    uint32_t rate;
+    uint32_t first_frame;
+    uint32_t num_changes = 0;
+    uint32_t num_busy = 0;
+    en_sampler_status_t status;
+    sim_counters_t counters;
+
+    SimTest_Init(Test_SamplerIsr);
+
+    AMux_Init(&amux, AMUX_B);
+    AMux_AddPort(&amux, GPIO_PRT9, 0xFF);
+    AMux_AddPort(&amux, GPIO_PRT10, 0xFF);
+    AMux_AddPort(&amux, GPIO_PRT12, 0xFF);
+    SIM_TEST_CHECK(AMux_ConfigureDescriptors(&amux, amux_desc, AMUX_MAX_NUM_DESCRIPTORS) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetupDMA(&amux, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_StartDMA(&amux) == AMUX_SUCCESS);
+
+    Sampler_Init(&sampler, SAR0, TCPWM0, 0);
+    /* The pin shall be switched within the period */
+    SIM_TEST_CHECK(Sampler_SetScanRate(&sampler, 10000000u, 180u) == SAMPLER_ERROR);
+    SIM_TEST_CHECK(Sampler_SetScanRate(&sampler, SAMPLING_RATE_SPS, SAMPLING_TIME_NS) == SAMPLER_SUCCESS);
+    Sampler_ConfigurePingPong(&sampler, amux.num_conn, ping, pong);
+    Sampler_RegisterCallback(&sampler, Test_FrameCallback, NULL);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_Start(&sampler) == SAMPLER_SUCCESS);
+
+    /* Retune at random times of the timer period */
+    for (uint32_t i = 0; i < NUM_CHANGES; i++)
+    {
+        Sim_Run((Test_Random() % MAX_CHANGE_TICKS) + 1u);
+        rate = Test_Random() % NUM_RATES;
+        status = Sampler_SetScanRate(&sampler, rates_sps[rate], times_ns[rate]);
+        if (status == SAMPLER_SUCCESS)
+        {
+            num_changes++;
+        }
+        else
+        {
+            SIM_TEST_CHECK(status == SAMPLER_BUSY);
+            num_busy++;
+        }
+    }
+    SIM_TEST_CHECK(num_changes > (NUM_CHANGES / 4u));
+
+    /* The last change is applied at the next terminal count */
+    while (Sampler_SetScanRate(&sampler, 500000u, SAMPLING_TIME_NS) == SAMPLER_BUSY)
+    {
+        Sim_Run(10u);
+    }
+    Sim_Run(RATE_TICKS);
+    SIM_TEST_EXPECT(Cy_TCPWM_PWM_GetPeriod0(TCPWM0, 0), sampler.timer_period);
+    SIM_TEST_EXPECT(Cy_TCPWM_PWM_GetCompare0(TCPWM0, 0), sampler.timer_compare);
+
+    /* 500 ksps of 24 channels */
+    first_frame = num_frames;
+    Sim_Run(RATE_TICKS);
+    rate = (num_frames - first_frame) * 100u;
+    SIM_TEST_CHECK((rate >= 20700u) && (rate <= 20900u));
+
+    Sampler_Stop(&sampler);
+    AMux_StopDMA(&amux);
+
+    /* One AMux DMA trigger per compare, one SAR conversion per overflow, and
+     * one Sampler DMA trigger per conversion */
+    Sim_GetCounters(&counters);
+    printf("frames %u, changes %u, busy %u, conversions %u, dma triggers %u\n", (unsigned) num_frames, 
+           (unsigned) num_changes, (unsigned) num_busy, (unsigned) counters.sar_conversions, 
+           (unsigned) counters.dma_triggers);
+    SIM_TEST_CHECK((counters.sar_conversions - (num_frames * NUM_CHANNELS)) < NUM_CHANNELS);
+    SIM_TEST_CHECK((counters.dma_triggers - (2u * counters.sar_conversions)) <= 1u);
+    SIM_TEST_EXPECT(counters.dma_missed_triggers, 0u);
+    SIM_TEST_EXPECT(counters.sar_collisions, 0u);
+    SIM_TEST_EXPECT(counters.sar_short_samples, 0u);
+    SIM_TEST_EXPECT(counters.sar_open_samples, 0u);
+
+    return SimTest_Result("test_scan_rate");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,238 @@
+/*******************************************************************************
+* File Name: test_settle.c
+*
+*  Description: This file contains the test of the per-channel settling: 16 channels
+*   where three slow pins only reach their value after a number of
+*   conversions. The scan timer interrupt models the settling, so a sample
+*   taken too early reads a wrong value. With the AMux holding the slow pins
+*   for the extra conversions and the Sampler discarding them, every sample
+*   of every frame shall be right, and each frame shall take the extra
+*   conversions only for the slow pins.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (16u)
+#define SAMPLE_RATE_SPS                (920000u)
+#define ACQUISITION_TIME_NS            (180u)
+
+/* Value read from a pin still settling */
+#define UNSETTLED_VALUE                (-1000)
+
+/* 5 ms of scanning at the peripheral clock */
+#define RUN_TICKS                      (SIM_TEST_CLK_PERI_HZ / 200u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static amux_t amux;
+static cy_stc_dma_descriptor_t amux_desc[AMUX_MAX_NUM_DESCRIPTORS];
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static int16_t ping[NUM_CHANNELS];
+static int16_t pong[NUM_CHANNELS];
+static int16_t ring[NUM_CHANNELS * 4u];
+
+/* Extra samples needed by each connection, in units of the hold count */
+static const uint8_t settle_count[NUM_CHANNELS] = { 1u, 0u, 0u, 2u, 0u, 0u, 0u, 0u, 0u, 0u, 3u };
+static uint16_t hold_count;
+static uint32_t connected_conn;
+static uint32_t connected_conversions;
+
+static uint32_t frames;
+static uint32_t bad_samples;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static uint32_t Test_Port(uint32_t conn)
+{
+    return (conn < 8u) ? 9u : 10u;
+}
+
+static bool Test_IsConnected(uint32_t conn)
+{
+    uint32_t pin = conn % 8u;
+    HSIOM_PRT_Type *hsiom = (HSIOM_PRT_Type *)(HSIOM_BASE + (HSIOM_PRT_SECTION_SIZE * Test_Port(conn)));
+    uint32_t reg = (pin < CY_GPIO_PRT_HALF) ? hsiom->PORT_SEL0 : hsiom->PORT_SEL1;
+
+    return ((reg >> (8u * (pin % CY_GPIO_PRT_HALF))) & 0xFFu) == HSIOM_SEL_AMUXB;
+}
+
+/* Called at the end of each scan period, before the SAR ADC samples: the
+ * connected pin reads its value once connected for its settle conversions */
+static void Test_TimerIsr(void)
+{
+    Cy_TCPWM_ClearInterrupt(TCPWM0, 0u, CY_TCPWM_INT_ON_CC_OR_TC);
+
+    for (uint32_t conn = 0; conn < NUM_CHANNELS; conn++)
+    {
+        if (Test_IsConnected(conn))
+        {
+            if (conn != connected_conn)
+            {
+                connected_conn = conn;
+                connected_conversions = 0;
+            }
+            Sim_SetPinValue(Test_Port(conn), conn % 8u, 
+                            (connected_conversions < ((uint32_t) settle_count[conn] * hold_count)) ? 
+                            UNSETTLED_VALUE : SimTest_PinValue(Test_Port(conn), conn % 8u));
+            connected_conversions++;
+            break;
+        }
+    }
+}
+
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+static void Test_FrameCallback(const sampler_event_t *event, void *arg)
+{
+    (void)arg;
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        if (event->frame[ch] != SimTest_PinValue(Test_Port(ch), ch % 8u))
+        {
+            bad_samples++;
+        }
+    }
+    frames++;
+}
+
+/* Scan with the settle and discard counts set or not, return the SAR 
+ * conversions */
+static uint32_t Test_Run(uint16_t hold, bool settle)
+{
+    sim_counters_t counters;
+
+    SimTest_Init(Test_SamplerIsr);
+    Sim_SetTimerIsr(TCPWM0, 0u, Test_TimerIsr);
+    hold_count = hold;
+    connected_conn = NUM_CHANNELS;
+    frames = 0;
+    bad_samples = 0;
+
+    AMux_Init(&amux, AMUX_B);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT9, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT10, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetHoldCount(&amux, hold) == AMUX_SUCCESS);
+
+    Sampler_Init(&sampler, SAR0, TCPWM0, 0);
+    SIM_TEST_CHECK(Sampler_SetScanRate(&sampler, SAMPLE_RATE_SPS, ACQUISITION_TIME_NS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetOversampling(&sampler, hold) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_ConfigurePingPong(&sampler, NUM_CHANNELS, ping, pong) == SAMPLER_SUCCESS);
+
+    for (uint32_t conn = 0; settle && conn < NUM_CHANNELS; conn++)
+    {
+        SIM_TEST_CHECK(AMux_SetSettleCount(&amux, (uint8_t) conn, settle_count[conn]) == AMUX_SUCCESS);
+        SIM_TEST_CHECK(Sampler_SetDiscardCount(&sampler, (uint8_t) conn, settle_count[conn]) == SAMPLER_SUCCESS);
+    }
+
+    SIM_TEST_CHECK(AMux_ConfigureDescriptors(&amux, amux_desc, AMUX_MAX_NUM_DESCRIPTORS) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetupDMA(&amux, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_StartDMA(&amux) == AMUX_SUCCESS);
+    Sampler_RegisterCallback(&sampler, Test_FrameCallback, NULL);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+    Cy_TCPWM_SetInterruptMask(TCPWM0, 0u, CY_TCPWM_INT_ON_TC);
+    SIM_TEST_CHECK(Sampler_Start(&sampler) == SAMPLER_SUCCESS);
+
+    Sim_Run(RUN_TICKS);
+    Sampler_Stop(&sampler);
+    AMux_StopDMA(&amux);
+
+    Sim_GetCounters(&counters);
+    SIM_TEST_EXPECT(counters.sar_short_samples, 0u);
+    SIM_TEST_EXPECT(counters.sar_open_samples, 0u);
+
+    AMux_Deinit(&amux);
+    Sampler_Deinit(&sampler);
+
+    return counters.sar_conversions;
+}
+
+int main(void)
+{
+    static const uint16_t holds[] = { 1u, 2u, 4u };
+    uint32_t frame_conversions;
+    uint32_t conversions;
+    uint32_t expected_frames;
+
+    for (uint32_t i = 0; i < (sizeof(holds) / sizeof(holds[0])); i++)
+    {
+        conversions = Test_Run(holds[i], true);
+
+        /* Only the slow pins take extra conversions, the frame being 
+         * converted when stopped is not reported */
+        frame_conversions = NUM_CHANNELS;
+        for (uint32_t conn = 0; conn < NUM_CHANNELS; conn++)
+        {
+            frame_conversions += settle_count[conn];
+        }
+        expected_frames = conversions / (frame_conversions * holds[i]);
+        SIM_TEST_CHECK(frames > 0u);
+        SIM_TEST_CHECK(frames == expected_frames || (frames + 1u) == expected_frames);
+        SIM_TEST_EXPECT(bad_samples, 0u);
+    }
+
+    /* Without the extra conversions, the slow pins read wrong values */
+    (void)Test_Run(1u, false);
+    SIM_TEST_CHECK(frames > 0u);
+    SIM_TEST_EXPECT(bad_samples, 3u * frames);
+
+    /* The discards are not supported by the single descriptor of the ring */
+    SimTest_Init(NULL);
+    Sampler_Init(&sampler, SAR0, TCPWM0, 0);
+    SIM_TEST_CHECK(Sampler_SetScanRate(&sampler, SAMPLE_RATE_SPS, ACQUISITION_TIME_NS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_ConfigureRing(&sampler, NUM_CHANNELS, ring, 4u) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetDiscardCount(&sampler, 0u, 1u) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_ERROR);
+    SIM_TEST_CHECK(Sampler_SetDiscardCount(&sampler, NUM_CHANNELS, SAMPLER_MAX_DISCARD_COUNT + 1u) == SAMPLER_ERROR);
+
+    return SimTest_Result("test_settle");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,215 @@
+/*******************************************************************************
+* File Name: test_stats.c
+*
+*  Description: This file contains the test of Sampler_GetStats() and AMux_GetStats():
+*   16 channels scanned within and above the SAR ADC rate, then stopped.
+*   The frame counts, stall flag, measured scan rate, missed triggers, DMA
+*   errors and ring overruns are compared with the frames and counters of the
+*   simulator.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (16u)
+#define ACQUISITION_TIME_NS            (180u)
+#define RING_FRAMES                    (8u)
+
+/* The SAR ADC converts at most about 990 ksps */
+#define SLOW_RATE_SPS                  (500000u)
+#define FAST_RATE_SPS                  (1500000u)
+
+/* Timer counting the peripheral clock for the timestamps */
+#define TIMESTAMP_CHAN                 (1u)
+
+/* 2 ms of scanning between two calls */
+#define PERIOD_TICKS                   (SIM_TEST_CLK_PERI_HZ / 500u)
+#define NUM_PERIODS                    (3u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static amux_t amux;
+static cy_stc_dma_descriptor_t amux_desc[AMUX_MAX_NUM_DESCRIPTORS];
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static int16_t ping[NUM_CHANNELS];
+static int16_t pong[NUM_CHANNELS];
+static int16_t ring[NUM_CHANNELS * RING_FRAMES];
+
+static uint32_t frames;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+static void Test_FrameCallback(const sampler_event_t *event, void *arg)
+{
+    (void)event;
+    (void)arg;
+    frames++;
+}
+
+static void Test_Setup(uint32_t rate, bool ring_mode)
+{
+    SimTest_Init(Test_SamplerIsr);
+    frames = 0;
+
+    AMux_Init(&amux, AMUX_B);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT9, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_AddPort(&amux, GPIO_PRT10, 0xFFu) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_ConfigureDescriptors(&amux, amux_desc, AMUX_MAX_NUM_DESCRIPTORS) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetupDMA(&amux, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+
+    Sampler_Init(&sampler, SAR0, TCPWM0, 0);
+    SIM_TEST_CHECK(Sampler_SetScanRate(&sampler, rate, ACQUISITION_TIME_NS) == SAMPLER_SUCCESS);
+    if (ring_mode)
+    {
+        SIM_TEST_CHECK(Sampler_ConfigureRing(&sampler, NUM_CHANNELS, ring, RING_FRAMES) == SAMPLER_SUCCESS);
+    }
+    else
+    {
+        SIM_TEST_CHECK(Sampler_SetTimestampTimer(&sampler, TCPWM0, TIMESTAMP_CHAN) == SAMPLER_SUCCESS);
+        SIM_TEST_CHECK(Sampler_ConfigurePingPong(&sampler, NUM_CHANNELS, ping, pong) == SAMPLER_SUCCESS);
+        Sampler_RegisterCallback(&sampler, Test_FrameCallback, NULL);
+    }
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+
+    SIM_TEST_CHECK(AMux_StartDMA(&amux) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(Sampler_Start(&sampler) == SAMPLER_SUCCESS);
+}
+
+/* Scan in periods and check the Sampler statistics of each period */
+static void Test_Periods(uint32_t rate, bool missing)
+{
+    sampler_stats_t stats;
+    amux_stats_t amux_stats;
+    sim_counters_t counters;
+    uint32_t previous_frames = 0;
+
+    Test_Setup(rate, false);
+    SIM_TEST_CHECK(Sampler_GetStats(&sampler, &stats) == SAMPLER_SUCCESS);
+
+    for (uint32_t i = 0; i < NUM_PERIODS; i++)
+    {
+        Sim_Run(PERIOD_TICKS);
+        SIM_TEST_CHECK(Sampler_GetStats(&sampler, &stats) == SAMPLER_SUCCESS);
+        SIM_TEST_EXPECT(stats.frames, frames);
+        SIM_TEST_EXPECT(stats.new_frames, frames - previous_frames);
+        SIM_TEST_CHECK(!stats.stalled);
+        SIM_TEST_EXPECT(stats.dma_errors, 0u);
+        SIM_TEST_EXPECT(stats.ring_overruns, 0u);
+        previous_frames = frames;
+
+        /* The rate achieved is the configured one while the SAR ADC keeps 
+         * up, within 1 %, and lower once it misses triggers */
+        if (!missing)
+        {
+            SIM_TEST_CHECK(stats.scan_rate_hz > (rate - (rate / 100u)) && stats.scan_rate_hz <= rate);
+        }
+        else
+        {
+            SIM_TEST_CHECK(stats.scan_rate_hz < rate);
+        }
+    }
+
+    /* Missed triggers are seen once per frame, as the SAR ADC collisions */
+    Sim_GetCounters(&counters);
+    if (missing)
+    {
+        SIM_TEST_CHECK(stats.missed_triggers >= frames && stats.missed_triggers <= counters.sar_collisions);
+    }
+    else
+    {
+        SIM_TEST_EXPECT(stats.missed_triggers, 0u);
+        SIM_TEST_EXPECT(counters.sar_collisions, 0u);
+    }
+
+    SIM_TEST_CHECK(AMux_GetStats(&amux, &amux_stats) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(!amux_stats.dma_error);
+    SIM_TEST_CHECK(amux_stats.descriptor < amux.num_desc);
+
+    /* Once stopped, no new frame is reported */
+    Sampler_Stop(&sampler);
+    AMux_StopDMA(&amux);
+    SIM_TEST_CHECK(Sampler_GetStats(&sampler, &stats) == SAMPLER_SUCCESS);
+    Sim_Run(PERIOD_TICKS);
+    SIM_TEST_CHECK(Sampler_GetStats(&sampler, &stats) == SAMPLER_SUCCESS);
+    SIM_TEST_EXPECT(stats.new_frames, 0u);
+    SIM_TEST_CHECK(stats.stalled);
+
+    AMux_Deinit(&amux);
+    Sampler_Deinit(&sampler);
+}
+
+int main(void)
+{
+    sampler_stats_t stats;
+    int16_t *ring_frames;
+    uint32_t head;
+    uint32_t available;
+
+    Test_Periods(SLOW_RATE_SPS, false);
+    Test_Periods(FAST_RATE_SPS, true);
+
+    /* The frames overwritten before being read are counted as overruns */
+    Test_Setup(SLOW_RATE_SPS, true);
+    Sim_Run(PERIOD_TICKS);
+    head = Sampler_RingGetHead(&sampler);
+    SIM_TEST_CHECK(head > RING_FRAMES);
+    available = Sampler_RingGetFrames(&sampler, &ring_frames);
+    SIM_TEST_CHECK(available > 0u && available < RING_FRAMES);
+    SIM_TEST_CHECK(Sampler_GetStats(&sampler, &stats) == SAMPLER_SUCCESS);
+    SIM_TEST_EXPECT(stats.ring_overruns, head - (RING_FRAMES - 1u));
+    SIM_TEST_EXPECT(stats.scan_rate_hz, 0u);
+    Sampler_Stop(&sampler);
+    AMux_StopDMA(&amux);
+
+    return SimTest_Result("test_stats");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,250 @@
+/*******************************************************************************
+* File Name: test_telemetry.c
+*
+*  Description: This file contains the regression test of the telemetry: the packets of 
+*   the newest ring frames sent on a UART by the header, samples and CRC 
+*   descriptors, as stream_frames() of main.c does. Every byte received 
+*   shall belong to a packet with a valid header, samples and CRC.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (24u)
+#define SAMPLING_RATE_SPS              (920000u)
+#define SAMPLING_TIME_NS               (180u)
+#define OVERSAMPLING                   (2u)
+#define RING_FRAMES                    (64u)
+
+#define UART_BAUD_RATE                 (921600u)
+#define TELEMETRY_DMA_CHAN             (3u)
+
+#define PACKET_SIZE                    (TELEMETRY_HEADER_SIZE + (2u * NUM_CHANNELS) + TELEMETRY_CRC_SIZE)
+#define POLL_TICKS                     (100u)
+/* 50 ms of peripheral clocks */
+#define RUN_TICKS                      (SIM_TEST_CLK_PERI_HZ / 20u)
+/* 1 ms, more than the TX FIFO takes to be sent */
+#define FIFO_TICKS                     (SIM_TEST_CLK_PERI_HZ / 1000u)
+#define MAX_BYTES                      (8192u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static amux_t amux;
+static cy_stc_dma_descriptor_t amux_desc[AMUX_MAX_NUM_DESCRIPTORS];
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static telemetry_t telemetry;
+static int16_t ring[RING_FRAMES * NUM_CHANNELS];
+static uint8_t received[MAX_BYTES];
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+static void Test_TelemetryIsr(void)
+{
+    Telemetry_IRQHandler(&telemetry);
+}
+
+/* Pins 0-7 of ports 9, 10 and 12 */
+static int16_t Test_ChannelValue(uint32_t ch)
+{
+    static const uint8_t ports[] = { 9u, 10u, 12u };
+
+    return SimTest_PinValue(ports[ch / 8u], ch % 8u);
+}
+
+static uint32_t Test_Read32(const uint8_t *data)
+{
+    return (uint32_t) data[0] | ((uint32_t) data[1] << 8) | ((uint32_t) data[2] << 16) | 
+           ((uint32_t) data[3] << 24);
+}
+
+static uint32_t Test_Timestamp(uint32_t sequence)
+{
+    return (uint32_t)(((uint64_t) sequence * NUM_CHANNELS * OVERSAMPLING * 1000000u) / SAMPLING_RATE_SPS);
+}
+
+/* Send the newest frame every time the UART is free, returns the packets */
+static uint32_t Test_Stream(uint32_t ticks)
+{
+    bool sending = false;
+    int16_t *frames;
+    uint32_t num_frames;
+    uint32_t sequence;
+    uint32_t num_packets = 0;
+
+    for (uint32_t t = 0; t < ticks; t += POLL_TICKS)
+    {
+        Sim_Run(POLL_TICKS);
+        if (Telemetry_IsBusy(&telemetry))
+        {
+            continue;
+        }
+
+        if (sending)
+        {
+            SIM_TEST_CHECK(Sampler_RingRelease(&sampler, 1) == SAMPLER_SUCCESS);
+            sending = false;
+        }
+
+        num_frames = Sampler_RingGetFrames(&sampler, &frames);
+        while (num_frames > 1)
+        {
+            Sampler_RingRelease(&sampler, num_frames - 1);
+            num_frames = Sampler_RingGetFrames(&sampler, &frames);
+        }
+
+        if (num_frames == 1)
+        {
+            sequence = Sampler_RingGetTail(&sampler);
+            SIM_TEST_CHECK(Telemetry_SendFrame(&telemetry, frames, sequence, Test_Timestamp(sequence)) == 
+                           TELEMETRY_SUCCESS);
+            /* A second packet waits for the end of the first one */
+            SIM_TEST_CHECK(Telemetry_SendFrame(&telemetry, frames, sequence, 0) == TELEMETRY_BUSY);
+            sending = true;
+            num_packets++;
+        }
+    }
+
+    /* Let the last packet leave the TX FIFO */
+    while (Telemetry_IsBusy(&telemetry))
+    {
+        Sim_Run(POLL_TICKS);
+    }
+    Sim_Run(FIFO_TICKS);
+
+    return num_packets;
+}
+
+int main(void)
+{
+    static const uint8_t check[] = "123456789";
+    const uint8_t *packet;
+    uint32_t length;
+    uint32_t num_sent;
+    uint32_t num_received = 0;
+    uint32_t sequence;
+    uint32_t prev_sequence = 0;
+    uint16_t crc;
+
+    /* CRC-16/CCITT-FALSE check value */
+    SIM_TEST_EXPECT(Telemetry_Crc16(TELEMETRY_CRC_INIT, check, 9u), 0x29B1u);
+
+    SimTest_Init(Test_SamplerIsr);
+    Sim_RouteUartTxToDma(SCB5, DW1, TELEMETRY_DMA_CHAN);
+    Sim_SetDmaIsr(DW1, TELEMETRY_DMA_CHAN, Test_TelemetryIsr);
+    Sim_SetUartBaud(SCB5, UART_BAUD_RATE);
+
+    AMux_Init(&amux, AMUX_B);
+    AMux_AddPort(&amux, GPIO_PRT9, 0xFF);
+    AMux_AddPort(&amux, GPIO_PRT10, 0xFF);
+    AMux_AddPort(&amux, GPIO_PRT12, 0xFF);
+    AMux_SetHoldCount(&amux, OVERSAMPLING);
+    SIM_TEST_CHECK(AMux_ConfigureDescriptors(&amux, amux_desc, AMUX_MAX_NUM_DESCRIPTORS) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetupDMA(&amux, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_StartDMA(&amux) == AMUX_SUCCESS);
+
+    Sampler_Init(&sampler, SAR0, TCPWM0, 0);
+    Sampler_SetScanRate(&sampler, SAMPLING_RATE_SPS, SAMPLING_TIME_NS);
+    Sampler_SetOversampling(&sampler, OVERSAMPLING);
+    SIM_TEST_CHECK(Sampler_ConfigureRing(&sampler, amux.num_conn, ring, RING_FRAMES) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+
+    SIM_TEST_CHECK(Telemetry_Init(&telemetry, SCB5, amux.num_conn) == TELEMETRY_SUCCESS);
+    SIM_TEST_CHECK(Telemetry_SetupDMA(&telemetry, DW1, TELEMETRY_DMA_CHAN) == TELEMETRY_SUCCESS);
+
+    SIM_TEST_CHECK(Sampler_Start(&sampler) == SAMPLER_SUCCESS);
+    num_sent = Test_Stream(RUN_TICKS);
+    Sampler_Stop(&sampler);
+    AMux_StopDMA(&amux);
+
+    /* The packets follow each other, without a byte lost or added */
+    length = Sim_ReadUart(SCB5, received, sizeof(received));
+    SIM_TEST_EXPECT(length % PACKET_SIZE, 0u);
+    for (uint32_t offset = 0; (offset + PACKET_SIZE) <= length; offset += PACKET_SIZE)
+    {
+        packet = &received[offset];
+        SIM_TEST_EXPECT(packet[0], TELEMETRY_SYNC_0);
+        SIM_TEST_EXPECT(packet[1], TELEMETRY_SYNC_1);
+        SIM_TEST_EXPECT(packet[2], NUM_CHANNELS);
+        SIM_TEST_EXPECT(packet[3], TELEMETRY_VERSION);
+
+        /* The newest frame, so the sequence numbers increase with gaps */
+        sequence = Test_Read32(&packet[4]);
+        if (num_received > 0u)
+        {
+            SIM_TEST_CHECK(sequence > prev_sequence);
+        }
+        prev_sequence = sequence;
+        SIM_TEST_EXPECT(Test_Read32(&packet[8]), Test_Timestamp(sequence));
+
+        for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+        {
+            SIM_TEST_EXPECT((int16_t)(packet[TELEMETRY_HEADER_SIZE + (2u * ch)] | 
+                                      (packet[TELEMETRY_HEADER_SIZE + (2u * ch) + 1u] << 8)), 
+                            Test_ChannelValue(ch));
+        }
+
+        crc = Telemetry_Crc16(TELEMETRY_CRC_INIT, &packet[2], PACKET_SIZE - 2u - TELEMETRY_CRC_SIZE);
+        SIM_TEST_EXPECT(packet[PACKET_SIZE - 2u] | (packet[PACKET_SIZE - 1u] << 8), crc);
+        num_received++;
+    }
+
+    printf("packets sent %u, received %u, ring overruns %u\n", (unsigned) num_sent, 
+           (unsigned) num_received, (unsigned) sampler.ring_overruns);
+    SIM_TEST_CHECK(num_sent > 0u);
+    SIM_TEST_EXPECT(num_received, num_sent);
+    SIM_TEST_EXPECT(telemetry.packets, num_sent);
+
+    return SimTest_Result("test_telemetry");
+}
+
+/* [] END OF FILE */
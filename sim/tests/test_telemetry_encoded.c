@@ -0,0 +1,260 @@
+/*******************************************************************************
+* File Name: test_telemetry_encoded.c
+*
+*  Description: This file contains the test of the encoded telemetry packets: the ring
+*   of 24 channels is streamed as main.c does, with each frame encoded by
+*   frame_codec.c against the previous one, while four pins change value.
+*   Every packet received by the emulated UART shall have a valid header and
+*   CRC, and its frame shall decode to the frame that was sent. The smaller
+*   packets shall carry more than twice as many frames as the raw ones.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "sim_test.h"
+#include "amux.h"
+#include "sampler.h"
+#include "telemetry.h"
+#include "frame_codec.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (24u)
+#define SAMPLING_RATE_SPS              (920000u)
+#define SAMPLING_TIME_NS               (180u)
+#define OVERSAMPLING                   (2u)
+#define RING_FRAMES                    (64u)
+#define KEY_INTERVAL                   (100u)
+
+#define UART_BAUD_RATE                 (921600u)
+#define TELEMETRY_DMA_CHAN             (3u)
+
+/* Pins whose value changes between two packets, and by how much */
+#define NUM_CHANGING                   (4u)
+#define CHANGE_STEPS                   (7u)
+#define CHANGE_LSB                     (5)
+
+#define RAW_PACKET_SIZE                (TELEMETRY_HEADER_SIZE + (2u * NUM_CHANNELS) + TELEMETRY_CRC_SIZE)
+#define POLL_TICKS                     (100u)
+/* 50 ms of peripheral clocks */
+#define RUN_TICKS                      (SIM_TEST_CLK_PERI_HZ / 20u)
+#define RUN_PER_SECOND                 (20u)
+/* 1 ms, more than the TX FIFO takes to be sent */
+#define FIFO_TICKS                     (SIM_TEST_CLK_PERI_HZ / 1000u)
+#define MAX_BYTES                      (8192u)
+#define MAX_PACKETS                    (512u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static amux_t amux;
+static cy_stc_dma_descriptor_t amux_desc[AMUX_MAX_NUM_DESCRIPTORS];
+static sampler_t sampler;
+static cy_stc_dma_descriptor_t sampler_desc[SAMPLER_MAX_NUM_DESCRIPTORS];
+static telemetry_t telemetry;
+static frame_codec_t encoder;
+static frame_codec_t decoder;
+static int16_t ring[RING_FRAMES * NUM_CHANNELS];
+static uint8_t encoded[FRAME_CODEC_MAX_SIZE(NUM_CHANNELS)];
+static int16_t sent[MAX_PACKETS][NUM_CHANNELS];
+static uint8_t received[MAX_BYTES];
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static void Test_SamplerIsr(void)
+{
+    Sampler_IRQHandler(&sampler);
+}
+
+static void Test_TelemetryIsr(void)
+{
+    Telemetry_IRQHandler(&telemetry);
+}
+
+/* Pins 0-7 of ports 9, 10 and 12, the first pins of port 9 change */
+static void Test_ChangePins(uint32_t step)
+{
+    for (uint32_t pin = 0; pin < NUM_CHANGING; pin++)
+    {
+        Sim_SetPinValue(9u, pin, (int16_t)(SimTest_PinValue(9u, pin) + 
+                                           (int16_t)(((step + pin) % CHANGE_STEPS) * CHANGE_LSB)));
+    }
+}
+
+/* Send the newest frame encoded every time the UART is free, returns the 
+ * packets */
+static uint32_t Test_Stream(uint32_t ticks)
+{
+    bool sending = false;
+    int16_t *frames;
+    uint32_t num_frames;
+    uint32_t sequence;
+    uint32_t length;
+    uint32_t num_packets = 0;
+
+    for (uint32_t t = 0; t < ticks; t += POLL_TICKS)
+    {
+        Sim_Run(POLL_TICKS);
+        if (Telemetry_IsBusy(&telemetry))
+        {
+            continue;
+        }
+
+        if (sending)
+        {
+            SIM_TEST_CHECK(Sampler_RingRelease(&sampler, 1) == SAMPLER_SUCCESS);
+            sending = false;
+        }
+
+        num_frames = Sampler_RingGetFrames(&sampler, &frames);
+        while (num_frames > 1)
+        {
+            Sampler_RingRelease(&sampler, num_frames - 1);
+            num_frames = Sampler_RingGetFrames(&sampler, &frames);
+        }
+
+        if (num_frames == 1 && num_packets < MAX_PACKETS)
+        {
+            sequence = Sampler_RingGetTail(&sampler);
+            SIM_TEST_CHECK(FrameCodec_Encode(&encoder, frames, encoded, sizeof(encoded), &length) == 
+                           FRAME_CODEC_SUCCESS);
+            SIM_TEST_CHECK(Telemetry_SendEncoded(&telemetry, encoded, length, sequence, 0u) == 
+                           TELEMETRY_SUCCESS);
+            memcpy(sent[num_packets], frames, sizeof(sent[0]));
+            sending = true;
+            num_packets++;
+            Test_ChangePins(num_packets);
+        }
+    }
+
+    /* Let the last packet leave the TX FIFO */
+    while (Telemetry_IsBusy(&telemetry))
+    {
+        Sim_Run(POLL_TICKS);
+    }
+    Sim_Run(FIFO_TICKS);
+
+    return num_packets;
+}
+
+int main(void)
+{
+    int16_t frame[NUM_CHANNELS];
+    const uint8_t *packet;
+    uint32_t length;
+    uint32_t frame_length;
+    uint32_t packet_length;
+    uint32_t num_sent;
+    uint32_t num_received = 0;
+    uint32_t raw_packets;
+    uint32_t offset = 0;
+    uint16_t crc;
+
+    SimTest_Init(Test_SamplerIsr);
+    Sim_RouteUartTxToDma(SCB5, DW1, TELEMETRY_DMA_CHAN);
+    Sim_SetDmaIsr(DW1, TELEMETRY_DMA_CHAN, Test_TelemetryIsr);
+    Sim_SetUartBaud(SCB5, UART_BAUD_RATE);
+
+    AMux_Init(&amux, AMUX_B);
+    AMux_AddPort(&amux, GPIO_PRT9, 0xFF);
+    AMux_AddPort(&amux, GPIO_PRT10, 0xFF);
+    AMux_AddPort(&amux, GPIO_PRT12, 0xFF);
+    AMux_SetHoldCount(&amux, OVERSAMPLING);
+    SIM_TEST_CHECK(AMux_ConfigureDescriptors(&amux, amux_desc, AMUX_MAX_NUM_DESCRIPTORS) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_SetupDMA(&amux, DW0, SIM_TEST_AMUX_DMA_CHAN) == AMUX_SUCCESS);
+    SIM_TEST_CHECK(AMux_StartDMA(&amux) == AMUX_SUCCESS);
+
+    Sampler_Init(&sampler, SAR0, TCPWM0, 0);
+    Sampler_SetScanRate(&sampler, SAMPLING_RATE_SPS, SAMPLING_TIME_NS);
+    Sampler_SetOversampling(&sampler, OVERSAMPLING);
+    SIM_TEST_CHECK(Sampler_ConfigureRing(&sampler, amux.num_conn, ring, RING_FRAMES) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_ConfigureDescriptors(&sampler, sampler_desc, SAMPLER_MAX_NUM_DESCRIPTORS) == SAMPLER_SUCCESS);
+    SIM_TEST_CHECK(Sampler_SetupDMA(&sampler, DW0, SIM_TEST_SAMPLER_DMA_CHAN) == SAMPLER_SUCCESS);
+
+    SIM_TEST_CHECK(Telemetry_Init(&telemetry, SCB5, amux.num_conn) == TELEMETRY_SUCCESS);
+    SIM_TEST_CHECK(Telemetry_SetupDMA(&telemetry, DW1, TELEMETRY_DMA_CHAN) == TELEMETRY_SUCCESS);
+    SIM_TEST_CHECK(FrameCodec_Init(&encoder, NUM_CHANNELS, KEY_INTERVAL) == FRAME_CODEC_SUCCESS);
+    SIM_TEST_CHECK(FrameCodec_Init(&decoder, NUM_CHANNELS, KEY_INTERVAL) == FRAME_CODEC_SUCCESS);
+
+    SIM_TEST_CHECK(Sampler_Start(&sampler) == SAMPLER_SUCCESS);
+    num_sent = Test_Stream(RUN_TICKS);
+    Sampler_Stop(&sampler);
+    AMux_StopDMA(&amux);
+
+    /* The packets follow each other, each decodes to the frame sent */
+    length = Sim_ReadUart(SCB5, received, sizeof(received));
+    while ((offset + TELEMETRY_HEADER_SIZE) < length && num_received < num_sent)
+    {
+        packet = &received[offset];
+        SIM_TEST_EXPECT(packet[0], TELEMETRY_SYNC_0);
+        SIM_TEST_EXPECT(packet[1], TELEMETRY_SYNC_1);
+        SIM_TEST_EXPECT(packet[2], NUM_CHANNELS);
+        SIM_TEST_EXPECT(packet[3], TELEMETRY_VERSION_ENCODED);
+
+        if (FrameCodec_Decode(&decoder, &packet[TELEMETRY_HEADER_SIZE], 
+                              length - offset - TELEMETRY_HEADER_SIZE, frame, &frame_length) != 
+            FRAME_CODEC_SUCCESS)
+        {
+            SIM_TEST_CHECK(false);
+            break;
+        }
+        SIM_TEST_CHECK(memcmp(frame, sent[num_received], sizeof(frame)) == 0);
+
+        packet_length = TELEMETRY_HEADER_SIZE + frame_length + TELEMETRY_CRC_SIZE;
+        crc = Telemetry_Crc16(TELEMETRY_CRC_INIT, &packet[2], packet_length - 2u - TELEMETRY_CRC_SIZE);
+        SIM_TEST_EXPECT(packet[packet_length - 2u] | (packet[packet_length - 1u] << 8), crc);
+
+        offset += packet_length;
+        num_received++;
+    }
+
+    /* The raw packets of test_telemetry.c fill the UART, 10 bits per byte */
+    raw_packets = (UART_BAUD_RATE / 10u) / (RAW_PACKET_SIZE * RUN_PER_SECOND);
+    printf("encoded packets sent %u, received %u, %u bytes, raw packets %u\n", (unsigned) num_sent, 
+           (unsigned) num_received, (unsigned) length, (unsigned) raw_packets);
+    SIM_TEST_EXPECT(offset, length);
+    SIM_TEST_EXPECT(num_received, num_sent);
+    SIM_TEST_EXPECT(telemetry.packets, num_sent);
+    SIM_TEST_CHECK(decoder.key_frames > 1u);
+    SIM_TEST_CHECK(num_sent > (2u * raw_packets));
+
+    return SimTest_Result("test_telemetry_encoded");
+}
+
+/* [] END OF FILE */
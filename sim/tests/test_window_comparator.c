@@ -0,0 +1,154 @@
+/*******************************************************************************
+* File Name: test_window_comparator.c
+*
+*  Description: This file contains the regression test of the window comparator: the
+*   limits and the hysteresis of the windows, the exit and enter events of
+*   frames of 24 channels, and the channels without a window.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_test.h"
+#include "window_comparator.h"
+
+/*******************************************************************************
+*                                 Constants
+*******************************************************************************/
+#define NUM_CHANNELS                   (24u)
+#define MAX_EVENTS                     (8u)
+
+/*******************************************************************************
+*                              Global Variables
+*******************************************************************************/
+static window_comparator_t comparator;
+static int16_t frame[NUM_CHANNELS];
+static uint32_t sequence;
+
+static window_comparator_event_t events[MAX_EVENTS];
+static uint32_t num_events;
+
+/*******************************************************************************
+*                              Local Functions
+*******************************************************************************/
+static void Test_EventCallback(const window_comparator_event_t *event, void *arg)
+{
+    SIM_TEST_CHECK(arg == &comparator);
+    if (num_events < MAX_EVENTS)
+    {
+        events[num_events] = *event;
+    }
+    num_events++;
+}
+
+/* Set a channel and check the next frame, returns the number of events */
+static uint32_t Test_Check(uint32_t channel, int16_t value)
+{
+    frame[channel] = value;
+    num_events = 0;
+    SIM_TEST_CHECK(WindowComparator_Check(&comparator, frame, sequence++) == WINDOW_COMPARATOR_SUCCESS);
+    return num_events;
+}
+
+static void Test_ExpectEvent(en_window_comparator_event_t type, uint32_t channel, int16_t value)
+{
+    SIM_TEST_EXPECT(events[0].event, type);
+    SIM_TEST_EXPECT(events[0].channel, channel);
+    SIM_TEST_EXPECT(events[0].value, value);
+    SIM_TEST_EXPECT(events[0].sequence, sequence - 1u);
+}
+
+int main(void)
+{
+    /* Configuration */
+    SIM_TEST_CHECK(WindowComparator_Init(&comparator, 0u) == WINDOW_COMPARATOR_ERROR);
+    SIM_TEST_CHECK(WindowComparator_Init(&comparator, WINDOW_COMPARATOR_MAX_NUM_CHANNELS + 1u) == 
+                   WINDOW_COMPARATOR_ERROR);
+    SIM_TEST_CHECK(WindowComparator_Init(&comparator, NUM_CHANNELS) == WINDOW_COMPARATOR_SUCCESS);
+    /* The window narrowed by the hysteresis would be empty */
+    SIM_TEST_CHECK(WindowComparator_SetLimits(&comparator, 5u, 900, 1100, 150u) == WINDOW_COMPARATOR_ERROR);
+    SIM_TEST_CHECK(WindowComparator_SetLimits(&comparator, 5u, 900, 1100, 50u) == WINDOW_COMPARATOR_SUCCESS);
+    SIM_TEST_CHECK(WindowComparator_SetLimits(&comparator, 20u, 500, 2000, 0u) == WINDOW_COMPARATOR_SUCCESS);
+    SIM_TEST_CHECK(WindowComparator_SetLimits(&comparator, NUM_CHANNELS, 0, 1, 0u) == WINDOW_COMPARATOR_ERROR);
+    SIM_TEST_CHECK(WindowComparator_RegisterCallback(&comparator, Test_EventCallback, &comparator) == 
+                   WINDOW_COMPARATOR_SUCCESS);
+
+    for (uint32_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        frame[ch] = 1000;
+    }
+    SIM_TEST_EXPECT(Test_Check(0u, 1000), 0u);
+
+    /* Exit above the high limit, the limit itself is within */
+    SIM_TEST_EXPECT(Test_Check(5u, 1100), 0u);
+    SIM_TEST_EXPECT(Test_Check(5u, 1101), 1u);
+    Test_ExpectEvent(WINDOW_COMPARATOR_EVENT_EXIT, 5u, 1101);
+    SIM_TEST_CHECK(WindowComparator_IsOutside(&comparator, 5u));
+
+    /* Back within the limits, but not the hysteresis: still outside */
+    SIM_TEST_EXPECT(Test_Check(5u, 1080), 0u);
+    SIM_TEST_EXPECT(Test_Check(5u, 1051), 0u);
+    SIM_TEST_EXPECT(Test_Check(5u, 1050), 1u);
+    Test_ExpectEvent(WINDOW_COMPARATOR_EVENT_ENTER, 5u, 1050);
+    SIM_TEST_CHECK(!WindowComparator_IsOutside(&comparator, 5u));
+
+    /* Exit below the low limit */
+    SIM_TEST_EXPECT(Test_Check(5u, 899), 1u);
+    Test_ExpectEvent(WINDOW_COMPARATOR_EVENT_EXIT, 5u, 899);
+    SIM_TEST_EXPECT(Test_Check(5u, 949), 0u);
+    SIM_TEST_EXPECT(Test_Check(5u, 950), 1u);
+    Test_ExpectEvent(WINDOW_COMPARATOR_EVENT_ENTER, 5u, 950);
+
+    /* A channel without a window never crosses */
+    SIM_TEST_EXPECT(Test_Check(6u, INT16_MAX), 0u);
+    SIM_TEST_EXPECT(Test_Check(6u, INT16_MIN), 0u);
+
+    /* Last channel, no hysteresis */
+    SIM_TEST_EXPECT(Test_Check(20u, 3000), 1u);
+    Test_ExpectEvent(WINDOW_COMPARATOR_EVENT_EXIT, 20u, 3000);
+    SIM_TEST_EXPECT(Test_Check(20u, 2500), 0u);
+    SIM_TEST_CHECK(WindowComparator_IsOutside(&comparator, 20u));
+
+    /* Clearing the window brings the channel back inside, silently */
+    SIM_TEST_CHECK(WindowComparator_ClearLimits(&comparator, 20u) == WINDOW_COMPARATOR_SUCCESS);
+    SIM_TEST_CHECK(!WindowComparator_IsOutside(&comparator, 20u));
+    SIM_TEST_EXPECT(Test_Check(20u, 2500), 0u);
+
+    SIM_TEST_EXPECT(WindowComparator_GetCrossings(&comparator), 5u);
+
+    return SimTest_Result("test_window_comparator");
+}
+
+/* [] END OF FILE */
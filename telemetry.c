@@ -0,0 +1,444 @@
+/*******************************************************************************
+* File Name: telemetry.c
+*
+*  Description: This file contains the implementation of the binary telemetry
+*   stream, which sends the Sampler frames over a UART with a DMA.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include "telemetry.h"
+#include "frame_codec.h"
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+/* The payload of an encoded packet is a single X loop, so any frame encoded
+ * by frame_codec.c shall fit in it: up to 81 channels */
+_Static_assert(FRAME_CODEC_MAX_SIZE(FRAME_CODEC_MAX_NUM_CHANNELS) <= TELEMETRY_MAX_ENCODED_SIZE,
+               "FRAME_CODEC_MAX_NUM_CHANNELS too large for TELEMETRY_MAX_ENCODED_SIZE");
+
+/* CRC-16/CCITT (polynomial 0x1021), one entry per nibble */
+static const uint16_t telemetry_crc_table[16] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+/*******************************************************************************
+* Local Functions
+*******************************************************************************/
+static en_telemetry_status_t Telemetry_Send(telemetry_t *telemetry, uint8_t version, const void *data, 
+                                            uint32_t x_count, uint32_t y_count, 
+                                            uint32_t sequence, uint32_t timestamp);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Writes one byte per TX FIFO trigger. The trigger is a level, so the DMA 
+ * waits for the FIFO level to update before sampling it again */
+const cy_stc_dma_descriptor_config_t telemetry_dma_descriptor_config = 
+{
+    .retrigger = CY_DMA_RETRIG_4CYC,
+    .interruptType = CY_DMA_DESCR_CHAIN,
+    .triggerOutType = CY_DMA_1ELEMENT,
+    .channelState = CY_DMA_CHANNEL_ENABLED,
+    .triggerInType = CY_DMA_1ELEMENT,
+    .dataSize = CY_DMA_BYTE,
+    .srcTransferSize = CY_DMA_TRANSFER_SIZE_DATA,
+    .dstTransferSize = CY_DMA_TRANSFER_SIZE_WORD,
+    .descriptorType = CY_DMA_1D_TRANSFER,
+    .srcAddress = NULL,
+    .dstAddress = NULL,
+    .srcXincrement = 1,
+    .dstXincrement = 0,
+    .xCount = 1,
+    .srcYincrement = 0,
+    .dstYincrement = 0,
+    .yCount = 1,
+    .nextDescriptor = NULL,
+};
+
+const cy_stc_dma_channel_config_t telemetry_dma_channel_config = 
+{
+    .descriptor = NULL,
+    .preemptable = false,
+    .priority = 3,
+    .enable = false,
+    .bufferable = false,
+};
+
+/*******************************************************************************
+* Function Name: Telemetry_Init
+********************************************************************************
+* Summary:
+*   Initialize a Telemetry object to send frames over the given UART. The UART
+*   has to be initialized and enabled by the application, for example by 
+*   retarget-io. The application shall not write to the UART while packets are
+*   being sent.
+*
+* Parameters:
+*   telemetry: telemetry object
+*   scb: SCB base of the UART
+*   num_channels: number of samples per frame
+*
+* Return:
+*   If initialized correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_telemetry_status_t Telemetry_Init(telemetry_t *telemetry, CySCB_Type *scb, uint8_t num_channels)
+{
+    if (telemetry == NULL || scb == NULL || num_channels == 0)
+    {
+        return TELEMETRY_ERROR;
+    }
+
+    telemetry->scb_base = scb;
+    telemetry->num_channels = num_channels;
+    telemetry->busy = false;
+    telemetry->packets = 0;
+    telemetry->dropped = 0;
+    telemetry->dma_base = NULL;
+
+    /* Fixed fields of the header */
+    telemetry->header[0] = TELEMETRY_SYNC_0;
+    telemetry->header[1] = TELEMETRY_SYNC_1;
+    telemetry->header[2] = num_channels;
+    telemetry->header[3] = TELEMETRY_VERSION;
+
+    /* Request data while the TX FIFO has room */
+    Cy_SCB_UART_SetTxFifoLevel(scb, TELEMETRY_TX_FIFO_LEVEL);
+
+    return TELEMETRY_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Telemetry_Deinit
+********************************************************************************
+* Summary:
+*   De-initialize a Telemetry object.
+*
+* Parameters:
+*   telemetry: telemetry object
+*
+*******************************************************************************/
+void Telemetry_Deinit(telemetry_t *telemetry)
+{
+    if (telemetry == NULL)
+    {
+        return;
+    }
+
+    if (telemetry->dma_base != NULL)
+    {
+        Cy_DMA_Channel_Disable(telemetry->dma_base, telemetry->dma_chan);
+        Cy_DMA_Channel_DeInit(telemetry->dma_base, telemetry->dma_chan);
+    }
+
+    telemetry->dma_base = NULL;
+    telemetry->busy = false;
+}
+
+/*******************************************************************************
+* Function Name: Telemetry_SetupDMA
+********************************************************************************
+* Summary:
+*   Setup a DMA to write the packets to the UART TX FIFO without the CPU. The
+*   DW channel input trigger shall be connected to the TX trigger of the SCB.
+*   One descriptor sends the header, one sends the samples straight from the 
+*   frame buffer, and the last one sends the CRC and disables the channel.
+*
+* Parameters:
+*   telemetry: telemetry object
+*   dma_base: DW base
+*   dma_chan: DW channel
+*
+* Return:
+*   If setup correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_telemetry_status_t Telemetry_SetupDMA(telemetry_t *telemetry, DW_Type *dma_base, uint32_t dma_chan)
+{
+    cy_stc_dma_channel_config_t channel_config = telemetry_dma_channel_config;
+    cy_stc_dma_descriptor_t *desc;
+
+    if (telemetry == NULL || dma_base == NULL || telemetry->scb_base == NULL)
+    {
+        return TELEMETRY_ERROR;
+    }
+
+    telemetry->dma_base = dma_base;
+    telemetry->dma_chan = dma_chan;
+    desc = telemetry->dma_desc;
+
+    /* Header */
+    Cy_DMA_Descriptor_Init(&desc[0], &telemetry_dma_descriptor_config);
+    Cy_DMA_Descriptor_SetSrcAddress(&desc[0], telemetry->header);
+    Cy_DMA_Descriptor_SetDstAddress(&desc[0], (void *) &telemetry->scb_base->TX_FIFO_WR);
+    Cy_DMA_Descriptor_SetXloopDataCount(&desc[0], TELEMETRY_HEADER_SIZE);
+    Cy_DMA_Descriptor_SetNextDescriptor(&desc[0], &desc[1]);
+
+    /* Samples, two bytes per channel. The frame is set for every packet */
+    Cy_DMA_Descriptor_Init(&desc[1], &telemetry_dma_descriptor_config);
+    Cy_DMA_Descriptor_SetDstAddress(&desc[1], (void *) &telemetry->scb_base->TX_FIFO_WR);
+    Cy_DMA_Descriptor_SetDescriptorType(&desc[1], CY_DMA_2D_TRANSFER);
+    Cy_DMA_Descriptor_SetXloopDataCount(&desc[1], sizeof(int16_t));
+    Cy_DMA_Descriptor_SetYloopDataCount(&desc[1], telemetry->num_channels);
+    Cy_DMA_Descriptor_SetYloopSrcIncrement(&desc[1], sizeof(int16_t));
+    Cy_DMA_Descriptor_SetYloopDstIncrement(&desc[1], 0);
+    Cy_DMA_Descriptor_SetNextDescriptor(&desc[1], &desc[2]);
+
+    /* CRC, then stop until the next packet */
+    Cy_DMA_Descriptor_Init(&desc[2], &telemetry_dma_descriptor_config);
+    Cy_DMA_Descriptor_SetSrcAddress(&desc[2], telemetry->crc);
+    Cy_DMA_Descriptor_SetDstAddress(&desc[2], (void *) &telemetry->scb_base->TX_FIFO_WR);
+    Cy_DMA_Descriptor_SetXloopDataCount(&desc[2], TELEMETRY_CRC_SIZE);
+    Cy_DMA_Descriptor_SetInterruptType(&desc[2], CY_DMA_DESCR);
+    Cy_DMA_Descriptor_SetChannelState(&desc[2], CY_DMA_CHANNEL_DISABLED);
+    Cy_DMA_Descriptor_SetNextDescriptor(&desc[2], &desc[0]);
+
+    /* Initialize the DMA channel and enable the packet sent interrupt */
+    channel_config.descriptor = &desc[0];
+    Cy_DMA_Channel_Init(dma_base, dma_chan, &channel_config);
+    Cy_DMA_Channel_SetInterruptMask(dma_base, dma_chan, CY_DMA_INTR_MASK);
+    Cy_DMA_Enable(dma_base);
+
+    return TELEMETRY_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Telemetry_SendFrame
+********************************************************************************
+* Summary:
+*   Send a frame as one packet. The samples are not copied, the DMA reads them
+*   from the frame while the packet is sent, so the frame shall not change 
+*   until Telemetry_IsBusy() returns false. If it changes anyway, the CRC does
+*   not match and the receiver drops the packet.
+*
+* Parameters:
+*   telemetry: telemetry object
+*   frame: samples of all the channels
+*   sequence: frame sequence number
+*   timestamp: frame time, in units chosen by the application
+*
+* Return:
+*   SUCCESS if the packet is being sent, BUSY if the previous packet is not 
+*   sent yet, in which case the frame is dropped, otherwise ERROR.
+*
+*******************************************************************************/
+en_telemetry_status_t Telemetry_SendFrame(telemetry_t *telemetry, const int16_t *frame, 
+                                          uint32_t sequence, uint32_t timestamp)
+{
+    if (telemetry == NULL || frame == NULL)
+    {
+        return TELEMETRY_ERROR;
+    }
+
+    return Telemetry_Send(telemetry, TELEMETRY_VERSION, frame, sizeof(int16_t), telemetry->num_channels, 
+                          sequence, timestamp);
+}
+
+/*******************************************************************************
+* Function Name: Telemetry_SendEncoded
+********************************************************************************
+* Summary:
+*   Send a frame encoded by FrameCodec_Encode() as one packet. Like with 
+*   Telemetry_SendFrame(), the DMA reads the encoded bytes while the packet is
+*   sent. If the packet is dropped, the next frame shall be a key frame.
+*
+* Parameters:
+*   telemetry: telemetry object
+*   data: encoded frame
+*   length: length of the encoded frame, up to TELEMETRY_MAX_ENCODED_SIZE
+*   sequence: frame sequence number
+*   timestamp: frame time, in units chosen by the application
+*
+* Return:
+*   SUCCESS if the packet is being sent, BUSY if the previous packet is not 
+*   sent yet, in which case the frame is dropped, otherwise ERROR.
+*
+*******************************************************************************/
+en_telemetry_status_t Telemetry_SendEncoded(telemetry_t *telemetry, const uint8_t *data, uint32_t length,
+                                            uint32_t sequence, uint32_t timestamp)
+{
+    if (telemetry == NULL || data == NULL || length == 0 || length > TELEMETRY_MAX_ENCODED_SIZE)
+    {
+        return TELEMETRY_ERROR;
+    }
+
+    return Telemetry_Send(telemetry, TELEMETRY_VERSION_ENCODED, data, length, 1u, sequence, timestamp);
+}
+
+/*******************************************************************************
+* Function Name: Telemetry_IsBusy
+********************************************************************************
+* Summary:
+*   Check if a packet is being sent.
+*
+* Parameters:
+*   telemetry: telemetry object
+*
+* Return:
+*   True while the DMA reads the frame of the last packet.
+*
+*******************************************************************************/
+bool Telemetry_IsBusy(telemetry_t *telemetry)
+{
+    if (telemetry == NULL)
+    {
+        return false;
+    }
+
+    return telemetry->busy;
+}
+
+/*******************************************************************************
+* Function Name: Telemetry_Crc16
+********************************************************************************
+* Summary:
+*   Update a CRC-16/CCITT with the given bytes. It is the CRC used by the 
+*   packets, so a receiver can check them with the same function.
+*
+* Parameters:
+*   crc: current CRC, TELEMETRY_CRC_INIT for the first bytes
+*   data: bytes to add
+*   length: number of bytes
+*
+* Return:
+*   Updated CRC.
+*
+*******************************************************************************/
+uint16_t Telemetry_Crc16(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; i++)
+    {
+        crc = (uint16_t)(crc << 4) ^ telemetry_crc_table[(crc >> 12) ^ (data[i] >> 4)];
+        crc = (uint16_t)(crc << 4) ^ telemetry_crc_table[(crc >> 12) ^ (data[i] & 0x0Fu)];
+    }
+
+    return crc;
+}
+
+/*******************************************************************************
+* Function Name: Telemetry_IRQHandler
+********************************************************************************
+* Summary:
+*   Handle the packet sent interrupt of the Telemetry DMA. This function shall
+*   be called from the interrupt service routine of the DW channel given to 
+*   Telemetry_SetupDMA().
+*
+* Parameters:
+*   telemetry: telemetry object
+*
+*******************************************************************************/
+void Telemetry_IRQHandler(telemetry_t *telemetry)
+{
+    if (telemetry == NULL || telemetry->dma_base == NULL)
+    {
+        return;
+    }
+
+    Cy_DMA_Channel_ClearInterrupt(telemetry->dma_base, telemetry->dma_chan);
+
+    telemetry->packets++;
+    telemetry->busy = false;
+}
+
+
+/*******************************************************************************
+* Function Name: Telemetry_Send
+********************************************************************************
+* Summary:
+*   Fill the header and CRC of a packet and start the DMA. The payload is sent
+*   as y_count rows of x_count bytes.
+*
+* Parameters:
+*   telemetry: telemetry object
+*   version: version field of the header
+*   data: payload
+*   x_count: bytes per row
+*   y_count: number of rows
+*   sequence: frame sequence number
+*   timestamp: frame time, in units chosen by the application
+*
+* Return:
+*   SUCCESS if the packet is being sent, BUSY if the previous packet is not 
+*   sent yet, otherwise ERROR.
+*
+*******************************************************************************/
+static en_telemetry_status_t Telemetry_Send(telemetry_t *telemetry, uint8_t version, const void *data, 
+                                            uint32_t x_count, uint32_t y_count, 
+                                            uint32_t sequence, uint32_t timestamp)
+{
+    uint16_t crc;
+
+    if (telemetry->dma_base == NULL)
+    {
+        return TELEMETRY_ERROR;
+    }
+
+    if (telemetry->busy)
+    {
+        telemetry->dropped++;
+        return TELEMETRY_BUSY;
+    }
+
+    telemetry->header[3] = version;
+    telemetry->header[4] = (uint8_t) sequence;
+    telemetry->header[5] = (uint8_t)(sequence >> 8);
+    telemetry->header[6] = (uint8_t)(sequence >> 16);
+    telemetry->header[7] = (uint8_t)(sequence >> 24);
+    telemetry->header[8] = (uint8_t) timestamp;
+    telemetry->header[9] = (uint8_t)(timestamp >> 8);
+    telemetry->header[10] = (uint8_t)(timestamp >> 16);
+    telemetry->header[11] = (uint8_t)(timestamp >> 24);
+
+    crc = Telemetry_Crc16(TELEMETRY_CRC_INIT, &telemetry->header[2], TELEMETRY_HEADER_SIZE - 2u);
+    crc = Telemetry_Crc16(crc, (const uint8_t *) data, x_count * y_count);
+    telemetry->crc[0] = (uint8_t) crc;
+    telemetry->crc[1] = (uint8_t)(crc >> 8);
+
+    telemetry->busy = true;
+
+    Cy_DMA_Descriptor_SetSrcAddress(&telemetry->dma_desc[1], data);
+    Cy_DMA_Descriptor_SetXloopDataCount(&telemetry->dma_desc[1], x_count);
+    Cy_DMA_Descriptor_SetYloopDataCount(&telemetry->dma_desc[1], y_count);
+    Cy_DMA_Descriptor_SetYloopSrcIncrement(&telemetry->dma_desc[1], x_count);
+    Cy_DMA_Channel_SetDescriptor(telemetry->dma_base, telemetry->dma_chan, 
+                                 &telemetry->dma_desc[0]);
+    Cy_DMA_Channel_Enable(telemetry->dma_base, telemetry->dma_chan);
+
+    return TELEMETRY_SUCCESS;
+}
+
+
+/* [] END OF FILE */
\ No newline at end of file
@@ -0,0 +1,125 @@
+/*****************************************************************************
+* File Name  : telemetry.h
+*
+* Description: This file contains definitions of constants and structures for
+*              the binary telemetry stream of the Sampler frames over a UART.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "cy_pdl.h"
+
+/*******************************************************************************
+*                              Enumerated Types
+*******************************************************************************/
+typedef enum
+{
+    /** Return success */
+    TELEMETRY_SUCCESS = 0u,
+
+    /** Return error */
+    TELEMETRY_ERROR = 1u,
+
+    /** The previous packet is still being sent */
+    TELEMETRY_BUSY = 2u,
+
+} en_telemetry_status_t;
+
+
+/*******************************************************************************
+*                                 API Constants
+*******************************************************************************/
+/* Packet: sync (2), number of channels (1), version (1), sequence (4), 
+ * timestamp (4), samples (2 per channel), CRC (2). Fields are little endian */
+#define TELEMETRY_SYNC_0               (0xA5u)
+#define TELEMETRY_SYNC_1               (0x5Au)
+#define TELEMETRY_VERSION              (1u)
+
+/* Packets of frames encoded by frame_codec.c carry this version. Their 
+ * samples are replaced by the encoded frame, which holds its own length */
+#define TELEMETRY_VERSION_ENCODED      (2u)
+#define TELEMETRY_MAX_ENCODED_SIZE     (CY_DMA_LOOP_COUNT_MAX)
+#define TELEMETRY_HEADER_SIZE          (12u)
+#define TELEMETRY_CRC_SIZE             (2u)
+
+/* The CRC-16/CCITT covers the packet after the sync bytes */
+#define TELEMETRY_CRC_INIT             (0xFFFFu)
+
+/* The DMA keeps the TX FIFO filled up to this number of bytes */
+#ifndef TELEMETRY_TX_FIFO_LEVEL
+    #define TELEMETRY_TX_FIFO_LEVEL        (32u)
+#endif
+
+/* Header, samples and CRC */
+#define TELEMETRY_NUM_DESCRIPTORS      (3u)
+
+/*******************************************************************************
+*                              Type Definitions
+*******************************************************************************/
+/** Object Structure */
+typedef struct
+{
+    CySCB_Type *scb_base;
+    uint8_t num_channels;
+    uint8_t header[TELEMETRY_HEADER_SIZE];
+    uint8_t crc[TELEMETRY_CRC_SIZE];
+    volatile bool busy;
+    uint32_t packets;
+    uint32_t dropped;
+    DW_Type* dma_base;
+    uint32_t dma_chan;
+    cy_stc_dma_descriptor_t dma_desc[TELEMETRY_NUM_DESCRIPTORS];
+} telemetry_t;
+
+/*******************************************************************************
+*                            Function Prototypes
+*******************************************************************************/
+en_telemetry_status_t Telemetry_Init(telemetry_t *telemetry, CySCB_Type *scb, uint8_t num_channels);
+en_telemetry_status_t Telemetry_SetupDMA(telemetry_t *telemetry, DW_Type *dma_base, uint32_t dma_chan);
+en_telemetry_status_t Telemetry_SendFrame(telemetry_t *telemetry, const int16_t *frame, 
+                                          uint32_t sequence, uint32_t timestamp);
+en_telemetry_status_t Telemetry_SendEncoded(telemetry_t *telemetry, const uint8_t *data, uint32_t length,
+                                            uint32_t sequence, uint32_t timestamp);
+bool Telemetry_IsBusy(telemetry_t *telemetry);
+uint16_t Telemetry_Crc16(uint16_t crc, const uint8_t *data, uint32_t length);
+void Telemetry_IRQHandler(telemetry_t *telemetry);
+void Telemetry_Deinit(telemetry_t *telemetry);
+
+
+#endif /* TELEMETRY_H_ */
\ No newline at end of file
@@ -0,0 +1,246 @@
+/*****************************************************************************
+* File Name  : capture_reader.hpp
+*
+* Description: This file contains the host reader of the capture files written
+*              by the Capture object. The file is memory mapped, so a channel
+*              of a capture larger than the memory of the host is read block
+*              by block, touching only the pages of that channel.
+*
+*              Header only, C++11 and POSIX:
+*
+*                  capture::Reader reader("adc.cap");
+*                  reader.for_each_sample(3, [](uint32_t seq, int16_t v) {});
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef CAPTURE_READER_HPP_
+#define CAPTURE_READER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../capture_format.h"
+
+namespace capture
+{
+
+/** Block of a capture, num_frames consecutive frames stored by channel */
+class Block
+{
+public:
+    Block(const capture_block_header_t *header, const int16_t *samples, uint32_t frames_per_block)
+        : header_(header), samples_(samples), frames_per_block_(frames_per_block) {}
+
+    uint32_t index() const { return header_->index; }
+    uint32_t first_sequence() const { return header_->first_sequence; }
+    uint32_t num_frames() const { return header_->num_frames; }
+
+    /** Samples of a channel, num_frames() of them */
+    const int16_t *column(uint32_t channel) const
+    {
+        return samples_ + static_cast<size_t>(channel) * frames_per_block_;
+    }
+
+private:
+    const capture_block_header_t *header_;
+    const int16_t *samples_;
+    uint32_t frames_per_block_;
+};
+
+/** Read-only view of a capture file */
+class Reader
+{
+public:
+    explicit Reader(const std::string &path)
+    {
+        struct stat st;
+
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0)
+        {
+            throw std::runtime_error("capture: cannot open " + path);
+        }
+
+        if (::fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(capture_file_header_t))
+        {
+            ::close(fd_);
+            throw std::runtime_error("capture: " + path + " is too short");
+        }
+
+        size_ = static_cast<size_t>(st.st_size);
+        void *map = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (map == MAP_FAILED)
+        {
+            ::close(fd_);
+            throw std::runtime_error("capture: cannot map " + path);
+        }
+        data_ = static_cast<const uint8_t *>(map);
+
+        /* Blocks are read in order, once */
+        ::madvise(map, size_, MADV_SEQUENTIAL);
+
+        try
+        {
+            validate();
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+    ~Reader() { release(); }
+
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    const capture_file_header_t &header() const { return *header_; }
+    uint32_t scan_rate_hz() const { return header_->scan_rate_hz; }
+    uint32_t acq_time_ns() const { return header_->acq_time_ns; }
+    uint16_t oversampling() const { return header_->oversampling; }
+    uint16_t num_channels() const { return header_->num_channels; }
+    uint32_t frames_per_block() const { return header_->frames_per_block; }
+
+    /** Port and pin sampled by a channel */
+    const capture_channel_t &channel(uint32_t index) const
+    {
+        if (index >= header_->num_channels)
+        {
+            throw std::out_of_range("capture: channel out of range");
+        }
+        return channels_[index];
+    }
+
+    /** Number of complete blocks, a block cut by the end of the file is 
+     *  ignored */
+    size_t num_blocks() const { return num_blocks_; }
+
+    Block block(size_t index) const
+    {
+        if (index >= num_blocks_)
+        {
+            throw std::out_of_range("capture: block out of range");
+        }
+
+        const uint8_t *base = data_ + header_->header_size + index * header_->block_size;
+        const capture_block_header_t *block = reinterpret_cast<const capture_block_header_t *>(base);
+        if (block->magic != CAPTURE_BLOCK_MAGIC || block->num_frames > header_->frames_per_block)
+        {
+            throw std::runtime_error("capture: corrupted block");
+        }
+
+        return Block(block, reinterpret_cast<const int16_t *>(base + sizeof(capture_block_header_t)),
+                     header_->frames_per_block);
+    }
+
+    /** Call f(sequence, sample) for every sample of a channel, in order */
+    template <typename F>
+    void for_each_sample(uint32_t channel, F f) const
+    {
+        if (channel >= header_->num_channels)
+        {
+            throw std::out_of_range("capture: channel out of range");
+        }
+
+        for (size_t i = 0; i < num_blocks_; i++)
+        {
+            Block b = block(i);
+            const int16_t *column = b.column(channel);
+            for (uint32_t j = 0; j < b.num_frames(); j++)
+            {
+                f(b.first_sequence() + j, column[j]);
+            }
+        }
+    }
+
+private:
+    void validate()
+    {
+        header_ = reinterpret_cast<const capture_file_header_t *>(data_);
+        if (header_->magic != CAPTURE_MAGIC)
+        {
+            throw std::runtime_error("capture: not a capture file");
+        }
+        if (header_->version != CAPTURE_VERSION)
+        {
+            throw std::runtime_error("capture: unsupported version");
+        }
+
+        size_t channels_size = header_->num_channels * sizeof(capture_channel_t);
+        size_t block_size = sizeof(capture_block_header_t) +
+                            static_cast<size_t>(header_->num_channels) * header_->frames_per_block * sizeof(int16_t);
+        if (header_->num_channels == 0 || header_->frames_per_block == 0 ||
+            header_->header_size != sizeof(capture_file_header_t) + channels_size ||
+            header_->block_size != block_size || size_ < header_->header_size)
+        {
+            throw std::runtime_error("capture: inconsistent header");
+        }
+
+        channels_ = reinterpret_cast<const capture_channel_t *>(data_ + sizeof(capture_file_header_t));
+        num_blocks_ = (size_ - header_->header_size) / header_->block_size;
+    }
+
+    void release()
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast<uint8_t *>(data_), size_);
+            data_ = nullptr;
+        }
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    int fd_ = -1;
+    size_t size_ = 0;
+    const uint8_t *data_ = nullptr;
+    const capture_file_header_t *header_ = nullptr;
+    const capture_channel_t *channels_ = nullptr;
+    size_t num_blocks_ = 0;
+};
+
+} /* namespace capture */
+
+#endif /* CAPTURE_READER_HPP_ */
\ No newline at end of file
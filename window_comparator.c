@@ -0,0 +1,309 @@
+/*******************************************************************************
+* File Name: window_comparator.c
+*
+*  Description: This file contains the per-channel window comparator that
+*   reports the Sampler channels crossing their limits.
+*
+******************************************************************************
+* (c) 2023, Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*****************************************************************************/
+
+#include "window_comparator.h"
+
+/*******************************************************************************
+* Function Name: WindowComparator_Init
+********************************************************************************
+* Summary:
+*   Initialize a window comparator for frames of num_channels samples. The 
+*   channels have no limits until WindowComparator_SetLimits() is called.
+*
+* Parameters:
+*   comparator: window comparator object
+*   num_channels: number of channels per frame
+*
+* Return:
+*   If initialized correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_window_comparator_status_t WindowComparator_Init(window_comparator_t *comparator, uint8_t num_channels)
+{
+    if (comparator == NULL || num_channels == 0 || num_channels > WINDOW_COMPARATOR_MAX_NUM_CHANNELS)
+    {
+        return WINDOW_COMPARATOR_ERROR;
+    }
+
+    comparator->num_channels = num_channels;
+    comparator->callback = NULL;
+    comparator->callback_arg = NULL;
+    comparator->crossings = 0;
+
+    for (uint32_t i = 0; i < WINDOW_COMPARATOR_NUM_WORDS; i++)
+    {
+        comparator->outside[i] = 0;
+    }
+
+    for (uint32_t i = 0; i < WINDOW_COMPARATOR_MAX_NUM_CHANNELS; i++)
+    {
+        comparator->low[i] = INT16_MIN;
+        comparator->high[i] = INT16_MAX;
+        comparator->enter_low[i] = INT16_MIN;
+        comparator->enter_high[i] = INT16_MAX;
+    }
+
+    return WINDOW_COMPARATOR_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: WindowComparator_SetLimits
+********************************************************************************
+* Summary:
+*   Set the window of a channel. The channel exits the window when a sample is
+*   below low or above high, then enters it again when a sample is within the
+*   window narrowed by the hysteresis, so a noisy sample close to a limit does
+*   not report a crossing on every frame. The channel starts within the window.
+*   If WindowComparator_Check() is called from an interrupt, call this function
+*   with that interrupt disabled.
+*
+* Parameters:
+*   comparator: window comparator object
+*   channel: channel index in the frame
+*   low: lowest sample value within the window
+*   high: highest sample value within the window
+*   hysteresis: distance from the limits to enter the window again
+*
+* Return:
+*   If set correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_window_comparator_status_t WindowComparator_SetLimits(window_comparator_t *comparator, uint8_t channel,
+                                                         int16_t low, int16_t high, uint16_t hysteresis)
+{
+    if (comparator == NULL || channel >= comparator->num_channels)
+    {
+        return WINDOW_COMPARATOR_ERROR;
+    }
+
+    /* The narrowed window shall not be empty */
+    if (((int32_t) high - (int32_t) low) < (2 * (int32_t) hysteresis))
+    {
+        return WINDOW_COMPARATOR_ERROR;
+    }
+
+    comparator->low[channel] = low;
+    comparator->high[channel] = high;
+    comparator->enter_low[channel] = (int16_t) (low + (int32_t) hysteresis);
+    comparator->enter_high[channel] = (int16_t) (high - (int32_t) hysteresis);
+    comparator->outside[channel / 32u] &= ~(1u << (channel % 32u));
+
+    return WINDOW_COMPARATOR_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: WindowComparator_ClearLimits
+********************************************************************************
+* Summary:
+*   Remove the window of a channel, which then never reports a crossing.
+*
+* Parameters:
+*   comparator: window comparator object
+*   channel: channel index in the frame
+*
+* Return:
+*   If cleared correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_window_comparator_status_t WindowComparator_ClearLimits(window_comparator_t *comparator, uint8_t channel)
+{
+    return WindowComparator_SetLimits(comparator, channel, INT16_MIN, INT16_MAX, 0);
+}
+
+/*******************************************************************************
+* Function Name: WindowComparator_RegisterCallback
+********************************************************************************
+* Summary:
+*   Register a function to be called from WindowComparator_Check() every time 
+*   a channel exits or enters its window. Pass NULL to remove the callback.
+*
+* Parameters:
+*   comparator: window comparator object
+*   callback: function to be called on events
+*   arg: user argument passed to the callback
+*
+* Return:
+*   If registered correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_window_comparator_status_t WindowComparator_RegisterCallback(window_comparator_t *comparator, 
+                                                                window_comparator_callback_t callback, void *arg)
+{
+    if (comparator == NULL)
+    {
+        return WINDOW_COMPARATOR_ERROR;
+    }
+
+    comparator->callback_arg = arg;
+    comparator->callback = callback;
+
+    return WINDOW_COMPARATOR_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: WindowComparator_Check
+********************************************************************************
+* Summary:
+*   Compare a frame with the windows of its channels and call the callback for
+*   every channel that exited or entered its window. It is meant to be called 
+*   from the Sampler callback, so the application only runs on a crossing.
+*   The comparisons are branchless and build a bitmap of the channels, 32 at a 
+*   time, which is compared with the previous one.
+*
+* Parameters:
+*   comparator: window comparator object
+*   frame: samples, num_channels of them
+*   sequence: sequence number of the frame, passed to the events
+*
+* Return:
+*   If checked correctly, returns SUCCESS, otherwise ERROR.
+*
+*******************************************************************************/
+en_window_comparator_status_t WindowComparator_Check(window_comparator_t *comparator, 
+                                                     const int16_t *frame, uint32_t sequence)
+{
+    window_comparator_event_t event;
+    uint32_t first;
+    uint32_t count;
+    uint32_t exit;
+    uint32_t enter;
+    uint32_t outside;
+    uint32_t changed;
+    int16_t value;
+
+    if (comparator == NULL || frame == NULL)
+    {
+        return WINDOW_COMPARATOR_ERROR;
+    }
+
+    for (uint32_t w = 0; (w * 32u) < comparator->num_channels; w++)
+    {
+        first = w * 32u;
+        count = comparator->num_channels - first;
+        if (count > 32u)
+        {
+            count = 32u;
+        }
+
+        exit = 0;
+        enter = 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            value = frame[first + i];
+            exit |= (uint32_t) ((value < comparator->low[first + i]) | 
+                                (value > comparator->high[first + i])) << i;
+            enter |= (uint32_t) ((value >= comparator->enter_low[first + i]) & 
+                                 (value <= comparator->enter_high[first + i])) << i;
+        }
+
+        outside = (comparator->outside[w] | exit) & ~enter;
+        changed = outside ^ comparator->outside[w];
+        comparator->outside[w] = outside;
+
+        for (uint32_t i = 0; changed != 0; i++, changed >>= 1)
+        {
+            if ((changed & 1u) == 0)
+            {
+                continue;
+            }
+
+            comparator->crossings++;
+
+            if (comparator->callback != NULL)
+            {
+                event.event = ((outside >> i) & 1u) ? WINDOW_COMPARATOR_EVENT_EXIT : WINDOW_COMPARATOR_EVENT_ENTER;
+                event.channel = (uint8_t) (first + i);
+                event.value = frame[first + i];
+                event.sequence = sequence;
+                comparator->callback(&event, comparator->callback_arg);
+            }
+        }
+    }
+
+    return WINDOW_COMPARATOR_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: WindowComparator_IsOutside
+********************************************************************************
+* Summary:
+*   Tell if a channel is outside its window, as of the last checked frame.
+*
+* Parameters:
+*   comparator: window comparator object
+*   channel: channel index in the frame
+*
+* Return:
+*   True if the channel is outside its window.
+*
+*******************************************************************************/
+bool WindowComparator_IsOutside(window_comparator_t *comparator, uint8_t channel)
+{
+    if (comparator == NULL || channel >= comparator->num_channels)
+    {
+        return false;
+    }
+
+    return ((comparator->outside[channel / 32u] >> (channel % 32u)) & 1u) != 0;
+}
+
+/*******************************************************************************
+* Function Name: WindowComparator_GetCrossings
+********************************************************************************
+* Summary:
+*   Return the number of exits and entries since WindowComparator_Init().
+*
+* Parameters:
+*   comparator: window comparator object
+*
+* Return:
+*   Number of crossings.
+*
+*******************************************************************************/
+uint32_t WindowComparator_GetCrossings(window_comparator_t *comparator)
+{
+    if (comparator == NULL)
+    {
+        return 0;
+    }
+
+    return comparator->crossings;
+}
+
+
+/* [] END OF FILE */
\ No newline at end of file
@@ -0,0 +1,128 @@
+/*****************************************************************************
+* File Name  : window_comparator.h
+*
+* Description: This file contains definitions of constants and structures for
+*              the per-channel window comparator of the Sampler frames.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef WINDOW_COMPARATOR_H_
+#define WINDOW_COMPARATOR_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+*                              Enumerated Types
+*******************************************************************************/
+typedef enum
+{
+    /** Return success */
+    WINDOW_COMPARATOR_SUCCESS = 0u,
+
+    /** Return error */
+    WINDOW_COMPARATOR_ERROR = 1u,
+
+} en_window_comparator_status_t;
+
+typedef enum
+{
+    /** The channel went below its low limit or above its high limit */
+    WINDOW_COMPARATOR_EVENT_EXIT = 0u,
+
+    /** The channel came back within its limits, minus the hysteresis */
+    WINDOW_COMPARATOR_EVENT_ENTER = 1u,
+
+} en_window_comparator_event_t;
+
+
+/*******************************************************************************
+*                                 API Constants
+*******************************************************************************/
+#ifndef WINDOW_COMPARATOR_MAX_NUM_CHANNELS
+    #define WINDOW_COMPARATOR_MAX_NUM_CHANNELS   (32u)
+#endif
+
+/* The channel states are kept as bitmaps, 32 channels per word */
+#define WINDOW_COMPARATOR_NUM_WORDS    ((WINDOW_COMPARATOR_MAX_NUM_CHANNELS + 31u) / 32u)
+
+/*******************************************************************************
+*                              Type Definitions
+*******************************************************************************/
+
+/** Event Structure */
+typedef struct
+{
+    en_window_comparator_event_t event;
+    uint8_t channel;
+    int16_t value;
+    uint32_t sequence;
+
+} window_comparator_event_t;
+
+/** Event Callback */
+typedef void (*window_comparator_callback_t)(const window_comparator_event_t *event, void *arg);
+
+/** Object Structure */
+typedef struct
+{
+    uint8_t num_channels;
+    /* A sample outside [low, high] exits the window, a sample within 
+     * [enter_low, enter_high] enters it again */
+    int16_t low[WINDOW_COMPARATOR_MAX_NUM_CHANNELS];
+    int16_t high[WINDOW_COMPARATOR_MAX_NUM_CHANNELS];
+    int16_t enter_low[WINDOW_COMPARATOR_MAX_NUM_CHANNELS];
+    int16_t enter_high[WINDOW_COMPARATOR_MAX_NUM_CHANNELS];
+    uint32_t outside[WINDOW_COMPARATOR_NUM_WORDS];
+    window_comparator_callback_t callback;
+    void *callback_arg;
+    uint32_t crossings;
+} window_comparator_t;
+
+/*******************************************************************************
+*                            Function Prototypes
+*******************************************************************************/
+en_window_comparator_status_t WindowComparator_Init(window_comparator_t *comparator, uint8_t num_channels);
+en_window_comparator_status_t WindowComparator_SetLimits(window_comparator_t *comparator, uint8_t channel,
+                                                         int16_t low, int16_t high, uint16_t hysteresis);
+en_window_comparator_status_t WindowComparator_ClearLimits(window_comparator_t *comparator, uint8_t channel);
+en_window_comparator_status_t WindowComparator_RegisterCallback(window_comparator_t *comparator, 
+                                                                window_comparator_callback_t callback, void *arg);
+en_window_comparator_status_t WindowComparator_Check(window_comparator_t *comparator, 
+                                                     const int16_t *frame, uint32_t sequence);
+bool WindowComparator_IsOutside(window_comparator_t *comparator, uint8_t channel);
+uint32_t WindowComparator_GetCrossings(window_comparator_t *comparator);
+
+
+#endif /* WINDOW_COMPARATOR_H_ */
\ No newline at end of file